@@ -0,0 +1,96 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "LayoutSpecialized.h"
+#import "RCTLayoutFuzzer.h"
+
+// Recorded layouts may come from a platform that contracts floating point
+// operations differently, so allow for rounding differences.
+static const float RCTTestCorpusEpsilon = 0.01f;
+
+// Set to regenerate RCTLayoutCorpus.txt from the reference engine.
+static NSString *const RCTTestRecordCorpusKey = @"RCT_RECORD_LAYOUT_CORPUS";
+
+static NSString *RCTTestCorpusPath(void)
+{
+  return [[@(__FILE__) stringByDeletingLastPathComponent] stringByAppendingPathComponent:@"RCTLayoutCorpus.txt"];
+}
+
+@interface RCTLayoutCorpusTests : XCTestCase
+
+@end
+
+@implementation RCTLayoutCorpusTests
+
+- (void)setUp
+{
+  [super setUp];
+
+  if (!NSProcessInfo.processInfo.environment[RCTTestRecordCorpusKey]) {
+    return;
+  }
+
+  FILE *file = fopen(RCTTestCorpusPath().fileSystemRepresentation, "w");
+  XCTAssertTrue(file != NULL);
+  fprintf(file, "# Golden layouts recorded from layoutNode, see RCTLayoutCorpusTests.m\n");
+  RCTLayoutFuzzerOptions options = RCTLayoutFuzzerDefaultOptions();
+  for (uint32_t seed = 0; seed < 64; seed++) {
+    options.maxDepth = seed % 4;
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCreateCase(seed, &options);
+    resetNodeLayout(testCase.root);
+    layoutNode(testCase.root, testCase.maxWidth, testCase.maxHeight, CSS_DIRECTION_INHERIT);
+    RCTLayoutFuzzerWriteCase(file, &testCase, true);
+    RCTLayoutFuzzerFreeCase(&testCase);
+  }
+  fclose(file);
+}
+
+- (void)validateCorpusWithEngine:(RCTLayoutEngine)engine
+{
+  FILE *file = fopen(RCTTestCorpusPath().fileSystemRepresentation, "r");
+  XCTAssertTrue(file != NULL, @"Missing corpus at %@", RCTTestCorpusPath());
+  if (!file) {
+    return;
+  }
+
+  int count = 0;
+  RCTLayoutFuzzerCase golden;
+  while (RCTLayoutFuzzerReadCase(file, &golden)) {
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCopyCase(&golden);
+    resetNodeLayout(testCase.root);
+    engine(testCase.root, testCase.maxWidth, testCase.maxHeight, CSS_DIRECTION_INHERIT);
+    XCTAssertTrue(RCTLayoutFuzzerLayoutsMatch(golden.root, testCase.root, RCTTestCorpusEpsilon),
+                  @"Layout of corpus case %d differs from the recorded one", count);
+    RCTLayoutFuzzerFreeCase(&testCase);
+    RCTLayoutFuzzerFreeCase(&golden);
+    count++;
+  }
+  XCTAssertTrue(feof(file), @"Malformed corpus case after %d cases", count);
+  XCTAssertGreaterThan(count, 0);
+  fclose(file);
+}
+
+- (void)testReferenceEngineMatchesCorpus
+{
+  [self validateCorpusWithEngine:layoutNode];
+}
+
+- (void)testSpecializedKernelMatchesCorpus
+{
+  [self validateCorpusWithEngine:layoutNodeSpecialized];
+}
+
+@end
@@ -0,0 +1,110 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "Layout.h"
+#import "RCTLayoutFuzzer.h"
+
+// RCTLayoutEngine takes no context, so the engines below read the viewports
+// of the case being checked from here.
+static css_viewport_t RCTTestViewport;
+static css_viewport_t RCTTestScrolledViewport;
+
+static void RCTTestLayoutCulled(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection)
+{
+  layoutNodeCulled(node, maxWidth, maxHeight, parentDirection, &RCTTestViewport);
+  layoutDeferredNodes(node);
+}
+
+static void RCTTestLayoutScrolled(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection)
+{
+  layoutNodeCulled(node, maxWidth, maxHeight, parentDirection, &RCTTestViewport);
+  layoutNodeCulled(node, maxWidth, maxHeight, parentDirection, &RCTTestScrolledViewport);
+  layoutNode(node, maxWidth, maxHeight, parentDirection);
+}
+
+// The fuzzer's nodes stay dirty, so every pass lays out the whole tree again
+static void RCTTestLayoutThreePasses(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection)
+{
+  for (int i = 0; i < 3; i++) {
+    layoutNode(node, maxWidth, maxHeight, parentDirection);
+  }
+}
+
+static css_viewport_t RCTTestMakeViewport(uint32_t seed)
+{
+  css_viewport_t viewport;
+  switch (seed % 3) {
+    case 0:
+      viewport.position[CSS_LEFT] = 0;
+      viewport.position[CSS_TOP] = 0;
+      viewport.dimensions[CSS_WIDTH] = CSS_UNDEFINED;
+      viewport.dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
+      break;
+    case 1:
+      viewport.position[CSS_LEFT] = 0;
+      viewport.position[CSS_TOP] = 0;
+      viewport.dimensions[CSS_WIDTH] = 10;
+      viewport.dimensions[CSS_HEIGHT] = 10;
+      break;
+    default:
+      viewport.position[CSS_LEFT] = (float)(seed % 400) - 200;
+      viewport.position[CSS_TOP] = (float)((seed / 400) % 400) - 200;
+      viewport.dimensions[CSS_WIDTH] = 50;
+      viewport.dimensions[CSS_HEIGHT] = 80;
+      break;
+  }
+  viewport.overscan = 5;
+  return viewport;
+}
+
+@interface RCTLayoutCulledTests : XCTestCase
+
+@end
+
+@implementation RCTLayoutCulledTests
+
+- (void)testCulledLayoutMatchesReferenceEngineOnceCompleted
+{
+  RCTLayoutFuzzerOptions options = RCTLayoutFuzzerDefaultOptions();
+  for (uint32_t seed = 0; seed < 3000; seed++) {
+    RCTTestViewport = RCTTestMakeViewport(seed);
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCreateCase(seed, &options);
+    if (!RCTLayoutFuzzerCheck(&testCase, layoutNode, RCTTestLayoutCulled, options.epsilon)) {
+      RCTLayoutFuzzerCase minimized = RCTLayoutFuzzerMinimize(&testCase, layoutNode, RCTTestLayoutCulled, options.epsilon);
+      char *description = RCTLayoutFuzzerDescribeCase(&minimized);
+      XCTFail(@"Culled layout differs for seed %u, minimized case:\n%s", seed, description);
+      free(description);
+      RCTLayoutFuzzerFreeCase(&minimized);
+    }
+    RCTLayoutFuzzerFreeCase(&testCase);
+  }
+}
+
+- (void)testScrolledCulledPassesMatchAsManyReferencePasses
+{
+  RCTLayoutFuzzerOptions options = RCTLayoutFuzzerDefaultOptions();
+  for (uint32_t seed = 0; seed < 3000; seed++) {
+    RCTTestViewport = RCTTestMakeViewport(seed);
+    RCTTestScrolledViewport = RCTTestViewport;
+    RCTTestScrolledViewport.position[CSS_TOP] += 100;
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCreateCase(seed, &options);
+    XCTAssertTrue(RCTLayoutFuzzerCheck(&testCase, RCTTestLayoutThreePasses, RCTTestLayoutScrolled, options.epsilon),
+                  @"Scrolled culled layout differs for seed %u", seed);
+    RCTLayoutFuzzerFreeCase(&testCase);
+  }
+}
+
+@end
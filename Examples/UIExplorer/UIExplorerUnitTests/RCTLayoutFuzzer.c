@@ -0,0 +1,770 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "RCTLayoutFuzzer.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RCT_LAYOUT_FUZZER_MAX_DEPTH 32
+#define RCT_LAYOUT_FUZZER_LINE_LENGTH 2048
+
+typedef struct {
+  css_node_t *children[RCT_LAYOUT_FUZZER_MAX_CHILDREN];
+  css_node_t *parent;
+  bool dirty;
+  // Text-like measure function: a run of `intrinsicWidth` points that wraps
+  // into lines of `lineHeight` points. Undefined when the node has no measure.
+  float intrinsicWidth;
+  float lineHeight;
+} RCTLayoutFuzzerNodeContext;
+
+#pragma mark - css_node_t callbacks
+
+static RCTLayoutFuzzerNodeContext *RCTContext(const css_node_t *node)
+{
+  return (RCTLayoutFuzzerNodeContext *)node->context;
+}
+
+static css_node_t *RCTGetChild(void *context, int i)
+{
+  return ((RCTLayoutFuzzerNodeContext *)context)->children[i];
+}
+
+static bool RCTIsDirty(void *context)
+{
+  return ((RCTLayoutFuzzerNodeContext *)context)->dirty;
+}
+
+static css_dim_t RCTMeasure(void *context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode)
+{
+  RCTLayoutFuzzerNodeContext *nodeContext = context;
+  float measuredWidth = nodeContext->intrinsicWidth;
+  if (widthMode == CSS_MEASURE_MODE_EXACTLY ||
+      (widthMode == CSS_MEASURE_MODE_AT_MOST && width < measuredWidth)) {
+    measuredWidth = width > 0 ? width : 0;
+  }
+  float lines = measuredWidth > 0 ? ceilf(nodeContext->intrinsicWidth / measuredWidth) : 1;
+  float measuredHeight = lines * nodeContext->lineHeight;
+  if (heightMode == CSS_MEASURE_MODE_EXACTLY ||
+      (heightMode == CSS_MEASURE_MODE_AT_MOST && height < measuredHeight)) {
+    measuredHeight = height > 0 ? height : 0;
+  }
+
+  css_dim_t dim;
+  dim.dimensions[CSS_WIDTH] = measuredWidth;
+  dim.dimensions[CSS_HEIGHT] = measuredHeight;
+  return dim;
+}
+
+static css_node_t *RCTCreateNode(void)
+{
+  css_node_t *node = new_css_node();
+  RCTLayoutFuzzerNodeContext *context = calloc(1, sizeof(RCTLayoutFuzzerNodeContext));
+  context->dirty = true;
+  context->intrinsicWidth = CSS_UNDEFINED;
+  context->lineHeight = CSS_UNDEFINED;
+  node->context = context;
+  node->get_child = RCTGetChild;
+  node->is_dirty = RCTIsDirty;
+  return node;
+}
+
+static void RCTSetMeasure(css_node_t *node, float intrinsicWidth, float lineHeight)
+{
+  RCTContext(node)->intrinsicWidth = intrinsicWidth;
+  RCTContext(node)->lineHeight = lineHeight;
+  node->measure = isUndefined(intrinsicWidth) ? NULL : RCTMeasure;
+}
+
+static void RCTAppendChild(css_node_t *node, css_node_t *child)
+{
+  RCTContext(node)->children[node->children_count++] = child;
+  RCTContext(child)->parent = node;
+}
+
+static void RCTRemoveChild(css_node_t *node, int index)
+{
+  RCTLayoutFuzzerNodeContext *context = RCTContext(node);
+  for (int i = index; i < node->children_count - 1; i++) {
+    context->children[i] = context->children[i + 1];
+  }
+  node->children_count--;
+}
+
+static void RCTFreeTree(css_node_t *node)
+{
+  for (int i = 0; i < node->children_count; i++) {
+    RCTFreeTree(RCTContext(node)->children[i]);
+  }
+  free(node->context);
+  free_css_node(node);
+}
+
+static css_node_t *RCTCopyTree(const css_node_t *node)
+{
+  css_node_t *copy = RCTCreateNode();
+  copy->style = node->style;
+  RCTSetMeasure(copy, RCTContext(node)->intrinsicWidth, RCTContext(node)->lineHeight);
+  for (int i = 0; i < node->children_count; i++) {
+    RCTAppendChild(copy, RCTCopyTree(RCTContext(node)->children[i]));
+  }
+  return copy;
+}
+
+static void RCTMarkClean(css_node_t *node)
+{
+  RCTContext(node)->dirty = false;
+  for (int i = 0; i < node->children_count; i++) {
+    RCTMarkClean(RCTContext(node)->children[i]);
+  }
+}
+
+static void RCTMarkDirty(css_node_t *node)
+{
+  for (; node != NULL; node = RCTContext(node)->parent) {
+    RCTContext(node)->dirty = true;
+  }
+}
+
+static css_node_t *RCTNodeAtIndex(css_node_t *node, int *index)
+{
+  if ((*index)-- == 0) {
+    return node;
+  }
+  for (int i = 0; i < node->children_count; i++) {
+    css_node_t *found = RCTNodeAtIndex(RCTContext(node)->children[i], index);
+    if (found != NULL) {
+      return found;
+    }
+  }
+  return NULL;
+}
+
+static css_node_t *RCTGetNode(css_node_t *root, int index)
+{
+  return RCTNodeAtIndex(root, &index);
+}
+
+#pragma mark - Generation
+
+static uint32_t RCTRandom(uint32_t *state)
+{
+  *state = *state * 1103515245 + 12345;
+  return (*state >> 16) & 0x7fff;
+}
+
+static bool RCTRandomChance(uint32_t *state, int outOf)
+{
+  return RCTRandom(state) % outOf == 0;
+}
+
+// Mostly small positive values with a sprinkle of undefined, zero and
+// negative ones, which the engine must all tolerate.
+static float RCTRandomValue(uint32_t *state)
+{
+  switch (RCTRandom(state) % 10) {
+    case 0:
+      return CSS_UNDEFINED;
+    case 1:
+      return 0;
+    case 2:
+      return -(float)(RCTRandom(state) % 20);
+    default:
+      return (RCTRandom(state) % 2000) / 10.0f;
+  }
+}
+
+static void RCTRandomizeStyle(uint32_t *state, css_style_t *style)
+{
+  style->direction = RCTRandomChance(state, 4) ? RCTRandom(state) % 3 : CSS_DIRECTION_INHERIT;
+  style->flex_direction = RCTRandom(state) % 4;
+  style->justify_content = RCTRandom(state) % 5;
+  style->align_content = RCTRandom(state) % 5;
+  style->align_items = 1 + RCTRandom(state) % 4;
+  style->align_self = RCTRandom(state) % 5;
+  style->position_type = RCTRandomChance(state, 5) ? CSS_POSITION_ABSOLUTE : CSS_POSITION_RELATIVE;
+  style->flex_wrap = RCTRandomChance(state, 3) ? CSS_WRAP : CSS_NOWRAP;
+  style->flex = RCTRandomChance(state, 3) ? (RCTRandom(state) % 4) / 1.5f : 0;
+  for (int i = 0; i < 6; i++) {
+    if (RCTRandomChance(state, 3)) {
+      style->margin[i] = RCTRandomValue(state);
+    }
+    if (RCTRandomChance(state, 3)) {
+      style->padding[i] = RCTRandomValue(state);
+    }
+    if (RCTRandomChance(state, 4)) {
+      style->border[i] = RCTRandomValue(state);
+    }
+  }
+  for (int i = 0; i < 4; i++) {
+    if (RCTRandomChance(state, 4)) {
+      style->position[i] = RCTRandomValue(state);
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    if (RCTRandomChance(state, 2)) {
+      style->dimensions[i] = RCTRandomValue(state);
+    }
+    if (RCTRandomChance(state, 4)) {
+      style->minDimensions[i] = RCTRandomValue(state);
+    }
+    if (RCTRandomChance(state, 4)) {
+      style->maxDimensions[i] = RCTRandomValue(state);
+    }
+  }
+}
+
+static css_node_t *RCTCreateTree(uint32_t *state, const RCTLayoutFuzzerOptions *options, int depth)
+{
+  css_node_t *node = RCTCreateNode();
+  RCTRandomizeStyle(state, &node->style);
+
+  if (depth < options->maxDepth) {
+    int childCount = RCTRandom(state) % (options->maxChildren + 1);
+    for (int i = 0; i < childCount; i++) {
+      RCTAppendChild(node, RCTCreateTree(state, options, depth + 1));
+    }
+  }
+  if (node->children_count == 0 && RCTRandomChance(state, 2)) {
+    RCTSetMeasure(node, (RCTRandom(state) % 3000) / 10.0f, 10 + RCTRandom(state) % 10);
+  }
+  return node;
+}
+
+RCTLayoutFuzzerOptions RCTLayoutFuzzerDefaultOptions(void)
+{
+  RCTLayoutFuzzerOptions options;
+  options.maxDepth = 4;
+  options.maxChildren = 4;
+  options.epsilon = 0;
+  return options;
+}
+
+RCTLayoutFuzzerCase RCTLayoutFuzzerCreateCase(uint32_t seed, const RCTLayoutFuzzerOptions *options)
+{
+  uint32_t state = seed;
+  RCTLayoutFuzzerCase testCase;
+  testCase.maxWidth = RCTRandomChance(&state, 2) ? CSS_UNDEFINED : 320;
+  testCase.maxHeight = RCTRandomChance(&state, 2) ? CSS_UNDEFINED : 480;
+  testCase.root = RCTCreateTree(&state, options, 0);
+  return testCase;
+}
+
+RCTLayoutFuzzerCase RCTLayoutFuzzerCopyCase(const RCTLayoutFuzzerCase *testCase)
+{
+  RCTLayoutFuzzerCase copy = *testCase;
+  copy.root = RCTCopyTree(testCase->root);
+  return copy;
+}
+
+void RCTLayoutFuzzerFreeCase(RCTLayoutFuzzerCase *testCase)
+{
+  if (testCase->root != NULL) {
+    RCTFreeTree(testCase->root);
+    testCase->root = NULL;
+  }
+}
+
+int RCTLayoutFuzzerCountNodes(const css_node_t *node)
+{
+  int count = 1;
+  for (int i = 0; i < node->children_count; i++) {
+    count += RCTLayoutFuzzerCountNodes(RCTContext(node)->children[i]);
+  }
+  return count;
+}
+
+#pragma mark - Comparison
+
+static bool RCTValuesMatch(float expected, float actual, float epsilon)
+{
+  if (isUndefined(expected) || isUndefined(actual)) {
+    return isUndefined(expected) && isUndefined(actual);
+  }
+  if (epsilon == 0) {
+    return memcmp(&expected, &actual, sizeof(float)) == 0 || expected == actual;
+  }
+  return fabsf(expected - actual) <= epsilon;
+}
+
+static bool RCTLayoutsMatch(css_node_t *expected, css_node_t *actual, float epsilon, bool compareTrailing)
+{
+  if (expected->children_count != actual->children_count ||
+      expected->layout.direction != actual->layout.direction) {
+    return false;
+  }
+  for (int i = 0; i < (compareTrailing ? 4 : 2); i++) {
+    if (!RCTValuesMatch(expected->layout.position[i], actual->layout.position[i], epsilon)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    if (!RCTValuesMatch(expected->layout.dimensions[i], actual->layout.dimensions[i], epsilon)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < expected->children_count; i++) {
+    if (!RCTLayoutsMatch(RCTContext(expected)->children[i], RCTContext(actual)->children[i], epsilon, compareTrailing)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RCTLayoutFuzzerLayoutsMatch(css_node_t *expected, css_node_t *actual, float epsilon)
+{
+  return RCTLayoutsMatch(expected, actual, epsilon, true);
+}
+
+static void RCTLayout(RCTLayoutEngine engine, RCTLayoutFuzzerCase *testCase)
+{
+  resetNodeLayout(testCase->root);
+  engine(testCase->root, testCase->maxWidth, testCase->maxHeight, CSS_DIRECTION_INHERIT);
+}
+
+bool RCTLayoutFuzzerCheck(const RCTLayoutFuzzerCase *testCase, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon)
+{
+  RCTLayoutFuzzerCase expected = RCTLayoutFuzzerCopyCase(testCase);
+  RCTLayoutFuzzerCase actual = RCTLayoutFuzzerCopyCase(testCase);
+  RCTLayout(reference, &expected);
+  RCTLayout(candidate, &actual);
+
+  bool match = RCTLayoutFuzzerLayoutsMatch(expected.root, actual.root, epsilon);
+
+  RCTLayoutFuzzerFreeCase(&expected);
+  RCTLayoutFuzzerFreeCase(&actual);
+  return match;
+}
+
+// Lays out `testCase`, then mutates one random node the way a prop update
+// through the bridge would and lays it out again, so the second pass goes
+// through the layout cache.
+static void RCTLayoutIncrementally(RCTLayoutEngine engine, RCTLayoutFuzzerCase *testCase, uint32_t seed)
+{
+  uint32_t state = seed;
+  RCTLayout(engine, testCase);
+  RCTMarkClean(testCase->root);
+
+  int index = RCTRandom(&state) % RCTLayoutFuzzerCountNodes(testCase->root);
+  css_node_t *node = RCTGetNode(testCase->root, index);
+  RCTRandomizeStyle(&state, &node->style);
+  RCTMarkDirty(node);
+  RCTLayout(engine, testCase);
+}
+
+bool RCTLayoutFuzzerCheckIncremental(const RCTLayoutFuzzerCase *testCase, uint32_t seed, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon)
+{
+  RCTLayoutFuzzerCase expected = RCTLayoutFuzzerCopyCase(testCase);
+  RCTLayoutFuzzerCase actual = RCTLayoutFuzzerCopyCase(testCase);
+  RCTLayoutIncrementally(reference, &expected, seed);
+  RCTLayoutIncrementally(candidate, &actual, seed);
+
+  // resetNodeLayout only clears the left and top positions of the root, so
+  // right and bottom accumulate across passes. Consumers only read left/top.
+  bool match = RCTLayoutsMatch(expected.root, actual.root, epsilon, false);
+
+  RCTLayoutFuzzerFreeCase(&expected);
+  RCTLayoutFuzzerFreeCase(&actual);
+  return match;
+}
+
+#pragma mark - Minimization
+
+// Style properties the minimizer tries to reset one at a time, by offset into
+// css_style_t. The measure callback is handled separately.
+typedef struct {
+  size_t offset;
+  size_t size;
+} RCTStyleProperty;
+
+#define RCT_STYLE_PROPERTY(field) { offsetof(css_style_t, field), sizeof(((css_style_t *)0)->field) }
+
+static const RCTStyleProperty RCTStyleProperties[] = {
+  RCT_STYLE_PROPERTY(direction),
+  RCT_STYLE_PROPERTY(flex_direction),
+  RCT_STYLE_PROPERTY(justify_content),
+  RCT_STYLE_PROPERTY(align_content),
+  RCT_STYLE_PROPERTY(align_items),
+  RCT_STYLE_PROPERTY(align_self),
+  RCT_STYLE_PROPERTY(position_type),
+  RCT_STYLE_PROPERTY(flex_wrap),
+  RCT_STYLE_PROPERTY(flex),
+  RCT_STYLE_PROPERTY(margin[0]), RCT_STYLE_PROPERTY(margin[1]), RCT_STYLE_PROPERTY(margin[2]),
+  RCT_STYLE_PROPERTY(margin[3]), RCT_STYLE_PROPERTY(margin[4]), RCT_STYLE_PROPERTY(margin[5]),
+  RCT_STYLE_PROPERTY(position[0]), RCT_STYLE_PROPERTY(position[1]),
+  RCT_STYLE_PROPERTY(position[2]), RCT_STYLE_PROPERTY(position[3]),
+  RCT_STYLE_PROPERTY(padding[0]), RCT_STYLE_PROPERTY(padding[1]), RCT_STYLE_PROPERTY(padding[2]),
+  RCT_STYLE_PROPERTY(padding[3]), RCT_STYLE_PROPERTY(padding[4]), RCT_STYLE_PROPERTY(padding[5]),
+  RCT_STYLE_PROPERTY(border[0]), RCT_STYLE_PROPERTY(border[1]), RCT_STYLE_PROPERTY(border[2]),
+  RCT_STYLE_PROPERTY(border[3]), RCT_STYLE_PROPERTY(border[4]), RCT_STYLE_PROPERTY(border[5]),
+  RCT_STYLE_PROPERTY(dimensions[0]), RCT_STYLE_PROPERTY(dimensions[1]),
+  RCT_STYLE_PROPERTY(minDimensions[0]), RCT_STYLE_PROPERTY(minDimensions[1]),
+  RCT_STYLE_PROPERTY(maxDimensions[0]), RCT_STYLE_PROPERTY(maxDimensions[1]),
+};
+
+#define RCT_STYLE_PROPERTY_COUNT (sizeof(RCTStyleProperties) / sizeof(RCTStyleProperties[0]))
+
+// Applies `candidate` if it still fails, otherwise discards it.
+static bool RCTKeepIfFailing(RCTLayoutFuzzerCase *current, RCTLayoutFuzzerCase *candidateCase, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon)
+{
+  if (!RCTLayoutFuzzerCheck(candidateCase, reference, candidate, epsilon)) {
+    RCTLayoutFuzzerFreeCase(current);
+    *current = *candidateCase;
+    return true;
+  }
+  RCTLayoutFuzzerFreeCase(candidateCase);
+  return false;
+}
+
+RCTLayoutFuzzerCase RCTLayoutFuzzerMinimize(const RCTLayoutFuzzerCase *testCase, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon)
+{
+  RCTLayoutFuzzerCase current = RCTLayoutFuzzerCopyCase(testCase);
+
+  css_node_t *defaults = new_css_node();
+
+  bool progress = true;
+  while (progress) {
+    progress = false;
+
+    // Remove whole subtrees first, they shrink the case the fastest
+    for (int index = 0; index < RCTLayoutFuzzerCountNodes(current.root); index++) {
+      for (int child = 0; child < RCTGetNode(current.root, index)->children_count;) {
+        RCTLayoutFuzzerCase attempt = RCTLayoutFuzzerCopyCase(&current);
+        css_node_t *node = RCTGetNode(attempt.root, index);
+        RCTFreeTree(RCTContext(node)->children[child]);
+        RCTRemoveChild(node, child);
+        if (RCTKeepIfFailing(&current, &attempt, reference, candidate, epsilon)) {
+          progress = true;
+        } else {
+          child++;
+        }
+      }
+    }
+
+    // Then drop measure functions and reset style properties to their default
+    for (int index = 0; index < RCTLayoutFuzzerCountNodes(current.root); index++) {
+      if (RCTGetNode(current.root, index)->measure != NULL) {
+        RCTLayoutFuzzerCase attempt = RCTLayoutFuzzerCopyCase(&current);
+        RCTSetMeasure(RCTGetNode(attempt.root, index), CSS_UNDEFINED, CSS_UNDEFINED);
+        progress |= RCTKeepIfFailing(&current, &attempt, reference, candidate, epsilon);
+      }
+
+      for (size_t i = 0; i < RCT_STYLE_PROPERTY_COUNT; i++) {
+        const RCTStyleProperty *property = &RCTStyleProperties[i];
+        char *style = (char *)&RCTGetNode(current.root, index)->style;
+        char *defaultStyle = (char *)&defaults->style;
+        if (memcmp(style + property->offset, defaultStyle + property->offset, property->size) == 0) {
+          continue;
+        }
+        RCTLayoutFuzzerCase attempt = RCTLayoutFuzzerCopyCase(&current);
+        style = (char *)&RCTGetNode(attempt.root, index)->style;
+        memcpy(style + property->offset, defaultStyle + property->offset, property->size);
+        progress |= RCTKeepIfFailing(&current, &attempt, reference, candidate, epsilon);
+      }
+    }
+
+    // Finally try to lift the root constraints
+    if (!isUndefined(current.maxWidth)) {
+      RCTLayoutFuzzerCase attempt = RCTLayoutFuzzerCopyCase(&current);
+      attempt.maxWidth = CSS_UNDEFINED;
+      progress |= RCTKeepIfFailing(&current, &attempt, reference, candidate, epsilon);
+    }
+    if (!isUndefined(current.maxHeight)) {
+      RCTLayoutFuzzerCase attempt = RCTLayoutFuzzerCopyCase(&current);
+      attempt.maxHeight = CSS_UNDEFINED;
+      progress |= RCTKeepIfFailing(&current, &attempt, reference, candidate, epsilon);
+    }
+  }
+
+  free_css_node(defaults);
+  return current;
+}
+
+#pragma mark - Serialization
+
+typedef enum {
+  RCTPropertyTypeEnum,
+  RCTPropertyTypeFloat,
+} RCTPropertyType;
+
+typedef struct {
+  const char *name;
+  size_t offset;
+  RCTPropertyType type;
+  int count;
+} RCTSerializedProperty;
+
+#define RCT_SERIALIZED_PROPERTY(name, field, type, count) \
+  { name, offsetof(css_style_t, field), type, count }
+
+static const RCTSerializedProperty RCTSerializedProperties[] = {
+  RCT_SERIALIZED_PROPERTY("direction", direction, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("flexDirection", flex_direction, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("justifyContent", justify_content, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("alignContent", align_content, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("alignItems", align_items, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("alignSelf", align_self, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("positionType", position_type, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("flexWrap", flex_wrap, RCTPropertyTypeEnum, 1),
+  RCT_SERIALIZED_PROPERTY("flex", flex, RCTPropertyTypeFloat, 1),
+  RCT_SERIALIZED_PROPERTY("margin", margin, RCTPropertyTypeFloat, 6),
+  RCT_SERIALIZED_PROPERTY("position", position, RCTPropertyTypeFloat, 4),
+  RCT_SERIALIZED_PROPERTY("padding", padding, RCTPropertyTypeFloat, 6),
+  RCT_SERIALIZED_PROPERTY("border", border, RCTPropertyTypeFloat, 6),
+  RCT_SERIALIZED_PROPERTY("dimensions", dimensions, RCTPropertyTypeFloat, 2),
+  RCT_SERIALIZED_PROPERTY("minDimensions", minDimensions, RCTPropertyTypeFloat, 2),
+  RCT_SERIALIZED_PROPERTY("maxDimensions", maxDimensions, RCTPropertyTypeFloat, 2),
+};
+
+#define RCT_SERIALIZED_PROPERTY_COUNT (sizeof(RCTSerializedProperties) / sizeof(RCTSerializedProperties[0]))
+
+// %.9g round-trips every float exactly
+static void RCTWriteFloat(FILE *file, float value)
+{
+  if (isUndefined(value)) {
+    fprintf(file, "nan");
+  } else {
+    fprintf(file, "%.9g", value);
+  }
+}
+
+static void RCTWriteNode(FILE *file, css_node_t *node, css_style_t *defaults, int depth, bool includeLayout)
+{
+  fprintf(file, "%d", depth);
+
+  for (size_t i = 0; i < RCT_SERIALIZED_PROPERTY_COUNT; i++) {
+    const RCTSerializedProperty *property = &RCTSerializedProperties[i];
+    char *style = (char *)&node->style + property->offset;
+    char *defaultStyle = (char *)defaults + property->offset;
+    for (int j = 0; j < property->count; j++) {
+      if (property->type == RCTPropertyTypeEnum) {
+        int value = *(int *)style;
+        if (value != *(int *)defaultStyle) {
+          fprintf(file, " %s=%d", property->name, value);
+        }
+      } else {
+        float value = ((float *)style)[j];
+        float defaultValue = ((float *)defaultStyle)[j];
+        if (memcmp(&value, &defaultValue, sizeof(float)) != 0 &&
+            !(isUndefined(value) && isUndefined(defaultValue))) {
+          if (property->count > 1) {
+            fprintf(file, " %s[%d]=", property->name, j);
+          } else {
+            fprintf(file, " %s=", property->name);
+          }
+          RCTWriteFloat(file, value);
+        }
+      }
+    }
+  }
+
+  if (node->measure != NULL) {
+    fprintf(file, " measure=");
+    RCTWriteFloat(file, RCTContext(node)->intrinsicWidth);
+    fprintf(file, ",");
+    RCTWriteFloat(file, RCTContext(node)->lineHeight);
+  }
+
+  if (includeLayout) {
+    fprintf(file, " layout=");
+    for (int i = 0; i < 4; i++) {
+      RCTWriteFloat(file, node->layout.position[i]);
+      fprintf(file, ",");
+    }
+    RCTWriteFloat(file, node->layout.dimensions[CSS_WIDTH]);
+    fprintf(file, ",");
+    RCTWriteFloat(file, node->layout.dimensions[CSS_HEIGHT]);
+    fprintf(file, " layoutDirection=%d", node->layout.direction);
+  }
+  fprintf(file, "\n");
+
+  for (int i = 0; i < node->children_count; i++) {
+    RCTWriteNode(file, RCTContext(node)->children[i], defaults, depth + 1, includeLayout);
+  }
+}
+
+void RCTLayoutFuzzerWriteCase(FILE *file, const RCTLayoutFuzzerCase *testCase, bool includeLayout)
+{
+  css_node_t *defaults = new_css_node();
+
+  fprintf(file, "case ");
+  RCTWriteFloat(file, testCase->maxWidth);
+  fprintf(file, " ");
+  RCTWriteFloat(file, testCase->maxHeight);
+  fprintf(file, "\n");
+  RCTWriteNode(file, testCase->root, &defaults->style, 0, includeLayout);
+  fprintf(file, "end\n");
+
+  free_css_node(defaults);
+}
+
+static bool RCTReadFloats(const char *value, float *floats, int count)
+{
+  char *end;
+  for (int i = 0; i < count; i++) {
+    floats[i] = strtof(value, &end);
+    if (end == value || (i < count - 1 && *end != ',')) {
+      return false;
+    }
+    value = end + 1;
+  }
+  return true;
+}
+
+static bool RCTReadProperty(css_node_t *node, const char *token)
+{
+  const char *equals = strchr(token, '=');
+  if (equals == NULL) {
+    return false;
+  }
+  size_t nameLength = equals - token;
+  const char *value = equals + 1;
+
+  if (strncmp(token, "measure", nameLength) == 0 && nameLength == strlen("measure")) {
+    float measure[2];
+    if (!RCTReadFloats(value, measure, 2)) {
+      return false;
+    }
+    RCTSetMeasure(node, measure[0], measure[1]);
+    return true;
+  }
+  if (strncmp(token, "layout", nameLength) == 0 && nameLength == strlen("layout")) {
+    float layout[6];
+    if (!RCTReadFloats(value, layout, 6)) {
+      return false;
+    }
+    memcpy(node->layout.position, layout, sizeof(node->layout.position));
+    node->layout.dimensions[CSS_WIDTH] = layout[4];
+    node->layout.dimensions[CSS_HEIGHT] = layout[5];
+    return true;
+  }
+  if (strncmp(token, "layoutDirection", nameLength) == 0 && nameLength == strlen("layoutDirection")) {
+    node->layout.direction = (css_direction_t)atoi(value);
+    return true;
+  }
+
+  const char *bracket = memchr(token, '[', nameLength);
+  size_t baseLength = bracket != NULL ? (size_t)(bracket - token) : nameLength;
+  int index = bracket != NULL ? atoi(bracket + 1) : 0;
+
+  for (size_t i = 0; i < RCT_SERIALIZED_PROPERTY_COUNT; i++) {
+    const RCTSerializedProperty *property = &RCTSerializedProperties[i];
+    if (strlen(property->name) != baseLength || strncmp(token, property->name, baseLength) != 0) {
+      continue;
+    }
+    if (index < 0 || index >= property->count) {
+      return false;
+    }
+    char *style = (char *)&node->style + property->offset;
+    if (property->type == RCTPropertyTypeEnum) {
+      *(int *)style = atoi(value);
+    } else {
+      ((float *)style)[index] = strtof(value, NULL);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool RCTLayoutFuzzerReadCase(FILE *file, RCTLayoutFuzzerCase *testCase)
+{
+  char line[RCT_LAYOUT_FUZZER_LINE_LENGTH];
+  css_node_t *ancestors[RCT_LAYOUT_FUZZER_MAX_DEPTH];
+
+  testCase->root = NULL;
+
+  // Skip blank lines and comments between cases
+  do {
+    if (fgets(line, sizeof(line), file) == NULL) {
+      return false;
+    }
+  } while (line[0] == '\n' || line[0] == '#');
+
+  char maxWidth[64], maxHeight[64];
+  if (sscanf(line, "case %63s %63s", maxWidth, maxHeight) != 2) {
+    return false;
+  }
+  testCase->maxWidth = strtof(maxWidth, NULL);
+  testCase->maxHeight = strtof(maxHeight, NULL);
+
+  int previousDepth = -1;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if (strncmp(line, "end", 3) == 0) {
+      return testCase->root != NULL;
+    }
+
+    char *saveptr;
+    char *token = strtok_r(line, " \n", &saveptr);
+    int depth = token != NULL ? atoi(token) : -1;
+    bool validDepth = depth >= 0 && depth < RCT_LAYOUT_FUZZER_MAX_DEPTH &&
+      depth <= previousDepth + 1 &&
+      (depth == 0) == (testCase->root == NULL);
+    if (!validDepth ||
+        (depth > 0 && ancestors[depth - 1]->children_count == RCT_LAYOUT_FUZZER_MAX_CHILDREN)) {
+      break;
+    }
+
+    css_node_t *node = RCTCreateNode();
+    if (depth == 0) {
+      testCase->root = node;
+    } else {
+      RCTAppendChild(ancestors[depth - 1], node);
+    }
+    ancestors[depth] = node;
+    previousDepth = depth;
+
+    while ((token = strtok_r(NULL, " \n", &saveptr)) != NULL) {
+      if (!RCTReadProperty(node, token)) {
+        RCTLayoutFuzzerFreeCase(testCase);
+        return false;
+      }
+    }
+  }
+
+  RCTLayoutFuzzerFreeCase(testCase);
+  return false;
+}
+
+char *RCTLayoutFuzzerReadFile(FILE *file)
+{
+  if (fseek(file, 0, SEEK_END) != 0) {
+    fclose(file);
+    return NULL;
+  }
+  long length = ftell(file);
+  char *contents = length >= 0 ? (char *)malloc(length + 1) : NULL;
+  rewind(file);
+  if (contents && fread(contents, 1, length, file) != (size_t)length) {
+    free(contents);
+    contents = NULL;
+  }
+  if (contents) {
+    contents[length] = '\0';
+  }
+  fclose(file);
+  return contents;
+}
+
+char *RCTLayoutFuzzerDescribeCase(const RCTLayoutFuzzerCase *testCase)
+{
+  FILE *file = tmpfile();
+  if (!file) {
+    return NULL;
+  }
+  RCTLayoutFuzzerWriteCase(file, testCase, false);
+  return RCTLayoutFuzzerReadFile(file);
+}
@@ -0,0 +1,133 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RCTLayoutFuzzer_h
+#define RCTLayoutFuzzer_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "Layout.h"
+
+/**
+ * Differential testing support for css-layout engines.
+ *
+ * The fuzzer generates random css_node_t trees (measure callbacks, wrap,
+ * absolute positioning, min/max constraints, RTL), lays them out with a
+ * reference engine and a candidate engine and compares the resulting
+ * css_layout_t values. Failing cases are shrunk to a minimal reproduction and
+ * can be written to, and read back from, a plain text corpus so that golden
+ * layouts can be checked in and validated against every engine.
+ */
+
+#define RCT_LAYOUT_FUZZER_MAX_CHILDREN 8
+
+/**
+ * Any function with the signature of `layoutNode`. Engines are expected to
+ * honor the same contract, including the `last_*` layout cache.
+ */
+typedef void (*RCTLayoutEngine)(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection);
+
+typedef struct {
+  int maxDepth;
+  int maxChildren;
+  // Maximum absolute difference tolerated between two layout values.
+  // Undefined values only match undefined values.
+  float epsilon;
+} RCTLayoutFuzzerOptions;
+
+RCTLayoutFuzzerOptions RCTLayoutFuzzerDefaultOptions(void);
+
+/**
+ * A root node and the constraints it is laid out with.
+ */
+typedef struct {
+  css_node_t *root;
+  float maxWidth;
+  float maxHeight;
+} RCTLayoutFuzzerCase;
+
+RCTLayoutFuzzerCase RCTLayoutFuzzerCreateCase(uint32_t seed, const RCTLayoutFuzzerOptions *options);
+
+/**
+ * Deep copy of the styles and measure parameters. The layout of the copy is
+ * reset, so it can be laid out from scratch.
+ */
+RCTLayoutFuzzerCase RCTLayoutFuzzerCopyCase(const RCTLayoutFuzzerCase *testCase);
+void RCTLayoutFuzzerFreeCase(RCTLayoutFuzzerCase *testCase);
+
+int RCTLayoutFuzzerCountNodes(const css_node_t *node);
+
+/**
+ * Compares the computed layout of two trees of the same shape.
+ */
+bool RCTLayoutFuzzerLayoutsMatch(css_node_t *expected, css_node_t *actual, float epsilon);
+
+/**
+ * Lays out copies of `testCase` with both engines and compares the results.
+ */
+bool RCTLayoutFuzzerCheck(const RCTLayoutFuzzerCase *testCase, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon);
+
+/**
+ * Lays out copies of `testCase`, mutates the style of the same random node in
+ * each (dirtying it and its ancestors, like RCTShadowView does) and lays them
+ * out again, each copy with its own engine. This checks that the candidate
+ * reproduces the `last_*` cache behavior of the reference, which is not
+ * always identical to a fresh layout: a cached child that gets stretched
+ * keeps the position of its previous pass.
+ */
+bool RCTLayoutFuzzerCheckIncremental(const RCTLayoutFuzzerCase *testCase, uint32_t seed, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon);
+
+/**
+ * Shrinks a case failing `RCTLayoutFuzzerCheck` by removing subtrees,
+ * measure callbacks and style properties for as long as it keeps failing.
+ * Returns a new case; the input is left untouched.
+ */
+RCTLayoutFuzzerCase RCTLayoutFuzzerMinimize(const RCTLayoutFuzzerCase *testCase, RCTLayoutEngine reference, RCTLayoutEngine candidate, float epsilon);
+
+/**
+ * Corpus serialization. A case is written as
+ *
+ *   case <maxWidth> <maxHeight>
+ *   <depth> <property>=<value> ... [layout=<left>,<top>,<right>,<bottom>,<width>,<height>]
+ *   ...
+ *   end
+ *
+ * with one line per node in pre-order and only non-default properties
+ * listed. When `includeLayout` is set, the computed layout of each node is
+ * recorded so that the case can serve as a golden reference.
+ */
+void RCTLayoutFuzzerWriteCase(FILE *file, const RCTLayoutFuzzerCase *testCase, bool includeLayout);
+
+/**
+ * Reads the next case from `file`, with recorded layouts (if any) stored in
+ * the nodes' css_layout_t. Returns false at the end of the file or on a
+ * malformed case.
+ */
+bool RCTLayoutFuzzerReadCase(FILE *file, RCTLayoutFuzzerCase *testCase);
+
+/**
+ * Rewinds `file`, e.g. a tmpfile() written by RCTLayoutFuzzerWriteCase or
+ * writeLayoutTrace, reads all of it and closes it. Returns a NUL terminated
+ * string to be freed by the caller, or NULL if the file can't be read.
+ */
+char *RCTLayoutFuzzerReadFile(FILE *file);
+
+/**
+ * The case as RCTLayoutFuzzerWriteCase writes it, without layouts, for
+ * failure messages. To be freed by the caller; NULL on failure.
+ */
+char *RCTLayoutFuzzerDescribeCase(const RCTLayoutFuzzerCase *testCase);
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "Layout.h"
+#import "RCTLayoutFuzzer.h"
+
+// Only built with -DCSS_LAYOUT_INSTRUMENTATION, which scripts/objc-test.sh
+// turns on for a separate run of the UIExplorerUnitTests scheme
+#ifdef CSS_LAYOUT_INSTRUMENTATION
+
+typedef struct {
+  css_node_t *children[4];
+  bool dirty;
+} RCTTestNodeContext;
+
+static css_node_t *RCTTestGetChild(void *context, int i)
+{
+  return ((RCTTestNodeContext *)context)->children[i];
+}
+
+static bool RCTTestIsDirty(void *context)
+{
+  return ((RCTTestNodeContext *)context)->dirty;
+}
+
+static css_dim_t RCTTestMeasure(void *context, float width, css_measure_mode_t widthMode, float height, css_measure_mode_t heightMode)
+{
+  css_dim_t dim;
+  dim.dimensions[CSS_WIDTH] = 10;
+  dim.dimensions[CSS_HEIGHT] = 10;
+  return dim;
+}
+
+static css_node_t *RCTTestCreateNode(void)
+{
+  css_node_t *node = new_css_node();
+  RCTTestNodeContext *context = calloc(1, sizeof(RCTTestNodeContext));
+  context->dirty = true;
+  node->context = context;
+  node->get_child = RCTTestGetChild;
+  node->is_dirty = RCTTestIsDirty;
+  return node;
+}
+
+static void RCTTestFreeTree(css_node_t *node)
+{
+  for (int i = 0; i < node->children_count; i++) {
+    RCTTestFreeTree(RCTTestGetChild(node->context, i));
+  }
+  free(node->context);
+  free_css_node(node);
+}
+
+static void RCTTestMarkClean(css_node_t *node)
+{
+  ((RCTTestNodeContext *)node->context)->dirty = false;
+  for (int i = 0; i < node->children_count; i++) {
+    RCTTestMarkClean(RCTTestGetChild(node->context, i));
+  }
+}
+
+// A 100x100 column with a fixed size child, a text-like child and a row
+// holding one more fixed size child
+static css_node_t *RCTTestCreateTree(void)
+{
+  css_node_t *root = RCTTestCreateNode();
+  root->style.dimensions[CSS_WIDTH] = 100;
+  root->style.dimensions[CSS_HEIGHT] = 100;
+
+  css_node_t *box = RCTTestCreateNode();
+  box->style.dimensions[CSS_HEIGHT] = 20;
+
+  css_node_t *text = RCTTestCreateNode();
+  text->measure = RCTTestMeasure;
+
+  css_node_t *row = RCTTestCreateNode();
+  row->style.flex_direction = CSS_FLEX_DIRECTION_ROW;
+  css_node_t *rowChild = RCTTestCreateNode();
+  rowChild->style.dimensions[CSS_WIDTH] = 30;
+  rowChild->style.dimensions[CSS_HEIGHT] = 30;
+  ((RCTTestNodeContext *)row->context)->children[row->children_count++] = rowChild;
+
+  RCTTestNodeContext *context = root->context;
+  context->children[root->children_count++] = box;
+  context->children[root->children_count++] = text;
+  context->children[root->children_count++] = row;
+  return root;
+}
+
+@interface RCTLayoutInstrumentationTests : XCTestCase
+
+@end
+
+@implementation RCTLayoutInstrumentationTests
+
+- (void)setUp
+{
+  [super setUp];
+  clearLayoutPasses();
+}
+
+- (void)testCountsVisitsMeasuresAndCacheHits
+{
+  css_node_t *root = RCTTestCreateTree();
+
+  layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  XCTAssertEqual(getLayoutPassCount(), 1);
+  css_layout_pass_stats_t first;
+  XCTAssertTrue(getLayoutPass(0, &first));
+  XCTAssertEqual(first.visited_count, 5);
+  XCTAssertEqual(first.skipped_count, 0);
+  XCTAssertEqual(first.measure_count, 1);
+  XCTAssertGreaterThanOrEqual(first.duration, 0);
+
+  // Nothing changed, so the root is served from the cache
+  RCTTestMarkClean(root);
+  resetNodeLayout(root);
+  layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  XCTAssertEqual(getLayoutPassCount(), 2);
+  css_layout_pass_stats_t second;
+  XCTAssertTrue(getLayoutPass(1, &second));
+  XCTAssertEqual(second.visited_count, 1);
+  XCTAssertEqual(second.skipped_count, 1);
+  XCTAssertEqual(second.measure_count, 0);
+  XCTAssertGreaterThanOrEqual(second.start_time, first.start_time);
+  XCTAssertFalse(getLayoutPass(2, &second));
+
+  RCTTestFreeTree(root);
+}
+
+- (void)testRanksHotNodesByVisits
+{
+  css_node_t *root = RCTTestCreateTree();
+
+  layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  css_layout_pass_stats_t pass;
+  XCTAssertTrue(getLayoutPass(0, &pass));
+  XCTAssertEqual(pass.hot_node_count, 5);
+  int visits = 0;
+  for (int i = 0; i < pass.hot_node_count; i++) {
+    XCTAssertTrue(pass.hot_nodes[i].node != NULL);
+    XCTAssertGreaterThanOrEqual(pass.hot_nodes[i].visits, 1);
+    if (i > 0) {
+      XCTAssertLessThanOrEqual(pass.hot_nodes[i].visits, pass.hot_nodes[i - 1].visits);
+    }
+    visits += pass.hot_nodes[i].visits;
+  }
+  XCTAssertEqual(visits, pass.visited_count);
+
+  RCTTestFreeTree(root);
+}
+
+- (void)testCountsNestedLayoutCallsAsOnePass
+{
+  css_node_t *root = RCTTestCreateTree();
+  css_viewport_t viewport = {{0, 0}, {CSS_UNDEFINED, CSS_UNDEFINED}, 0};
+
+  layoutNodeCulled(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &viewport);
+  layoutDeferredNodes(root);
+  XCTAssertEqual(getLayoutPassCount(), 2);
+  css_layout_pass_stats_t culled;
+  css_layout_pass_stats_t deferred;
+  XCTAssertTrue(getLayoutPass(0, &culled));
+  XCTAssertTrue(getLayoutPass(1, &deferred));
+  // The fixed size root is deferred first, then laid out as it is visible
+  XCTAssertEqual(culled.visited_count, 6);
+  XCTAssertEqual(culled.measure_count, 1);
+  XCTAssertEqual(deferred.visited_count, 0);
+
+  RCTTestFreeTree(root);
+}
+
+- (void)testKeepsTheLastPasses
+{
+  css_node_t *root = RCTTestCreateTree();
+
+  for (int i = 0; i < CSS_LAYOUT_TRACE_CAPACITY + 3; i++) {
+    layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  }
+  XCTAssertEqual(getLayoutPassCount(), CSS_LAYOUT_TRACE_CAPACITY);
+  css_layout_pass_stats_t previous;
+  XCTAssertTrue(getLayoutPass(0, &previous));
+  for (int i = 1; i < CSS_LAYOUT_TRACE_CAPACITY; i++) {
+    css_layout_pass_stats_t pass;
+    XCTAssertTrue(getLayoutPass(i, &pass));
+    XCTAssertGreaterThanOrEqual(pass.start_time, previous.start_time);
+    previous = pass;
+  }
+
+  clearLayoutPasses();
+  XCTAssertEqual(getLayoutPassCount(), 0);
+
+  RCTTestFreeTree(root);
+}
+
+- (void)testWritesChromeTraceEvents
+{
+  css_node_t *root = RCTTestCreateTree();
+  layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  layoutNode(root, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  RCTTestFreeTree(root);
+
+  FILE *file = tmpfile();
+  XCTAssertTrue(writeLayoutTrace(file));
+  char *json = RCTLayoutFuzzerReadFile(file);
+  XCTAssertTrue(json != NULL);
+  NSData *data = [NSData dataWithBytes:json length:strlen(json)];
+  free(json);
+
+  NSError *error;
+  NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+  XCTAssertNil(error);
+  NSArray *events = trace[@"traceEvents"];
+  XCTAssertEqual(events.count, 4u);
+  XCTAssertEqualObjects(events[0][@"ph"], @"X");
+  XCTAssertEqualObjects(events[0][@"args"][@"visited"], @5);
+  XCTAssertEqualObjects(events[0][@"args"][@"measured"], @1);
+  XCTAssertEqualObjects(events[1][@"ph"], @"C");
+}
+
+@end
+
+#endif
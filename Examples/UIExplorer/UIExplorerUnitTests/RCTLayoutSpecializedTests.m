@@ -0,0 +1,56 @@
+/**
+ * The examples provided by Facebook are for non-commercial testing and
+ * evaluation purposes only.
+ *
+ * Facebook reserves all rights not expressly granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL
+ * FACEBOOK BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+ * AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "LayoutSpecialized.h"
+#import "RCTLayoutFuzzer.h"
+
+@interface RCTLayoutSpecializedTests : XCTestCase
+
+@end
+
+@implementation RCTLayoutSpecializedTests
+
+- (void)testSpecializedKernelMatchesReferenceEngine
+{
+  RCTLayoutFuzzerOptions options = RCTLayoutFuzzerDefaultOptions();
+  for (uint32_t seed = 0; seed < 2000; seed++) {
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCreateCase(seed, &options);
+    if (!RCTLayoutFuzzerCheck(&testCase, layoutNode, layoutNodeSpecialized, options.epsilon)) {
+      RCTLayoutFuzzerCase minimized = RCTLayoutFuzzerMinimize(&testCase, layoutNode, layoutNodeSpecialized, options.epsilon);
+      char *description = RCTLayoutFuzzerDescribeCase(&minimized);
+      XCTFail(@"Layouts differ for seed %u, minimized case:\n%s", seed, description);
+      free(description);
+      RCTLayoutFuzzerFreeCase(&minimized);
+    }
+    RCTLayoutFuzzerFreeCase(&testCase);
+  }
+}
+
+- (void)testSpecializedKernelMatchesReferenceCache
+{
+  RCTLayoutFuzzerOptions options = RCTLayoutFuzzerDefaultOptions();
+  for (uint32_t seed = 0; seed < 2000; seed++) {
+    RCTLayoutFuzzerCase testCase = RCTLayoutFuzzerCreateCase(seed, &options);
+    if (!RCTLayoutFuzzerCheckIncremental(&testCase, seed, layoutNode, layoutNodeSpecialized, options.epsilon)) {
+      char *description = RCTLayoutFuzzerDescribeCase(&testCase);
+      XCTFail(@"Incremental layouts differ for seed %u:\n%s", seed, description);
+      free(description);
+    }
+    RCTLayoutFuzzerFreeCase(&testCase);
+  }
+}
+
+@end
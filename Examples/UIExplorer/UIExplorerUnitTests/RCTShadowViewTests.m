@@ -106,6 +106,113 @@
   XCTAssertTrue(CGRectEqualToRect([rightView measureLayoutRelativeToAncestor:self.parentView], CGRectMake(330, 120, 100, 200)));
 }
 
+- (void)testLayoutChangesOnlyReportNodesWithNewFrames
+{
+  RCTShadowView *topView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 100;
+  }];
+  RCTShadowView *bottomView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 100;
+  }];
+  RCTShadowView *innerView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 50;
+  }];
+
+  [bottomView insertReactSubview:innerView atIndex:0];
+  [self.parentView insertReactSubview:topView atIndex:0];
+  [self.parentView insertReactSubview:bottomView atIndex:1];
+
+  css_layout_changes_t changes;
+  init_css_layout_changes(&changes);
+
+  resetNodeLayout(self.parentView.cssNode);
+  layoutNodeWithChanges(self.parentView.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &changes);
+  XCTAssertEqual(getLayoutChangeCount(&changes), 4);
+
+  topView.height = 150;
+  resetNodeLayout(self.parentView.cssNode);
+  layoutNodeWithChanges(self.parentView.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &changes);
+
+  XCTAssertEqual(getLayoutChangeCount(&changes), 2);
+  XCTAssertEqual(getLayoutChange(&changes, 0)->node, topView.cssNode);
+  XCTAssertEqual(getLayoutChange(&changes, 0)->flags, CSS_LAYOUT_CHANGED_DIMENSIONS);
+  XCTAssertEqual(getLayoutChange(&changes, 1)->node, bottomView.cssNode);
+  XCTAssertEqual(getLayoutChange(&changes, 1)->flags, CSS_LAYOUT_CHANGED_POSITION);
+
+  free_css_layout_changes(&changes);
+}
+
+- (void)testCollectsOnlyViewsWithNewFrames
+{
+  RCTShadowView *topView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 100;
+  }];
+  RCTShadowView *bottomView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 100;
+  }];
+  RCTShadowView *innerView = [self _shadowViewWithStyle:^(css_style_t *style) {
+    style->dimensions[CSS_HEIGHT] = 50;
+  }];
+
+  [bottomView insertReactSubview:innerView atIndex:0];
+  [self.parentView insertReactSubview:topView atIndex:0];
+  [self.parentView insertReactSubview:bottomView atIndex:1];
+
+  NSSet<RCTShadowView *> *viewsWithNewFrames = [self.parentView collectViewsWithUpdatedFrames];
+  XCTAssertEqual(viewsWithNewFrames.count, 4u);
+
+  topView.height = 150;
+  viewsWithNewFrames = [self.parentView collectViewsWithUpdatedFrames];
+  XCTAssertEqualObjects(viewsWithNewFrames, ([NSSet setWithObjects:topView, bottomView, nil]));
+  XCTAssertTrue(CGRectEqualToRect(bottomView.frame, CGRectMake(0, 150, 440, 100)));
+  XCTAssertTrue(CGRectEqualToRect([innerView measureLayoutRelativeToAncestor:self.parentView], CGRectMake(0, 150, 440, 50)));
+  // Laid out again without a new frame, and computed all the same
+  XCTAssertFalse(self.parentView.isLayoutDirty);
+  XCTAssertFalse(topView.isLayoutDirty);
+
+  XCTAssertEqual([self.parentView collectViewsWithUpdatedFrames].count, 0u);
+}
+
+- (void)testCulledLayoutDefersOffscreenRows
+{
+  NSMutableArray<RCTShadowView *> *rows = [NSMutableArray new];
+  for (NSInteger i = 0; i < 20; i++) {
+    RCTShadowView *row = [self _shadowViewWithStyle:^(css_style_t *style) {
+      style->dimensions[CSS_HEIGHT] = 100;
+    }];
+    RCTShadowView *content = [self _shadowViewWithStyle:^(css_style_t *style) {
+      style->dimensions[CSS_HEIGHT] = 50;
+    }];
+    [row insertReactSubview:content atIndex:0];
+    [self.parentView insertReactSubview:row atIndex:i];
+    [rows addObject:row];
+  }
+
+  css_viewport_t viewport = {{0, 0}, {440, 200}, 50};
+  resetNodeLayout(self.parentView.cssNode);
+  layoutNodeCulled(self.parentView.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &viewport);
+
+  // Rows within the viewport and overscan are fully laid out
+  XCTAssertFalse(rows[2].cssNode->layout.deferred);
+  XCTAssertEqual(rows[2].reactSubviews[0].cssNode->layout.dimensions[CSS_WIDTH], 440);
+  // The others only get their own frame
+  XCTAssertTrue(rows[3].cssNode->layout.deferred);
+  XCTAssertEqual(rows[19].cssNode->layout.position[CSS_TOP], 1900);
+  XCTAssertEqual(rows[19].cssNode->layout.dimensions[CSS_WIDTH], 440);
+
+  viewport.position[CSS_TOP] = 1000;
+  resetNodeLayout(self.parentView.cssNode);
+  layoutNodeCulled(self.parentView.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &viewport);
+  XCTAssertFalse(rows[10].cssNode->layout.deferred);
+  XCTAssertEqual(rows[10].reactSubviews[0].cssNode->layout.dimensions[CSS_WIDTH], 440);
+
+  layoutDeferredNodes(self.parentView.cssNode);
+  for (RCTShadowView *row in rows) {
+    XCTAssertFalse(row.cssNode->layout.deferred);
+    XCTAssertEqual(row.reactSubviews[0].cssNode->layout.dimensions[CSS_WIDTH], 440);
+  }
+}
+
 - (void)testAssignsSuggestedWidthDimension
 {
   [self _withShadowViewWithStyle:^(css_style_t *style) {
@@ -29,6 +29,10 @@ let CALL_IDS = 3;
 let MIN_TIME_BETWEEN_FLUSHES_MS = 5;
 
 let TRACE_TAG_REACT_APPS = 1 << 17;
+// Registered once, since they are traced on every call to native
+let NATIVE_FLOW_NAME_ID = global.nativeTraceRegisterName ?
+  global.nativeTraceRegisterName('native') : -1;
+let PENDING_QUEUE_NAME_ID = Systrace.registerName('pending_js_to_native_queue');
 
 let SPY_MODE = false;
 
@@ -147,8 +151,11 @@ class MessageQueue {
       this._callbacks[this._callbackID++] = onSucc;
     }
 
-    global.nativeTraceBeginAsyncFlow &&
+    if (global.nativeTraceBeginAsyncFlowById) {
+      global.nativeTraceBeginAsyncFlowById(TRACE_TAG_REACT_APPS, NATIVE_FLOW_NAME_ID, this._callID);
+    } else if (global.nativeTraceBeginAsyncFlow) {
       global.nativeTraceBeginAsyncFlow(TRACE_TAG_REACT_APPS, 'native', this._callID);
+    }
     this._callID++;
 
     this._queue[MODULE_IDS].push(module);
@@ -162,7 +169,7 @@ class MessageQueue {
       this._queue = [[], [], [], this._callID];
       this._lastFlush = now;
     }
-    Systrace.counterEvent('pending_js_to_native_queue', this._queue[0].length);
+    Systrace.counterEventById(PENDING_QUEUE_NAME_ID, this._queue[0].length);
     if (__DEV__ && SPY_MODE && isFinite(module)) {
       console.log('JS->N : ' + this._remoteModuleTable[module] + '.' +
         this._remoteMethodTable[module][method] + '(' + JSON.stringify(params) + ')');
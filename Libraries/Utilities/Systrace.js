@@ -27,7 +27,12 @@ var TRACE_TAG_REACT_APPS = 1 << 17;
 var TRACE_TAG_JSC_CALLS = 1 << 27;
 
 var _enabled = false;
+// Set when native trace recording was on as the bridge was created. The *ById
+// methods then call their native hooks even while systrace is off.
+var _nativeTraceRecording = global.__nativeTraceRecording || false;
 var _asyncCookie = 0;
+// Names of registered IDs, for when the native ID based hooks are missing
+var _registeredNames: Array<string> = [];
 var _ReactDebugTool = null;
 var _ReactComponentTreeDevtool = null;
 function ReactDebugTool() {
@@ -127,6 +132,65 @@ var Systrace = {
     }
   },
 
+  /**
+   * registerName returns an ID for profileName, to pass to the *ById
+   * variants of the methods above. These don't copy the name to native on
+   * every call, so prefer them for hot, fixed names. Register a name once,
+   * e.g. when a module is initialized: registered names are never freed.
+  **/
+  registerName(profileName: string): number {
+    if (global.nativeTraceRegisterName) {
+      return global.nativeTraceRegisterName(profileName);
+    }
+    _registeredNames.push(profileName);
+    return _registeredNames.length - 1;
+  },
+
+  beginEventById(nameId: number) {
+    if (global.nativeTraceBeginSectionById) {
+      if (_enabled || _nativeTraceRecording) {
+        global.nativeTraceBeginSectionById(TRACE_TAG_REACT_APPS, nameId);
+      }
+    } else if (_enabled) {
+      global.nativeTraceBeginSection(TRACE_TAG_REACT_APPS, _registeredNames[nameId]);
+    }
+  },
+
+  beginAsyncEventById(nameId: number): any {
+    var cookie = _asyncCookie;
+    if (global.nativeTraceBeginAsyncSectionById) {
+      if (_enabled || _nativeTraceRecording) {
+        _asyncCookie++;
+        global.nativeTraceBeginAsyncSectionById(TRACE_TAG_REACT_APPS, nameId, cookie);
+      }
+    } else if (_enabled) {
+      _asyncCookie++;
+      global.nativeTraceBeginAsyncSection(TRACE_TAG_REACT_APPS, _registeredNames[nameId], cookie, 0);
+    }
+    return cookie;
+  },
+
+  endAsyncEventById(nameId: number, cookie?: any) {
+    if (global.nativeTraceEndAsyncSectionById) {
+      if (_enabled || _nativeTraceRecording) {
+        global.nativeTraceEndAsyncSectionById(TRACE_TAG_REACT_APPS, nameId, cookie);
+      }
+    } else if (_enabled) {
+      global.nativeTraceEndAsyncSection(TRACE_TAG_REACT_APPS, _registeredNames[nameId], cookie, 0);
+    }
+  },
+
+  counterEventById(nameId: number, value?: any) {
+    if (global.nativeTraceCounterById) {
+      if (_enabled || _nativeTraceRecording) {
+        global.nativeTraceCounterById(TRACE_TAG_REACT_APPS, nameId, value);
+      }
+    } else if (_enabled) {
+      global.nativeTraceCounter &&
+        global.nativeTraceCounter(TRACE_TAG_REACT_APPS, _registeredNames[nameId], value);
+    }
+  },
+
   /**
    * Relay profiles use await calls, so likely occur out of current stack frame
    * therefore async variant of profiling is used
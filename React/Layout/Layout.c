@@ -19,6 +19,11 @@
  * of patent rights can be found in the PATENTS file in the same directory.
  */
 
+ // clock_gettime and pthreads are POSIX, and hidden by a strict -std=c99
+ #if defined(CSS_LAYOUT_INSTRUMENTATION) && !defined(__APPLE__) && !defined(_MSC_VER) && !defined(_POSIX_C_SOURCE)
+ #define _POSIX_C_SOURCE 200112L
+ #endif
+
  #include <math.h>
  #include <stdio.h>
  #include <stdlib.h>
@@ -52,6 +57,177 @@
    return fabs(a - b) < 0.0001;
  }
 
+ // State of the layout pass in progress. It is handed down through every
+ // layoutNode call instead of living in globals, so that passes over different
+ // trees can run at the same time, e.g. on two threads.
+ typedef struct {
+   // Set by layoutNodeWithChanges, see recordVisitedNode
+   css_layout_changes_t *changes;
+   // Set by layoutNodeCulled. Whether a node is visible is only known once its
+   // parent has placed it, so during the pass every node whose size does not
+   // depend on its children gets deferred; visible ones are laid out right
+   // after.
+   const css_viewport_t *viewport;
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   css_layout_pass_stats_t stats;
+   // Visit count of every node of the pass, in an open addressing table keyed
+   // by node. Visits are simply not counted if it cannot grow.
+   css_layout_node_visits_t *node_visits;
+   int node_visits_capacity;
+   int node_visits_count;
+   #endif
+ } css_layout_pass_t;
+
+ #ifdef CSS_LAYOUT_INSTRUMENTATION
+ #include <stdint.h>
+ #if defined(__APPLE__)
+ #include <mach/mach_time.h>
+ #include <pthread.h>
+ #elif defined(_MSC_VER)
+ #include <windows.h>
+ #else
+ #include <pthread.h>
+ #include <time.h>
+ #endif
+
+ static double currentTimeMicros(void) {
+ #if defined(__APPLE__)
+   static mach_timebase_info_data_t timebase;
+   if (timebase.denom == 0) {
+     mach_timebase_info(&timebase);
+   }
+   return (double)mach_absolute_time() * timebase.numer / timebase.denom / 1000.0;
+ #elif defined(_MSC_VER)
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+   return (double)counter.QuadPart * 1000000.0 / frequency.QuadPart;
+ #else
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return now.tv_sec * 1000000.0 + now.tv_nsec / 1000.0;
+ #endif
+ }
+
+ // Passes from every thread end up in the same ring, which is only accessed
+ // with recorded_passes_lock held
+ static css_layout_pass_stats_t recorded_passes[CSS_LAYOUT_TRACE_CAPACITY];
+ static int recorded_pass_count = 0;
+ static int next_recorded_pass = 0;
+
+ #if defined(_MSC_VER)
+ static SRWLOCK recorded_passes_lock = SRWLOCK_INIT;
+
+ static void lockRecordedPasses(void) {
+   AcquireSRWLockExclusive(&recorded_passes_lock);
+ }
+
+ static void unlockRecordedPasses(void) {
+   ReleaseSRWLockExclusive(&recorded_passes_lock);
+ }
+ #else
+ static pthread_mutex_t recorded_passes_lock = PTHREAD_MUTEX_INITIALIZER;
+
+ static void lockRecordedPasses(void) {
+   pthread_mutex_lock(&recorded_passes_lock);
+ }
+
+ static void unlockRecordedPasses(void) {
+   pthread_mutex_unlock(&recorded_passes_lock);
+ }
+ #endif
+
+ static int nodeVisitsSlot(css_layout_node_visits_t *table, int capacity, css_node_t *node) {
+   uintptr_t hash = ((uintptr_t)node >> 4) * 2654435761u;
+   int slot = (int)(hash & (uintptr_t)(capacity - 1));
+   while (table[slot].node != NULL && table[slot].node != node) {
+     slot = (slot + 1) & (capacity - 1);
+   }
+   return slot;
+ }
+
+ static bool growNodeVisits(css_layout_pass_t *pass) {
+   int capacity = pass->node_visits_capacity > 0 ? pass->node_visits_capacity * 2 : 256;
+   css_layout_node_visits_t *table = (css_layout_node_visits_t *)calloc(
+     capacity,
+     sizeof(css_layout_node_visits_t)
+   );
+   if (table == NULL) {
+     return false;
+   }
+   for (int i = 0; i < pass->node_visits_capacity; i++) {
+     if (pass->node_visits[i].node != NULL) {
+       table[nodeVisitsSlot(table, capacity, pass->node_visits[i].node)] = pass->node_visits[i];
+     }
+   }
+   free(pass->node_visits);
+   pass->node_visits = table;
+   pass->node_visits_capacity = capacity;
+   return true;
+ }
+
+ static void recordNodeVisit(css_layout_pass_t *pass, css_node_t *node) {
+   pass->stats.visited_count++;
+   // Keep the load factor under 1/2
+   if (pass->node_visits_count * 2 >= pass->node_visits_capacity && !growNodeVisits(pass)) {
+     return;
+   }
+   css_layout_node_visits_t *entry =
+     &pass->node_visits[nodeVisitsSlot(pass->node_visits, pass->node_visits_capacity, node)];
+   if (entry->node == NULL) {
+     entry->node = node;
+     pass->node_visits_count++;
+   }
+   entry->visits++;
+ }
+
+ static void beginLayoutPass(css_layout_pass_t *pass) {
+   pass->stats.start_time = currentTimeMicros();
+ }
+
+ static void endLayoutPass(css_layout_pass_t *pass) {
+   css_layout_pass_stats_t *stats = &pass->stats;
+   stats->duration = currentTimeMicros() - stats->start_time;
+
+   // Insertion into the sorted top N
+   for (int i = 0; i < pass->node_visits_capacity; i++) {
+     css_layout_node_visits_t entry = pass->node_visits[i];
+     if (entry.node == NULL) {
+       continue;
+     }
+     int position = stats->hot_node_count;
+     while (position > 0 && stats->hot_nodes[position - 1].visits < entry.visits) {
+       position--;
+     }
+     if (position < CSS_LAYOUT_HOT_NODE_COUNT) {
+       int last = stats->hot_node_count < CSS_LAYOUT_HOT_NODE_COUNT ?
+         stats->hot_node_count :
+         CSS_LAYOUT_HOT_NODE_COUNT - 1;
+       memmove(
+         &stats->hot_nodes[position + 1],
+         &stats->hot_nodes[position],
+         (last - position) * sizeof(css_layout_node_visits_t)
+       );
+       stats->hot_nodes[position] = entry;
+       if (stats->hot_node_count < CSS_LAYOUT_HOT_NODE_COUNT) {
+         stats->hot_node_count++;
+       }
+     }
+   }
+   free(pass->node_visits);
+   pass->node_visits = NULL;
+
+   lockRecordedPasses();
+   recorded_passes[next_recorded_pass] = *stats;
+   next_recorded_pass = (next_recorded_pass + 1) % CSS_LAYOUT_TRACE_CAPACITY;
+   if (recorded_pass_count < CSS_LAYOUT_TRACE_CAPACITY) {
+     recorded_pass_count++;
+   }
+   unlockRecordedPasses();
+ }
+ #endif
+
  void init_css_node(css_node_t *node) {
    node->style.align_items = CSS_ALIGN_STRETCH;
    node->style.align_content = CSS_ALIGN_FLEX_START;
@@ -91,6 +267,14 @@
    node->layout.last_parent_max_height = -1;
    node->layout.last_direction = (css_direction_t)-1;
    node->layout.should_update = true;
+
+   // Such that the first change-tracked pass reports every node
+   node->layout.reported_position[CSS_LEFT] = CSS_UNDEFINED;
+   node->layout.reported_position[CSS_TOP] = CSS_UNDEFINED;
+   node->layout.reported_dimensions[CSS_WIDTH] = CSS_UNDEFINED;
+   node->layout.reported_dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
+
+   node->layout.deferred = false;
  }
 
  css_node_t *new_css_node() {
@@ -534,7 +718,9 @@
    return -getPosition(node, trailing[axis]);
  }
 
- static void layoutNodeImpl(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+ static void layoutNodeInPass(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection, css_layout_pass_t *pass);
+
+ static void layoutNodeImpl(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection, css_layout_pass_t *pass) {
    /** START_GENERATED **/
    css_direction_t direction = resolveDirection(node, parentDirection);
    css_flex_direction_t mainAxis = resolveAxis(getFlexDirection(node), direction);
@@ -613,6 +799,9 @@
 
      // Let's not measure the text if we already know both dimensions
      if (isRowUndefined || isColumnUndefined) {
+       #ifdef CSS_LAYOUT_INSTRUMENTATION
+       pass->stats.measure_count++;
+       #endif
        css_dim_t measureDim = node->measure(
          node->context,
 
@@ -813,7 +1002,7 @@
 
          // This is the main recursive call. We layout non flexible children.
          if (alreadyComputedNextLayout == 0) {
-           layoutNode(child, maxWidth, maxHeight, direction);
+           layoutNodeInPass(child, maxWidth, maxHeight, direction, pass);
          }
 
          // Absolute positioned elements do not take part of the layout, so we
@@ -954,7 +1143,7 @@
          }
 
          // And we recursively call the layout algorithm for this child
-         layoutNode(currentFlexChild, maxWidth, maxHeight, direction);
+         layoutNodeInPass(currentFlexChild, maxWidth, maxHeight, direction, pass);
 
          child = currentFlexChild;
          currentFlexChild = currentFlexChild->next_flex_child;
@@ -1085,7 +1274,7 @@
                  child->layout.position[trailing[crossAxis]] -= getTrailingMargin(child, crossAxis) +
                    getRelativePosition(child, crossAxis);
 
-                 layoutNode(child, maxWidth, maxHeight, direction);
+                 layoutNodeInPass(child, maxWidth, maxHeight, direction, pass);
                }
              }
            } else if (alignItem != CSS_ALIGN_FLEX_START) {
@@ -1289,11 +1478,120 @@
    /** END_GENERATED **/
  }
 
- void layoutNode(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+ // During a pass started through layoutNodeWithChanges, the change list
+ // accumulates every node handed to layoutNode; it is filtered down to the
+ // actual changes once the pass is over, because a child's position is only
+ // final after its parent has placed it.
+ static void recordVisitedNode(css_node_t *node, css_layout_changes_t *changes) {
+   if (changes->overflowed) {
+     return;
+   }
+   if (changes->count == changes->capacity) {
+     int capacity = changes->capacity > 0 ? changes->capacity * 2 : 64;
+     css_layout_change_t *grown = (css_layout_change_t *)realloc(
+       changes->changes,
+       capacity * sizeof(css_layout_change_t)
+     );
+     if (grown == NULL) {
+       changes->overflowed = true;
+       return;
+     }
+     changes->changes = grown;
+     changes->capacity = capacity;
+   }
+   changes->changes[changes->count].node = node;
+   changes->changes[changes->count].flags = 0;
+   changes->count++;
+ }
+
+ static bool canDeferLayout(css_node_t *node, css_direction_t parentDirection) {
+   if (node->children_count == 0) {
+     return false;
+   }
+   // Same as the beginning of layoutNodeImpl, which is fine to run twice. The
+   // resolved axes matter: start/end padding and border are not symmetric.
+   css_direction_t direction = resolveDirection(node, parentDirection);
+   css_flex_direction_t mainAxis = resolveAxis(getFlexDirection(node), direction);
+   css_flex_direction_t crossAxis = getCrossFlexDirection(mainAxis, direction);
+   setDimensionFromStyle(node, mainAxis);
+   setDimensionFromStyle(node, crossAxis);
+   return isLayoutDimDefined(node, mainAxis) && isLayoutDimDefined(node, crossAxis);
+ }
+
+ // Does the part of layoutNodeImpl that the parent relies on, i.e. everything
+ // but the layout of the children.
+ static void deferLayout(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+   css_direction_t direction = resolveDirection(node, parentDirection);
+   css_flex_direction_t mainAxis = resolveAxis(getFlexDirection(node), direction);
+   css_flex_direction_t crossAxis = getCrossFlexDirection(mainAxis, direction);
+
+   node->layout.direction = direction;
+
+   node->layout.position[leading[mainAxis]] += getLeadingMargin(node, mainAxis) +
+     getRelativePosition(node, mainAxis);
+   node->layout.position[trailing[mainAxis]] += getTrailingMargin(node, mainAxis) +
+     getRelativePosition(node, mainAxis);
+   node->layout.position[leading[crossAxis]] += getLeadingMargin(node, crossAxis) +
+     getRelativePosition(node, crossAxis);
+   node->layout.position[trailing[crossAxis]] += getTrailingMargin(node, crossAxis) +
+     getRelativePosition(node, crossAxis);
+
+   node->layout.deferred = true;
+   node->layout.deferred_parent_max_width = parentMaxWidth;
+   node->layout.deferred_parent_max_height = parentMaxHeight;
+   node->layout.deferred_parent_direction = parentDirection;
+ }
+
+ // Runs the layoutNodeImpl that deferLayout skipped, with the constraints and
+ // the frame the node had then. It has to run before anything else touches
+ // the subtree: children in reverse directions are placed from their trailing
+ // position, which resetNodeLayout leaves alone, so the layout of a subtree
+ // depends on every pass it went through and not only on the last one.
+ static void layoutDeferredNode(css_node_t *node, css_layout_pass_t *pass) {
+   css_layout_t *layout = &node->layout;
+   layout->deferred = false;
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   recordNodeVisit(pass, node);
+   #endif
+
+   // The parent may have placed or reset the node since, and layoutNodeImpl
+   // would add the margins and relative position a second time.
+   float position[4];
+   float dimensions[2];
+   memcpy(position, layout->position, sizeof(position));
+   memcpy(dimensions, layout->dimensions, sizeof(dimensions));
+   layout->dimensions[CSS_WIDTH] = layout->last_dimensions[CSS_WIDTH];
+   layout->dimensions[CSS_HEIGHT] = layout->last_dimensions[CSS_HEIGHT];
+
+   for (int i = 0, childCount = node->children_count; i < childCount; i++) {
+     resetNodeLayout(node->get_child(node->context, i));
+   }
+   layoutNodeImpl(
+     node,
+     layout->deferred_parent_max_width,
+     layout->deferred_parent_max_height,
+     layout->deferred_parent_direction,
+     pass
+   );
+
+   memcpy(layout->position, position, sizeof(position));
+   memcpy(layout->dimensions, dimensions, sizeof(dimensions));
+ }
+
+ static void layoutNodeInPass(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection, css_layout_pass_t *pass) {
    css_layout_t *layout = &node->layout;
    css_direction_t direction = node->style.direction;
    layout->should_update = true;
 
+   if (pass->changes != NULL) {
+     recordVisitedNode(node, pass->changes);
+   }
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   recordNodeVisit(pass, node);
+   #endif
+
    bool skipLayout =
      !node->is_dirty(node->context) &&
      eq(layout->last_requested_dimensions[CSS_WIDTH], layout->dimensions[CSS_WIDTH]) &&
@@ -1303,22 +1601,39 @@
      eq(layout->last_direction, direction);
 
    if (skipLayout) {
+     #ifdef CSS_LAYOUT_INSTRUMENTATION
+     pass->stats.skipped_count++;
+     #endif
      layout->dimensions[CSS_WIDTH] = layout->last_dimensions[CSS_WIDTH];
      layout->dimensions[CSS_HEIGHT] = layout->last_dimensions[CSS_HEIGHT];
      layout->position[CSS_TOP] = layout->last_position[CSS_TOP];
      layout->position[CSS_LEFT] = layout->last_position[CSS_LEFT];
+     // A culled pass keeps the subtree deferred, any other pass needs it
+     if (layout->deferred && pass->viewport == NULL) {
+       layoutDeferredNode(node, pass);
+     }
    } else {
+     // The subtree has to go through the pass it skipped first, see
+     // layoutDeferredNode
+     if (layout->deferred) {
+       layoutDeferredNode(node, pass);
+     }
+
      layout->last_requested_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
      layout->last_requested_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
      layout->last_parent_max_width = parentMaxWidth;
      layout->last_parent_max_height = parentMaxHeight;
      layout->last_direction = direction;
 
-     for (int i = 0, childCount = node->children_count; i < childCount; i++) {
-       resetNodeLayout(node->get_child(node->context, i));
-     }
+     if (pass->viewport != NULL && canDeferLayout(node, parentDirection)) {
+       deferLayout(node, parentMaxWidth, parentMaxHeight, parentDirection);
+     } else {
+       for (int i = 0, childCount = node->children_count; i < childCount; i++) {
+         resetNodeLayout(node->get_child(node->context, i));
+       }
 
-     layoutNodeImpl(node, parentMaxWidth, parentMaxHeight, parentDirection);
+       layoutNodeImpl(node, parentMaxWidth, parentMaxHeight, parentDirection, pass);
+     }
 
      layout->last_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
      layout->last_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
@@ -1327,9 +1642,254 @@
    }
  }
 
+ void layoutNode(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+   css_layout_pass_t pass = { NULL, NULL };
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   beginLayoutPass(&pass);
+   #endif
+
+   layoutNodeInPass(node, parentMaxWidth, parentMaxHeight, parentDirection, &pass);
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   endLayoutPass(&pass);
+   #endif
+ }
+
  void resetNodeLayout(css_node_t *node) {
    node->layout.dimensions[CSS_WIDTH] = CSS_UNDEFINED;
    node->layout.dimensions[CSS_HEIGHT] = CSS_UNDEFINED;
    node->layout.position[CSS_LEFT] = 0;
    node->layout.position[CSS_TOP] = 0;
  }
+
+ void init_css_layout_changes(css_layout_changes_t *changes) {
+   changes->changes = NULL;
+   changes->count = 0;
+   changes->capacity = 0;
+   changes->overflowed = false;
+ }
+
+ void free_css_layout_changes(css_layout_changes_t *changes) {
+   free(changes->changes);
+   init_css_layout_changes(changes);
+ }
+
+ static int diffReportedLayout(css_layout_t *layout) {
+   int flags = 0;
+   if (!eq(layout->reported_position[CSS_LEFT], layout->position[CSS_LEFT]) ||
+       !eq(layout->reported_position[CSS_TOP], layout->position[CSS_TOP])) {
+     flags |= CSS_LAYOUT_CHANGED_POSITION;
+   }
+   if (!eq(layout->reported_dimensions[CSS_WIDTH], layout->dimensions[CSS_WIDTH]) ||
+       !eq(layout->reported_dimensions[CSS_HEIGHT], layout->dimensions[CSS_HEIGHT])) {
+     flags |= CSS_LAYOUT_CHANGED_DIMENSIONS;
+   }
+   return flags;
+ }
+
+ static void commitReportedLayout(css_layout_t *layout) {
+   layout->reported_position[CSS_LEFT] = layout->position[CSS_LEFT];
+   layout->reported_position[CSS_TOP] = layout->position[CSS_TOP];
+   layout->reported_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
+   layout->reported_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
+ }
+
+ void layoutNodeWithChanges(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection, css_layout_changes_t *changes) {
+   changes->count = 0;
+   changes->overflowed = false;
+
+   css_layout_pass_t pass = { changes, NULL };
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   beginLayoutPass(&pass);
+   #endif
+
+   layoutNodeInPass(node, maxWidth, maxHeight, parentDirection, &pass);
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   endLayoutPass(&pass);
+   #endif
+
+   if (changes->overflowed) {
+     // We lost track of some visited nodes, so commit nothing: the next pass
+     // must still see this one's changes.
+     changes->count = 0;
+     return;
+   }
+
+   // A node may have been visited several times (e.g. re-layout after a
+   // stretch). Committing on the first occurrence makes later duplicates
+   // compare equal, so every node is reported at most once.
+   int count = 0;
+   for (int i = 0; i < changes->count; i++) {
+     css_layout_t *layout = &changes->changes[i].node->layout;
+     int flags = diffReportedLayout(layout);
+     if (flags != 0) {
+       commitReportedLayout(layout);
+       changes->changes[count].node = changes->changes[i].node;
+       changes->changes[count].flags = flags;
+       count++;
+     }
+   }
+   changes->count = count;
+ }
+
+ int getLayoutChangeCount(const css_layout_changes_t *changes) {
+   return changes->count;
+ }
+
+ const css_layout_change_t *getLayoutChange(const css_layout_changes_t *changes, int index) {
+   return &changes->changes[index];
+ }
+
+ static bool isOutsideViewport(float left, float top, float width, float height, const css_viewport_t *viewport) {
+   float overscan = viewport->overscan;
+   // Comparisons against an undefined viewport dimension are false, so the
+   // node is never considered outside along that axis.
+   return
+     left + width < viewport->position[CSS_LEFT] - overscan ||
+     top + height < viewport->position[CSS_TOP] - overscan ||
+     left > viewport->position[CSS_LEFT] + viewport->dimensions[CSS_WIDTH] + overscan ||
+     top > viewport->position[CSS_TOP] + viewport->dimensions[CSS_HEIGHT] + overscan;
+ }
+
+ // Walks the tree with the origin of each node relative to the root, and lays
+ // out the deferred subtrees that intersect the viewport. Those may defer
+ // deeper subtrees in turn, which the walk then visits as well.
+ static void layoutVisibleNodes(css_node_t *node, float left, float top, css_layout_pass_t *pass) {
+   for (int i = 0, childCount = node->children_count; i < childCount; i++) {
+     css_node_t *child = node->get_child(node->context, i);
+     float childLeft = left + child->layout.position[CSS_LEFT];
+     float childTop = top + child->layout.position[CSS_TOP];
+
+     if (child->layout.deferred) {
+       if (isOutsideViewport(childLeft, childTop, child->layout.dimensions[CSS_WIDTH], child->layout.dimensions[CSS_HEIGHT], pass->viewport)) {
+         continue;
+       }
+       layoutDeferredNode(child, pass);
+     }
+     layoutVisibleNodes(child, childLeft, childTop, pass);
+   }
+ }
+
+ void layoutNodeCulled(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection, const css_viewport_t *viewport) {
+   css_layout_pass_t pass = { NULL, viewport };
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   beginLayoutPass(&pass);
+   #endif
+
+   layoutNodeInPass(node, maxWidth, maxHeight, parentDirection, &pass);
+   // The viewport is relative to the root, which is therefore always visible
+   if (node->layout.deferred) {
+     layoutDeferredNode(node, &pass);
+   }
+   layoutVisibleNodes(node, 0, 0, &pass);
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   endLayoutPass(&pass);
+   #endif
+ }
+
+ static void layoutDeferredNodesInPass(css_node_t *node, css_layout_pass_t *pass) {
+   if (node->layout.deferred) {
+     layoutDeferredNode(node, pass);
+   }
+   for (int i = 0, childCount = node->children_count; i < childCount; i++) {
+     layoutDeferredNodesInPass(node->get_child(node->context, i), pass);
+   }
+ }
+
+ void layoutDeferredNodes(css_node_t *node) {
+   css_layout_pass_t pass = { NULL, NULL };
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   beginLayoutPass(&pass);
+   #endif
+
+   layoutDeferredNodesInPass(node, &pass);
+
+   #ifdef CSS_LAYOUT_INSTRUMENTATION
+   endLayoutPass(&pass);
+   #endif
+ }
+
+ #ifdef CSS_LAYOUT_INSTRUMENTATION
+ int getLayoutPassCount(void) {
+   lockRecordedPasses();
+   int count = recorded_pass_count;
+   unlockRecordedPasses();
+   return count;
+ }
+
+ // With recorded_passes_lock held
+ static const css_layout_pass_stats_t *getRecordedPass(int index) {
+   int oldest = recorded_pass_count < CSS_LAYOUT_TRACE_CAPACITY ? 0 : next_recorded_pass;
+   return &recorded_passes[(oldest + index) % CSS_LAYOUT_TRACE_CAPACITY];
+ }
+
+ bool getLayoutPass(int index, css_layout_pass_stats_t *pass) {
+   lockRecordedPasses();
+   bool found = index >= 0 && index < recorded_pass_count;
+   if (found) {
+     *pass = *getRecordedPass(index);
+   }
+   unlockRecordedPasses();
+   return found;
+ }
+
+ void clearLayoutPasses(void) {
+   lockRecordedPasses();
+   recorded_pass_count = 0;
+   next_recorded_pass = 0;
+   unlockRecordedPasses();
+ }
+
+ // One complete ("X") event per pass, with the counters and hot nodes as
+ // arguments, and one counter ("C") event so that the counts get plotted.
+ bool writeLayoutTrace(FILE *file) {
+   // A copy, so that layout passes don't wait for the file
+   css_layout_pass_stats_t *passes = (css_layout_pass_stats_t *)malloc(
+     CSS_LAYOUT_TRACE_CAPACITY * sizeof(css_layout_pass_stats_t)
+   );
+   if (passes == NULL) {
+     return false;
+   }
+   lockRecordedPasses();
+   int count = recorded_pass_count;
+   for (int i = 0; i < count; i++) {
+     passes[i] = *getRecordedPass(i);
+   }
+   unlockRecordedPasses();
+
+   fprintf(file, "{\"traceEvents\":[");
+   for (int i = 0; i < count; i++) {
+     const css_layout_pass_stats_t *pass = &passes[i];
+     fprintf(file,
+       "%s\n{\"name\":\"layoutNode\",\"cat\":\"css-layout\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+       "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"visited\":%d,\"skipped\":%d,\"measured\":%d,\"hotNodes\":[",
+       i > 0 ? "," : "",
+       pass->start_time,
+       pass->duration,
+       pass->visited_count,
+       pass->skipped_count,
+       pass->measure_count
+     );
+     for (int j = 0; j < pass->hot_node_count; j++) {
+       fprintf(file, "%s{\"node\":\"%p\",\"visits\":%d}",
+         j > 0 ? "," : "",
+         (void *)pass->hot_nodes[j].node,
+         pass->hot_nodes[j].visits
+       );
+     }
+     fprintf(file,
+       "]}},\n{\"name\":\"css-layout\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":%.3f,"
+       "\"args\":{\"visited\":%d,\"skipped\":%d,\"measured\":%d}}",
+       pass->start_time,
+       pass->visited_count,
+       pass->skipped_count,
+       pass->measure_count
+     );
+   }
+   fprintf(file, "\n]}\n");
+   free(passes);
+   return ferror(file) == 0;
+ }
+ #endif
@@ -113,6 +113,19 @@
    float last_dimensions[2];
    float last_position[2];
    css_direction_t last_direction;
+
+   // Frame as of the last change-tracked pass, used to report only the nodes
+   // that actually moved or resized (see layoutNodeWithChanges)
+   float reported_position[2];
+   float reported_dimensions[2];
+
+   // Set when a culled pass computed this node's frame but skipped its
+   // subtree (see layoutNodeCulled). The constraints it was given are kept so
+   // that the subtree can be laid out later.
+   bool deferred;
+   float deferred_parent_max_width;
+   float deferred_parent_max_height;
+   css_direction_t deferred_parent_direction;
  } css_layout_t;
 
  typedef struct {
@@ -186,4 +199,110 @@
  // Reset the calculated layout values for a given node. You should call this before `layoutNode`.
  void resetNodeLayout(css_node_t *node);
 
+ // Change tracking
+ typedef enum {
+   CSS_LAYOUT_CHANGED_POSITION = 1,
+   CSS_LAYOUT_CHANGED_DIMENSIONS = 2,
+ } css_layout_change_flags_t;
+
+ typedef struct {
+   css_node_t *node;
+   int flags; // css_layout_change_flags_t
+ } css_layout_change_t;
+
+ typedef struct {
+   css_layout_change_t *changes;
+   int count;
+   int capacity;
+   // Set when the list could not grow. Consumers must then fall back to
+   // walking the whole tree for this pass.
+   bool overflowed;
+ } css_layout_changes_t;
+
+ void init_css_layout_changes(css_layout_changes_t *changes);
+ void free_css_layout_changes(css_layout_changes_t *changes);
+
+ // Same as `layoutNode`, but also fills `changes` with the nodes whose
+ // computed position (relative to their parent) or dimensions differ from the
+ // previous change-tracked pass. Nodes skipped through the layout cache keep
+ // their frame and are never reported. Passes over different trees may run
+ // at the same time, each with its own change list.
+ void layoutNodeWithChanges(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection, css_layout_changes_t *changes);
+
+ // Iteration over the result of the last pass
+ int getLayoutChangeCount(const css_layout_changes_t *changes);
+ const css_layout_change_t *getLayoutChange(const css_layout_changes_t *changes, int index);
+
+ // Viewport culling
+ typedef struct {
+   // Visible rectangle in the coordinate space of the node being laid out.
+   // An undefined dimension disables culling along that axis.
+   float position[2];
+   float dimensions[2];
+   // Extra distance around the rectangle that is laid out as well, so that
+   // content is ready before it scrolls into view
+   float overscan;
+ } css_viewport_t;
+
+ // Same as `layoutNode`, but the subtree of a node whose size does not depend
+ // on its children (both dimensions fixed by its style or by its parent) is
+ // deferred when the node ends up outside of the viewport. Such a node still
+ // gets its own frame, and is marked `layout.deferred`. Calling this again
+ // with another viewport lays out the deferred subtrees that became visible;
+ // the rest of the tree is served from the layout cache. Once every deferred
+ // subtree is laid out, the tree is the same as after as many `layoutNode`
+ // passes; `layoutNode` itself finishes the deferred subtrees it visits.
+ void layoutNodeCulled(css_node_t *node, float maxWidth, float maxHeight, css_direction_t parentDirection, const css_viewport_t *viewport);
+
+ // Lays out every deferred subtree below and including `node`, without
+ // culling, e.g. before reading the layout of an off-screen node.
+ void layoutDeferredNodes(css_node_t *node);
+
+ // Instrumentation, only compiled in with -DCSS_LAYOUT_INSTRUMENTATION.
+ //
+ // Every top-level call to one of the layout functions above is one pass.
+ // The last CSS_LAYOUT_TRACE_CAPACITY passes are kept in memory, and can be
+ // exported for chrome://tracing. Passes from all threads are recorded, the
+ // accessors below are thread safe.
+ #ifdef CSS_LAYOUT_INSTRUMENTATION
+ #include <stdio.h>
+
+ #ifndef CSS_LAYOUT_TRACE_CAPACITY
+ #define CSS_LAYOUT_TRACE_CAPACITY 128
+ #endif
+
+ #ifndef CSS_LAYOUT_HOT_NODE_COUNT
+ #define CSS_LAYOUT_HOT_NODE_COUNT 8
+ #endif
+
+ typedef struct {
+   css_node_t *node;
+   int visits;
+ } css_layout_node_visits_t;
+
+ typedef struct {
+   // Microseconds, from a monotonic clock
+   double start_time;
+   double duration;
+   // Number of calls to layoutNode, including the ones for the same node
+   int visited_count;
+   // Visits that were served from the last_* cache
+   int skipped_count;
+   int measure_count;
+   // Most visited nodes first
+   int hot_node_count;
+   css_layout_node_visits_t hot_nodes[CSS_LAYOUT_HOT_NODE_COUNT];
+ } css_layout_pass_stats_t;
+
+ // Retained passes, oldest first. getLayoutPass copies a pass out, and returns
+ // false if there is no pass at that index (anymore).
+ int getLayoutPassCount(void);
+ bool getLayoutPass(int index, css_layout_pass_stats_t *pass);
+ void clearLayoutPasses(void);
+
+ // Writes the retained passes in the Chrome trace event format. Returns false
+ // if writing to `file` failed.
+ bool writeLayoutTrace(FILE *file);
+ #endif
+
  #endif
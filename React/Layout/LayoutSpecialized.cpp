@@ -0,0 +1,1000 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include "LayoutSpecialized.h"
+
+#include <math.h>
+
+// This is a port of `layoutNodeImpl` from Layout.c. Keep the two in sync: every
+// expression below has the same shape (operand order, parenthesization) as its
+// C counterpart so that both engines round identically, including when the
+// compiler contracts multiply-adds.
+
+namespace {
+
+constexpr css_flex_direction_t COLUMN = CSS_FLEX_DIRECTION_COLUMN;
+constexpr css_flex_direction_t COLUMN_REVERSE = CSS_FLEX_DIRECTION_COLUMN_REVERSE;
+constexpr css_flex_direction_t ROW = CSS_FLEX_DIRECTION_ROW;
+constexpr css_flex_direction_t ROW_REVERSE = CSS_FLEX_DIRECTION_ROW_REVERSE;
+
+constexpr bool isRowDirection(css_flex_direction_t axis) {
+  return axis == ROW || axis == ROW_REVERSE;
+}
+
+constexpr bool isColumnDirection(css_flex_direction_t axis) {
+  return axis == COLUMN || axis == COLUMN_REVERSE;
+}
+
+// The `leading`, `trailing`, `pos` and `dim` tables of Layout.c.
+constexpr css_position_t leading(css_flex_direction_t axis) {
+  return axis == COLUMN ? CSS_TOP :
+    axis == COLUMN_REVERSE ? CSS_BOTTOM :
+    axis == ROW ? CSS_LEFT :
+    CSS_RIGHT;
+}
+
+constexpr css_position_t trailing(css_flex_direction_t axis) {
+  return axis == COLUMN ? CSS_BOTTOM :
+    axis == COLUMN_REVERSE ? CSS_TOP :
+    axis == ROW ? CSS_RIGHT :
+    CSS_LEFT;
+}
+
+constexpr css_position_t pos(css_flex_direction_t axis) {
+  return leading(axis);
+}
+
+constexpr css_dimension_t dim(css_flex_direction_t axis) {
+  return isColumnDirection(axis) ? CSS_HEIGHT : CSS_WIDTH;
+}
+
+// Hides the exported `isUndefined` so that the check inlines in the kernel
+inline bool isUndefined(float value) {
+  return isnan(value);
+}
+
+inline bool eq(float a, float b) {
+  if (isUndefined(a)) {
+    return isUndefined(b);
+  }
+  return fabs(a - b) < 0.0001;
+}
+
+template <css_flex_direction_t Axis>
+inline float getLeadingMargin(const css_node_t *node) {
+  if (isRowDirection(Axis) && !isUndefined(node->style.margin[CSS_START])) {
+    return node->style.margin[CSS_START];
+  }
+
+  return node->style.margin[leading(Axis)];
+}
+
+template <css_flex_direction_t Axis>
+inline float getTrailingMargin(const css_node_t *node) {
+  if (isRowDirection(Axis) && !isUndefined(node->style.margin[CSS_END])) {
+    return node->style.margin[CSS_END];
+  }
+
+  return node->style.margin[trailing(Axis)];
+}
+
+template <css_flex_direction_t Axis>
+inline float getLeadingPadding(const css_node_t *node) {
+  if (isRowDirection(Axis) &&
+      !isUndefined(node->style.padding[CSS_START]) &&
+      node->style.padding[CSS_START] >= 0) {
+    return node->style.padding[CSS_START];
+  }
+
+  if (node->style.padding[leading(Axis)] >= 0) {
+    return node->style.padding[leading(Axis)];
+  }
+
+  return 0;
+}
+
+template <css_flex_direction_t Axis>
+inline float getTrailingPadding(const css_node_t *node) {
+  if (isRowDirection(Axis) &&
+      !isUndefined(node->style.padding[CSS_END]) &&
+      node->style.padding[CSS_END] >= 0) {
+    return node->style.padding[CSS_END];
+  }
+
+  if (node->style.padding[trailing(Axis)] >= 0) {
+    return node->style.padding[trailing(Axis)];
+  }
+
+  return 0;
+}
+
+template <css_flex_direction_t Axis>
+inline float getLeadingBorder(const css_node_t *node) {
+  if (isRowDirection(Axis) &&
+      !isUndefined(node->style.border[CSS_START]) &&
+      node->style.border[CSS_START] >= 0) {
+    return node->style.border[CSS_START];
+  }
+
+  if (node->style.border[leading(Axis)] >= 0) {
+    return node->style.border[leading(Axis)];
+  }
+
+  return 0;
+}
+
+template <css_flex_direction_t Axis>
+inline float getTrailingBorder(const css_node_t *node) {
+  if (isRowDirection(Axis) &&
+      !isUndefined(node->style.border[CSS_END]) &&
+      node->style.border[CSS_END] >= 0) {
+    return node->style.border[CSS_END];
+  }
+
+  if (node->style.border[trailing(Axis)] >= 0) {
+    return node->style.border[trailing(Axis)];
+  }
+
+  return 0;
+}
+
+template <css_flex_direction_t Axis>
+inline float getLeadingPaddingAndBorder(const css_node_t *node) {
+  return getLeadingPadding<Axis>(node) + getLeadingBorder<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline float getTrailingPaddingAndBorder(const css_node_t *node) {
+  return getTrailingPadding<Axis>(node) + getTrailingBorder<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline float getBorderAxis(const css_node_t *node) {
+  return getLeadingBorder<Axis>(node) + getTrailingBorder<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline float getMarginAxis(const css_node_t *node) {
+  return getLeadingMargin<Axis>(node) + getTrailingMargin<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline float getPaddingAndBorderAxis(const css_node_t *node) {
+  return getLeadingPaddingAndBorder<Axis>(node) + getTrailingPaddingAndBorder<Axis>(node);
+}
+
+inline css_align_t getAlignItem(const css_node_t *node, const css_node_t *child) {
+  if (child->style.align_self != CSS_ALIGN_AUTO) {
+    return child->style.align_self;
+  }
+  return node->style.align_items;
+}
+
+inline css_direction_t resolveDirection(const css_node_t *node, css_direction_t parentDirection) {
+  css_direction_t direction = node->style.direction;
+
+  if (direction == CSS_DIRECTION_INHERIT) {
+    direction = parentDirection > CSS_DIRECTION_INHERIT ? parentDirection : CSS_DIRECTION_LTR;
+  }
+
+  return direction;
+}
+
+inline css_flex_direction_t resolveAxis(css_flex_direction_t flex_direction, css_direction_t direction) {
+  if (direction == CSS_DIRECTION_RTL) {
+    if (flex_direction == ROW) {
+      return ROW_REVERSE;
+    } else if (flex_direction == ROW_REVERSE) {
+      return ROW;
+    }
+  }
+
+  return flex_direction;
+}
+
+inline bool isFlex(const css_node_t *node) {
+  return (
+    node->style.position_type == CSS_POSITION_RELATIVE &&
+    node->style.flex > 0
+  );
+}
+
+inline bool isFlexWrap(const css_node_t *node) {
+  return node->style.flex_wrap == CSS_WRAP;
+}
+
+template <css_flex_direction_t Axis>
+inline float getDimWithMargin(const css_node_t *node) {
+  return node->layout.dimensions[dim(Axis)] +
+    getLeadingMargin<Axis>(node) +
+    getTrailingMargin<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline bool isStyleDimDefined(const css_node_t *node) {
+  float value = node->style.dimensions[dim(Axis)];
+  return !isUndefined(value) && value >= 0.0;
+}
+
+template <css_flex_direction_t Axis>
+inline bool isLayoutDimDefined(const css_node_t *node) {
+  float value = node->layout.dimensions[dim(Axis)];
+  return !isUndefined(value) && value >= 0.0;
+}
+
+inline bool isPosDefined(const css_node_t *node, css_position_t position) {
+  return !isUndefined(node->style.position[position]);
+}
+
+inline bool isMeasureDefined(const css_node_t *node) {
+  return node->measure;
+}
+
+inline float getPosition(const css_node_t *node, css_position_t position) {
+  float result = node->style.position[position];
+  if (!isUndefined(result)) {
+    return result;
+  }
+  return 0;
+}
+
+template <css_flex_direction_t Axis>
+inline float boundAxis(const css_node_t *node, float value) {
+  float min = node->style.minDimensions[dim(Axis)];
+  float max = node->style.maxDimensions[dim(Axis)];
+
+  float boundValue = value;
+
+  if (!isUndefined(max) && max >= 0.0 && boundValue > max) {
+    boundValue = max;
+  }
+  if (!isUndefined(min) && min >= 0.0 && boundValue < min) {
+    boundValue = min;
+  }
+
+  return boundValue;
+}
+
+template <css_flex_direction_t Axis>
+inline void setDimensionFromStyle(css_node_t *node) {
+  if (isLayoutDimDefined<Axis>(node)) {
+    return;
+  }
+  if (!isStyleDimDefined<Axis>(node)) {
+    return;
+  }
+
+  node->layout.dimensions[dim(Axis)] = fmaxf(
+    boundAxis<Axis>(node, node->style.dimensions[dim(Axis)]),
+    getPaddingAndBorderAxis<Axis>(node)
+  );
+}
+
+template <css_flex_direction_t Axis>
+inline void setTrailingPosition(const css_node_t *node, css_node_t *child) {
+  child->layout.position[trailing(Axis)] = node->layout.dimensions[dim(Axis)] -
+    child->layout.dimensions[dim(Axis)] - child->layout.position[pos(Axis)];
+}
+
+template <css_flex_direction_t Axis>
+inline float getRelativePosition(const css_node_t *node) {
+  float lead = node->style.position[leading(Axis)];
+  if (!isUndefined(lead)) {
+    return lead;
+  }
+  return -getPosition(node, trailing(Axis));
+}
+
+template <css_flex_direction_t Axis>
+inline void addMarginAndRelativePosition(css_node_t *node) {
+  node->layout.position[leading(Axis)] += getLeadingMargin<Axis>(node) +
+    getRelativePosition<Axis>(node);
+  node->layout.position[trailing(Axis)] += getTrailingMargin<Axis>(node) +
+    getRelativePosition<Axis>(node);
+}
+
+template <css_flex_direction_t Axis>
+inline void removeMarginAndRelativePosition(css_node_t *node) {
+  node->layout.position[leading(Axis)] -= getLeadingMargin<Axis>(node) +
+    getRelativePosition<Axis>(node);
+  node->layout.position[trailing(Axis)] -= getTrailingMargin<Axis>(node) +
+    getRelativePosition<Axis>(node);
+}
+
+// Pre-fill dimensions when using absolute position and both offsets for the
+// axis are defined (<Loop A>).
+template <css_flex_direction_t Axis>
+inline void prefillAbsoluteDimension(const css_node_t *node, css_node_t *child) {
+  if (isLayoutDimDefined<Axis>(node) &&
+      !isStyleDimDefined<Axis>(child) &&
+      isPosDefined(child, leading(Axis)) &&
+      isPosDefined(child, trailing(Axis))) {
+    child->layout.dimensions[dim(Axis)] = fmaxf(
+      boundAxis<Axis>(child, node->layout.dimensions[dim(Axis)] -
+        getPaddingAndBorderAxis<Axis>(node) -
+        getMarginAxis<Axis>(child) -
+        getPosition(child, leading(Axis)) -
+        getPosition(child, trailing(Axis))),
+      getPaddingAndBorderAxis<Axis>(child)
+    );
+  }
+}
+
+// Calculate dimensions and trailing-anchored positions of absolutely
+// positioned children (<Loop G>).
+template <css_flex_direction_t Axis>
+inline void layoutAbsoluteChild(const css_node_t *node, css_node_t *child) {
+  if (isLayoutDimDefined<Axis>(node) &&
+      !isStyleDimDefined<Axis>(child) &&
+      isPosDefined(child, leading(Axis)) &&
+      isPosDefined(child, trailing(Axis))) {
+    child->layout.dimensions[dim(Axis)] = fmaxf(
+      boundAxis<Axis>(child, node->layout.dimensions[dim(Axis)] -
+        getBorderAxis<Axis>(node) -
+        getMarginAxis<Axis>(child) -
+        getPosition(child, leading(Axis)) -
+        getPosition(child, trailing(Axis))
+      ),
+      getPaddingAndBorderAxis<Axis>(child)
+    );
+  }
+
+  if (isPosDefined(child, trailing(Axis)) &&
+      !isPosDefined(child, leading(Axis))) {
+    child->layout.position[leading(Axis)] =
+      node->layout.dimensions[dim(Axis)] -
+      child->layout.dimensions[dim(Axis)] -
+      getPosition(child, trailing(Axis));
+  }
+}
+
+void layoutNodeCached(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection);
+
+template <css_flex_direction_t MainAxis, css_flex_direction_t ResolvedRowAxis>
+void layoutNodeImpl(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t direction) {
+  constexpr css_flex_direction_t mainAxis = MainAxis;
+  constexpr css_flex_direction_t crossAxis = isColumnDirection(MainAxis) ? ResolvedRowAxis : COLUMN;
+  constexpr css_flex_direction_t resolvedRowAxis = ResolvedRowAxis;
+  constexpr bool isMainRowDirection = isRowDirection(mainAxis);
+
+  setDimensionFromStyle<mainAxis>(node);
+  setDimensionFromStyle<crossAxis>(node);
+
+  node->layout.direction = direction;
+
+  addMarginAndRelativePosition<mainAxis>(node);
+  addMarginAndRelativePosition<crossAxis>(node);
+
+  int childCount = node->children_count;
+  float paddingAndBorderAxisResolvedRow = getPaddingAndBorderAxis<resolvedRowAxis>(node);
+  float paddingAndBorderAxisColumn = getPaddingAndBorderAxis<COLUMN>(node);
+
+  if (isMeasureDefined(node)) {
+    bool isResolvedRowDimDefined = isLayoutDimDefined<resolvedRowAxis>(node);
+
+    float width = CSS_UNDEFINED;
+    css_measure_mode_t widthMode = CSS_MEASURE_MODE_UNDEFINED;
+    if (isStyleDimDefined<resolvedRowAxis>(node)) {
+      width = node->style.dimensions[CSS_WIDTH];
+      widthMode = CSS_MEASURE_MODE_EXACTLY;
+    } else if (isResolvedRowDimDefined) {
+      width = node->layout.dimensions[dim(resolvedRowAxis)];
+      widthMode = CSS_MEASURE_MODE_EXACTLY;
+    } else {
+      width = parentMaxWidth -
+        getMarginAxis<resolvedRowAxis>(node);
+      widthMode = CSS_MEASURE_MODE_AT_MOST;
+    }
+    width -= paddingAndBorderAxisResolvedRow;
+    if (isUndefined(width)) {
+      widthMode = CSS_MEASURE_MODE_UNDEFINED;
+    }
+
+    float height = CSS_UNDEFINED;
+    css_measure_mode_t heightMode = CSS_MEASURE_MODE_UNDEFINED;
+    if (isStyleDimDefined<COLUMN>(node)) {
+      height = node->style.dimensions[CSS_HEIGHT];
+      heightMode = CSS_MEASURE_MODE_EXACTLY;
+    } else if (isLayoutDimDefined<COLUMN>(node)) {
+      height = node->layout.dimensions[dim(COLUMN)];
+      heightMode = CSS_MEASURE_MODE_EXACTLY;
+    } else {
+      // Layout.c subtracts the row margins here as well
+      height = parentMaxHeight -
+        getMarginAxis<resolvedRowAxis>(node);
+      heightMode = CSS_MEASURE_MODE_AT_MOST;
+    }
+    height -= getPaddingAndBorderAxis<COLUMN>(node);
+    if (isUndefined(height)) {
+      heightMode = CSS_MEASURE_MODE_UNDEFINED;
+    }
+
+    bool isRowUndefined = !isStyleDimDefined<resolvedRowAxis>(node) && !isResolvedRowDimDefined;
+    bool isColumnUndefined = !isStyleDimDefined<COLUMN>(node) &&
+      isUndefined(node->layout.dimensions[dim(COLUMN)]);
+
+    if (isRowUndefined || isColumnUndefined) {
+      css_dim_t measureDim = node->measure(
+        node->context,
+
+        width,
+        widthMode,
+        height,
+        heightMode
+      );
+      if (isRowUndefined) {
+        node->layout.dimensions[CSS_WIDTH] = measureDim.dimensions[CSS_WIDTH] +
+          paddingAndBorderAxisResolvedRow;
+      }
+      if (isColumnUndefined) {
+        node->layout.dimensions[CSS_HEIGHT] = measureDim.dimensions[CSS_HEIGHT] +
+          paddingAndBorderAxisColumn;
+      }
+    }
+    if (childCount == 0) {
+      return;
+    }
+  }
+
+  bool isNodeFlexWrap = isFlexWrap(node);
+
+  css_justify_t justifyContent = node->style.justify_content;
+
+  float leadingPaddingAndBorderMain = getLeadingPaddingAndBorder<mainAxis>(node);
+  float leadingPaddingAndBorderCross = getLeadingPaddingAndBorder<crossAxis>(node);
+  float paddingAndBorderAxisMain = getPaddingAndBorderAxis<mainAxis>(node);
+  float paddingAndBorderAxisCross = getPaddingAndBorderAxis<crossAxis>(node);
+
+  bool isMainDimDefined = isLayoutDimDefined<mainAxis>(node);
+  bool isCrossDimDefined = isLayoutDimDefined<crossAxis>(node);
+
+  int i;
+  int ii;
+  css_node_t *child;
+
+  css_node_t *firstAbsoluteChild = NULL;
+  css_node_t *currentAbsoluteChild = NULL;
+
+  float definedMainDim = CSS_UNDEFINED;
+  if (isMainDimDefined) {
+    definedMainDim = node->layout.dimensions[dim(mainAxis)] - paddingAndBorderAxisMain;
+  }
+
+  int startLine = 0;
+  int endLine = 0;
+  int alreadyComputedNextLayout = 0;
+  float linesCrossDim = 0;
+  float linesMainDim = 0;
+  int linesCount = 0;
+  while (endLine < childCount) {
+    // <Loop A> Layout non flexible children and count children by type
+    float mainContentDim = 0;
+
+    int flexibleChildrenCount = 0;
+    float totalFlexible = 0;
+    int nonFlexibleChildrenCount = 0;
+
+    bool isSimpleStackMain =
+        (isMainDimDefined && justifyContent == CSS_JUSTIFY_FLEX_START) ||
+        (!isMainDimDefined && justifyContent != CSS_JUSTIFY_CENTER);
+    int firstComplexMain = (isSimpleStackMain ? childCount : startLine);
+
+    bool isSimpleStackCross = true;
+    int firstComplexCross = childCount;
+
+    css_node_t *firstFlexChild = NULL;
+    css_node_t *currentFlexChild = NULL;
+
+    float mainDim = leadingPaddingAndBorderMain;
+    float crossDim = 0;
+
+    float maxWidth = CSS_UNDEFINED;
+    float maxHeight = CSS_UNDEFINED;
+    for (i = startLine; i < childCount; ++i) {
+      child = node->get_child(node->context, i);
+      child->line_index = linesCount;
+
+      child->next_absolute_child = NULL;
+      child->next_flex_child = NULL;
+
+      css_align_t alignItem = getAlignItem(node, child);
+
+      if (alignItem == CSS_ALIGN_STRETCH &&
+          child->style.position_type == CSS_POSITION_RELATIVE &&
+          isCrossDimDefined &&
+          !isStyleDimDefined<crossAxis>(child)) {
+        child->layout.dimensions[dim(crossAxis)] = fmaxf(
+          boundAxis<crossAxis>(child, node->layout.dimensions[dim(crossAxis)] -
+            paddingAndBorderAxisCross - getMarginAxis<crossAxis>(child)),
+          getPaddingAndBorderAxis<crossAxis>(child)
+        );
+      } else if (child->style.position_type == CSS_POSITION_ABSOLUTE) {
+        if (firstAbsoluteChild == NULL) {
+          firstAbsoluteChild = child;
+        }
+        if (currentAbsoluteChild != NULL) {
+          currentAbsoluteChild->next_absolute_child = child;
+        }
+        currentAbsoluteChild = child;
+
+        prefillAbsoluteDimension<COLUMN>(node, child);
+        prefillAbsoluteDimension<ROW>(node, child);
+      }
+
+      float nextContentDim = 0;
+
+      if (isMainDimDefined && isFlex(child)) {
+        flexibleChildrenCount++;
+        totalFlexible += child->style.flex;
+
+        if (firstFlexChild == NULL) {
+          firstFlexChild = child;
+        }
+        if (currentFlexChild != NULL) {
+          currentFlexChild->next_flex_child = child;
+        }
+        currentFlexChild = child;
+
+        nextContentDim = getPaddingAndBorderAxis<mainAxis>(child) +
+          getMarginAxis<mainAxis>(child);
+
+      } else {
+        maxWidth = CSS_UNDEFINED;
+        maxHeight = CSS_UNDEFINED;
+
+        if (!isMainRowDirection) {
+          if (isLayoutDimDefined<resolvedRowAxis>(node)) {
+            maxWidth = node->layout.dimensions[dim(resolvedRowAxis)] -
+              paddingAndBorderAxisResolvedRow;
+          } else {
+            maxWidth = parentMaxWidth -
+              getMarginAxis<resolvedRowAxis>(node) -
+              paddingAndBorderAxisResolvedRow;
+          }
+        } else {
+          if (isLayoutDimDefined<COLUMN>(node)) {
+            maxHeight = node->layout.dimensions[dim(COLUMN)] -
+                paddingAndBorderAxisColumn;
+          } else {
+            maxHeight = parentMaxHeight -
+              getMarginAxis<COLUMN>(node) -
+              paddingAndBorderAxisColumn;
+          }
+        }
+
+        if (alreadyComputedNextLayout == 0) {
+          layoutNodeCached(child, maxWidth, maxHeight, direction);
+        }
+
+        if (child->style.position_type == CSS_POSITION_RELATIVE) {
+          nonFlexibleChildrenCount++;
+          nextContentDim = getDimWithMargin<mainAxis>(child);
+        }
+      }
+
+      if (isNodeFlexWrap &&
+          isMainDimDefined &&
+          mainContentDim + nextContentDim > definedMainDim &&
+          i != startLine) {
+        nonFlexibleChildrenCount--;
+        alreadyComputedNextLayout = 1;
+        break;
+      }
+
+      if (isSimpleStackMain &&
+          (child->style.position_type != CSS_POSITION_RELATIVE || isFlex(child))) {
+        isSimpleStackMain = false;
+        firstComplexMain = i;
+      }
+
+      if (isSimpleStackCross &&
+          (child->style.position_type != CSS_POSITION_RELATIVE ||
+              (alignItem != CSS_ALIGN_STRETCH && alignItem != CSS_ALIGN_FLEX_START) ||
+              (alignItem == CSS_ALIGN_STRETCH && !isCrossDimDefined))) {
+        isSimpleStackCross = false;
+        firstComplexCross = i;
+      }
+
+      if (isSimpleStackMain) {
+        child->layout.position[pos(mainAxis)] += mainDim;
+        if (isMainDimDefined) {
+          setTrailingPosition<mainAxis>(node, child);
+        }
+
+        mainDim += getDimWithMargin<mainAxis>(child);
+        crossDim = fmaxf(crossDim, boundAxis<crossAxis>(child, getDimWithMargin<crossAxis>(child)));
+      }
+
+      if (isSimpleStackCross) {
+        child->layout.position[pos(crossAxis)] += linesCrossDim + leadingPaddingAndBorderCross;
+        if (isCrossDimDefined) {
+          setTrailingPosition<crossAxis>(node, child);
+        }
+      }
+
+      alreadyComputedNextLayout = 0;
+      mainContentDim += nextContentDim;
+      endLine = i + 1;
+    }
+
+    // <Loop B> Layout flexible children and allocate empty space
+    float leadingMainDim = 0;
+    float betweenMainDim = 0;
+
+    float remainingMainDim = 0;
+    if (isMainDimDefined) {
+      remainingMainDim = definedMainDim - mainContentDim;
+    } else {
+      remainingMainDim = fmaxf(mainContentDim, 0) - mainContentDim;
+    }
+
+    if (flexibleChildrenCount != 0) {
+      float flexibleMainDim = remainingMainDim / totalFlexible;
+      float baseMainDim;
+      float boundMainDim;
+
+      currentFlexChild = firstFlexChild;
+      while (currentFlexChild != NULL) {
+        baseMainDim = flexibleMainDim * currentFlexChild->style.flex +
+            getPaddingAndBorderAxis<mainAxis>(currentFlexChild);
+        boundMainDim = boundAxis<mainAxis>(currentFlexChild, baseMainDim);
+
+        if (baseMainDim != boundMainDim) {
+          remainingMainDim -= boundMainDim;
+          totalFlexible -= currentFlexChild->style.flex;
+        }
+
+        currentFlexChild = currentFlexChild->next_flex_child;
+      }
+      flexibleMainDim = remainingMainDim / totalFlexible;
+
+      if (flexibleMainDim < 0) {
+        flexibleMainDim = 0;
+      }
+
+      currentFlexChild = firstFlexChild;
+      while (currentFlexChild != NULL) {
+        currentFlexChild->layout.dimensions[dim(mainAxis)] = boundAxis<mainAxis>(currentFlexChild,
+          flexibleMainDim * currentFlexChild->style.flex +
+              getPaddingAndBorderAxis<mainAxis>(currentFlexChild)
+        );
+
+        maxWidth = CSS_UNDEFINED;
+        if (isLayoutDimDefined<resolvedRowAxis>(node)) {
+          maxWidth = node->layout.dimensions[dim(resolvedRowAxis)] -
+            paddingAndBorderAxisResolvedRow;
+        } else if (!isMainRowDirection) {
+          maxWidth = parentMaxWidth -
+            getMarginAxis<resolvedRowAxis>(node) -
+            paddingAndBorderAxisResolvedRow;
+        }
+        maxHeight = CSS_UNDEFINED;
+        if (isLayoutDimDefined<COLUMN>(node)) {
+          maxHeight = node->layout.dimensions[dim(COLUMN)] -
+            paddingAndBorderAxisColumn;
+        } else if (isMainRowDirection) {
+          maxHeight = parentMaxHeight -
+            getMarginAxis<COLUMN>(node) -
+            paddingAndBorderAxisColumn;
+        }
+
+        layoutNodeCached(currentFlexChild, maxWidth, maxHeight, direction);
+
+        child = currentFlexChild;
+        currentFlexChild = currentFlexChild->next_flex_child;
+        child->next_flex_child = NULL;
+      }
+
+    } else if (justifyContent != CSS_JUSTIFY_FLEX_START) {
+      if (justifyContent == CSS_JUSTIFY_CENTER) {
+        leadingMainDim = remainingMainDim / 2;
+      } else if (justifyContent == CSS_JUSTIFY_FLEX_END) {
+        leadingMainDim = remainingMainDim;
+      } else if (justifyContent == CSS_JUSTIFY_SPACE_BETWEEN) {
+        remainingMainDim = fmaxf(remainingMainDim, 0);
+        if (flexibleChildrenCount + nonFlexibleChildrenCount - 1 != 0) {
+          betweenMainDim = remainingMainDim /
+            (flexibleChildrenCount + nonFlexibleChildrenCount - 1);
+        } else {
+          betweenMainDim = 0;
+        }
+      } else if (justifyContent == CSS_JUSTIFY_SPACE_AROUND) {
+        betweenMainDim = remainingMainDim /
+          (flexibleChildrenCount + nonFlexibleChildrenCount);
+        leadingMainDim = betweenMainDim / 2;
+      }
+    }
+
+    // <Loop C> Position elements in the main axis and compute dimensions
+    mainDim += leadingMainDim;
+
+    for (i = firstComplexMain; i < endLine; ++i) {
+      child = node->get_child(node->context, i);
+
+      if (child->style.position_type == CSS_POSITION_ABSOLUTE &&
+          isPosDefined(child, leading(mainAxis))) {
+        child->layout.position[pos(mainAxis)] = getPosition(child, leading(mainAxis)) +
+          getLeadingBorder<mainAxis>(node) +
+          getLeadingMargin<mainAxis>(child);
+      } else {
+        child->layout.position[pos(mainAxis)] += mainDim;
+
+        if (isMainDimDefined) {
+          setTrailingPosition<mainAxis>(node, child);
+        }
+
+        if (child->style.position_type == CSS_POSITION_RELATIVE) {
+          mainDim += betweenMainDim + getDimWithMargin<mainAxis>(child);
+          crossDim = fmaxf(crossDim, boundAxis<crossAxis>(child, getDimWithMargin<crossAxis>(child)));
+        }
+      }
+    }
+
+    float containerCrossAxis = node->layout.dimensions[dim(crossAxis)];
+    if (!isCrossDimDefined) {
+      containerCrossAxis = fmaxf(
+        boundAxis<crossAxis>(node, crossDim + paddingAndBorderAxisCross),
+        paddingAndBorderAxisCross
+      );
+    }
+
+    // <Loop D> Position elements in the cross axis
+    for (i = firstComplexCross; i < endLine; ++i) {
+      child = node->get_child(node->context, i);
+
+      if (child->style.position_type == CSS_POSITION_ABSOLUTE &&
+          isPosDefined(child, leading(crossAxis))) {
+        child->layout.position[pos(crossAxis)] = getPosition(child, leading(crossAxis)) +
+          getLeadingBorder<crossAxis>(node) +
+          getLeadingMargin<crossAxis>(child);
+
+      } else {
+        float leadingCrossDim = leadingPaddingAndBorderCross;
+
+        if (child->style.position_type == CSS_POSITION_RELATIVE) {
+          css_align_t alignItem = getAlignItem(node, child);
+          if (alignItem == CSS_ALIGN_STRETCH) {
+            if (!isStyleDimDefined<crossAxis>(child)) {
+              float dimCrossAxis = child->layout.dimensions[dim(crossAxis)];
+              child->layout.dimensions[dim(crossAxis)] = fmaxf(
+                boundAxis<crossAxis>(child, containerCrossAxis -
+                  paddingAndBorderAxisCross - getMarginAxis<crossAxis>(child)),
+                getPaddingAndBorderAxis<crossAxis>(child)
+              );
+
+              if (dimCrossAxis != child->layout.dimensions[dim(crossAxis)] && child->children_count > 0) {
+                removeMarginAndRelativePosition<mainAxis>(child);
+                removeMarginAndRelativePosition<crossAxis>(child);
+
+                layoutNodeCached(child, maxWidth, maxHeight, direction);
+              }
+            }
+          } else if (alignItem != CSS_ALIGN_FLEX_START) {
+            float remainingCrossDim = containerCrossAxis -
+              paddingAndBorderAxisCross - getDimWithMargin<crossAxis>(child);
+
+            if (alignItem == CSS_ALIGN_CENTER) {
+              leadingCrossDim += remainingCrossDim / 2;
+            } else { // CSS_ALIGN_FLEX_END
+              leadingCrossDim += remainingCrossDim;
+            }
+          }
+        }
+
+        child->layout.position[pos(crossAxis)] += linesCrossDim + leadingCrossDim;
+
+        if (isCrossDimDefined) {
+          setTrailingPosition<crossAxis>(node, child);
+        }
+      }
+    }
+
+    linesCrossDim += crossDim;
+    linesMainDim = fmaxf(linesMainDim, mainDim);
+    linesCount += 1;
+    startLine = endLine;
+  }
+
+  // <Loop E> Lay out the lines along the cross axis according to alignContent
+  if (linesCount > 1 && isCrossDimDefined) {
+    float nodeCrossAxisInnerSize = node->layout.dimensions[dim(crossAxis)] -
+        paddingAndBorderAxisCross;
+    float remainingAlignContentDim = nodeCrossAxisInnerSize - linesCrossDim;
+
+    float crossDimLead = 0;
+    float currentLead = leadingPaddingAndBorderCross;
+
+    css_align_t alignContent = node->style.align_content;
+    if (alignContent == CSS_ALIGN_FLEX_END) {
+      currentLead += remainingAlignContentDim;
+    } else if (alignContent == CSS_ALIGN_CENTER) {
+      currentLead += remainingAlignContentDim / 2;
+    } else if (alignContent == CSS_ALIGN_STRETCH) {
+      if (nodeCrossAxisInnerSize > linesCrossDim) {
+        crossDimLead = (remainingAlignContentDim / linesCount);
+      }
+    }
+
+    int endIndex = 0;
+    for (i = 0; i < linesCount; ++i) {
+      int startIndex = endIndex;
+
+      float lineHeight = 0;
+      for (ii = startIndex; ii < childCount; ++ii) {
+        child = node->get_child(node->context, ii);
+        if (child->style.position_type != CSS_POSITION_RELATIVE) {
+          continue;
+        }
+        if (child->line_index != i) {
+          break;
+        }
+        if (isLayoutDimDefined<crossAxis>(child)) {
+          lineHeight = fmaxf(
+            lineHeight,
+            child->layout.dimensions[dim(crossAxis)] + getMarginAxis<crossAxis>(child)
+          );
+        }
+      }
+      endIndex = ii;
+      lineHeight += crossDimLead;
+
+      for (ii = startIndex; ii < endIndex; ++ii) {
+        child = node->get_child(node->context, ii);
+        if (child->style.position_type != CSS_POSITION_RELATIVE) {
+          continue;
+        }
+
+        css_align_t alignContentAlignItem = getAlignItem(node, child);
+        if (alignContentAlignItem == CSS_ALIGN_FLEX_START) {
+          child->layout.position[pos(crossAxis)] = currentLead + getLeadingMargin<crossAxis>(child);
+        } else if (alignContentAlignItem == CSS_ALIGN_FLEX_END) {
+          child->layout.position[pos(crossAxis)] = currentLead + lineHeight - getTrailingMargin<crossAxis>(child) - child->layout.dimensions[dim(crossAxis)];
+        } else if (alignContentAlignItem == CSS_ALIGN_CENTER) {
+          float childHeight = child->layout.dimensions[dim(crossAxis)];
+          child->layout.position[pos(crossAxis)] = currentLead + (lineHeight - childHeight) / 2;
+        } else if (alignContentAlignItem == CSS_ALIGN_STRETCH) {
+          child->layout.position[pos(crossAxis)] = currentLead + getLeadingMargin<crossAxis>(child);
+        }
+      }
+
+      currentLead += lineHeight;
+    }
+  }
+
+  bool needsMainTrailingPos = false;
+  bool needsCrossTrailingPos = false;
+
+  if (!isMainDimDefined) {
+    node->layout.dimensions[dim(mainAxis)] = fmaxf(
+      boundAxis<mainAxis>(node, linesMainDim + getTrailingPaddingAndBorder<mainAxis>(node)),
+      paddingAndBorderAxisMain
+    );
+
+    if (mainAxis == ROW_REVERSE ||
+        mainAxis == COLUMN_REVERSE) {
+      needsMainTrailingPos = true;
+    }
+  }
+
+  if (!isCrossDimDefined) {
+    node->layout.dimensions[dim(crossAxis)] = fmaxf(
+      boundAxis<crossAxis>(node, linesCrossDim + paddingAndBorderAxisCross),
+      paddingAndBorderAxisCross
+    );
+
+    if (crossAxis == ROW_REVERSE ||
+        crossAxis == COLUMN_REVERSE) {
+      needsCrossTrailingPos = true;
+    }
+  }
+
+  // <Loop F> Set trailing position if necessary
+  if (needsMainTrailingPos || needsCrossTrailingPos) {
+    for (i = 0; i < childCount; ++i) {
+      child = node->get_child(node->context, i);
+
+      if (needsMainTrailingPos) {
+        setTrailingPosition<mainAxis>(node, child);
+      }
+
+      if (needsCrossTrailingPos) {
+        setTrailingPosition<crossAxis>(node, child);
+      }
+    }
+  }
+
+  // <Loop G> Calculate dimensions for absolutely positioned elements
+  currentAbsoluteChild = firstAbsoluteChild;
+  while (currentAbsoluteChild != NULL) {
+    layoutAbsoluteChild<COLUMN>(node, currentAbsoluteChild);
+    layoutAbsoluteChild<ROW>(node, currentAbsoluteChild);
+
+    child = currentAbsoluteChild;
+    currentAbsoluteChild = currentAbsoluteChild->next_absolute_child;
+    child->next_absolute_child = NULL;
+  }
+}
+
+// Resolves the axis configuration of `node` once and jumps into the matching
+// specialization of the kernel.
+void dispatchLayoutNodeImpl(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+  css_direction_t direction = resolveDirection(node, parentDirection);
+  css_flex_direction_t mainAxis = resolveAxis(node->style.flex_direction, direction);
+  bool isRTL = resolveAxis(ROW, direction) == ROW_REVERSE;
+
+  switch (mainAxis) {
+    case CSS_FLEX_DIRECTION_COLUMN:
+      return isRTL ?
+        layoutNodeImpl<COLUMN, ROW_REVERSE>(node, parentMaxWidth, parentMaxHeight, direction) :
+        layoutNodeImpl<COLUMN, ROW>(node, parentMaxWidth, parentMaxHeight, direction);
+    case CSS_FLEX_DIRECTION_COLUMN_REVERSE:
+      return isRTL ?
+        layoutNodeImpl<COLUMN_REVERSE, ROW_REVERSE>(node, parentMaxWidth, parentMaxHeight, direction) :
+        layoutNodeImpl<COLUMN_REVERSE, ROW>(node, parentMaxWidth, parentMaxHeight, direction);
+    case CSS_FLEX_DIRECTION_ROW:
+      return isRTL ?
+        layoutNodeImpl<ROW, ROW_REVERSE>(node, parentMaxWidth, parentMaxHeight, direction) :
+        layoutNodeImpl<ROW, ROW>(node, parentMaxWidth, parentMaxHeight, direction);
+    case CSS_FLEX_DIRECTION_ROW_REVERSE:
+      return isRTL ?
+        layoutNodeImpl<ROW_REVERSE, ROW_REVERSE>(node, parentMaxWidth, parentMaxHeight, direction) :
+        layoutNodeImpl<ROW_REVERSE, ROW>(node, parentMaxWidth, parentMaxHeight, direction);
+  }
+}
+
+// Same caching front-end as `layoutNode` in Layout.c.
+void layoutNodeCached(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+  css_layout_t *layout = &node->layout;
+  css_direction_t direction = node->style.direction;
+  layout->should_update = true;
+
+  if (layout->deferred) {
+    // Finish the pass the subtree skipped in a culled layout first, its
+    // result depends on it
+    layoutDeferredNodes(node);
+  }
+
+  bool skipLayout =
+    !node->is_dirty(node->context) &&
+    eq(layout->last_requested_dimensions[CSS_WIDTH], layout->dimensions[CSS_WIDTH]) &&
+    eq(layout->last_requested_dimensions[CSS_HEIGHT], layout->dimensions[CSS_HEIGHT]) &&
+    eq(layout->last_parent_max_width, parentMaxWidth) &&
+    eq(layout->last_parent_max_height, parentMaxHeight) &&
+    eq(layout->last_direction, direction);
+
+  if (skipLayout) {
+    layout->dimensions[CSS_WIDTH] = layout->last_dimensions[CSS_WIDTH];
+    layout->dimensions[CSS_HEIGHT] = layout->last_dimensions[CSS_HEIGHT];
+    layout->position[CSS_TOP] = layout->last_position[CSS_TOP];
+    layout->position[CSS_LEFT] = layout->last_position[CSS_LEFT];
+  } else {
+    layout->last_requested_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
+    layout->last_requested_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
+    layout->last_parent_max_width = parentMaxWidth;
+    layout->last_parent_max_height = parentMaxHeight;
+    layout->last_direction = direction;
+
+    for (int i = 0, childCount = node->children_count; i < childCount; i++) {
+      resetNodeLayout(node->get_child(node->context, i));
+    }
+
+    dispatchLayoutNodeImpl(node, parentMaxWidth, parentMaxHeight, parentDirection);
+
+    layout->last_dimensions[CSS_WIDTH] = layout->dimensions[CSS_WIDTH];
+    layout->last_dimensions[CSS_HEIGHT] = layout->dimensions[CSS_HEIGHT];
+    layout->last_position[CSS_TOP] = layout->position[CSS_TOP];
+    layout->last_position[CSS_LEFT] = layout->position[CSS_LEFT];
+  }
+}
+
+} // namespace
+
+void layoutNodeSpecialized(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection) {
+  layoutNodeCached(node, parentMaxWidth, parentMaxHeight, parentDirection);
+}
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __LAYOUT_SPECIALIZED_H
+#define __LAYOUT_SPECIALIZED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Layout.h"
+
+/**
+ * Drop-in replacement for `layoutNode` backed by a C++ kernel in which the
+ * main axis and the resolved row axis are template parameters. All the
+ * `leading`/`trailing`/`pos`/`dim` lookups of Layout.c fold to constants and
+ * the axis configuration is dispatched once per node.
+ *
+ * The kernel mirrors Layout.c operation for operation and must produce
+ * bit-for-bit identical `css_layout_t` output; it shares the `last_*` layout
+ * cache with the C engine, so both can be used on the same tree. It does not
+ * feed `layoutNodeWithChanges` change lists and never defers subtrees the way
+ * `layoutNodeCulled` does; deferred subtrees it visits are finished first.
+ */
+void layoutNodeSpecialized(css_node_t *node, float parentMaxWidth, float parentMaxHeight, css_direction_t parentDirection);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
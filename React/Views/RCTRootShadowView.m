@@ -9,7 +9,48 @@
 
 #import "RCTRootShadowView.h"
 
+// Sum of the layout positions of shadowView and its superviews, i.e. the
+// absolutePosition that applyLayoutNode: passes to the subviews of shadowView
+static CGPoint RCTGetAbsolutePosition(RCTShadowView *shadowView)
+{
+  CGPoint position = CGPointZero;
+  for (; shadowView; shadowView = shadowView.reactSuperview) {
+    position.x += shadowView.cssNode->layout.position[CSS_LEFT];
+    position.y += shadowView.cssNode->layout.position[CSS_TOP];
+  }
+  return position;
+}
+
+// Views laid out again without a new frame aren't applied, but they have to
+// be marked computed all the same. A dirty view always has a dirty superview,
+// so the clean parts of the tree don't need to be visited.
+static void RCTSetLayoutComputed(RCTShadowView *shadowView)
+{
+  [shadowView setLayoutComputed];
+  for (RCTShadowView *subview in shadowView.reactSubviews) {
+    if (subview.isLayoutDirty) {
+      RCTSetLayoutComputed(subview);
+    }
+  }
+}
+
 @implementation RCTRootShadowView
+{
+  css_layout_changes_t _layoutChanges;
+}
+
+- (instancetype)init
+{
+  if ((self = [super init])) {
+    init_css_layout_changes(&_layoutChanges);
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  free_css_layout_changes(&_layoutChanges);
+}
 
 - (void)applySizeConstraints
 {
@@ -35,10 +76,26 @@
 
   [self fillCSSNode:self.cssNode];
   resetNodeLayout(self.cssNode);
-  layoutNode(self.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT);
+  layoutNodeWithChanges(self.cssNode, CSS_UNDEFINED, CSS_UNDEFINED, CSS_DIRECTION_INHERIT, &_layoutChanges);
 
   NSMutableSet<RCTShadowView *> *viewsWithNewFrame = [NSMutableSet set];
-  [self applyLayoutNode:self.cssNode viewsWithNewFrame:viewsWithNewFrame absolutePosition:CGPointZero];
+  if (_layoutChanges.overflowed) {
+    // The pass lost track of some nodes, so the whole tree has to be walked
+    [self applyLayoutNode:self.cssNode viewsWithNewFrame:viewsWithNewFrame absolutePosition:CGPointZero];
+    return viewsWithNewFrame;
+  }
+
+  // Only the views whose frame changed, and the views below them: frames are
+  // rounded relative to the screen, so moving a view can change the rounded
+  // frames of its subviews too.
+  for (int i = 0; i < getLayoutChangeCount(&_layoutChanges); i++) {
+    css_node_t *node = getLayoutChange(&_layoutChanges, i)->node;
+    RCTShadowView *shadowView = (__bridge RCTShadowView *)node->context;
+    [shadowView applyLayoutNode:node
+              viewsWithNewFrame:viewsWithNewFrame
+               absolutePosition:RCTGetAbsolutePosition(shadowView.reactSuperview)];
+  }
+  RCTSetLayoutComputed(self);
   return viewsWithNewFrame;
 }
 
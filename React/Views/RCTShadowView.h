@@ -145,6 +145,7 @@ typedef void (^RCTApplierBlock)(NSDictionary<NSNumber *, UIView *> *viewRegistry
  */
 - (void)fillCSSNode:(css_node_t *)node NS_REQUIRES_SUPER;
 - (void)dirtyLayout NS_REQUIRES_SUPER;
+- (void)setLayoutComputed NS_REQUIRES_SUPER;
 - (BOOL)isLayoutDirty;
 
 - (void)dirtyPropagation NS_REQUIRES_SUPER;
@@ -273,6 +273,11 @@ static void RCTProcessMetaProps(const float metaProps[META_PROP_COUNT], float st
   }
 }
 
+- (void)setLayoutComputed
+{
+  _layoutLifecycle = RCTUpdateLifecycleComputed;
+}
+
 - (BOOL)isLayoutDirty
 {
   return _layoutLifecycle != RCTUpdateLifecycleComputed;
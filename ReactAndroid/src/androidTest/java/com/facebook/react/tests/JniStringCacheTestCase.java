@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.tests;
+
+import java.util.Arrays;
+import java.util.HashSet;
+import java.util.Set;
+
+import com.facebook.react.bridge.JniStringCache;
+import com.facebook.react.bridge.ReadableMapKeySetIterator;
+import com.facebook.react.bridge.WritableNativeMap;
+import com.facebook.react.testing.ReactIntegrationTestCase;
+
+/**
+ * Tests for {@link JniStringCache}, which map keys are converted through.
+ */
+public class JniStringCacheTestCase extends ReactIntegrationTestCase {
+
+  public void testRepeatedKeysHitTheCache() {
+    WritableNativeMap map = new WritableNativeMap();
+    map.putDouble("width", 1);
+
+    long hits = JniStringCache.getHitCount();
+    for (int i = 0; i < 100; i++) {
+      assertEquals(1.0, map.getDouble("width"));
+    }
+    assertTrue(JniStringCache.getHitCount() - hits >= 100);
+  }
+
+  public void testNonAsciiKeysRoundTrip() {
+    String[] keys = {"café", "日本", "emoji\uD83D\uDE00"};
+    WritableNativeMap map = new WritableNativeMap();
+    for (int i = 0; i < keys.length; i++) {
+      map.putInt(keys[i], i);
+    }
+    // Looked up a second time to go through cache hits
+    for (int i = 0; i < keys.length; i++) {
+      assertTrue(map.hasKey(keys[i]));
+      assertEquals(i, map.getInt(keys[i]));
+    }
+
+    Set<String> iterated = new HashSet<>();
+    ReadableMapKeySetIterator iterator = map.keySetIterator();
+    while (iterator.hasNextKey()) {
+      iterated.add(iterator.nextKey());
+    }
+    assertEquals(new HashSet<>(Arrays.asList(keys)), iterated);
+  }
+}
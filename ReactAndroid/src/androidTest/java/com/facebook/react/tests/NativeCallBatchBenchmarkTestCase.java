@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.tests;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+import android.util.Log;
+
+import com.facebook.react.bridge.BaseJavaModule;
+import com.facebook.react.bridge.JavaScriptModule;
+import com.facebook.react.bridge.ReactMethod;
+import com.facebook.react.bridge.ReadableMap;
+import com.facebook.react.testing.ReactAppInstrumentationTestCase;
+import com.facebook.react.testing.ReactInstanceSpecForTest;
+
+/**
+ * Sends large batches of native module calls from JS and measures how long it takes for all of
+ * them to be dispatched to Java. The whole batch is delivered to Java with a single JNI upcall.
+ */
+public class NativeCallBatchBenchmarkTestCase extends ReactAppInstrumentationTestCase {
+
+  private static final String TAG = "NativeCallBatchBenchmark";
+
+  private static interface NativeCallBatchTestModule extends JavaScriptModule {
+    public void sendCalls(int count);
+  }
+
+  private static class NativeCallBatchRecordingModule extends BaseJavaModule {
+
+    private final List<Integer> mIndices = new ArrayList<>();
+    private volatile CountDownLatch mDone;
+    private volatile long mDoneNanos;
+
+    @Override
+    public String getName() {
+      return "NativeCallBatchRecordingModule";
+    }
+
+    @ReactMethod
+    public void record(int index, ReadableMap style) {
+      assertEquals((double) index, style.getDouble("width"));
+      mIndices.add(index);
+    }
+
+    @ReactMethod
+    public void done() {
+      mDoneNanos = System.nanoTime();
+      mDone.countDown();
+    }
+
+    public void reset() {
+      mIndices.clear();
+      mDone = new CountDownLatch(1);
+    }
+  }
+
+  private final NativeCallBatchRecordingModule mRecordingModule =
+      new NativeCallBatchRecordingModule();
+
+  @Override
+  protected ReactInstanceSpecForTest createReactInstanceSpecForTest() {
+    return super.createReactInstanceSpecForTest()
+        .addNativeModule(mRecordingModule)
+        .addJSModule(NativeCallBatchTestModule.class);
+  }
+
+  @Override
+  protected String getReactApplicationKeyUnderTest() {
+    return "NativeCallBatchTestApp";
+  }
+
+  private long sendCalls(int count) throws InterruptedException {
+    mRecordingModule.reset();
+    long start = System.nanoTime();
+    getReactContext().getCatalystInstance().getJSModule(NativeCallBatchTestModule.class)
+        .sendCalls(count);
+    assertTrue(mRecordingModule.mDone.await(10, TimeUnit.SECONDS));
+    waitForBridgeAndUIIdle();
+
+    assertEquals(count, mRecordingModule.mIndices.size());
+    for (int i = 0; i < count; i++) {
+      assertEquals(i, (int) mRecordingModule.mIndices.get(i));
+    }
+    return mRecordingModule.mDoneNanos - start;
+  }
+
+  public void testBatchedCalls() throws InterruptedException {
+    // Warm up the JIT and the JS side
+    sendCalls(100);
+
+    for (int count : new int[] {100, 500, 2000}) {
+      long nanos = sendCalls(count);
+      Log.i(TAG, count + " calls: " + nanos / 1000 + "us, " + nanos / count + "ns per call");
+    }
+  }
+}
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.tests;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+
+import android.util.Log;
+
+import com.facebook.react.bridge.ReadableArray;
+import com.facebook.react.bridge.ReadableMap;
+import com.facebook.react.bridge.ReadableMapKeySetIterator;
+import com.facebook.react.bridge.WritableNativeArray;
+import com.facebook.react.bridge.WritableNativeMap;
+import com.facebook.react.testing.ReactIntegrationTestCase;
+
+/**
+ * Compares {@link com.facebook.react.bridge.ReadableNativeMap#toHashMap()}, which converts the
+ * whole map in one native call, with reading the map key by key through the {@link ReadableMap}
+ * interface, for prop maps of typical sizes.
+ */
+public class NativeMapToHashMapBenchmarkTestCase extends ReactIntegrationTestCase {
+
+  private static final String TAG = "NativeMapToHashMapBenchmark";
+  private static final int ITERATIONS = 200;
+
+  private static WritableNativeMap createProps(int keyCount) {
+    WritableNativeMap props = new WritableNativeMap();
+    for (int i = 0; i < keyCount; i++) {
+      String key = "prop" + i;
+      switch (i % 6) {
+        case 0:
+          props.putDouble(key, i * 1.5);
+          break;
+        case 1:
+          props.putInt(key, i);
+          break;
+        case 2:
+          props.putString(key, "value" + i);
+          break;
+        case 3:
+          props.putBoolean(key, i % 2 == 0);
+          break;
+        case 4:
+          props.putNull(key);
+          break;
+        default:
+          WritableNativeMap style = new WritableNativeMap();
+          style.putDouble("width", i);
+          WritableNativeArray transform = new WritableNativeArray();
+          transform.pushDouble(1);
+          transform.pushString("rotate");
+          style.putArray("transform", transform);
+          props.putMap(key, style);
+          break;
+      }
+    }
+    return props;
+  }
+
+  private static HashMap<String, Object> readKeyByKey(ReadableMap map) {
+    ReadableMapKeySetIterator iterator = map.keySetIterator();
+    HashMap<String, Object> hashMap = new HashMap<>();
+    while (iterator.hasNextKey()) {
+      String key = iterator.nextKey();
+      switch (map.getType(key)) {
+        case Null:
+          hashMap.put(key, null);
+          break;
+        case Boolean:
+          hashMap.put(key, map.getBoolean(key));
+          break;
+        case Number:
+          hashMap.put(key, map.getDouble(key));
+          break;
+        case String:
+          hashMap.put(key, map.getString(key));
+          break;
+        case Map:
+          hashMap.put(key, readKeyByKey(map.getMap(key)));
+          break;
+        case Array:
+          hashMap.put(key, readIndexByIndex(map.getArray(key)));
+          break;
+      }
+    }
+    return hashMap;
+  }
+
+  private static ArrayList<Object> readIndexByIndex(ReadableArray array) {
+    ArrayList<Object> arrayList = new ArrayList<>();
+    for (int i = 0; i < array.size(); i++) {
+      switch (array.getType(i)) {
+        case Null:
+          arrayList.add(null);
+          break;
+        case Boolean:
+          arrayList.add(array.getBoolean(i));
+          break;
+        case Number:
+          arrayList.add(array.getDouble(i));
+          break;
+        case String:
+          arrayList.add(array.getString(i));
+          break;
+        case Map:
+          arrayList.add(readKeyByKey(array.getMap(i)));
+          break;
+        case Array:
+          arrayList.add(readIndexByIndex(array.getArray(i)));
+          break;
+      }
+    }
+    return arrayList;
+  }
+
+  public void testToHashMapMatchesKeyByKeyRead() {
+    WritableNativeMap props = createProps(50);
+    assertEquals(readKeyByKey(props), props.toHashMap());
+  }
+
+  public void testToHashMapPerformance() {
+    for (int keyCount : new int[] {20, 35, 50}) {
+      WritableNativeMap props = createProps(keyCount);
+
+      long start = System.nanoTime();
+      for (int i = 0; i < ITERATIONS; i++) {
+        readKeyByKey(props);
+      }
+      long keyByKeyNanos = (System.nanoTime() - start) / ITERATIONS;
+
+      start = System.nanoTime();
+      for (int i = 0; i < ITERATIONS; i++) {
+        props.toHashMap();
+      }
+      long bulkNanos = (System.nanoTime() - start) / ITERATIONS;
+
+      Log.i(
+          TAG,
+          keyCount + " keys: key by key " + keyByKeyNanos / 1000 + "us, bulk " +
+              bulkNanos / 1000 + "us");
+    }
+  }
+}
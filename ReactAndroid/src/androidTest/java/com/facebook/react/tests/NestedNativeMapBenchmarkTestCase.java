@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.tests;
+
+import android.util.Log;
+
+import com.facebook.react.bridge.ReactBridge;
+import com.facebook.react.bridge.ReadableArray;
+import com.facebook.react.bridge.ReadableMap;
+import com.facebook.react.bridge.WritableNativeArray;
+import com.facebook.react.bridge.WritableNativeMap;
+import com.facebook.react.testing.ReactIntegrationTestCase;
+
+/**
+ * Reads deeply nested props payloads, the way UIManagerModule.updateView does with styles. Nested
+ * ReadableNativeMap/ReadableNativeArray objects reference their parent's native value, so walking
+ * down N levels must stay linear in N: reading never copies a native value.
+ */
+public class NestedNativeMapBenchmarkTestCase extends ReactIntegrationTestCase {
+
+  private static final String TAG = "NestedNativeMapBenchmark";
+  private static final int ITERATIONS = 50;
+
+  private static WritableNativeMap createProps(int depth) {
+    WritableNativeMap props = new WritableNativeMap();
+    props.putInt("depth", depth);
+    props.putString("testID", "view" + depth);
+
+    WritableNativeMap style = new WritableNativeMap();
+    style.putDouble("width", 100);
+    style.putDouble("height", 50);
+    style.putString("backgroundColor", "#ff0000");
+    WritableNativeArray transform = new WritableNativeArray();
+    for (int i = 0; i < 4; i++) {
+      WritableNativeMap scale = new WritableNativeMap();
+      scale.putDouble("scale", i);
+      transform.pushMap(scale);
+    }
+    style.putArray("transform", transform);
+    props.putMap("style", style);
+
+    if (depth > 0) {
+      WritableNativeArray children = new WritableNativeArray();
+      children.pushMap(createProps(depth - 1));
+      props.putArray("children", children);
+    }
+    return props;
+  }
+
+  private static int walk(ReadableMap props) {
+    ReadableMap style = props.getMap("style");
+    ReadableArray transform = style.getArray("transform");
+    int count = (int) transform.getMap(transform.size() - 1).getDouble("scale");
+    if (props.hasKey("children")) {
+      count += walk(props.getArray("children").getMap(0));
+    }
+    return count;
+  }
+
+  private long timeWalk(ReadableMap props, int expected) {
+    long start = System.nanoTime();
+    for (int i = 0; i < ITERATIONS; i++) {
+      assertEquals(expected, walk(props));
+    }
+    return (System.nanoTime() - start) / ITERATIONS;
+  }
+
+  public void testNestedAccessIsLinearInDepth() {
+    for (int depth : new int[] {16, 64, 256}) {
+      WritableNativeMap props = createProps(depth);
+      long copies = ReactBridge.getNativeValueCopyCount();
+      long nanos = timeWalk(props, 3 * (depth + 1));
+      assertEquals(copies, ReactBridge.getNativeValueCopyCount());
+      Log.i(TAG, "depth " + depth + ": " + nanos / 1000 + "us per walk");
+    }
+  }
+
+  public void testNestedMapDoesNotSeeLaterWrites() {
+    WritableNativeMap props = createProps(1);
+    ReadableMap style = props.getMap("style");
+    long copies = ReactBridge.getNativeValueCopyCount();
+    props.putMap("style", new WritableNativeMap());
+    props.putInt("depth", 42);
+    // Only the first write copies props, while style still references it
+    assertEquals(copies + 1, ReactBridge.getNativeValueCopyCount());
+
+    assertEquals(100.0, style.getDouble("width"));
+    assertFalse(props.getMap("style").hasKey("width"));
+    assertEquals(42, props.getInt("depth"));
+  }
+}
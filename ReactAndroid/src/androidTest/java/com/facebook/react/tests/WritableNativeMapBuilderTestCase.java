@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2014-present, Facebook, Inc.
+ * All rights reserved.
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.tests;
+
+import android.util.Log;
+
+import com.facebook.react.bridge.ObjectAlreadyConsumedException;
+import com.facebook.react.bridge.WritableNativeArray;
+import com.facebook.react.bridge.WritableNativeArrayBuilder;
+import com.facebook.react.bridge.WritableNativeMap;
+import com.facebook.react.bridge.WritableNativeMapBuilder;
+import com.facebook.react.testing.ReactIntegrationTestCase;
+
+/**
+ * Checks that {@link WritableNativeMapBuilder} and {@link WritableNativeArrayBuilder} produce the
+ * same values as the corresponding {@link WritableNativeMap} and {@link WritableNativeArray}
+ * methods, and compares their cost for event sized payloads.
+ */
+public class WritableNativeMapBuilderTestCase extends ReactIntegrationTestCase {
+
+  private static final String TAG = "WritableNativeMapBuilder";
+  private static final int FIELD_COUNT = 30;
+  private static final int ITERATIONS = 500;
+
+  private static WritableNativeMap createWithPuts() {
+    WritableNativeMap map = new WritableNativeMap();
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      map.putDouble("double" + i, i * 0.5);
+    }
+    map.putInt("target", 42);
+    map.putBoolean("flag", true);
+    map.putString("type", "topScroll");
+    map.putNull("nothing");
+    WritableNativeMap nested = new WritableNativeMap();
+    nested.putDouble("x", 1);
+    map.putMap("nested", nested);
+    WritableNativeArray array = new WritableNativeArray();
+    array.pushInt(1);
+    array.pushString("two");
+    WritableNativeMap inArray = new WritableNativeMap();
+    inArray.putBoolean("three", false);
+    array.pushMap(inArray);
+    map.putArray("array", array);
+    return map;
+  }
+
+  private static WritableNativeMap createWithBuilder() {
+    WritableNativeMapBuilder builder = new WritableNativeMapBuilder();
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      builder.putDouble("double" + i, i * 0.5);
+    }
+    return builder
+        .putInt("target", 42)
+        .putBoolean("flag", true)
+        .putString("type", "topScroll")
+        .putNull("nothing")
+        .putMap("nested", new WritableNativeMapBuilder().putDouble("x", 1))
+        .putArray(
+            "array",
+            new WritableNativeArrayBuilder()
+                .pushInt(1)
+                .pushString("two")
+                .pushMap(new WritableNativeMapBuilder().putBoolean("three", false)))
+        .build();
+  }
+
+  public void testBuilderMatchesPuts() {
+    assertEquals(createWithPuts().toString(), createWithBuilder().toString());
+  }
+
+  public void testBuilderConsumesNativeValuesWhenPut() {
+    WritableNativeMap nested = new WritableNativeMap();
+    nested.putInt("x", 1);
+    WritableNativeMapBuilder builder = new WritableNativeMapBuilder().putMap("nested", nested);
+    try {
+      nested.putInt("y", 2);
+      fail("Expected the map to have been consumed");
+    } catch (ObjectAlreadyConsumedException e) {
+      // expected
+    }
+    try {
+      builder.putMap("again", nested);
+      fail("Expected the map to have been consumed");
+    } catch (ObjectAlreadyConsumedException e) {
+      // expected
+    }
+
+    WritableNativeMap map = builder.build();
+    assertEquals(1, map.getMap("nested").getInt("x"));
+    assertFalse(map.hasKey("again"));
+  }
+
+  public void testBuilderPutsNullForMissingBuilders() {
+    WritableNativeMap map = new WritableNativeMapBuilder()
+        .putMap("map", (WritableNativeMapBuilder) null)
+        .putArray("array", (WritableNativeArrayBuilder) null)
+        .build();
+    assertTrue(map.isNull("map"));
+    assertTrue(map.isNull("array"));
+  }
+
+  public void testBuilderMergesLikeMergeMap() {
+    WritableNativeMap source = new WritableNativeMap();
+    source.putInt("a", 2);
+    source.putString("b", "source");
+
+    WritableNativeMap expected = new WritableNativeMap();
+    expected.putInt("a", 1);
+    expected.merge(source);
+    expected.putInt("c", 3);
+
+    WritableNativeMap map = new WritableNativeMapBuilder()
+        .putInt("a", 1)
+        .merge(source)
+        .putInt("c", 3)
+        .build();
+    assertEquals(expected.toString(), map.toString());
+    // The source map is not consumed
+    assertEquals("source", source.getString("b"));
+  }
+
+  public void testBuilderCommitsToExistingArray() {
+    WritableNativeArray array = new WritableNativeArray();
+    array.pushInt(0);
+    new WritableNativeArrayBuilder().pushInt(1).pushDouble(2.5).pushNull().commitTo(array);
+    assertEquals(4, array.size());
+    assertEquals(1, array.getInt(1));
+    assertEquals(2.5, array.getDouble(2));
+    assertTrue(array.isNull(3));
+  }
+
+  public void testReusedBuilderStartsEmpty() {
+    WritableNativeMapBuilder builder = new WritableNativeMapBuilder();
+    WritableNativeMapBuilder nested = new WritableNativeMapBuilder();
+    for (int i = 0; i < 3; i++) {
+      builder.putMap("nested", nested.putInt("i", i));
+      nested.reset();
+      WritableNativeMap map = builder.putInt("i", i).build();
+      assertEquals(i, map.getInt("i"));
+      assertEquals(i, map.getMap("nested").getInt("i"));
+      assertEquals(1, map.getMap("nested").toHashMap().size());
+    }
+  }
+
+  public void testBuilderRejectsDeepNesting() {
+    WritableNativeMapBuilder builder = new WritableNativeMapBuilder().putInt("leaf", 1);
+    for (int i = 0; i < 200; i++) {
+      builder = new WritableNativeMapBuilder().putMap("nested", builder);
+    }
+    try {
+      builder.build();
+      fail("Expected the builder to be rejected");
+    } catch (IllegalStateException e) {
+      // expected
+    }
+  }
+
+  public void testRejectedBuilderLeavesMapUntouched() {
+    WritableNativeMapBuilder deep = new WritableNativeMapBuilder().putInt("leaf", 1);
+    for (int i = 0; i < 200; i++) {
+      deep = new WritableNativeMapBuilder().putMap("nested", deep);
+    }
+    WritableNativeMap map = new WritableNativeMap();
+    map.putInt("a", 1);
+    try {
+      // "b" is applied before the nesting is rejected
+      new WritableNativeMapBuilder().putInt("b", 2).putMap("deep", deep).commitTo(map);
+      fail("Expected the builder to be rejected");
+    } catch (IllegalStateException e) {
+      // expected
+    }
+    assertEquals(1, map.toHashMap().size());
+    assertEquals(1, map.getInt("a"));
+  }
+
+  public void testBuilderPerformance() {
+    long start = System.nanoTime();
+    for (int i = 0; i < ITERATIONS; i++) {
+      createWithPuts();
+    }
+    long putsNanos = (System.nanoTime() - start) / ITERATIONS;
+
+    start = System.nanoTime();
+    for (int i = 0; i < ITERATIONS; i++) {
+      createWithBuilder();
+    }
+    long builderNanos = (System.nanoTime() - start) / ITERATIONS;
+
+    Log.i(TAG, "puts " + putsNanos / 1000 + "us, builder " + builderNanos / 1000 + "us");
+  }
+}
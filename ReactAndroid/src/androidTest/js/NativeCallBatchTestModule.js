@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2013-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ *
+ * @providesModule NativeCallBatchTestModule
+ */
+
+'use strict';
+
+var BatchedBridge = require('BatchedBridge');
+var React = require('React');
+var RecordingModule = require('NativeModules').NativeCallBatchRecordingModule;
+var View = require('View');
+
+var NativeCallBatchTestApp = React.createClass({
+  render: function() {
+    return <View />;
+  },
+});
+
+var NativeCallBatchTestModule = {
+  NativeCallBatchTestApp: NativeCallBatchTestApp,
+  // All the calls are queued in the same batch
+  sendCalls: function(count) {
+    for (var i = 0; i < count; i++) {
+      RecordingModule.record(i, {width: i, height: i, opacity: 0.5});
+    }
+    RecordingModule.done();
+  },
+};
+
+BatchedBridge.registerCallableModule(
+  'NativeCallBatchTestModule',
+  NativeCallBatchTestModule
+);
+
+module.exports = NativeCallBatchTestModule;
@@ -19,6 +19,7 @@ require('ViewRenderingTestModule');
 require('PickerAndroidTestModule');
 require('CatalystRootViewTestModule');
 require('DatePickerDialogTestModule');
+require('NativeCallBatchTestModule');
 require('ScrollViewTestModule');
 require('SwipeRefreshLayoutTestModule');
 require('TextInputTestModule');
@@ -36,6 +37,10 @@ var apps = [
   appKey: 'DatePickerDialogTestApp',
   component: () => require('DatePickerDialogTestModule').DatePickerDialogTestApp
 },
+{
+  appKey: 'NativeCallBatchTestApp',
+  component: () => require('NativeCallBatchTestModule').NativeCallBatchTestApp
+},
 {
   appKey: 'HorizontalScrollViewTestApp',
   component: () => require('ScrollViewTestModule').HorizontalScrollViewTestApp,
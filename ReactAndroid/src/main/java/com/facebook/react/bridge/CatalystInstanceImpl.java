@@ -13,6 +13,9 @@ import javax.annotation.Nullable;
 
 import java.io.IOException;
 import java.io.StringWriter;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
 import java.util.Collection;
 import java.util.concurrent.Callable;
 import java.util.concurrent.CopyOnWriteArrayList;
@@ -114,7 +117,8 @@ public class CatalystInstanceImpl implements CatalystInstance {
       bridge = new ReactBridge(
           jsExecutor,
           new NativeModulesReactCallback(),
-          mReactQueueConfiguration.getNativeModulesQueueThread());
+          mReactQueueConfiguration.getNativeModulesQueueThread(),
+          mJavaRegistry.getMethodNames());
       mMainExecutorToken = bridge.getMainExecutorToken();
     } finally {
       Systrace.endSection(Systrace.TRACE_TAG_REACT_JAVA_BRIDGE);
@@ -153,6 +157,7 @@ public class CatalystInstanceImpl implements CatalystInstance {
       mNativeModuleCallExceptionHandler.handleException(e);
     } finally {
       Systrace.endSection(Systrace.TRACE_TAG_REACT_JAVA_BRIDGE);
+      ReactMarker.flushNativeMarkers();
     }
 
     mJSBundleHasLoaded = true;
@@ -408,7 +413,10 @@ public class CatalystInstanceImpl implements CatalystInstance {
   private class NativeModulesReactCallback implements ReactCallback {
 
     @Override
-    public void call(ExecutorToken executorToken, int moduleId, int methodId, ReadableNativeArray parameters) {
+    public void callBatch(
+        ExecutorToken executorToken,
+        ByteBuffer calls,
+        ReadableNativeArray[] parameters) {
       mReactQueueConfiguration.getNativeModulesQueueThread().assertIsOnThread();
 
       synchronized (mJSToJavaCallsTeardownLock) {
@@ -417,7 +425,19 @@ public class CatalystInstanceImpl implements CatalystInstance {
           return;
         }
 
-        mJavaRegistry.call(CatalystInstanceImpl.this, executorToken, moduleId, methodId, parameters);
+        IntBuffer ids = calls.order(ByteOrder.nativeOrder()).asIntBuffer();
+        for (int i = 0; ids.hasRemaining(); i++) {
+          int moduleId = ids.get();
+          int methodId = ids.get();
+          long startNanos = System.nanoTime();
+          mJavaRegistry.call(
+              CatalystInstanceImpl.this,
+              executorToken,
+              moduleId,
+              methodId,
+              parameters[i]);
+          ids.put((int) ((System.nanoTime() - startNanos) / 1000));
+        }
       }
     }
 
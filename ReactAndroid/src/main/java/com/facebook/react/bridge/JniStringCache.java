@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import com.facebook.soloader.SoLoader;
+
+/**
+ * Statistics of the native cache used to convert map keys and module and method names passed to
+ * native code.
+ */
+@DoNotStrip
+public class JniStringCache {
+
+  static {
+    SoLoader.loadLibrary(ReactBridge.REACT_NATIVE_LIB);
+  }
+
+  public static native long getHitCount();
+  public static native long getMissCount();
+  /**
+   * Returns how many strings were short enough to be cached but weren't, because the slots they
+   * hash to hold other strings.
+   */
+  public static native long getOverflowCount();
+
+  public static double getHitRate() {
+    long hits = getHitCount();
+    long lookups = hits + getMissCount();
+    return lookups == 0 ? 0 : (double) hits / lookups;
+  }
+}
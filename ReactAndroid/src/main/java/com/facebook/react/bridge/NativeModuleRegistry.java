@@ -62,6 +62,20 @@ public class NativeModuleRegistry {
     definition.call(catalystInstance, executorToken, methodId, parameters);
   }
 
+  /**
+   * Returns the "Module.method" names of the methods of each module, by module ID and method ID.
+   */
+  /* package */ String[][] getMethodNames() {
+    String[][] names = new String[mModuleTable.size()][];
+    for (ModuleDefinition moduleDef : mModuleTable) {
+      names[moduleDef.id] = new String[moduleDef.methods.size()];
+      for (int i = 0; i < moduleDef.methods.size(); i++) {
+        names[moduleDef.id][i] = moduleDef.name + "." + moduleDef.methods.get(i).name;
+      }
+    }
+    return names;
+  }
+
   /* package */ void writeModuleDescriptions(JsonWriter writer) throws IOException {
     Systrace.beginSection(Systrace.TRACE_TAG_REACT_JAVA_BRIDGE, "CreateJSON");
     try {
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import java.util.Arrays;
+
+import com.facebook.proguard.annotations.DoNotStrip;
+import com.facebook.soloader.SoLoader;
+
+/**
+ * Records writes to a map or an array in Java so that they can be applied to a
+ * {@link WritableNativeMap} or {@link WritableNativeArray} with a single JNI call, instead of one
+ * per value.
+ *
+ * Writes are encoded as a stream of ops. Each op is a type, followed for map entries by the key in
+ * {@link #mObjects}, and by its value: inline in {@link #mOps} for ints and booleans, in
+ * {@link #mDoubles} for doubles, in {@link #mObjects} for strings and native values, or as nested
+ * ops up to {@link #TYPE_END} for nested builders. The format is shared with NativeValueBuilder in
+ * NativeCollections.cpp.
+ */
+@DoNotStrip
+/* package */ abstract class NativeValueBuilder {
+
+  static {
+    SoLoader.loadLibrary(ReactBridge.REACT_NATIVE_LIB);
+  }
+
+  /* package */ static final int TYPE_NULL = 0;
+  /* package */ static final int TYPE_BOOLEAN = 1;
+  /* package */ static final int TYPE_INT = 2;
+  /* package */ static final int TYPE_DOUBLE = 3;
+  /* package */ static final int TYPE_STRING = 4;
+  /* package */ static final int TYPE_MAP = 5;
+  /* package */ static final int TYPE_ARRAY = 6;
+  /* package */ static final int TYPE_NATIVE_MAP = 7;
+  /* package */ static final int TYPE_NATIVE_ARRAY = 8;
+  /* package */ static final int TYPE_MERGE = 9;
+  /* package */ static final int TYPE_END = 10;
+
+  private int[] mOps = new int[16];
+  private int mOpCount;
+  private double[] mDoubles = new double[8];
+  private int mDoubleCount;
+  private Object[] mObjects = new Object[16];
+  private int mObjectCount;
+
+  /* package */ void addOp(int op) {
+    if (mOpCount == mOps.length) {
+      mOps = Arrays.copyOf(mOps, mOpCount * 2);
+    }
+    mOps[mOpCount++] = op;
+  }
+
+  /* package */ void addDouble(double value) {
+    if (mDoubleCount == mDoubles.length) {
+      mDoubles = Arrays.copyOf(mDoubles, mDoubleCount * 2);
+    }
+    mDoubles[mDoubleCount++] = value;
+  }
+
+  /* package */ void addObject(Object value) {
+    if (mObjectCount == mObjects.length) {
+      mObjects = Arrays.copyOf(mObjects, mObjectCount * 2);
+    }
+    mObjects[mObjectCount++] = value;
+  }
+
+  /**
+   * Takes over a native map or array when it is put, like {@link WritableNativeMap#putMap} does,
+   * so that it can't be modified or put anywhere else before the builder is committed.
+   */
+  /* package */ void addNativeMap(WritableNativeMap map) {
+    consumeMap(map);
+    addOp(TYPE_NATIVE_MAP);
+  }
+
+  /* package */ void addNativeArray(WritableNativeArray array) {
+    consumeArray(array);
+    addOp(TYPE_NATIVE_ARRAY);
+  }
+
+  /**
+   * Appends the ops of {@code nested}, enclosed in {@code type} and {@link #TYPE_END}.
+   */
+  /* package */ void addNested(int type, NativeValueBuilder nested) {
+    addOp(type);
+    for (int i = 0; i < nested.mOpCount; i++) {
+      addOp(nested.mOps[i]);
+    }
+    for (int i = 0; i < nested.mDoubleCount; i++) {
+      addDouble(nested.mDoubles[i]);
+    }
+    for (int i = 0; i < nested.mObjectCount; i++) {
+      addObject(nested.mObjects[i]);
+    }
+    addOp(TYPE_END);
+  }
+
+  /**
+   * Forgets all recorded writes, so that the builder can be reused. The arrays holding them are
+   * kept, so a reused builder doesn't allocate once it has grown to its payload.
+   */
+  public void reset() {
+    mOpCount = 0;
+    mDoubleCount = 0;
+    Arrays.fill(mObjects, 0, mObjectCount, null);
+    mObjectCount = 0;
+  }
+
+  /* package */ void applyTo(WritableNativeMap map) {
+    commitToMap(map, mOps, mOpCount, mDoubles, mDoubleCount, mObjects, mObjectCount);
+  }
+
+  /* package */ void applyTo(WritableNativeArray array) {
+    commitToArray(array, mOps, mOpCount, mDoubles, mDoubleCount, mObjects, mObjectCount);
+  }
+
+  private static native void commitToMap(
+      WritableNativeMap map,
+      int[] ops,
+      int opCount,
+      double[] doubles,
+      int doubleCount,
+      Object[] objects,
+      int objectCount);
+  private static native void commitToArray(
+      WritableNativeArray array,
+      int[] ops,
+      int opCount,
+      double[] doubles,
+      int doubleCount,
+      Object[] objects,
+      int objectCount);
+  private static native void consumeMap(WritableNativeMap map);
+  private static native void consumeArray(WritableNativeArray array);
+}
@@ -38,15 +38,18 @@ public class ReactBridge extends Countable {
    * @param jsExecutor the JS executor to use to run JS
    * @param callback the callback class used to invoke native modules
    * @param nativeModulesQueueThread the MessageQueueThread the callbacks should be invoked on
+   * @param nativeMethodNames the "Module.method" names of the native module methods, by module ID
+   *     and method ID, that native module method times are reported under
    */
   public ReactBridge(
       JavaScriptExecutor jsExecutor,
       ReactCallback callback,
-      MessageQueueThread nativeModulesQueueThread) {
+      MessageQueueThread nativeModulesQueueThread,
+      String[][] nativeMethodNames) {
     mJSExecutor = jsExecutor;
     mCallback = callback;
     mNativeModulesQueueThread = nativeModulesQueueThread;
-    initialize(jsExecutor, callback, mNativeModulesQueueThread);
+    initialize(jsExecutor, callback, mNativeModulesQueueThread, nativeMethodNames);
   }
 
   @Override
@@ -72,7 +75,8 @@ public class ReactBridge extends Countable {
   private native void initialize(
       JavaScriptExecutor jsExecutor,
       ReactCallback callback,
-      MessageQueueThread nativeModulesQueueThread);
+      MessageQueueThread nativeModulesQueueThread,
+      String[][] nativeMethodNames);
 
   /**
    * All native functions are not thread safe and appropriate queues should be used
@@ -98,4 +102,130 @@ public class ReactBridge extends Countable {
    * available. It will likely change in a future release!
    */
   public native long getJavaScriptContextNativePtrExperimental();
+
+  /**
+   * Returns the JS heap and GC stats sampled on the JS thread as a JSON array, oldest first. The
+   * main executor samples at most every "HeapSamplingIntervalMs" of its JSC config (1000 by
+   * default, 0 to disable) when it finishes a task, and whenever it handles memory pressure.
+   * Timestamps are in {@link System#nanoTime()} nanoseconds, so that they can be lined up with
+   * frame times.
+   */
+  public native String getJSHeapSamples();
+
+  /**
+   * Returns the number of calls made between Java and native code by all bridges so far, in
+   * either direction.
+   */
+  public static native long getJniTransitionCount();
+
+  /**
+   * Returns how many times the value of a NativeMap or NativeArray was copied so far, because it
+   * was written to or consumed while a nested map or array read from it was still alive.
+   */
+  public static native long getNativeValueCopyCount();
+
+  /**
+   * Makes native logging (including console.log from JS) write to logcat from a background thread,
+   * so that threads logging heavily in bursts don't wait on logd. Off by default. No message is
+   * lost: a thread that outpaces logcat writes out its own backlog, in order.
+   */
+  public static native void setAsyncNativeLogging(boolean enabled);
+
+  /**
+   * Returns a human readable summary of how many of each pooled native object (NativeMap,
+   * NativeRunnable, ...) are live, pooled for reuse, and were ever allocated.
+   */
+  public static native String getNativeObjectPoolStats();
+
+  /**
+   * Starts or stops recording the bridge's native trace sections in process. Unlike systrace,
+   * this works in every build.
+   */
+  public static native void setNativeTraceRecordingEnabled(boolean enabled);
+
+  /**
+   * Returns the native trace events recorded since the last call, as Chrome Trace Event JSON.
+   */
+  public static native String dumpNativeTrace();
+
+  /**
+   * Returns the latency percentiles of bridge traffic since the last reset, as JSON: queue wait
+   * times by JS queue, JS call times by tracing name, and native module method times by
+   * "Module.method". With {@code reset}, starts a new window.
+   */
+  public static native String getBridgeLatencyStats(boolean reset);
+
+  /**
+   * Starts or stops metering the native hooks JS calls, e.g. {@code nativeFlushQueueImmediate} or
+   * {@code nativeRequire}. Metering is off by default.
+   */
+  public static native void setNativeHookStatsEnabled(boolean enabled);
+
+  /**
+   * Returns the call count, total and max time of each native hook called while metering since
+   * the last reset, as JSON, the hook taking the most time first. With {@code reset}, starts a new
+   * window. JS can read the same stats with {@code nativeGetHookStats(reset)}.
+   */
+  public static native String getNativeHookStats(boolean reset);
+
+  /**
+   * Starts sampling the native stacks of the JS threads every {@code intervalMicros}, attributing
+   * each sample to the JS call, callback or module require the thread was in. Unlike
+   * {@link #startProfiler}, this doesn't slow JS down between samples. During a profile capture,
+   * samples are written to it. Returns false if the sampling profiler is already running.
+   */
+  public static native boolean startSamplingProfiler(int intervalMicros);
+
+  /**
+   * Stops the sampling profiler and returns its samples as a .cpuprofile, which Chrome DevTools
+   * can load, or an empty string if it isn't running or was writing to a profile capture.
+   */
+  public static native String stopSamplingProfiler();
+
+  /**
+   * Starts writing the bridge's native trace sections to {@code path} as they are recorded, along
+   * with the samples of the sampling profiler and the JSC profiles ended from JS
+   * ({@code nativeProfilerEnd}) until {@link #stopProfileCapture}. Memory use doesn't grow with
+   * the length of the capture. Convert the file to Chrome Trace Event JSON with profile2trace.
+   * Returns false if the file can't be created or a capture is already running.
+   */
+  public static native boolean startProfileCapture(String path, boolean compress);
+
+  /**
+   * Writes out the rest of the capture and closes its file. Stop the sampling profiler first.
+   * Returns false if there is no capture or writing it failed.
+   */
+  public static native boolean stopProfileCapture();
+
+  /**
+   * Returns the startup timeline of the last bridge created, as JSON: when each startup phase
+   * (reading the bundle, converting it, injecting the module config, creating the JS context,
+   * evaluating the bundle, the first flush and the first native batch) began and ended, on which
+   * threads, and the critical path through them, with the gaps no phase accounts for. Times are
+   * {@link System#nanoTime()} nanoseconds.
+   */
+  public static native String getStartupTimeline();
+
+  /**
+   * Records the traffic of the bridges created from now on to {@code path}, replacing it each
+   * time, or stops recording new bridges if {@code path} is null. The calls into JS and the
+   * batches of native module calls are recorded with when they happened and how long they took,
+   * until the bridge is destroyed. Replay recordings on a host with bridgereplay.
+   */
+  public static native void setBridgeTrafficRecordingPath(String path);
+
+  /**
+   * Starts timing the tasks run on the JS and native module queues, logging the ones taking
+   * longer than {@code budgetMs}, e.g. 16 for a frame, with the call they ran and the JS stack
+   * when it is known. Starting it again replaces the budget.
+   */
+  public static native void startLongTaskWatchdog(int budgetMs);
+
+  public static native void stopLongTaskWatchdog();
+
+  /**
+   * Returns, as JSON, how many tasks each queue ran and how many went over budget, by how much,
+   * and the last long tasks reported. If {@code reset} is true, this starts a new window.
+   */
+  public static native String getLongTaskStats(boolean reset);
 }
@@ -9,13 +9,21 @@
 
 package com.facebook.react.bridge;
 
+import java.nio.ByteBuffer;
+
 import com.facebook.proguard.annotations.DoNotStrip;
 
 @DoNotStrip
 public interface ReactCallback {
 
+  /**
+   * Invokes a batch of native module methods. {@code calls} holds three native-endian ints per
+   * call: the module ID, the method ID, and a slot to write the time the call took in microseconds
+   * to, for the bridge latency stats. The parameters of the i-th call are {@code parameters[i]}.
+   * {@code calls} wraps native memory and must not be used after this method returns.
+   */
   @DoNotStrip
-  void call(ExecutorToken executorToken, int moduleId, int methodId, ReadableNativeArray parameters);
+  void callBatch(ExecutorToken executorToken, ByteBuffer calls, ReadableNativeArray[] parameters);
 
   @DoNotStrip
   void onBatchComplete();
@@ -11,10 +11,29 @@ import com.facebook.proguard.annotations.DoNotStrip;
 @DoNotStrip
 public class ReactMarker {
 
+  /**
+   * Markers logged from Java are delivered as they are logged. Markers logged from native code are
+   * buffered and only delivered, in a batch, by {@link #flushNativeMarkers()}, so they arrive late
+   * and all at the same time. Implement {@link TimedMarkerListener} to get the time they were
+   * actually logged at.
+   */
   public interface MarkerListener {
     void logMarker(String name);
   };
 
+  /**
+   * Listener that also receives the time at which markers logged from native code were logged,
+   * since they are only delivered when {@link #flushNativeMarkers()} is called.
+   */
+  public interface TimedMarkerListener extends MarkerListener {
+    /**
+     * @param timestampNanos in the {@link System#nanoTime()} time base
+     */
+    void logMarker(String name, long timestampNanos);
+  }
+
+  private static final int NATIVE_MARKER_BATCH_SIZE = 32;
+
   @Nullable static private MarkerListener sMarkerListener = null;
 
   static public void setMarkerListener(MarkerListener listener) {
@@ -28,4 +47,29 @@ public class ReactMarker {
     }
   }
 
+  /**
+   * Delivers the markers logged from native code since the last flush. They are buffered in native
+   * code so that logging one doesn't need to call into Java. Native code also calls this when its
+   * buffer is getting full.
+   */
+  @DoNotStrip
+  static public synchronized void flushNativeMarkers() {
+    String[] names = new String[NATIVE_MARKER_BATCH_SIZE];
+    long[] timestamps = new long[NATIVE_MARKER_BATCH_SIZE];
+    int count;
+    do {
+      count = drainNativeMarkers(names, timestamps);
+      MarkerListener listener = sMarkerListener;
+      for (int i = 0; i < count; i++) {
+        if (listener instanceof TimedMarkerListener) {
+          ((TimedMarkerListener) listener).logMarker(names[i], timestamps[i]);
+        } else if (listener != null) {
+          listener.logMarker(names[i]);
+        }
+      }
+    } while (count == NATIVE_MARKER_BATCH_SIZE);
+  }
+
+  private static native int drainNativeMarkers(String[] names, long[] timestamps);
+
 }
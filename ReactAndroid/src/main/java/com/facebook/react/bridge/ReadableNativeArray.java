@@ -49,33 +49,9 @@ public class ReadableNativeArray extends NativeArray implements ReadableArray {
   @Override
   public native ReadableType getType(int index);
 
-  public ArrayList<Object> toArrayList() {
-    ArrayList<Object> arrayList = new ArrayList<>();
-
-    for (int i = 0; i < this.size(); i++) {
-      switch (getType(i)) {
-        case Null:
-          arrayList.add(null);
-          break;
-        case Boolean:
-          arrayList.add(getBoolean(i));
-          break;
-        case Number:
-          arrayList.add(getDouble(i));
-          break;
-        case String:
-          arrayList.add(getString(i));
-          break;
-        case Map:
-          arrayList.add(getMap(i).toHashMap());
-          break;
-        case Array:
-          arrayList.add(getArray(i).toArrayList());
-          break;
-        default:
-          throw new IllegalArgumentException("Could not convert object at index: " + i + ".");
-      }
-    }
-    return arrayList;
-  }
+  /**
+   * Converts the whole array, including nested maps and arrays, in a single native call. Numbers
+   * are converted to {@link Double}.
+   */
+  public native ArrayList<Object> toArrayList();
 }
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import javax.annotation.Nullable;
+
+/**
+ * Builds a {@link WritableNativeArray} with a single JNI call. See
+ * {@link WritableNativeMapBuilder}.
+ */
+public class WritableNativeArrayBuilder extends NativeValueBuilder {
+
+  public WritableNativeArrayBuilder pushNull() {
+    addOp(TYPE_NULL);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushBoolean(boolean value) {
+    addOp(TYPE_BOOLEAN);
+    addOp(value ? 1 : 0);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushDouble(double value) {
+    addOp(TYPE_DOUBLE);
+    addDouble(value);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushInt(int value) {
+    addOp(TYPE_INT);
+    addOp(value);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushString(@Nullable String value) {
+    if (value == null) {
+      return pushNull();
+    }
+    addOp(TYPE_STRING);
+    addObject(value);
+    return this;
+  }
+
+  // Note: this consumes the map so do not reuse it.
+  public WritableNativeArrayBuilder pushMap(@Nullable WritableNativeMap map) {
+    if (map == null) {
+      return pushNull();
+    }
+    addNativeMap(map);
+    addObject(map);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushMap(@Nullable WritableNativeMapBuilder map) {
+    if (map == null) {
+      return pushNull();
+    }
+    addNested(TYPE_MAP, map);
+    return this;
+  }
+
+  // Note: this consumes the array so do not reuse it.
+  public WritableNativeArrayBuilder pushArray(@Nullable WritableNativeArray array) {
+    if (array == null) {
+      return pushNull();
+    }
+    addNativeArray(array);
+    addObject(array);
+    return this;
+  }
+
+  public WritableNativeArrayBuilder pushArray(@Nullable WritableNativeArrayBuilder array) {
+    if (array == null) {
+      return pushNull();
+    }
+    addNested(TYPE_ARRAY, array);
+    return this;
+  }
+
+  /**
+   * Applies the recorded writes to {@code array}, and resets the builder.
+   */
+  public void commitTo(WritableNativeArray array) {
+    try {
+      applyTo(array);
+    } finally {
+      reset();
+    }
+  }
+
+  /**
+   * Returns a new array with the recorded writes, and resets the builder.
+   */
+  public WritableNativeArray build() {
+    WritableNativeArray array = new WritableNativeArray();
+    commitTo(array);
+    return array;
+  }
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import javax.annotation.Nullable;
+
+/**
+ * Builds a {@link WritableNativeMap} with a single JNI call. Writes are recorded in Java and
+ * applied in order by {@link #build()} or {@link #commitTo}, with the same semantics as the
+ * corresponding {@link WritableNativeMap} methods. Use this when creating maps at a high rate, for
+ * instance for events. If the writes can't be applied, the map is left untouched.
+ */
+public class WritableNativeMapBuilder extends NativeValueBuilder {
+
+  public WritableNativeMapBuilder putNull(String key) {
+    addOp(TYPE_NULL);
+    addObject(key);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putBoolean(String key, boolean value) {
+    addOp(TYPE_BOOLEAN);
+    addObject(key);
+    addOp(value ? 1 : 0);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putDouble(String key, double value) {
+    addOp(TYPE_DOUBLE);
+    addObject(key);
+    addDouble(value);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putInt(String key, int value) {
+    addOp(TYPE_INT);
+    addObject(key);
+    addOp(value);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putString(String key, @Nullable String value) {
+    if (value == null) {
+      return putNull(key);
+    }
+    addOp(TYPE_STRING);
+    addObject(key);
+    addObject(value);
+    return this;
+  }
+
+  // Note: this consumes the map so do not reuse it.
+  public WritableNativeMapBuilder putMap(String key, @Nullable WritableNativeMap value) {
+    if (value == null) {
+      return putNull(key);
+    }
+    addNativeMap(value);
+    addObject(key);
+    addObject(value);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putMap(String key, @Nullable WritableNativeMapBuilder value) {
+    if (value == null) {
+      return putNull(key);
+    }
+    addObject(key);
+    addNested(TYPE_MAP, value);
+    return this;
+  }
+
+  // Note: this consumes the array so do not reuse it.
+  public WritableNativeMapBuilder putArray(String key, @Nullable WritableNativeArray value) {
+    if (value == null) {
+      return putNull(key);
+    }
+    addNativeArray(value);
+    addObject(key);
+    addObject(value);
+    return this;
+  }
+
+  public WritableNativeMapBuilder putArray(String key, @Nullable WritableNativeArrayBuilder value) {
+    if (value == null) {
+      return putNull(key);
+    }
+    addObject(key);
+    addNested(TYPE_ARRAY, value);
+    return this;
+  }
+
+  // Note: this **DOES NOT** consume the source map
+  public WritableNativeMapBuilder merge(ReadableNativeMap source) {
+    addOp(TYPE_MERGE);
+    addObject(source);
+    return this;
+  }
+
+  /**
+   * Applies the recorded writes to {@code map}, and resets the builder.
+   */
+  public void commitTo(WritableNativeMap map) {
+    try {
+      applyTo(map);
+    } finally {
+      reset();
+    }
+  }
+
+  /**
+   * Returns a new map with the recorded writes, and resets the builder.
+   */
+  public WritableNativeMap build() {
+    WritableNativeMap map = new WritableNativeMap();
+    commitTo(map);
+    return map;
+  }
+}
@@ -16,8 +16,8 @@ import java.lang.Override;
 import android.support.v4.util.Pools;
 
 import com.facebook.infer.annotation.Assertions;
-import com.facebook.react.bridge.Arguments;
 import com.facebook.react.bridge.WritableMap;
+import com.facebook.react.bridge.WritableNativeMapBuilder;
 import com.facebook.react.uimanager.PixelUtil;
 import com.facebook.react.uimanager.events.Event;
 import com.facebook.react.uimanager.events.RCTEventEmitter;
@@ -37,6 +37,9 @@ public class ScrollEvent extends Event<ScrollEvent> {
   private int mScrollViewWidth;
   private int mScrollViewHeight;
   private @Nullable ScrollEventType mScrollEventType;
+  // Pooled along with the event, so that serializing it every frame reuses their arrays
+  private final WritableNativeMapBuilder mEventData = new WritableNativeMapBuilder();
+  private final WritableNativeMapBuilder mNestedData = new WritableNativeMapBuilder();
 
   public static ScrollEvent obtain(
       int viewTag,
@@ -119,32 +122,40 @@ public class ScrollEvent extends Event<ScrollEvent> {
   }
 
   private WritableMap serializeEventData() {
-    WritableMap contentInset = Arguments.createMap();
-    contentInset.putDouble("top", 0);
-    contentInset.putDouble("bottom", 0);
-    contentInset.putDouble("left", 0);
-    contentInset.putDouble("right", 0);
-
-    WritableMap contentOffset = Arguments.createMap();
-    contentOffset.putDouble("x", PixelUtil.toDIPFromPixel(mScrollX));
-    contentOffset.putDouble("y", PixelUtil.toDIPFromPixel(mScrollY));
-
-    WritableMap contentSize = Arguments.createMap();
-    contentSize.putDouble("width", PixelUtil.toDIPFromPixel(mContentWidth));
-    contentSize.putDouble("height", PixelUtil.toDIPFromPixel(mContentHeight));
-
-    WritableMap layoutMeasurement = Arguments.createMap();
-    layoutMeasurement.putDouble("width", PixelUtil.toDIPFromPixel(mScrollViewWidth));
-    layoutMeasurement.putDouble("height", PixelUtil.toDIPFromPixel(mScrollViewHeight));
-
-    WritableMap event = Arguments.createMap();
-    event.putMap("contentInset", contentInset);
-    event.putMap("contentOffset", contentOffset);
-    event.putMap("contentSize", contentSize);
-    event.putMap("layoutMeasurement", layoutMeasurement);
-
-    event.putInt("target", getViewTag());
-    event.putBoolean("responderIgnoreScroll", true);
-    return event;
+    mEventData.putMap(
+        "contentInset",
+        mNestedData
+            .putDouble("top", 0)
+            .putDouble("bottom", 0)
+            .putDouble("left", 0)
+            .putDouble("right", 0));
+    mNestedData.reset();
+
+    mEventData.putMap(
+        "contentOffset",
+        mNestedData
+            .putDouble("x", PixelUtil.toDIPFromPixel(mScrollX))
+            .putDouble("y", PixelUtil.toDIPFromPixel(mScrollY)));
+    mNestedData.reset();
+
+    mEventData.putMap(
+        "contentSize",
+        mNestedData
+            .putDouble("width", PixelUtil.toDIPFromPixel(mContentWidth))
+            .putDouble("height", PixelUtil.toDIPFromPixel(mContentHeight)));
+    mNestedData.reset();
+
+    mEventData.putMap(
+        "layoutMeasurement",
+        mNestedData
+            .putDouble("width", PixelUtil.toDIPFromPixel(mScrollViewWidth))
+            .putDouble("height", PixelUtil.toDIPFromPixel(mScrollViewHeight)));
+    mNestedData.reset();
+
+    // Scroll events are sent for every frame, build the whole event with a single JNI call
+    return mEventData
+        .putInt("target", getViewTag())
+        .putBoolean("responderIgnoreScroll", true)
+        .build();
   }
 }
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <fb/ThreadLocal.h>
+
+namespace facebook {
+
+struct ObjectPoolStats {
+  // Handed out by the pool and not given back yet
+  size_t live;
+  // Sitting in free lists, waiting to be reused
+  size_t pooled;
+  // Ever allocated from the heap
+  size_t allocated;
+};
+
+/**
+ * Recycles the memory of objects of type T, for types that are created and destroyed often
+ * enough for malloc to show up in profiles.
+ *
+ * Each thread keeps a free list of up to 2 * BatchSize objects, which it can use without
+ * locking. Objects are often freed on a different thread than the one that allocated them (by
+ * Java finalizers, for example), so threads exchange batches of BatchSize objects through a
+ * shared depot, under a lock. Objects that don't fit in the depot go back to the heap.
+ *
+ * Only hands out raw memory: construct objects with placement new, or derive from
+ * PooledAllocation to use the pool from new and delete.
+ */
+template <typename T, size_t BatchSize = 32, size_t MaxDepotBatches = 8>
+class ObjectPool {
+public:
+  static void* allocate() {
+    FreeList& local = localFreeList();
+    local.allocations.increment();
+    if (local.head == nullptr) {
+      state().refill(local);
+    }
+    if (local.head != nullptr) {
+      return local.pop();
+    }
+    local.heapAllocations.increment();
+    return ::operator new(sizeof(Slot));
+  }
+
+  static void deallocate(void* p) {
+    FreeList& local = localFreeList();
+    local.deallocations.increment();
+    if (local.size == 2 * BatchSize) {
+      state().spill(local, BatchSize);
+    }
+    local.push(static_cast<Slot*>(p));
+  }
+
+  static ObjectPoolStats getStats() {
+    return state().getStats();
+  }
+
+private:
+  union Slot {
+    Slot* next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  // Only ever incremented by the owning thread, so that doesn't need an atomic
+  // read-modify-write, but can be read from any thread
+  struct Counter {
+    std::atomic<size_t> value{0};
+
+    void increment(size_t n = 1) {
+      value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    size_t get() const {
+      return value.load(std::memory_order_relaxed);
+    }
+  };
+
+  struct FreeList {
+    Slot* head = nullptr;
+    size_t size = 0;
+    Counter allocations;
+    Counter deallocations;
+    Counter heapAllocations;
+    Counter heapFrees;
+
+    void push(Slot* slot) {
+      slot->next = head;
+      head = slot;
+      size++;
+    }
+
+    Slot* pop() {
+      Slot* slot = head;
+      head = slot->next;
+      size--;
+      return slot;
+    }
+
+    // Detaches the first count slots as a null terminated list
+    Slot* take(size_t count) {
+      Slot* first = head;
+      Slot* last = head;
+      for (size_t i = 1; i < count; i++) {
+        last = last->next;
+      }
+      head = last->next;
+      last->next = nullptr;
+      size -= count;
+      return first;
+    }
+  };
+
+  struct State {
+    std::mutex mutex;
+    std::vector<Slot*> depot;
+    std::vector<FreeList*> freeLists;
+    // Counters of the threads that have exited
+    size_t exitedAllocations = 0;
+    size_t exitedDeallocations = 0;
+    size_t exitedHeapAllocations = 0;
+    size_t exitedHeapFrees = 0;
+    ThreadLocal<FreeList> exitHandler{&onThreadExit};
+
+    void refill(FreeList& list) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!depot.empty()) {
+        list.head = depot.back();
+        list.size = BatchSize;
+        depot.pop_back();
+      }
+    }
+
+    // Moves count slots out of list, into the depot if there's room for them
+    void spill(FreeList& list, size_t count) {
+      Slot* batch = list.take(count);
+      if (count == BatchSize) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (depot.size() < MaxDepotBatches) {
+          depot.push_back(batch);
+          return;
+        }
+      }
+      list.heapFrees.increment(count);
+      while (batch != nullptr) {
+        Slot* next = batch->next;
+        ::operator delete(batch);
+        batch = next;
+      }
+    }
+
+    ObjectPoolStats getStats() {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t allocations = exitedAllocations;
+      size_t deallocations = exitedDeallocations;
+      size_t heapAllocations = exitedHeapAllocations;
+      size_t heapFrees = exitedHeapFrees;
+      for (FreeList* list : freeLists) {
+        allocations += list->allocations.get();
+        deallocations += list->deallocations.get();
+        heapAllocations += list->heapAllocations.get();
+        heapFrees += list->heapFrees.get();
+      }
+      // Every slot that came from the heap and hasn't gone back is either
+      // live or pooled
+      size_t live = allocations - deallocations;
+      return { live, heapAllocations - heapFrees - live, heapAllocations };
+    }
+  };
+
+  static FreeList*& threadFreeList() {
+    // A thread_local for speed; exitHandler is only there to clean up
+    static thread_local FreeList* list = nullptr;
+    return list;
+  }
+
+  static FreeList& localFreeList() {
+    FreeList*& local = threadFreeList();
+    if (local == nullptr) {
+      State& s = state();
+      local = new FreeList();
+      {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.freeLists.push_back(local);
+      }
+      s.exitHandler.reset(local);
+    }
+    return *local;
+  }
+
+  static void onThreadExit(void* obj) {
+    FreeList* list = static_cast<FreeList*>(obj);
+    if (list == nullptr) {
+      return;
+    }
+    // Other thread exit handlers may still use the pool, with a new free list
+    threadFreeList() = nullptr;
+    State& s = state();
+    while (list->size >= BatchSize) {
+      s.spill(*list, BatchSize);
+    }
+    if (list->size > 0) {
+      s.spill(*list, list->size);
+    }
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.exitedAllocations += list->allocations.get();
+    s.exitedDeallocations += list->deallocations.get();
+    s.exitedHeapAllocations += list->heapAllocations.get();
+    s.exitedHeapFrees += list->heapFrees.get();
+    for (auto it = s.freeLists.begin(); it != s.freeLists.end(); ++it) {
+      if (*it == list) {
+        s.freeLists.erase(it);
+        break;
+      }
+    }
+    delete list;
+  }
+
+  static State& state() {
+    // Leaked, since objects may be freed during or after static destruction
+    static State* s = new State();
+    return *s;
+  }
+};
+
+/**
+ * Makes new and delete of T use ObjectPool<T>. Classes derived from T are still allocated on the
+ * heap, since they don't fit in the pool's slots.
+ *
+ *   struct Foo : public Countable, public PooledAllocation<Foo> { ... };
+ */
+template <typename T>
+class PooledAllocation {
+public:
+  static void* operator new(size_t size) {
+    return size == sizeof(T) ? ObjectPool<T>::allocate() : ::operator new(size);
+  }
+
+  static void operator delete(void* p, size_t size) {
+    if (size == sizeof(T)) {
+      ObjectPool<T>::deallocate(p);
+    } else {
+      ::operator delete(p);
+    }
+  }
+};
+
+}
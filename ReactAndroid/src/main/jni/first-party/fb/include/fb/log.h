@@ -321,6 +321,40 @@ extern "C" {
 typedef void (*LogHandler)(int priority, const char* tag, const char* message);
 void setLogHandler(LogHandler logHandler);
 
+/*
+ * Where fb_printLog writes messages to. Defaults to __android_log_write (or
+ * stderr on other platforms); passing NULL restores the default. The log
+ * handler above is still called on the logging thread, before the message is
+ * handed to the sink.
+ */
+typedef void (*LogSink)(int priority, const char* tag, const char* message);
+void setLogSink(LogSink logSink);
+
+/*
+ * What to do with a message when asynchronous logging is enabled and the
+ * logging thread's buffer is full.
+ */
+typedef enum LogOverflowPolicy {
+    LOG_OVERFLOW_DROP = 0,          /* drop it and count it in getDroppedLogCount() */
+    LOG_OVERFLOW_WRITE_THROUGH = 1, /* write it synchronously, out of order */
+    LOG_OVERFLOW_BLOCK = 2,         /* write out the buffer on the logging thread first */
+} LogOverflowPolicy;
+
+/*
+ * When enabled, fb_printLog copies messages into a lock-free buffer owned by
+ * the logging thread and a background thread writes them to the sink, so
+ * that logging doesn't block on I/O. Fatal messages are always written
+ * synchronously, after flushing everything logged before them.
+ */
+void setAsyncLogging(int enabled, LogOverflowPolicy overflowPolicy);
+
+/*
+ * Blocks until every message logged asynchronously so far has been written.
+ */
+void flushLogs(void);
+
+unsigned long long getDroppedLogCount(void);
+
 /*
  * ===========================================================================
  *
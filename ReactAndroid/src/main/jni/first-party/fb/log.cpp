@@ -8,10 +8,19 @@
  */
 
 #include <fb/log.h>
+#include <fb/ThreadLocal.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #define LOG_BUFFER_SIZE 4096
 static LogHandler gLogHandler;
 
@@ -19,6 +28,275 @@ void setLogHandler(LogHandler logHandler) {
   gLogHandler = logHandler;
 }
 
+namespace {
+
+std::atomic<LogSink> gLogSink(nullptr);
+
+void writeToSink(int prio, const char *tag, const char *text) {
+  LogSink sink = gLogSink.load(std::memory_order_acquire);
+  if (sink != nullptr) {
+    sink(prio, tag, text);
+  } else {
+    __android_log_write(prio, tag, text);
+  }
+}
+
+// Asynchronous logging
+//
+// Every thread that logs gets a LogRing: a single producer, single consumer
+// ring of variable length records. The logging thread appends records without
+// taking any lock, and the drain thread consumes them, holding gRingsMutex so
+// that flushLogs() can consume from any thread. Rings are only created and
+// retired under gRingsMutex, the first time a thread logs and when it exits.
+
+const size_t kRingSize = 64 * 1024;
+const size_t kMaxTagLength = 63;
+const uint8_t kNullTag = 0xff;
+const uint8_t kPaddingPriority = 0xff;
+const auto kDrainInterval = std::chrono::milliseconds(50);
+
+struct RecordHeader {
+  // Of the whole record, including this header and padding
+  uint32_t size;
+  uint16_t messageLength;
+  uint8_t priority;
+  uint8_t tagLength;
+};
+
+static_assert(sizeof(RecordHeader) == 8, "Records are 8 byte aligned");
+
+size_t alignRecordSize(size_t size) {
+  return (size + sizeof(RecordHeader) - 1) & ~(sizeof(RecordHeader) - 1);
+}
+
+struct LogRing {
+  // Positions only ever increase; they are masked to index into data, which
+  // works across wrap around because kRingSize is a power of two.
+  std::atomic<size_t> head{0}; // written by the consumer
+  std::atomic<size_t> tail{0}; // written by the producer
+  std::atomic<bool> retired{false};
+  char data[kRingSize];
+
+  bool tryAppend(int prio, const char *tag, const char *message, size_t messageLength) {
+    size_t tagLength = tag ? std::min(strlen(tag), kMaxTagLength) : 0;
+    size_t size = alignRecordSize(
+      sizeof(RecordHeader) + tagLength + 1 + messageLength + 1);
+
+    size_t tailPosition = tail.load(std::memory_order_relaxed);
+    size_t headPosition = head.load(std::memory_order_acquire);
+    size_t offset = tailPosition & (kRingSize - 1);
+    // Records are contiguous: pad out the end of the ring if this one doesn't fit
+    size_t padding = offset + size > kRingSize ? kRingSize - offset : 0;
+    if (tailPosition + padding + size - headPosition > kRingSize) {
+      return false;
+    }
+
+    if (padding > 0) {
+      RecordHeader paddingHeader = {
+        static_cast<uint32_t>(padding), 0, kPaddingPriority, 0 };
+      memcpy(data + offset, &paddingHeader, sizeof(paddingHeader));
+      offset = 0;
+    }
+
+    RecordHeader header = {
+      static_cast<uint32_t>(size),
+      static_cast<uint16_t>(messageLength),
+      static_cast<uint8_t>(prio),
+      tag ? static_cast<uint8_t>(tagLength) : kNullTag,
+    };
+    char *record = data + offset;
+    memcpy(record, &header, sizeof(header));
+    char *recordTag = record + sizeof(header);
+    memcpy(recordTag, tag ? tag : "", tagLength);
+    recordTag[tagLength] = '\0';
+    char *recordMessage = recordTag + tagLength + 1;
+    memcpy(recordMessage, message, messageLength);
+    recordMessage[messageLength] = '\0';
+
+    tail.store(tailPosition + padding + size, std::memory_order_release);
+    return true;
+  }
+
+  // Must hold gRingsMutex
+  void drain() {
+    size_t headPosition = head.load(std::memory_order_relaxed);
+    size_t tailPosition = tail.load(std::memory_order_acquire);
+    while (headPosition != tailPosition) {
+      const char *record = data + (headPosition & (kRingSize - 1));
+      RecordHeader header;
+      memcpy(&header, record, sizeof(header));
+      if (header.priority != kPaddingPriority) {
+        const char *recordTag = record + sizeof(header);
+        size_t tagLength = header.tagLength == kNullTag ? 0 : header.tagLength;
+        writeToSink(
+          header.priority,
+          header.tagLength == kNullTag ? nullptr : recordTag,
+          recordTag + tagLength + 1);
+      }
+      headPosition += header.size;
+      // Give the space back straight away so a busy producer can reuse it
+      head.store(headPosition, std::memory_order_release);
+    }
+  }
+};
+
+std::atomic<bool> gAsyncLogging(false);
+std::atomic<int> gOverflowPolicy(LOG_OVERFLOW_DROP);
+std::atomic<unsigned long long> gDroppedLogCount(0);
+
+// These are leaked so that they outlive static destructors, which may log, and
+// the drain thread, which is never joined
+std::mutex& gRingsMutex = *new std::mutex();
+std::vector<LogRing*>& gRings = *new std::vector<LogRing*>();
+
+std::once_flag gDrainThreadStarted;
+// Set by the drain thread itself, so it is never read before it is written
+thread_local bool t_isDrainThread = false;
+std::atomic<bool> gDrainRequested(false);
+std::mutex& gDrainRequestMutex = *new std::mutex();
+std::condition_variable& gDrainRequestCondition = *new std::condition_variable();
+
+void retireLogRing(void *ring) {
+  if (ring != nullptr) {
+    static_cast<LogRing*>(ring)->retired.store(true, std::memory_order_release);
+  }
+}
+
+facebook::ThreadLocal<LogRing>& currentLogRing() {
+  static facebook::ThreadLocal<LogRing> ring(retireLogRing);
+  return ring;
+}
+
+LogRing *getOrCreateLogRing() {
+  auto& threadRing = currentLogRing();
+  LogRing *ring = threadRing.get();
+  if (ring == nullptr) {
+    ring = new LogRing();
+    {
+      std::lock_guard<std::mutex> lock(gRingsMutex);
+      gRings.push_back(ring);
+    }
+    threadRing.reset(ring);
+  }
+  return ring;
+}
+
+void drainLogRings() {
+  std::lock_guard<std::mutex> lock(gRingsMutex);
+  for (auto it = gRings.begin(); it != gRings.end();) {
+    LogRing *ring = *it;
+    // Read retired first: a retired ring gets no more records
+    bool retired = ring->retired.load(std::memory_order_acquire);
+    ring->drain();
+    if (retired) {
+      delete ring;
+      it = gRings.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Lets the logging thread make room in its own ring
+void drainLogRing(LogRing *ring) {
+  std::lock_guard<std::mutex> lock(gRingsMutex);
+  ring->drain();
+}
+
+void requestDrain() {
+  if (!gDrainRequested.exchange(true, std::memory_order_acq_rel)) {
+    gDrainRequestCondition.notify_one();
+  }
+}
+
+void runDrainThread() {
+  t_isDrainThread = true;
+  unsigned long long reportedDropCount = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(gDrainRequestMutex);
+      // Notifications may be missed since producers don't take the lock, so
+      // also drain periodically
+      gDrainRequestCondition.wait_for(lock, kDrainInterval, [] {
+        return gDrainRequested.load(std::memory_order_acquire);
+      });
+    }
+    gDrainRequested.store(false, std::memory_order_release);
+    drainLogRings();
+
+    unsigned long long dropCount = gDroppedLogCount.load(std::memory_order_relaxed);
+    if (dropCount != reportedDropCount) {
+      char message[64];
+      snprintf(message, sizeof(message), "Dropped %llu log messages",
+               dropCount - reportedDropCount);
+      writeToSink(ANDROID_LOG_WARN, "libfb", message);
+      reportedDropCount = dropCount;
+    }
+  }
+}
+
+void writeLog(int prio, const char *tag, const char *message, size_t messageLength) {
+  if (!gAsyncLogging.load(std::memory_order_acquire) || t_isDrainThread) {
+    // The drain thread may log from a sink, and can't wait for itself
+    writeToSink(prio, tag, message);
+    return;
+  }
+
+  if (prio >= ANDROID_LOG_FATAL) {
+    flushLogs();
+    writeToSink(prio, tag, message);
+    return;
+  }
+
+  LogRing *ring = getOrCreateLogRing();
+  if (ring->tryAppend(prio, tag, message, messageLength)) {
+    requestDrain();
+    return;
+  }
+  switch (gOverflowPolicy.load(std::memory_order_relaxed)) {
+    case LOG_OVERFLOW_BLOCK:
+      // Only this thread appends to its ring, so once drained the message fits
+      drainLogRing(ring);
+      ring->tryAppend(prio, tag, message, messageLength);
+      requestDrain();
+      break;
+    case LOG_OVERFLOW_WRITE_THROUGH:
+      writeToSink(prio, tag, message);
+      break;
+    default:
+      gDroppedLogCount.fetch_add(1, std::memory_order_relaxed);
+      requestDrain();
+      break;
+  }
+}
+
+} // namespace
+
+void setLogSink(LogSink logSink) {
+  gLogSink.store(logSink, std::memory_order_release);
+}
+
+void setAsyncLogging(int enabled, LogOverflowPolicy overflowPolicy) {
+  gOverflowPolicy.store(overflowPolicy, std::memory_order_relaxed);
+  if (enabled) {
+    std::call_once(gDrainThreadStarted, [] {
+      std::thread(runDrainThread).detach();
+    });
+    gAsyncLogging.store(true, std::memory_order_release);
+  } else {
+    gAsyncLogging.store(false, std::memory_order_release);
+    flushLogs();
+  }
+}
+
+void flushLogs(void) {
+  drainLogRings();
+}
+
+unsigned long long getDroppedLogCount(void) {
+  return gDroppedLogCount.load(std::memory_order_relaxed);
+}
+
 int fb_printLog(int prio, const char *tag,  const char *fmt, ...) {
   char logBuffer[LOG_BUFFER_SIZE];
 
@@ -29,7 +307,9 @@ int fb_printLog(int prio, const char *tag,  const char *fmt, ...) {
   if (gLogHandler != NULL) {
       gLogHandler(prio, tag, logBuffer);
   }
-  __android_log_write(prio, tag, logBuffer);
+  if (result >= 0) {
+    writeLog(prio, tag, logBuffer, std::min<size_t>(result, sizeof(logBuffer) - 1));
+  }
   return result;
 }
 
@@ -17,6 +17,10 @@ namespace jni {
 
 static jfieldID gCountableNativePtr;
 
+// Every Java object that wraps a Countable needs one of these, and they come
+// and go at the same rate as the Countables themselves
+using CountableHolderPool = ObjectPool<RefPtr<Countable>>;
+
 static RefPtr<Countable>* rawCountableFromJava(JNIEnv* env, jobject obj) {
   FBASSERT(obj);
   return reinterpret_cast<RefPtr<Countable>*>(env->GetLongField(obj, gCountableNativePtr));
@@ -32,7 +36,8 @@ void setCountableForJava(JNIEnv* env, jobject obj, RefPtr<Countable>&& countable
   FBASSERTMSGF(oldValue == 0, "Cannot reinitialize object; expected nullptr, got %x", oldValue);
 
   FBASSERT(countable);
-  uintptr_t fieldValue = (uintptr_t) new RefPtr<Countable>(std::move(countable));
+  uintptr_t fieldValue = (uintptr_t)
+    new (CountableHolderPool::allocate()) RefPtr<Countable>(std::move(countable));
   env->SetLongField(obj, gCountableNativePtr, fieldValue);
 }
 
@@ -55,7 +60,12 @@ void dispose(JNIEnv* env, jobject obj) {
   // Clear out the old value to avoid double-frees
   env->SetLongField(obj, gCountableNativePtr, 0);
 
-  delete countable;
+  countable->~RefPtr<Countable>();
+  CountableHolderPool::deallocate(countable);
+}
+
+ObjectPoolStats getCountableHolderPoolStats() {
+  return CountableHolderPool::getStats();
 }
 
 void CountableOnLoad(JNIEnv* env) {
@@ -10,6 +10,7 @@
 #pragma once
 #include <jni.h>
 #include <fb/Countable.h>
+#include <fb/ObjectPool.h>
 #include <fb/RefPtr.h>
 
 namespace facebook {
@@ -27,6 +28,9 @@ template <typename T> RefPtr<T> extractPossiblyNullRefPtr(JNIEnv* env, jobject o
 
 void setCountableForJava(JNIEnv* env, jobject obj, RefPtr<Countable>&& countable);
 
+// The RefPtrs that Java objects hold their Countable through are pooled
+ObjectPoolStats getCountableHolderPoolStats();
+
 void CountableOnLoad(JNIEnv* env);
 
 } }
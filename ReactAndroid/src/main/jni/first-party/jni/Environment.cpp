@@ -8,26 +8,29 @@
  */
 
 #include <pthread.h>
+#include <fb/assert.h>
 #include <fb/log.h>
-#include <fb/StaticInitialized.h>
-#include <fb/ThreadLocal.h>
 #include <jni/Environment.h>
 
 namespace facebook {
 namespace jni {
 
-static StaticInitialized<ThreadLocal<JNIEnv>> g_env;
+// A plain thread_local pointer rather than a pthread key: reading it is a TLS
+// load instead of a call into libc. Nothing needs to happen when a thread
+// exits, so this doesn't need a destructor.
+static thread_local JNIEnv* t_env = nullptr;
 static JavaVM* g_vm = nullptr;
+static pthread_key_t g_detachAtExitKey;
 
 /* static */
 JNIEnv* Environment::current() {
-  JNIEnv* env = g_env->get();
+  JNIEnv* env = t_env;
   if ((env == nullptr) && (g_vm != nullptr)) {
     if (g_vm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_OK) {
       FBLOGE("Error retrieving JNI Environment, thread is probably not attached to JVM");
       env = nullptr;
     } else {
-      g_env->reset(env);
+      t_env = env;
     }
   }
   return env;
@@ -35,20 +38,28 @@ JNIEnv* Environment::current() {
 
 /* static */
 void Environment::detachCurrentThread() {
-  auto env = g_env->get();
+  auto env = t_env;
   if (env) {
     FBASSERT(g_vm);
     g_vm->DetachCurrentThread();
-    g_env->reset();
+    t_env = nullptr;
   }
 }
 
+static void detachAtThreadExit(void*) {
+  // Don't go through t_env: TLS may already have been torn down (emutls uses
+  // a pthread key too, and destructors run in no particular order)
+  g_vm->DetachCurrentThread();
+}
+
 struct EnvironmentInitializer {
   EnvironmentInitializer(JavaVM* vm) {
       FBASSERT(!g_vm);
       FBASSERT(vm);
       g_vm = vm;
-      g_env.initialize([] (void*) {});
+      int ret = pthread_key_create(&g_detachAtExitKey, detachAtThreadExit);
+      FBASSERTMSGF(ret == 0, "pthread_key_create failed: %d", ret);
+      (void) ret;
   }
 };
 
@@ -59,22 +70,28 @@ void Environment::initialize(JavaVM* vm) {
 
 /* static */
 JNIEnv* Environment::ensureCurrentThreadIsAttached() {
-  auto env = g_env->get();
+  auto env = t_env;
   if (!env) {
     FBASSERT(g_vm);
     g_vm->AttachCurrentThread(&env, nullptr);
-    g_env->reset(env);
+    t_env = env;
   }
   return env;
 }
 
+/* static */
+bool Environment::isCurrentThreadAttached() {
+  FBASSERT(g_vm);
+  JNIEnv* env = nullptr;
+  return g_vm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_EDETACHED;
+}
+
 ThreadScope::ThreadScope()
     : attachedWithThisScope_(false) {
-  JNIEnv* env = nullptr;
-  if (g_vm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_EDETACHED) {
+  if (Environment::isCurrentThreadAttached()) {
     return;
   }
-  env = facebook::jni::Environment::ensureCurrentThreadIsAttached();
+  JNIEnv* env = facebook::jni::Environment::ensureCurrentThreadIsAttached();
   FBASSERT(env);
   attachedWithThisScope_ = true;
 }
@@ -85,5 +102,17 @@ ThreadScope::~ThreadScope() {
   }
 }
 
-} }
+/* static */
+void ThreadScope::attachUntilThreadExit() {
+  if (pthread_getspecific(g_detachAtExitKey) != nullptr ||
+      Environment::isCurrentThreadAttached()) {
+    // Either we already did this, or somebody else owns the attachment
+    return;
+  }
+  JNIEnv* env = Environment::ensureCurrentThreadIsAttached();
+  FBASSERT(env);
+  // The value only needs to be non-null for the destructor to run
+  pthread_setspecific(g_detachAtExitKey, env);
+}
 
+} }
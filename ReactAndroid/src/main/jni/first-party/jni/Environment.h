@@ -21,6 +21,8 @@ struct Environment {
   static void initialize(JavaVM* vm);
   static JNIEnv* ensureCurrentThreadIsAttached();
   static void detachCurrentThread();
+  // Asks the JVM, rather than relying on the cached JNIEnv
+  static bool isCurrentThreadAttached();
 };
 
 /**
@@ -53,6 +55,15 @@ class ThreadScope {
   ThreadScope& operator=(ThreadScope&&) = delete;
   ~ThreadScope();
 
+  /**
+   * Attaches the current thread to the JVM, if it isn't already, and only detaches it when the
+   * thread exits. Worker threads that call into Java repeatedly should use this instead of a
+   * ThreadScope per unit of work, which attaches and detaches every time (~100us each way). The
+   * thread must not have any Java frames on its stack when it exits, which is the case for
+   * threads created from C++.
+   */
+  static void attachUntilThreadExit();
+
  private:
   bool attachedWithThisScope_;
 };
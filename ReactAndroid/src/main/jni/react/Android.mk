@@ -6,10 +6,21 @@ LOCAL_MODULE := libreactnative
 
 LOCAL_SRC_FILES := \
   Bridge.cpp \
+  BridgeLatency.cpp \
+  BridgeRecorder.cpp \
+  BridgeTraffic.cpp \
   JSCExecutor.cpp \
+  JSCHeapSampler.cpp \
   JSCHelpers.cpp \
+  JSCTraceRecorder.cpp \
+  LongTaskWatchdog.cpp \
   MethodCall.cpp \
+  NativeHookStats.cpp \
   Platform.cpp \
+  ProfileWriter.cpp \
+  SamplingProfiler.cpp \
+  StartupTimeline.cpp \
+  TraceRecorder.cpp \
   Value.cpp \
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/..
@@ -19,7 +30,11 @@ LOCAL_CFLAGS := \
   -DLOG_TAG=\"ReactNative\"
 
 LOCAL_LDLIBS += -landroid
+# ProfileWriter compresses with zlib
+LOCAL_EXPORT_LDLIBS := -lz
 LOCAL_CFLAGS += -Wall -Werror -fexceptions -frtti
+# SamplingProfiler walks stacks through frame pointers
+LOCAL_CFLAGS += -fno-omit-frame-pointer
 CXX11_FLAGS := -std=c++11
 LOCAL_CFLAGS += $(CXX11_FLAGS)
 LOCAL_EXPORT_CPPFLAGS := $(CXX11_FLAGS)
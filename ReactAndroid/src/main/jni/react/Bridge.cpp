@@ -2,14 +2,14 @@
 
 #include "Bridge.h"
 
-#ifdef WITH_FBSYSTRACE
-#include <fbsystrace.h>
-using fbsystrace::FbSystraceSection;
-using fbsystrace::FbSystraceAsyncFlow;
-#endif
 #include <folly/Memory.h>
+#include <glog/logging.h>
 
+#include "BridgeLatency.h"
 #include "Platform.h"
+#include "SamplingProfiler.h"
+#include "SystraceSection.h"
+#include "TraceRecorder.h"
 
 namespace facebook {
 namespace react {
@@ -51,52 +51,38 @@ void Bridge::callFunction(
     const std::string& methodId,
     const folly::dynamic& arguments,
     const std::string& tracingName) {
-  #ifdef WITH_FBSYSTRACE
   int systraceCookie = m_systraceCookie++;
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      tracingName.c_str(),
-      systraceCookie);
-  #endif
-
-  #ifdef WITH_FBSYSTRACE
-  runOnExecutorQueue(executorToken, [moduleId, methodId, arguments, tracingName, systraceCookie] (JSExecutor* executor) {
-    FbSystraceAsyncFlow::end(
-        TRACE_TAG_REACT_CXX_BRIDGE,
-        tracingName.c_str(),
-        systraceCookie);
-    FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, tracingName.c_str());
-  #else
-  runOnExecutorQueue(executorToken, [moduleId, methodId, arguments, tracingName] (JSExecutor* executor) {
-  #endif
+  SystraceAsyncFlow::begin(tracingName.c_str(), systraceCookie);
+  uint32_t latencyNameId = TraceRecorder::internName(tracingName.c_str());
+
+  runOnExecutorQueue(executorToken, [moduleId, methodId, arguments, tracingName, systraceCookie, latencyNameId] (JSExecutor* executor) {
+    SystraceAsyncFlow::end(tracingName.c_str(), systraceCookie);
+    SystraceSection s(tracingName.c_str());
+    SamplingProfiler::ActivityScope activity(SamplingProfiler::Activity::CallFunction, latencyNameId);
+    uint64_t start = BridgeLatency::nowNanos();
     // This is safe because we are running on the executor's thread: it won't
     // destruct until after it's been unregistered (which we check above) and
     // that will happen on this thread
     executor->callFunction(moduleId, methodId, arguments);
-  });
+    BridgeLatency::record(
+      BridgeLatency::Kind::JSCall, latencyNameId, BridgeLatency::nowNanos() - start);
+  }, LongTaskWatchdog::TaskOrigin::callFunction(latencyNameId));
 }
 
 void Bridge::invokeCallback(ExecutorToken executorToken, const double callbackId, const folly::dynamic& arguments) {
-  #ifdef WITH_FBSYSTRACE
   int systraceCookie = m_systraceCookie++;
-  FbSystraceAsyncFlow::begin(
-      TRACE_TAG_REACT_CXX_BRIDGE,
-      "<callback>",
-      systraceCookie);
-  #endif
+  SystraceAsyncFlow::begin("<callback>", systraceCookie);
 
-  #ifdef WITH_FBSYSTRACE
   runOnExecutorQueue(executorToken, [callbackId, arguments, systraceCookie] (JSExecutor* executor) {
-    FbSystraceAsyncFlow::end(
-        TRACE_TAG_REACT_CXX_BRIDGE,
-        "<callback>",
-        systraceCookie);
-    FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "Bridge.invokeCallback");
-  #else
-  runOnExecutorQueue(executorToken, [callbackId, arguments] (JSExecutor* executor) {
-  #endif
+    SystraceAsyncFlow::end("<callback>", systraceCookie);
+    SystraceSection s("Bridge.invokeCallback");
+    static const uint32_t kLatencyNameId = TraceRecorder::internName("<callback>");
+    SamplingProfiler::ActivityScope activity(SamplingProfiler::Activity::InvokeCallback, 0);
+    uint64_t start = BridgeLatency::nowNanos();
     executor->invokeCallback(callbackId, arguments);
-  });
+    BridgeLatency::record(
+      BridgeLatency::Kind::JSCall, kLatencyNameId, BridgeLatency::nowNanos() - start);
+  }, LongTaskWatchdog::TaskOrigin::invokeCallback(callbackId));
 }
 
 void Bridge::setGlobalVariable(const std::string& propName, const std::string& jsonValue) {
@@ -139,7 +125,22 @@ void Bridge::handleMemoryPressureCritical() {
   });
 }
 
+std::string Bridge::getHeapSamplesJSON() {
+  // Intentionally doesn't post to jsqueue, so that the samples can be read while JS is busy. The
+  // registration lock keeps destroy() from unregistering and freeing the executor meanwhile.
+  std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
+  if (m_destroyed->load(std::memory_order_acquire)) {
+    return "[]";
+  }
+  auto it = m_executorMap.find(*m_mainExecutorToken);
+  if (it == m_executorMap.end()) {
+    return "[]";
+  }
+  return it->second->executor_->getHeapSamplesJSON();
+}
+
 void Bridge::callNativeModules(JSExecutor& executor, const std::string& callJSON, bool isEndOfBatch) {
+  SystraceSection s("Bridge::callNativeModules");
   m_callback->onCallNativeModules(getTokenForExecutor(executor), callJSON, isEndOfBatch);
 }
 
@@ -154,10 +155,11 @@ ExecutorToken Bridge::registerExecutor(
 
   std::lock_guard<std::mutex> registrationGuard(m_registrationMutex);
 
-  CHECK(m_executorTokenMap.find(executor.get()) == m_executorTokenMap.end())
-      << "Trying to register an already registered executor!";
-
-  m_executorTokenMap.emplace(executor.get(), token);
+  for (JSExecutor* e = executor.get(); e != nullptr; e = e->getWrappedExecutor()) {
+    CHECK(m_executorTokenMap.find(e) == m_executorTokenMap.end())
+        << "Trying to register an already registered executor!";
+    m_executorTokenMap.emplace(e, token);
+  }
   m_executorMap.emplace(
       token,
       folly::make_unique<ExecutorRegistration>(std::move(executor), std::move(messageQueueThread)));
@@ -177,7 +179,9 @@ std::unique_ptr<JSExecutor> Bridge::unregisterExecutor(ExecutorToken executorTok
 
     executor = std::move(it->second->executor_);
     m_executorMap.erase(it);
-    m_executorTokenMap.erase(executor.get());
+    for (JSExecutor* e = executor.get(); e != nullptr; e = e->getWrappedExecutor()) {
+      m_executorTokenMap.erase(e);
+    }
   }
 
   m_callback->onExecutorUnregistered(executorToken);
@@ -215,7 +219,10 @@ void Bridge::destroy() {
   mainExecutor->destroy();
 }
 
-void Bridge::runOnExecutorQueue(ExecutorToken executorToken, std::function<void(JSExecutor*)> task) {
+void Bridge::runOnExecutorQueue(
+    ExecutorToken executorToken,
+    std::function<void(JSExecutor*)> task,
+    const LongTaskWatchdog::TaskOrigin& origin) {
   if (m_destroyed->load(std::memory_order_acquire)) {
     return;
   }
@@ -226,8 +233,19 @@ void Bridge::runOnExecutorQueue(ExecutorToken executorToken, std::function<void(
     return;
   }
 
+  static const uint32_t kMainQueueNameId = TraceRecorder::internName("main");
+  static const uint32_t kWorkerQueueNameId = TraceRecorder::internName("worker");
+  uint32_t queueNameId = executorToken == *m_mainExecutorToken ? kMainQueueNameId : kWorkerQueueNameId;
+  auto longTaskQueue = queueNameId == kMainQueueNameId
+    ? LongTaskWatchdog::Queue::JS
+    : LongTaskWatchdog::Queue::JSWorker;
+  uint64_t queuedNanos = BridgeLatency::nowNanos();
+
   std::shared_ptr<std::atomic_bool> isDestroyed = m_destroyed;
-  executorMessageQueueThread->runOnQueue([this, isDestroyed, executorToken, task=std::move(task)] {
+  executorMessageQueueThread->runOnQueue([this, isDestroyed, executorToken, queueNameId, longTaskQueue, origin, queuedNanos, task=std::move(task)] {
+    BridgeLatency::record(
+      BridgeLatency::Kind::QueueWait, queueNameId, BridgeLatency::nowNanos() - queuedNanos);
+    LongTaskWatchdog::TaskScope longTask(longTaskQueue, origin);
     if (isDestroyed->load(std::memory_order_acquire)) {
       return;
     }
@@ -13,6 +13,7 @@
 #include "MessageQueueThread.h"
 #include "MethodCall.h"
 #include "JSModulesUnbundle.h"
+#include "LongTaskWatchdog.h"
 #include "Value.h"
 
 namespace folly {
@@ -99,6 +100,13 @@ public:
   void handleMemoryPressureModerate();
   void handleMemoryPressureCritical();
 
+  /**
+   * Returns the heap samples of the main executor as a JSON array, see
+   * JSExecutor::getHeapSamplesJSON(). Can be called from any thread, and
+   * returns an empty array once the bridge is destroyed.
+   */
+  std::string getHeapSamplesJSON();
+
   /**
    * Invokes a set of native module calls on behalf of the given executor.
    *
@@ -138,7 +146,10 @@ public:
    */
   void destroy();
 private:
-  void runOnExecutorQueue(ExecutorToken token, std::function<void(JSExecutor*)> task);
+  void runOnExecutorQueue(
+    ExecutorToken token,
+    std::function<void(JSExecutor*)> task,
+    const LongTaskWatchdog::TaskOrigin& origin = LongTaskWatchdog::TaskOrigin());
   std::unique_ptr<BridgeCallback> m_callback;
   // This is used to avoid a race condition where a proxyCallback gets queued after ~Bridge(),
   // on the same thread. In that case, the callback will try to run the task on m_callback which
@@ -150,9 +161,7 @@ private:
   std::unordered_map<JSExecutor*, ExecutorToken> m_executorTokenMap;
   std::unordered_map<ExecutorToken, std::unique_ptr<ExecutorRegistration>> m_executorMap;
   std::mutex m_registrationMutex;
-  #ifdef WITH_FBSYSTRACE
   std::atomic_uint_least32_t m_systraceCookie = ATOMIC_VAR_INIT();
-  #endif
 
   MessageQueueThread* getMessageQueueThread(const ExecutorToken& executorToken);
   JSExecutor* getExecutor(const ExecutorToken& executorToken);
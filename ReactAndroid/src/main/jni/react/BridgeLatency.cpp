@@ -0,0 +1,236 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BridgeLatency.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <fb/ThreadLocal.h>
+
+#include "TraceRecorder.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// Values below 2 * kSubBuckets get a bucket each, larger ones kSubBuckets
+// buckets per power of two
+const int kSubBucketBits = 4;
+const uint64_t kSubBuckets = 1 << kSubBucketBits;
+const int kMaxShift = 30;
+const size_t kBuckets = (kMaxShift + 2) * kSubBuckets;
+const uint64_t kMaxValue = ((2 * kSubBuckets) << kMaxShift) - 1;
+
+size_t bucketIndex(uint64_t value) {
+  value = std::min(value, kMaxValue);
+  if (value < 2 * kSubBuckets) {
+    return value;
+  }
+  int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+  return (shift << kSubBucketBits) + (value >> shift);
+}
+
+// The largest value that goes to the bucket
+uint64_t bucketValue(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return index;
+  }
+  int shift = (index >> kSubBucketBits) - 1;
+  uint64_t subBucket = index - (shift << kSubBucketBits);
+  return ((subBucket + 1) << shift) - 1;
+}
+
+// Written by its thread only, without read-modify-write instructions
+struct Histogram {
+  Histogram() {
+    for (auto& count : counts) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void record(uint64_t value) {
+    auto& count = counts[bucketIndex(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> counts[kBuckets];
+};
+
+using Counts = std::vector<uint64_t>;
+
+void addTo(Counts& to, const Histogram& histogram) {
+  to.resize(kBuckets);
+  for (size_t i = 0; i < kBuckets; i++) {
+    to[i] += histogram.counts[i].load(std::memory_order_relaxed);
+  }
+}
+
+uint64_t makeKey(BridgeLatency::Kind kind, uint32_t nameId) {
+  return (static_cast<uint64_t>(kind) << 32) | nameId;
+}
+
+struct ThreadState {
+  // Only modified by its thread, with State::mutex held
+  std::unordered_map<uint64_t, Histogram*> histograms;
+};
+
+struct State {
+  std::mutex mutex;
+  std::vector<ThreadState*> threads;
+  // Counts of threads that have exited
+  std::unordered_map<uint64_t, Counts> exited;
+  // Counts as of the last reset
+  std::unordered_map<uint64_t, Counts> baselines;
+};
+
+State& state() {
+  // Leaked, since threads may record while static destructors run
+  static State* s = new State();
+  return *s;
+}
+
+ThreadState*& threadState() {
+  // A thread_local for speed; exitHandler() only cleans up
+  static thread_local ThreadState* t_state = nullptr;
+  return t_state;
+}
+
+void onThreadExit(void* obj) {
+  ThreadState* threadStateToDelete = static_cast<ThreadState*>(obj);
+  if (threadStateToDelete == nullptr) {
+    return;
+  }
+  // Later thread exit handlers may still record, with a new ThreadState
+  threadState() = nullptr;
+  {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (auto& entry : threadStateToDelete->histograms) {
+      addTo(s.exited[entry.first], *entry.second);
+    }
+    s.threads.erase(std::find(s.threads.begin(), s.threads.end(), threadStateToDelete));
+  }
+  for (auto& entry : threadStateToDelete->histograms) {
+    delete entry.second;
+  }
+  delete threadStateToDelete;
+}
+
+ThreadLocal<ThreadState>& exitHandler() {
+  static ThreadLocal<ThreadState>* handler = new ThreadLocal<ThreadState>(&onThreadExit);
+  return *handler;
+}
+
+ThreadState& localState() {
+  ThreadState*& local = threadState();
+  if (local == nullptr) {
+    local = new ThreadState();
+    exitHandler().reset(local);
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.threads.push_back(local);
+  }
+  return *local;
+}
+
+// The value at or below which fraction of the counted values are
+uint64_t percentile(const Counts& counts, uint64_t total, double fraction) {
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucketValue(i);
+    }
+  }
+  return bucketValue(counts.size() - 1);
+}
+
+}
+
+void BridgeLatency::record(Kind kind, uint32_t nameId, uint64_t nanos) {
+  ThreadState& local = localState();
+  uint64_t key = makeKey(kind, nameId);
+  auto it = local.histograms.find(key);
+  if (it == local.histograms.end()) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    it = local.histograms.emplace(key, new Histogram()).first;
+  }
+  it->second->record(nanos);
+}
+
+std::vector<BridgeLatency::Stats> BridgeLatency::getStats(bool reset) {
+  State& s = state();
+  std::unordered_map<uint64_t, Counts> totals;
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    totals = s.exited;
+    for (ThreadState* thread : s.threads) {
+      for (auto& entry : thread->histograms) {
+        addTo(totals[entry.first], *entry.second);
+      }
+    }
+
+    for (auto& entry : totals) {
+      Counts& baseline = s.baselines[entry.first];
+      baseline.resize(kBuckets);
+      for (size_t i = 0; i < kBuckets; i++) {
+        uint64_t total = entry.second[i];
+        entry.second[i] = total - baseline[i];
+        if (reset) {
+          baseline[i] = total;
+        }
+      }
+    }
+  }
+
+  std::vector<Stats> stats;
+  for (auto& entry : totals) {
+    const Counts& counts = entry.second;
+    uint64_t count = 0;
+    size_t highest = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+      if (counts[i] != 0) {
+        count += counts[i];
+        highest = i;
+      }
+    }
+    if (count == 0) {
+      continue;
+    }
+    const char* name = TraceRecorder::getName(static_cast<uint32_t>(entry.first));
+    stats.push_back({
+      static_cast<Kind>(entry.first >> 32),
+      name != nullptr ? name : "",
+      count,
+      percentile(counts, count, 0.5),
+      percentile(counts, count, 0.9),
+      percentile(counts, count, 0.99),
+      bucketValue(highest),
+    });
+  }
+  std::sort(stats.begin(), stats.end(), [] (const Stats& a, const Stats& b) {
+    return a.kind != b.kind ? a.kind < b.kind : a.p99Nanos > b.p99Nanos;
+  });
+  return stats;
+}
+
+const char* BridgeLatency::getKindName(Kind kind) {
+  switch (kind) {
+    case Kind::QueueWait:
+      return "queueWait";
+    case Kind::JSCall:
+      return "jsCall";
+    case Kind::NativeCall:
+      return "nativeCall";
+  }
+  return "";
+}
+
+} }
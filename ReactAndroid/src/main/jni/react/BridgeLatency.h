@@ -0,0 +1,59 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Always-on latency histograms of bridge traffic, keyed by a kind and a name
+ * interned with TraceRecorder::internName().
+ *
+ * Each thread records into its own histograms, which are only merged when
+ * stats are read, so recording takes no locks once a thread has seen a key.
+ * Histograms have 16 linear buckets per power of two, so reported values are
+ * within 1/16 of the recorded ones, up to about 34 seconds.
+ */
+class BridgeLatency {
+public:
+  enum class Kind : uint8_t {
+    // Time from posting a task to a JS executor's queue until it runs, by queue
+    QueueWait,
+    // Time spent executing a call into JS, by tracing name of the call
+    JSCall,
+    // Time spent executing a native module method, by "Module.method"
+    NativeCall,
+  };
+
+  struct Stats {
+    Kind kind;
+    std::string name;
+    uint64_t count;
+    uint64_t p50Nanos;
+    uint64_t p90Nanos;
+    uint64_t p99Nanos;
+    uint64_t maxNanos;
+  };
+
+  static uint64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void record(Kind kind, uint32_t nameId, uint64_t nanos);
+
+  /**
+   * Returns the stats of every key with values recorded since the last reset.
+   * If reset is true, this starts a new window.
+   */
+  static std::vector<Stats> getStats(bool reset);
+
+  static const char* getKindName(Kind kind);
+};
+
+} }
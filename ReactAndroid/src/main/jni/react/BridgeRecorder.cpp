@@ -0,0 +1,148 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BridgeRecorder.h"
+
+#include <folly/json.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+using Type = BridgeTrafficRecord::Type;
+
+// Runs call, then writes record with when it began and how long it took
+template <typename F>
+void recordCall(BridgeTrafficWriter& writer, BridgeTrafficRecord&& record, F&& call) {
+  record.timestampNanos = writer.elapsedNanos();
+  call();
+  record.durationNanos = writer.elapsedNanos() - record.timestampNanos;
+  writer.write(record);
+}
+
+}
+
+std::unique_ptr<JSExecutor> RecordingJSExecutorFactory::createJSExecutor(Bridge *bridge) {
+  return std::unique_ptr<JSExecutor>(
+    new RecordingJSExecutor(m_factory->createJSExecutor(bridge), m_writer));
+}
+
+void RecordingJSExecutor::loadApplicationScript(
+    const std::string& script,
+    const std::string& sourceURL) {
+  BridgeTrafficRecord record;
+  record.type = Type::LoadScript;
+  record.target = sourceURL;
+  recordCall(*m_writer, std::move(record), [&] {
+    m_executor->loadApplicationScript(script, sourceURL);
+  });
+}
+
+void RecordingJSExecutor::loadApplicationUnbundle(
+    std::unique_ptr<JSModulesUnbundle> bundle,
+    const std::string& startupCode,
+    const std::string& sourceURL) {
+  BridgeTrafficRecord record;
+  record.type = Type::LoadScript;
+  record.target = sourceURL;
+  recordCall(*m_writer, std::move(record), [&] {
+    m_executor->loadApplicationUnbundle(std::move(bundle), startupCode, sourceURL);
+  });
+}
+
+void RecordingJSExecutor::callFunction(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) {
+  BridgeTrafficRecord record;
+  record.type = Type::CallFunction;
+  record.target = moduleId;
+  record.method = methodId;
+  record.json = folly::toJson(arguments).c_str();
+  recordCall(*m_writer, std::move(record), [&] {
+    m_executor->callFunction(moduleId, methodId, arguments);
+  });
+}
+
+void RecordingJSExecutor::invokeCallback(
+    const double callbackId,
+    const folly::dynamic& arguments) {
+  BridgeTrafficRecord record;
+  record.type = Type::InvokeCallback;
+  record.callbackId = callbackId;
+  record.json = folly::toJson(arguments).c_str();
+  recordCall(*m_writer, std::move(record), [&] {
+    m_executor->invokeCallback(callbackId, arguments);
+  });
+}
+
+void RecordingJSExecutor::setGlobalVariable(
+    const std::string& propName,
+    const std::string& jsonValue) {
+  BridgeTrafficRecord record;
+  record.type = Type::SetGlobalVariable;
+  record.target = propName;
+  record.json = jsonValue;
+  recordCall(*m_writer, std::move(record), [&] {
+    m_executor->setGlobalVariable(propName, jsonValue);
+  });
+}
+
+void* RecordingJSExecutor::getJavaScriptContext() {
+  return m_executor->getJavaScriptContext();
+}
+
+bool RecordingJSExecutor::supportsProfiling() {
+  return m_executor->supportsProfiling();
+}
+
+void RecordingJSExecutor::startProfiler(const std::string &titleString) {
+  m_executor->startProfiler(titleString);
+}
+
+void RecordingJSExecutor::stopProfiler(const std::string &titleString, const std::string &filename) {
+  m_executor->stopProfiler(titleString, filename);
+}
+
+void RecordingJSExecutor::handleMemoryPressureModerate() {
+  m_executor->handleMemoryPressureModerate();
+}
+
+void RecordingJSExecutor::handleMemoryPressureCritical() {
+  m_executor->handleMemoryPressureCritical();
+}
+
+std::string RecordingJSExecutor::getHeapSamplesJSON() {
+  return m_executor->getHeapSamplesJSON();
+}
+
+void RecordingJSExecutor::destroy() {
+  m_executor->destroy();
+  // Nothing is called into JS after this
+  m_writer->close();
+}
+
+JSExecutor* RecordingJSExecutor::getWrappedExecutor() {
+  return m_executor.get();
+}
+
+void RecordingBridgeCallback::onCallNativeModules(
+    ExecutorToken executorToken,
+    const std::string& callJSON,
+    bool isEndOfBatch) {
+  BridgeTrafficRecord record;
+  record.type = Type::CallNativeModules;
+  record.json = callJSON;
+  record.isEndOfBatch = isEndOfBatch;
+  // Without a duration: the callback only posts the batch to the native
+  // modules thread, so timing it wouldn't say how long the calls took
+  record.timestampNanos = m_writer->elapsedNanos();
+  m_writer->write(record);
+  m_callback->onCallNativeModules(executorToken, callJSON, isEndOfBatch);
+}
+
+void RecordingBridgeCallback::onExecutorUnregistered(ExecutorToken executorToken) {
+  m_callback->onExecutorUnregistered(executorToken);
+}
+
+} }
@@ -0,0 +1,104 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Bridge.h"
+#include "BridgeTraffic.h"
+#include "Executor.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Creates executors that record the calls into JS, see RecordingJSExecutor.
+ * factory must outlive this factory.
+ */
+class RecordingJSExecutorFactory : public JSExecutorFactory {
+public:
+  RecordingJSExecutorFactory(
+      JSExecutorFactory* factory,
+      std::shared_ptr<BridgeTrafficWriter> writer) :
+    m_factory(factory),
+    m_writer(std::move(writer)) {}
+
+  virtual std::unique_ptr<JSExecutor> createJSExecutor(Bridge *bridge) override;
+
+private:
+  JSExecutorFactory* m_factory;
+  std::shared_ptr<BridgeTrafficWriter> m_writer;
+};
+
+/**
+ * Records the scripts loaded, global variables set, and functions and
+ * callbacks called into the executor it wraps, with how long they took.
+ * Web workers aren't recorded.
+ */
+class RecordingJSExecutor : public JSExecutor {
+public:
+  RecordingJSExecutor(
+      std::unique_ptr<JSExecutor> executor,
+      std::shared_ptr<BridgeTrafficWriter> writer) :
+    m_executor(std::move(executor)),
+    m_writer(std::move(writer)) {}
+
+  virtual void loadApplicationScript(
+    const std::string& script,
+    const std::string& sourceURL) override;
+  virtual void loadApplicationUnbundle(
+    std::unique_ptr<JSModulesUnbundle> bundle,
+    const std::string& startupCode,
+    const std::string& sourceURL) override;
+  virtual void callFunction(
+    const std::string& moduleId,
+    const std::string& methodId,
+    const folly::dynamic& arguments) override;
+  virtual void invokeCallback(
+    const double callbackId,
+    const folly::dynamic& arguments) override;
+  virtual void setGlobalVariable(
+    const std::string& propName,
+    const std::string& jsonValue) override;
+  virtual void* getJavaScriptContext() override;
+  virtual bool supportsProfiling() override;
+  virtual void startProfiler(const std::string &titleString) override;
+  virtual void stopProfiler(const std::string &titleString, const std::string &filename) override;
+  virtual void handleMemoryPressureModerate() override;
+  virtual void handleMemoryPressureCritical() override;
+  virtual std::string getHeapSamplesJSON() override;
+  virtual void destroy() override;
+  virtual JSExecutor* getWrappedExecutor() override;
+
+private:
+  std::unique_ptr<JSExecutor> m_executor;
+  std::shared_ptr<BridgeTrafficWriter> m_writer;
+};
+
+/**
+ * Records the batches of native module calls passed to the callback it
+ * wraps, web workers' included. Only when each batch was passed is recorded,
+ * the callback hands it off to the native modules thread.
+ */
+class RecordingBridgeCallback : public BridgeCallback {
+public:
+  RecordingBridgeCallback(
+      std::unique_ptr<BridgeCallback> callback,
+      std::shared_ptr<BridgeTrafficWriter> writer) :
+    m_callback(std::move(callback)),
+    m_writer(std::move(writer)) {}
+
+  virtual void onCallNativeModules(
+      ExecutorToken executorToken,
+      const std::string& callJSON,
+      bool isEndOfBatch) override;
+
+  virtual void onExecutorUnregistered(ExecutorToken executorToken) override;
+
+private:
+  std::unique_ptr<BridgeCallback> m_callback;
+  std::shared_ptr<BridgeTrafficWriter> m_writer;
+};
+
+} }
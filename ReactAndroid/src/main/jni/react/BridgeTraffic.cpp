@@ -0,0 +1,207 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "BridgeTraffic.h"
+
+#include <errno.h>
+#include <time.h>
+
+#include <cstring>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+const char kMagic[8] = { 'R', 'N', 'B', 'R', 'I', 'D', 'G', 'E' };
+const uint32_t kVersion = 1;
+// Strings can't be longer than this, so that reading a damaged file can't
+// allocate much
+const uint64_t kMaxStringLength = 64 * 1024 * 1024;
+
+using Type = BridgeTrafficRecord::Type;
+
+uint64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void appendVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+void appendString(std::string& out, const std::string& value) {
+  appendVarint(out, value.size());
+  out += value;
+}
+
+void appendDouble(std::string& out, double value) {
+  char bytes[sizeof(value)];
+  memcpy(bytes, &value, sizeof(value));
+  out.append(bytes, sizeof(bytes));
+}
+
+bool readVarint(FILE* file, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int c = fgetc(file);
+    if (c == EOF) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool readString(FILE* file, std::string& value) {
+  uint64_t length;
+  if (!readVarint(file, length) || length > kMaxStringLength) {
+    return false;
+  }
+  value.resize(length);
+  return length == 0 || fread(&value[0], 1, length, file) == length;
+}
+
+bool readDouble(FILE* file, double& value) {
+  return fread(&value, 1, sizeof(value), file) == sizeof(value);
+}
+
+bool readRecord(FILE* file, int type, BridgeTrafficRecord& record) {
+  record.type = static_cast<Type>(type);
+  if (!readVarint(file, record.timestampNanos) || !readVarint(file, record.durationNanos)) {
+    return false;
+  }
+  switch (record.type) {
+    case Type::LoadScript:
+      return readString(file, record.target);
+    case Type::SetGlobalVariable:
+      return readString(file, record.target) && readString(file, record.json);
+    case Type::CallFunction:
+      return readString(file, record.target) &&
+        readString(file, record.method) &&
+        readString(file, record.json);
+    case Type::InvokeCallback:
+      return readDouble(file, record.callbackId) && readString(file, record.json);
+    case Type::CallNativeModules: {
+      int isEndOfBatch = fgetc(file);
+      record.isEndOfBatch = isEndOfBatch == 1;
+      return isEndOfBatch != EOF && readString(file, record.json);
+    }
+  }
+  return false;
+}
+
+}
+
+std::unique_ptr<BridgeTrafficWriter> BridgeTrafficWriter::create(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "we");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  if (fwrite(kMagic, sizeof(kMagic), 1, file) != 1 ||
+      fwrite(&kVersion, sizeof(kVersion), 1, file) != 1) {
+    int error = errno;
+    fclose(file);
+    errno = error;
+    return nullptr;
+  }
+  return std::unique_ptr<BridgeTrafficWriter>(new BridgeTrafficWriter(file, nowNanos()));
+}
+
+BridgeTrafficWriter::BridgeTrafficWriter(FILE* file, uint64_t startNanos) :
+    m_file(file),
+    m_startNanos(startNanos) {}
+
+BridgeTrafficWriter::~BridgeTrafficWriter() {
+  close();
+}
+
+uint64_t BridgeTrafficWriter::elapsedNanos() const {
+  return nowNanos() - m_startNanos;
+}
+
+void BridgeTrafficWriter::write(const BridgeTrafficRecord& record) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_file == nullptr || m_failed) {
+    return;
+  }
+  m_buffer.clear();
+  m_buffer += static_cast<char>(record.type);
+  appendVarint(m_buffer, record.timestampNanos);
+  appendVarint(m_buffer, record.durationNanos);
+  switch (record.type) {
+    case Type::LoadScript:
+      appendString(m_buffer, record.target);
+      break;
+    case Type::SetGlobalVariable:
+      appendString(m_buffer, record.target);
+      appendString(m_buffer, record.json);
+      break;
+    case Type::CallFunction:
+      appendString(m_buffer, record.target);
+      appendString(m_buffer, record.method);
+      appendString(m_buffer, record.json);
+      break;
+    case Type::InvokeCallback:
+      appendDouble(m_buffer, record.callbackId);
+      appendString(m_buffer, record.json);
+      break;
+    case Type::CallNativeModules:
+      m_buffer += static_cast<char>(record.isEndOfBatch ? 1 : 0);
+      appendString(m_buffer, record.json);
+      break;
+  }
+  if (fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size()) {
+    m_failed = true;
+  }
+  // Records can be as large as the bundle config, don't keep their buffer
+  if (m_buffer.capacity() > 64 * 1024) {
+    std::string().swap(m_buffer);
+  }
+}
+
+bool BridgeTrafficWriter::close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_file != nullptr) {
+    if (fclose(m_file) != 0) {
+      m_failed = true;
+    }
+    m_file = nullptr;
+  }
+  return !m_failed;
+}
+
+bool BridgeTrafficReader::read(const std::string& path, const RecordCallback& onRecord) {
+  FILE* file = fopen(path.c_str(), "re");
+  if (file == nullptr) {
+    return false;
+  }
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  bool complete = fread(magic, sizeof(magic), 1, file) == 1 &&
+    memcmp(magic, kMagic, sizeof(magic)) == 0 &&
+    fread(&version, sizeof(version), 1, file) == 1 &&
+    version == kVersion;
+  while (complete) {
+    int type = fgetc(file);
+    if (type == EOF) {
+      break;
+    }
+    BridgeTrafficRecord record;
+    complete = readRecord(file, type, record);
+    if (complete) {
+      onRecord(record);
+    }
+  }
+  fclose(file);
+  return complete;
+}
+
+} }
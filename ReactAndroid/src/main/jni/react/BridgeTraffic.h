@@ -0,0 +1,107 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * A call that crossed the bridge, as recorded by the recording executor and
+ * bridge callback (BridgeRecorder.h) and replayed by bridgereplay (tools/).
+ */
+struct BridgeTrafficRecord {
+  enum class Type : uint8_t {
+    LoadScript = 1,
+    SetGlobalVariable = 2,
+    CallFunction = 3,
+    InvokeCallback = 4,
+    // A batch of native module calls returned or flushed by JS
+    CallNativeModules = 5,
+  };
+
+  Type type;
+  // Since the recording began
+  uint64_t timestampNanos = 0;
+  // How long the call into JS took, 0 for CallNativeModules
+  uint64_t durationNanos = 0;
+  // The source URL, the global variable or the module ID
+  std::string target;
+  // The method ID, for CallFunction
+  std::string method;
+  // The value of the global variable, the arguments of the call or callback,
+  // or the batch of native module calls
+  std::string json;
+  double callbackId = 0;
+  bool isEndOfBatch = false;
+};
+
+/**
+ * Writes bridge traffic to a compact binary file. Records are buffered and
+ * written out in the order they are written, which for calls is when they
+ * return, so calls come after the native module calls they flushed.
+ *
+ * The file is "RNBRIDGE", a uint32 version, then records. A record is its
+ * uint8 type, varint timestamp and duration, and the fields of its type:
+ * strings as a varint length and bytes, callback IDs as little-endian
+ * doubles and isEndOfBatch as a uint8.
+ *
+ * All methods are thread safe.
+ */
+class BridgeTrafficWriter : public noncopyable {
+public:
+  /**
+   * Returns nullptr, with errno set, if path can't be created.
+   */
+  static std::unique_ptr<BridgeTrafficWriter> create(const std::string& path);
+
+  ~BridgeTrafficWriter();
+
+  /**
+   * The time since the recording began, for record timestamps.
+   */
+  uint64_t elapsedNanos() const;
+
+  void write(const BridgeTrafficRecord& record);
+
+  /**
+   * Writes out the buffered records and closes the file. Later records are
+   * dropped. Returns false if any write failed.
+   */
+  bool close();
+
+private:
+  BridgeTrafficWriter(FILE* file, uint64_t startNanos);
+
+  std::mutex m_mutex;
+  FILE* m_file;
+  bool m_failed = false;
+  const uint64_t m_startNanos;
+  // Reused for encoding records
+  std::string m_buffer;
+};
+
+/**
+ * Reads the files written by BridgeTrafficWriter.
+ */
+class BridgeTrafficReader {
+public:
+  using RecordCallback = std::function<void(const BridgeTrafficRecord& record)>;
+
+  /**
+   * Calls onRecord with each record, in order. Returns false if the file
+   * can't be read or is malformed, which includes files truncated by a
+   * crash: the records before the damage have been read then.
+   */
+  static bool read(const std::string& path, const RecordCallback& onRecord);
+};
+
+} }
@@ -72,7 +72,23 @@ public:
   virtual void handleMemoryPressureCritical() {
     handleMemoryPressureModerate();
   };
+
+  /**
+   * Returns the heap and GC stats the executor has sampled, including at
+   * memory pressure, as a JSON array. Can be called from any thread.
+   */
+  virtual std::string getHeapSamplesJSON() {
+    return "[]";
+  };
   virtual void destroy() {};
+
+  /**
+   * Executors decorating another one, e.g. to record its traffic, return it,
+   * so that the Bridge knows its native module calls come from this one.
+   */
+  virtual JSExecutor* getWrappedExecutor() {
+    return nullptr;
+  };
   virtual ~JSExecutor() {};
 };
 
@@ -15,7 +15,12 @@
 
 #include "Bridge.h"
 #include "JSCHelpers.h"
+#include "JSCTraceRecorder.h"
+#include "NativeHookStats.h"
 #include "Platform.h"
+#include "SamplingProfiler.h"
+#include "StartupTimeline.h"
+#include "SystraceSection.h"
 #include "Value.h"
 
 #ifdef WITH_JSC_EXTRA_TRACING
@@ -28,11 +33,6 @@
 #include <jsc_memory.h>
 #endif
 
-#ifdef WITH_FBSYSTRACE
-#include <fbsystrace.h>
-using fbsystrace::FbSystraceSection;
-#endif
-
 #ifdef WITH_FB_MEMORY_PROFILING
 #include "JSCMemory.h"
 #endif
@@ -47,6 +47,7 @@ using fbsystrace::FbSystraceSection;
 
 static const int64_t NANOSECONDS_IN_SECOND = 1000000000LL;
 static const int64_t NANOSECONDS_IN_MILLISECOND = 1000000LL;
+static const int64_t DEFAULT_HEAP_SAMPLING_INTERVAL_MS = 1000;
 
 namespace facebook {
 namespace react {
@@ -67,16 +68,19 @@ static JSValueRef nativeInjectHMRUpdate(
     size_t argumentCount,
     const JSValueRef arguments[],
     JSValueRef *exception);
+static JSValueRef nativeGetHookStats(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception);
 
 static std::string executeJSCallWithJSC(
     JSGlobalContextRef ctx,
     const std::string& methodName,
     const std::vector<folly::dynamic>& arguments) {
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(
-      TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.executeJSCall",
-      "method", methodName);
-  #endif
+  SystraceSection s("JSCExecutor.executeJSCall", "method", methodName);
 
   // Evaluate script with JSC
   folly::dynamic jsonArgs(arguments.begin(), arguments.end());
@@ -87,6 +91,10 @@ static std::string executeJSCallWithJSC(
   return Value(ctx, result).toJSONString();
 }
 
+static int64_t getHeapSamplingIntervalMs(const folly::dynamic& jscConfig) {
+  return jscConfig.getDefault("HeapSamplingIntervalMs", DEFAULT_HEAP_SAMPLING_INTERVAL_MS).getInt();
+}
+
 std::unique_ptr<JSExecutor> JSCExecutorFactory::createJSExecutor(Bridge *bridge) {
   return std::unique_ptr<JSExecutor>(new JSCExecutor(bridge, cacheDir_, m_jscConfig));
 }
@@ -95,7 +103,8 @@ JSCExecutor::JSCExecutor(Bridge *bridge, const std::string& cacheDir, const foll
     m_bridge(bridge),
     m_deviceCacheDir(cacheDir),
     m_messageQueueThread(MessageQueues::getCurrentMessageQueueThread()),
-    m_jscConfig(jscConfig) {
+    m_jscConfig(jscConfig),
+    m_heapSampler(getHeapSamplingIntervalMs(jscConfig)) {
   initOnJSVMThread();
 }
 
@@ -111,7 +120,8 @@ JSCExecutor::JSCExecutor(
     m_owner(owner),
     m_deviceCacheDir(owner->m_deviceCacheDir),
     m_messageQueueThread(MessageQueues::getCurrentMessageQueueThread()),
-    m_jscConfig(jscConfig) {
+    m_jscConfig(jscConfig),
+    m_heapSampler(getHeapSamplingIntervalMs(jscConfig)) {
   // We post initOnJSVMThread here so that the owner doesn't have to wait for
   // initialization on its own thread
   m_messageQueueThread->runOnQueue([this, script, globalObjAsJSON] () {
@@ -156,19 +166,24 @@ void JSCExecutor::destroy() {
 }
 
 void JSCExecutor::initOnJSVMThread() {
+  StartupTimeline::Scope phase(StartupTimeline::Phase::CreateContext);
   #if defined(WITH_FB_JSC_TUNING)
   configureJSCForAndroid(m_jscConfig);
   #endif
   m_context = JSGlobalContextCreateInGroup(nullptr, nullptr);
   s_globalContextRefToJSCExecutor[m_context] = this;
+  // Web workers run on threads of their own, which are registered too
+  SamplingProfiler::registerCurrentThread();
   installGlobalFunction(m_context, "nativeFlushQueueImmediate", nativeFlushQueueImmediate);
   installGlobalFunction(m_context, "nativePerformanceNow", nativePerformanceNow);
   installGlobalFunction(m_context, "nativeStartWorker", nativeStartWorker);
   installGlobalFunction(m_context, "nativePostMessageToWorker", nativePostMessageToWorker);
   installGlobalFunction(m_context, "nativeTerminateWorker", nativeTerminateWorker);
   installGlobalFunction(m_context, "nativeInjectHMRUpdate", nativeInjectHMRUpdate);
+  installGlobalFunction(m_context, "nativeGetHookStats", nativeGetHookStats);
 
   installGlobalFunction(m_context, "nativeLoggingHook", JSLogging::nativeHook);
+  addTraceRecorderHooks(m_context);
 
   #ifdef WITH_JSC_EXTRA_TRACING
   addNativeTracingHooks(m_context);
@@ -206,6 +221,7 @@ void JSCExecutor::terminateOnJSVMThread() {
   s_globalContextRefToJSCExecutor.erase(m_context);
   JSGlobalContextRelease(m_context);
   m_context = nullptr;
+  SamplingProfiler::unregisterCurrentThread();
 }
 
 // Checks if the user is in the pre-parsing cache & StringRef QE.
@@ -218,6 +234,7 @@ void JSCExecutor::loadApplicationScript(
     const std::string& script,
     const std::string& sourceURL) {
   ReactMarker::logMarker("loadApplicationScript_startStringConvert");
+  StartupTimeline::begin(StartupTimeline::Phase::ConvertScript);
 #if WITH_FBJSCEXTENSIONS
   JSStringRef jsScriptRef;
   if (usePreparsingAndStringRef()){
@@ -231,15 +248,17 @@ void JSCExecutor::loadApplicationScript(
   String jsScript = String::createExpectingAscii(script);
 #endif
 
+  StartupTimeline::end(StartupTimeline::Phase::ConvertScript);
   ReactMarker::logMarker("loadApplicationScript_endStringConvert");
 
   String jsSourceURL(sourceURL.c_str());
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor::loadApplicationScript",
-    "sourceURL", sourceURL);
-  #endif
+  SystraceSection s("JSCExecutor::loadApplicationScript", "sourceURL", sourceURL);
+  StartupTimeline::begin(StartupTimeline::Phase::EvaluateScript);
   evaluateScript(m_context, jsScript, jsSourceURL);
+  StartupTimeline::end(StartupTimeline::Phase::EvaluateScript);
+  StartupTimeline::begin(StartupTimeline::Phase::FirstFlush);
   flush();
+  StartupTimeline::end(StartupTimeline::Phase::FirstFlush);
   ReactMarker::logMarker("RUN_JS_BUNDLE_END");
   ReactMarker::logMarker("CREATE_REACT_CONTEXT_END");
 }
@@ -270,10 +289,7 @@ bool JSCExecutor::ensureBatchedBridgeObject() {
 }
 
 void JSCExecutor::flush() {
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(
-      TRACE_TAG_REACT_CXX_BRIDGE, "JSCExecutor.flush");
-  #endif
+  SystraceSection s("JSCExecutor.flush");
 
   if (!ensureBatchedBridgeObject()) {
     throwJSExecutionException(
@@ -284,6 +300,7 @@ void JSCExecutor::flush() {
 
   std::string calls = m_flushedQueueObj->callAsFunction().toJSONString();
   m_bridge->callNativeModules(*this, calls, true);
+  scheduleHeapSample();
 }
 
 void JSCExecutor::callFunction(const std::string& moduleId, const std::string& methodId, const folly::dynamic& arguments) {
@@ -302,6 +319,7 @@ void JSCExecutor::callFunction(const std::string& moduleId, const std::string& m
   };
   std::string calls = executeJSCallWithJSC(m_context, "callFunctionReturnFlushedQueue", std::move(call));
   m_bridge->callNativeModules(*this, calls, true);
+  scheduleHeapSample();
 }
 
 void JSCExecutor::invokeCallback(const double callbackId, const folly::dynamic& arguments) {
@@ -316,9 +334,14 @@ void JSCExecutor::invokeCallback(const double callbackId, const folly::dynamic&
   };
   std::string calls = executeJSCallWithJSC(m_context, "invokeCallbackAndReturnFlushedQueue", std::move(call));
   m_bridge->callNativeModules(*this, calls, true);
+  scheduleHeapSample();
 }
 
 void JSCExecutor::setGlobalVariable(const std::string& propName, const std::string& jsonValue) {
+  bool isModuleConfig = propName == "__fbBatchedBridgeConfig";
+  if (isModuleConfig) {
+    StartupTimeline::begin(StartupTimeline::Phase::ModuleConfig);
+  }
   auto globalObject = JSContextGetGlobalObject(m_context);
   String jsPropertyName(propName.c_str());
 
@@ -326,6 +349,9 @@ void JSCExecutor::setGlobalVariable(const std::string& propName, const std::stri
   auto valueToInject = JSValueMakeFromJSONString(m_context, jsValueJSON);
 
   JSObjectSetProperty(m_context, globalObject, jsPropertyName, valueToInject, 0, NULL);
+  if (isModuleConfig) {
+    StartupTimeline::end(StartupTimeline::Phase::ModuleConfig);
+  }
 }
 
 void* JSCExecutor::getJavaScriptContext() {
@@ -364,12 +390,53 @@ void JSCExecutor::handleMemoryPressureModerate() {
   #ifdef WITH_JSC_MEMORY_PRESSURE
   JSHandleMemoryPressure(this, m_context, JSMemoryPressure::MODERATE);
   #endif
+  // After handling it, to show how much it freed
+  m_heapSampler.sample(m_context, JSCHeapSample::Event::MemoryPressureModerate);
 }
 
 void JSCExecutor::handleMemoryPressureCritical() {
   #ifdef WITH_JSC_MEMORY_PRESSURE
   JSHandleMemoryPressure(this, m_context, JSMemoryPressure::CRITICAL);
   #endif
+  m_heapSampler.sample(m_context, JSCHeapSample::Event::MemoryPressureCritical);
+}
+
+void JSCExecutor::scheduleHeapSample() {
+  if (m_heapSamplePending || !m_heapSampler.isSampleDue()) {
+    return;
+  }
+  // MessageQueueThread has no idle callback. Sampling from a task of its own,
+  // queued behind the work that is already waiting, at least keeps the sample
+  // from delaying that work.
+  m_heapSamplePending = true;
+  std::shared_ptr<bool> isDestroyed = m_isDestroyed;
+  m_messageQueueThread->runOnQueue([this, isDestroyed] () {
+    if (*isDestroyed) {
+      return;
+    }
+    m_heapSamplePending = false;
+    m_heapSampler.sample(m_context, JSCHeapSample::Event::Sample);
+  });
+}
+
+std::string JSCExecutor::getHeapSamplesJSON() {
+  folly::dynamic samples = folly::dynamic::array();
+  for (auto& sample : m_heapSampler.getSamples()) {
+    samples.push_back(folly::dynamic::object
+      ("timestampNanos", sample.timestampNanos)
+      ("event", JSCHeapSampler::getEventName(sample.event))
+      ("heapSize", static_cast<int64_t>(sample.heapSize))
+      ("heapExtraSize", static_cast<int64_t>(sample.heapExtraSize))
+      ("heapCapacity", static_cast<int64_t>(sample.heapCapacity))
+      ("objectCount", static_cast<int64_t>(sample.objectCount))
+      ("lastFullGCLength", sample.lastFullGCLength)
+      ("lastEdenGCLength", sample.lastEdenGCLength));
+  }
+  return folly::toJson(samples).c_str();
+}
+
+void JSCExecutor::installNativeHook(const char *name, JSObjectCallAsFunctionCallback callback) {
+  installGlobalFunction(m_context, name, callback);
 }
 
 void JSCExecutor::flushQueueImmediate(std::string queueJSON) {
@@ -377,6 +444,7 @@ void JSCExecutor::flushQueueImmediate(std::string queueJSON) {
 }
 
 void JSCExecutor::loadModule(uint32_t moduleId) {
+  SamplingProfiler::ActivityScope activity(SamplingProfiler::Activity::NativeRequire, moduleId);
   auto module = m_unbundle->getModule(moduleId);
   auto sourceUrl = String::createExpectingAscii(module.name);
   auto source = String::createExpectingAscii(module.code);
@@ -700,4 +768,26 @@ static JSValueRef nativeInjectHMRUpdate(
   return JSValueMakeUndefined(ctx);
 }
 
+static JSValueRef nativeGetHookStats(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[], JSValueRef *exception) {
+  bool reset = argumentCount > 0 && JSValueToBoolean(ctx, arguments[0]);
+  auto result = Object::create(ctx);
+  for (auto& entry : NativeHookStats::getStats(reset)) {
+    auto stats = Object::create(ctx);
+    stats.setProperty("count", Value(ctx, JSValueMakeNumber(ctx, entry.count)));
+    stats.setProperty(
+        "totalMs",
+        Value(ctx, JSValueMakeNumber(ctx, entry.totalNanos / (double)NANOSECONDS_IN_MILLISECOND)));
+    stats.setProperty(
+        "maxMs",
+        Value(ctx, JSValueMakeNumber(ctx, entry.maxNanos / (double)NANOSECONDS_IN_MILLISECOND)));
+    result.setProperty(entry.name.c_str(), stats);
+  }
+  return (JSObjectRef) result;
+}
+
 } }
@@ -10,6 +10,7 @@
 
 #include "ExecutorToken.h"
 #include "Executor.h"
+#include "JSCHeapSampler.h"
 #include "JSCHelpers.h"
 #include "Value.h"
 
@@ -73,6 +74,7 @@ public:
   virtual void stopProfiler(const std::string &titleString, const std::string &filename) override;
   virtual void handleMemoryPressureModerate() override;
   virtual void handleMemoryPressureCritical() override;
+  virtual std::string getHeapSamplesJSON() override;
   virtual void destroy() override;
 
   void installNativeHook(const char *name, JSObjectCallAsFunctionCallback callback);
@@ -88,6 +90,9 @@ private:
   std::shared_ptr<MessageQueueThread> m_messageQueueThread;
   std::unique_ptr<JSModulesUnbundle> m_unbundle;
   folly::dynamic m_jscConfig;
+  JSCHeapSampler m_heapSampler;
+  // Only used on the JS thread
+  bool m_heapSamplePending = false;
   std::unique_ptr<Object> m_batchedBridge;
   std::unique_ptr<Object> m_flushedQueueObj;
 
@@ -106,6 +111,7 @@ private:
   void terminateOnJSVMThread();
   void flush();
   void flushQueueImmediate(std::string queueJSON);
+  void scheduleHeapSample();
   void loadModule(uint32_t moduleId);
   bool ensureBatchedBridgeObject();
 
@@ -0,0 +1,80 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCHeapSampler.h"
+
+#include <time.h>
+
+#ifdef JSC_HAS_PERF_STATS_API
+#include <JavaScriptCore/JSPerfStats.h>
+#endif
+
+namespace facebook {
+namespace react {
+
+static int64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+const size_t JSCHeapSampler::kCapacity;
+
+JSCHeapSampler::JSCHeapSampler(int64_t intervalMs) :
+  m_intervalNanos(intervalMs * 1000000) {}
+
+bool JSCHeapSampler::isSampleDue() const {
+  return m_intervalNanos > 0 && nowNanos() - m_lastSampleNanos >= m_intervalNanos;
+}
+
+void JSCHeapSampler::sample(JSContextRef ctx, JSCHeapSample::Event event) {
+  JSCHeapSample sample = {0};
+  sample.event = event;
+
+  #ifdef JSC_HAS_PERF_STATS_API
+  JSHeapStats heapStats = {0};
+  JSGetHeapStats(ctx, &heapStats);
+  sample.heapSize = heapStats.size;
+  sample.heapExtraSize = heapStats.extraSize;
+  sample.heapCapacity = heapStats.capacity;
+  sample.objectCount = heapStats.objectCount;
+
+  JSGCStats gcStats = {0};
+  JSGetGCStats(ctx, &gcStats);
+  sample.lastFullGCLength = gcStats.lastFullGCLength;
+  sample.lastEdenGCLength = gcStats.lastEdenGCLength;
+  #endif
+
+  // After reading the stats, so that reading them doesn't count towards the
+  // interval
+  sample.timestampNanos = nowNanos();
+  m_lastSampleNanos = sample.timestampNanos;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_samples[m_sampleCount % kCapacity] = sample;
+  m_sampleCount++;
+}
+
+std::vector<JSCHeapSample> JSCHeapSampler::getSamples() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<JSCHeapSample> samples;
+  size_t first = m_sampleCount > kCapacity ? m_sampleCount - kCapacity : 0;
+  samples.reserve(m_sampleCount - first);
+  for (size_t i = first; i < m_sampleCount; i++) {
+    samples.push_back(m_samples[i % kCapacity]);
+  }
+  return samples;
+}
+
+const char* JSCHeapSampler::getEventName(JSCHeapSample::Event event) {
+  switch (event) {
+    case JSCHeapSample::Event::Sample:
+      return "sample";
+    case JSCHeapSample::Event::MemoryPressureModerate:
+      return "memoryPressureModerate";
+    case JSCHeapSample::Event::MemoryPressureCritical:
+      return "memoryPressureCritical";
+  }
+  return "";
+}
+
+} }
@@ -0,0 +1,76 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <JavaScriptCore/JSContextRef.h>
+
+namespace facebook {
+namespace react {
+
+struct JSCHeapSample {
+  enum class Event : uint8_t {
+    Sample,
+    MemoryPressureModerate,
+    MemoryPressureCritical,
+  };
+
+  // CLOCK_MONOTONIC, like System.nanoTime() and TraceRecorder
+  int64_t timestampNanos;
+  Event event;
+  // Zero if JSC doesn't have the perf stats API
+  uint64_t heapSize;
+  uint64_t heapExtraSize;
+  uint64_t heapCapacity;
+  uint64_t objectCount;
+  double lastFullGCLength;
+  double lastEdenGCLength;
+};
+
+/**
+ * Keeps the last kCapacity samples of a JSC context's heap and GC stats, read
+ * on its JS thread at most every intervalMs, and whenever it handles memory
+ * pressure. Samples can be read from any thread.
+ */
+class JSCHeapSampler {
+public:
+  static const size_t kCapacity = 512;
+
+  // intervalMs <= 0 only records memory pressure events
+  explicit JSCHeapSampler(int64_t intervalMs);
+
+  /**
+   * Returns whether intervalMs has passed since the last sample. Must be
+   * called on the context's JS thread.
+   */
+  bool isSampleDue() const;
+
+  /**
+   * Must be called on the context's JS thread.
+   */
+  void sample(JSContextRef ctx, JSCHeapSample::Event event);
+
+  /**
+   * Returns the samples in the order they were taken.
+   */
+  std::vector<JSCHeapSample> getSamples() const;
+
+  static const char* getEventName(JSCHeapSample::Event event);
+
+private:
+  const int64_t m_intervalNanos;
+  // Only used on the JS thread
+  int64_t m_lastSampleNanos = 0;
+
+  mutable std::mutex m_mutex;
+  std::array<JSCHeapSample, kCapacity> m_samples;
+  // Total samples taken, the oldest one is overwritten once there are more
+  // than kCapacity
+  size_t m_sampleCount = 0;
+};
+
+} }
@@ -5,6 +5,11 @@
 #include <JavaScriptCore/JSStringRef.h>
 #include <glog/logging.h>
 
+#include <atomic>
+#include <string>
+
+#include "LongTaskWatchdog.h"
+#include "NativeHookStats.h"
 #include "Value.h"
 
 #if WITH_FBJSCEXTENSIONS
@@ -14,13 +19,93 @@
 namespace facebook {
 namespace react {
 
+namespace {
+
+// The callbacks of the registered hooks, by NativeHookStats index. JSC
+// callbacks carry no data, so each index has a trampoline of its own.
+std::atomic<JSObjectCallAsFunctionCallback> s_hookCallbacks[NativeHookStats::kMaxHooks];
+
+std::string captureJSStack(JSContextRef ctx) {
+  JSValueRef exn = nullptr;
+  JSObjectRef error = JSObjectMakeError(ctx, 0, nullptr, &exn);
+  if (error == nullptr) {
+    return "";
+  }
+  Value stack = Object(ctx, error).getProperty("stack");
+  return stack.isString() ? stack.toString().str() : "";
+}
+
+template <size_t Hook>
+JSValueRef meteredHook(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  NativeHookStats::Scope scope(Hook);
+  JSValueRef result = s_hookCallbacks[Hook].load(std::memory_order_relaxed)(
+      ctx, function, thisObject, argumentCount, arguments, exception);
+  // The JS stack of a long task can only be walked from the JS thread, so
+  // the first hook it calls once over budget captures it
+  if (LongTaskWatchdog::needsCurrentTaskJSStack()) {
+    LongTaskWatchdog::setCurrentTaskJSStack(captureJSStack(ctx));
+  }
+  return result;
+}
+
+template <size_t Count>
+struct MeteredHooks {
+  static void fill(JSObjectCallAsFunctionCallback* hooks) {
+    MeteredHooks<Count - 1>::fill(hooks);
+    hooks[Count - 1] = meteredHook<Count - 1>;
+  }
+};
+
+template <>
+struct MeteredHooks<0> {
+  static void fill(JSObjectCallAsFunctionCallback* hooks) {}
+};
+
+struct MeteredHookTable {
+  JSObjectCallAsFunctionCallback hooks[NativeHookStats::kMaxHooks];
+
+  MeteredHookTable() {
+    MeteredHooks<NativeHookStats::kMaxHooks>::fill(hooks);
+  }
+};
+
+JSObjectCallAsFunctionCallback meter(
+    const char* name,
+    JSObjectCallAsFunctionCallback callback) {
+  static const MeteredHookTable table;
+  if (callback == nullptr) {
+    return nullptr;
+  }
+  int hook = NativeHookStats::registerHook(name);
+  if (hook < 0) {
+    LOG(WARNING) << "Too many native hooks, not metering " << name;
+    return callback;
+  }
+  JSObjectCallAsFunctionCallback expected = nullptr;
+  if (!s_hookCallbacks[hook].compare_exchange_strong(expected, callback) &&
+      expected != callback) {
+    // Stats are by name, so only the first callback of a name is metered
+    LOG(WARNING) << "Native hook " << name << " has another callback, not metering it";
+    return callback;
+  }
+  return table.hooks[hook];
+}
+
+}
+
 void installGlobalFunction(
     JSGlobalContextRef ctx,
     const char* name,
     JSObjectCallAsFunctionCallback callback) {
   JSStringRef jsName = JSStringCreateWithUTF8CString(name);
   JSObjectRef functionObj = JSObjectMakeFunctionWithCallback(
-      ctx, jsName, callback);
+      ctx, jsName, meter(name, callback));
   JSObjectRef globalObject = JSContextGetGlobalObject(ctx);
   JSObjectSetProperty(ctx, globalObject, jsName, functionObj, 0, NULL);
   JSStringRelease(jsName);
@@ -2,11 +2,14 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include <JavaScriptCore/JavaScript.h>
 #include <JavaScriptCore/API/JSProfilerPrivate.h>
 #include <jsc_legacy_profiler.h>
 #include "JSCHelpers.h"
 #include "JSCLegacyProfiler.h"
+#include "ProfileWriter.h"
+#include "TraceRecorder.h"
 #include "Value.h"
 
 static JSValueRef nativeProfilerStart(
@@ -51,6 +54,7 @@ static JSValueRef nativeProfilerEnd(
     return JSValueMakeUndefined(ctx);
   }
 
+  JSStringRef title = JSValueToStringCopy(ctx, arguments[0], exception);
   std::string writeLocation("/sdcard/");
   if (argumentCount > 1) {
     JSStringRef fileName = JSValueToStringCopy(ctx, arguments[1], exception);
@@ -59,8 +63,7 @@ static JSValueRef nativeProfilerEnd(
   } else {
     writeLocation += "profile.json";
   }
-  JSStringRef title = JSValueToStringCopy(ctx, arguments[0], exception);
-  JSEndProfilingAndRender(ctx, title, writeLocation.c_str());
+  facebook::react::stopAndOutputProfilingFile(ctx, title, writeLocation.c_str());
   JSStringRelease(title);
   return JSValueMakeUndefined(ctx);
 }
@@ -72,6 +75,17 @@ void stopAndOutputProfilingFile(
   JSContextRef ctx,
   JSStringRef title,
   const char *filename) {
+  auto writer = TraceRecorder::getStreamingWriter();
+  if (writer) {
+    // Goes into the capture, with the rest of the profiling output. JSC
+    // renders to a file, which is then copied over a chunk at a time.
+    std::string renderLocation = writer->getPath() + ".jsc";
+    JSEndProfilingAndRender(ctx, title, renderLocation.c_str());
+    writer->writeFile(ProfileWriter::ChunkType::JSCProfile, renderLocation);
+    unlink(renderLocation.c_str());
+    return;
+  }
+
   JSEndProfilingAndRender(ctx, title, filename);
 }
 
@@ -7,6 +7,9 @@ namespace facebook {
 namespace react {
 
 void addNativeProfilingHooks(JSGlobalContextRef ctx);
+
+// Renders to filename, or into the capture of TraceRecorder's streaming
+// writer while there is one
 void stopAndOutputProfilingFile(
     JSContextRef ctx,
     JSStringRef title,
@@ -0,0 +1,360 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JSCTraceRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <JavaScriptCore/JavaScript.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef WITH_FBSYSTRACE
+#include <fbsystrace.h>
+#endif
+
+#include "JSCHelpers.h"
+#include "TraceRecorder.h"
+#include "Value.h"
+
+// The hooks take name IDs from nativeTraceRegisterName, and arguments as
+// pairs of a name ID key and a number. They record to TraceRecorder when it
+// is enabled, which maps the IDs back to names only when its trace is
+// dumped, and to systrace when it is tracing. IDs that weren't registered
+// throw and record nothing.
+//
+// Unlike the hooks of JSCTracing.cpp, these don't need fbsystrace, so they
+// are installed in every build. Without them Systrace.js uses its own name
+// table, and MessageQueue's per-call flow event doesn't cost a call into
+// native.
+
+using std::min;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+// Same as FBSYSTRACE_MAX_SECTION_NAME_LENGTH, so that registered names fit
+// in a systrace section
+const size_t kMaxNameLength = 100;
+#ifdef WITH_FBSYSTRACE
+static_assert(kMaxNameLength == FBSYSTRACE_MAX_SECTION_NAME_LENGTH,
+  "Registered names must fit in a systrace section");
+#endif
+
+JSValueRef throwException(JSContextRef ctx, const char* message, JSValueRef* exception) {
+  if (exception) {
+    *exception = makeJSCException(ctx, message);
+  }
+  return JSValueMakeUndefined(ctx);
+}
+
+// Returns the name registered as the ID in value, and sets id to it. Returns
+// nullptr and throws if value isn't a registered ID, so that nothing gets
+// recorded under an ID that doesn't map back to a name.
+const char* nameFromIdValue(
+    JSContextRef ctx,
+    JSValueRef value,
+    uint32_t* id,
+    JSValueRef* exception) {
+  double number = JSValueToNumber(ctx, value, nullptr);
+  const char* name = nullptr;
+  // Also false for NaN
+  if (number >= 0 && number <= UINT32_MAX && number == (uint32_t) number) {
+    *id = (uint32_t) number;
+    name = TraceRecorder::getName(*id);
+  }
+  if (name == nullptr) {
+    throwException(
+      ctx,
+      "Unknown trace name ID, register names with nativeTraceRegisterName",
+      exception);
+  }
+  return name;
+}
+
+#ifdef WITH_FBSYSTRACE
+
+uint64_t tagFromJSValue(JSContextRef ctx, JSValueRef value) {
+  return (uint64_t) JSValueToNumber(ctx, value, nullptr);
+}
+
+// Appends the systrace arguments of a hook, as "|key=value;key=value", for
+// keys that are registered name IDs and values that are numbers
+size_t copyArgIdsToBuffer(
+    char* buf,
+    size_t bufLen,
+    size_t pos,
+    JSContextRef ctx,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  char separator = '|';
+  for (
+      size_t idx = 0;
+      idx + 1 < argumentCount;  // Make sure key and value are present.
+      idx += 2) {
+    uint32_t keyId;
+    const char* key = nameFromIdValue(ctx, arguments[idx], &keyId, exception);
+    if (FBSYSTRACE_UNLIKELY(key == nullptr)) { break; }
+    double value = JSValueToNumber(ctx, arguments[idx+1], nullptr);
+
+    if (FBSYSTRACE_UNLIKELY(pos >= bufLen)) { break; }
+    pos += snprintf(buf + pos, bufLen - pos, "%c%s=%.15g", separator, key, value);
+    separator = ';';
+  }
+  return pos;
+}
+
+#endif
+
+JSValueRef nativeTraceRegisterName(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  if (argumentCount < 1) {
+    return throwException(ctx, "nativeTraceRegisterName: requires at least 1 argument", exception);
+  }
+
+  // Truncated like the names passed to the systrace hooks, which also keeps
+  // the systrace output of the ID based hooks within its buffers
+  std::string name = Value(ctx, arguments[0]).toString().str();
+  if (name.size() > kMaxNameLength) {
+    name.resize(kMaxNameLength);
+  }
+  return JSValueMakeNumber(ctx, TraceRecorder::internName(name.c_str()));
+}
+
+JSValueRef nativeTraceBeginSectionById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  if (argumentCount < 2) {
+    return throwException(ctx, "nativeTraceBeginSectionById: requires at least 2 arguments", exception);
+  }
+
+  uint32_t id;
+  const char* name = nameFromIdValue(ctx, arguments[1], &id, exception);
+  if (name == nullptr) {
+    return JSValueMakeUndefined(ctx);
+  }
+  if (TraceRecorder::isEnabled()) {
+    TraceRecorder::record(TraceRecorder::EventType::Begin, id);
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  uint64_t tag = tagFromJSValue(ctx, arguments[0]);
+  if (fbsystrace_is_tracing(tag)) {
+    char buf[FBSYSTRACE_MAX_MESSAGE_LENGTH];
+    // Registered names are at most FBSYSTRACE_MAX_SECTION_NAME_LENGTH long
+    size_t pos = snprintf(buf, sizeof(buf), "B|%d|%s", getpid(), name);
+    pos = copyArgIdsToBuffer(buf, sizeof(buf), pos, ctx, argumentCount - 2, arguments + 2, exception);
+    fbsystrace_trace_raw(buf, min(pos, sizeof(buf)-1));
+  }
+  #endif
+
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef nativeTraceEndSectionById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  if (argumentCount < 1) {
+    return throwException(ctx, "nativeTraceEndSectionById: requires at least 1 argument", exception);
+  }
+
+  if (TraceRecorder::isEnabled()) {
+    TraceRecorder::record(TraceRecorder::EventType::End, static_cast<uint32_t>(0));
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  uint64_t tag = tagFromJSValue(ctx, arguments[0]);
+  if (!fbsystrace_is_tracing(tag)) {
+    return JSValueMakeUndefined(ctx);
+  }
+  if (FBSYSTRACE_LIKELY(argumentCount == 1)) {
+    fbsystrace_end_section(tag);
+  } else {
+    char buf[FBSYSTRACE_MAX_MESSAGE_LENGTH];
+    size_t pos = 0;
+
+    buf[pos++] = 'E';
+    buf[pos++] = '|';
+    buf[pos++] = '|';
+    pos = copyArgIdsToBuffer(buf, sizeof(buf), pos, ctx, argumentCount - 1, arguments + 1, exception);
+    fbsystrace_trace_raw(buf, min(pos, sizeof(buf)-1));
+  }
+  #endif
+
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef beginOrEndAsyncById(
+    bool isEnd,
+    bool isFlow,
+    JSContextRef ctx,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  if (argumentCount < 3) {
+    return throwException(ctx, "beginOrEndAsyncById: requires at least 3 arguments", exception);
+  }
+
+  uint32_t id;
+  const char* name = nameFromIdValue(ctx, arguments[1], &id, exception);
+  if (name == nullptr) {
+    return JSValueMakeUndefined(ctx);
+  }
+  int64_t cookie = (int64_t) JSValueToNumber(ctx, arguments[2], nullptr);
+  if (TraceRecorder::isEnabled()) {
+    TraceRecorder::record(
+      isEnd ? TraceRecorder::EventType::AsyncEnd : TraceRecorder::EventType::AsyncBegin,
+      id,
+      cookie);
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  uint64_t tag = tagFromJSValue(ctx, arguments[0]);
+  if (fbsystrace_is_tracing(tag)) {
+    char buf[FBSYSTRACE_MAX_MESSAGE_LENGTH];
+    // Same format as beginOrEndAsync() in JSCTracing.cpp
+    size_t pos = snprintf(
+      buf,
+      sizeof(buf),
+      "%c|%d|%s%s|%lld",
+      (isFlow) ? (isEnd ? 'f' : 's') : (isEnd ? 'F' : 'S'),
+      getpid(),
+      name,
+      (isEnd | isFlow) ? "" : "<0>",
+      (long long) cookie);
+    pos = copyArgIdsToBuffer(buf, sizeof(buf), pos, ctx, argumentCount - 3, arguments + 3, exception);
+    fbsystrace_trace_raw(buf, min(pos, sizeof(buf)-1));
+  }
+  #endif
+
+  return JSValueMakeUndefined(ctx);
+}
+
+JSValueRef nativeTraceBeginAsyncSectionById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  return beginOrEndAsyncById(
+      false /* isEnd */,
+      false /* isFlow */,
+      ctx,
+      argumentCount,
+      arguments,
+      exception);
+}
+
+JSValueRef nativeTraceEndAsyncSectionById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  return beginOrEndAsyncById(
+      true /* isEnd */,
+      false /* isFlow */,
+      ctx,
+      argumentCount,
+      arguments,
+      exception);
+}
+
+JSValueRef nativeTraceBeginAsyncFlowById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  return beginOrEndAsyncById(
+      false /* isEnd */,
+      true /* isFlow */,
+      ctx,
+      argumentCount,
+      arguments,
+      exception);
+}
+
+JSValueRef nativeTraceEndAsyncFlowById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  return beginOrEndAsyncById(
+      true /* isEnd */,
+      true /* isFlow */,
+      ctx,
+      argumentCount,
+      arguments,
+      exception);
+}
+
+JSValueRef nativeTraceCounterById(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef* exception) {
+  if (argumentCount < 3) {
+    return throwException(ctx, "nativeTraceCounterById: requires at least 3 arguments", exception);
+  }
+
+  uint32_t id;
+  const char* name = nameFromIdValue(ctx, arguments[1], &id, exception);
+  if (name == nullptr) {
+    return JSValueMakeUndefined(ctx);
+  }
+  int64_t value = (int64_t) JSValueToNumber(ctx, arguments[2], nullptr);
+  if (TraceRecorder::isEnabled()) {
+    TraceRecorder::record(TraceRecorder::EventType::Counter, id, value);
+  }
+
+  #ifdef WITH_FBSYSTRACE
+  uint64_t tag = tagFromJSValue(ctx, arguments[0]);
+  if (fbsystrace_is_tracing(tag)) {
+    fbsystrace_counter(tag, name, value);
+  }
+  #endif
+
+  return JSValueMakeUndefined(ctx);
+}
+
+}
+
+void addTraceRecorderHooks(JSGlobalContextRef ctx) {
+  // Read once by Systrace.js, see there
+  Object::getGlobalObject(ctx).setProperty(
+    "__nativeTraceRecording", Value(ctx, JSValueMakeBoolean(ctx, TraceRecorder::isEnabled())));
+  installGlobalFunction(ctx, "nativeTraceRegisterName", nativeTraceRegisterName);
+  installGlobalFunction(ctx, "nativeTraceBeginSectionById", nativeTraceBeginSectionById);
+  installGlobalFunction(ctx, "nativeTraceEndSectionById", nativeTraceEndSectionById);
+  installGlobalFunction(ctx, "nativeTraceBeginAsyncSectionById", nativeTraceBeginAsyncSectionById);
+  installGlobalFunction(ctx, "nativeTraceEndAsyncSectionById", nativeTraceEndAsyncSectionById);
+  installGlobalFunction(ctx, "nativeTraceBeginAsyncFlowById", nativeTraceBeginAsyncFlowById);
+  installGlobalFunction(ctx, "nativeTraceEndAsyncFlowById", nativeTraceEndAsyncFlowById);
+  installGlobalFunction(ctx, "nativeTraceCounterById", nativeTraceCounterById);
+}
+
+} }
@@ -0,0 +1,17 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <JavaScriptCore/JSContextRef.h>
+namespace facebook {
+namespace react {
+
+/**
+ * Installs nativeTraceRegisterName and the nativeTrace*ById hooks, which
+ * record to TraceRecorder in every build, and to systrace in builds with
+ * WITH_FBSYSTRACE. Systrace.js calls them while systrace runs, and for the
+ * lifetime of the context if TraceRecorder is enabled when this is called.
+ */
+void addTraceRecorderHooks(JSGlobalContextRef ctx);
+
+} }
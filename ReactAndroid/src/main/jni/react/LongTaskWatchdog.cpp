@@ -0,0 +1,208 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "LongTaskWatchdog.h"
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+struct QueueStats {
+  std::atomic<uint64_t> taskCount;
+  std::atomic<uint64_t> longTaskCount;
+  std::atomic<uint64_t> overBudgetNanos;
+  std::atomic<uint64_t> maxNanos;
+};
+
+QueueStats g_stats[LongTaskWatchdog::kQueueCount];
+// 0 while stopped
+std::atomic<int64_t> g_budgetNanos{0};
+std::mutex g_callbackMutex;
+std::shared_ptr<LongTaskWatchdog::LongTaskCallback> g_callback;
+
+int64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+LongTaskWatchdog::TaskScope*& currentTask() {
+  static thread_local LongTaskWatchdog::TaskScope* t_task = nullptr;
+  return t_task;
+}
+
+uint64_t loadOrReset(std::atomic<uint64_t>& value, bool reset) {
+  return reset
+    ? value.exchange(0, std::memory_order_relaxed)
+    : value.load(std::memory_order_relaxed);
+}
+
+}
+
+const size_t LongTaskWatchdog::kQueueCount;
+
+LongTaskWatchdog::TaskOrigin LongTaskWatchdog::TaskOrigin::callFunction(uint32_t nameId) {
+  TaskOrigin origin;
+  origin.kind = Kind::CallFunction;
+  origin.nameId = nameId;
+  return origin;
+}
+
+LongTaskWatchdog::TaskOrigin LongTaskWatchdog::TaskOrigin::invokeCallback(double callbackId) {
+  TaskOrigin origin;
+  origin.kind = Kind::InvokeCallback;
+  origin.callbackId = callbackId;
+  return origin;
+}
+
+LongTaskWatchdog::TaskOrigin LongTaskWatchdog::TaskOrigin::nativeModuleCalls(
+    int moduleId,
+    int methodId,
+    size_t callCount) {
+  TaskOrigin origin;
+  origin.kind = Kind::NativeModuleCalls;
+  origin.moduleId = moduleId;
+  origin.methodId = methodId;
+  origin.callCount = callCount;
+  return origin;
+}
+
+LongTaskWatchdog::TaskScope::TaskScope(Queue queue) :
+    TaskScope(queue, TaskOrigin()) {}
+
+LongTaskWatchdog::TaskScope::TaskScope(Queue queue, const TaskOrigin& origin) :
+    m_queue(queue),
+    m_origin(origin),
+    m_budgetNanos(g_budgetNanos.load(std::memory_order_relaxed)) {
+  if (m_budgetNanos == 0) {
+    return;
+  }
+  m_startNanos = nowNanos();
+  TaskScope*& current = currentTask();
+  m_previous = current;
+  current = this;
+}
+
+LongTaskWatchdog::TaskScope::~TaskScope() {
+  if (m_budgetNanos == 0) {
+    return;
+  }
+  int64_t durationNanos = nowNanos() - m_startNanos;
+  currentTask() = m_previous;
+
+  QueueStats& stats = g_stats[static_cast<size_t>(m_queue)];
+  stats.taskCount.fetch_add(1, std::memory_order_relaxed);
+  uint64_t max = stats.maxNanos.load(std::memory_order_relaxed);
+  while (static_cast<uint64_t>(durationNanos) > max &&
+         !stats.maxNanos.compare_exchange_weak(max, durationNanos, std::memory_order_relaxed)) {
+  }
+  if (durationNanos <= m_budgetNanos) {
+    return;
+  }
+  stats.longTaskCount.fetch_add(1, std::memory_order_relaxed);
+  stats.overBudgetNanos.fetch_add(durationNanos - m_budgetNanos, std::memory_order_relaxed);
+
+  std::shared_ptr<LongTaskCallback> callback;
+  {
+    std::lock_guard<std::mutex> lock(g_callbackMutex);
+    callback = g_callback;
+  }
+  if (!callback) {
+    // Stopped while the task ran
+    return;
+  }
+  LongTaskEvent event {
+    m_queue,
+    m_origin,
+    static_cast<pid_t>(syscall(__NR_gettid)),
+    m_startNanos,
+    durationNanos,
+    m_budgetNanos,
+    std::move(m_jsStack),
+  };
+  (*callback)(event);
+}
+
+void LongTaskWatchdog::start(int budgetMs, LongTaskCallback onLongTask) {
+  {
+    std::lock_guard<std::mutex> lock(g_callbackMutex);
+    g_callback = std::make_shared<LongTaskCallback>(std::move(onLongTask));
+  }
+  g_budgetNanos.store(std::max(1, budgetMs) * 1000000LL, std::memory_order_relaxed);
+}
+
+void LongTaskWatchdog::stop() {
+  g_budgetNanos.store(0, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(g_callbackMutex);
+  g_callback = nullptr;
+}
+
+bool LongTaskWatchdog::isRunning() {
+  return g_budgetNanos.load(std::memory_order_relaxed) != 0;
+}
+
+bool LongTaskWatchdog::needsCurrentTaskJSStack() {
+  TaskScope* task = currentTask();
+  return task != nullptr &&
+    task->m_jsStack.empty() &&
+    nowNanos() - task->m_startNanos > task->m_budgetNanos;
+}
+
+void LongTaskWatchdog::setCurrentTaskJSStack(std::string jsStack) {
+  TaskScope* task = currentTask();
+  if (task != nullptr) {
+    task->m_jsStack = std::move(jsStack);
+  }
+}
+
+std::vector<LongTaskWatchdog::Stats> LongTaskWatchdog::getStats(bool reset) {
+  std::vector<Stats> stats;
+  for (size_t i = 0; i < kQueueCount; i++) {
+    QueueStats& queue = g_stats[i];
+    stats.push_back(Stats {
+      static_cast<Queue>(i),
+      loadOrReset(queue.taskCount, reset),
+      loadOrReset(queue.longTaskCount, reset),
+      loadOrReset(queue.overBudgetNanos, reset),
+      loadOrReset(queue.maxNanos, reset),
+    });
+  }
+  return stats;
+}
+
+const char* LongTaskWatchdog::getQueueName(Queue queue) {
+  switch (queue) {
+    case Queue::JS:
+      return "js";
+    case Queue::JSWorker:
+      return "jsWorker";
+    case Queue::NativeModules:
+      return "nativeModules";
+  }
+  return "";
+}
+
+const char* LongTaskWatchdog::getOriginKindName(TaskOrigin::Kind kind) {
+  switch (kind) {
+    case TaskOrigin::Kind::Other:
+      return "other";
+    case TaskOrigin::Kind::CallFunction:
+      return "callFunction";
+    case TaskOrigin::Kind::InvokeCallback:
+      return "invokeCallback";
+    case TaskOrigin::Kind::NativeModuleCalls:
+      return "nativeModuleCalls";
+  }
+  return "";
+}
+
+} }
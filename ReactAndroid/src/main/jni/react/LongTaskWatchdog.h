@@ -0,0 +1,142 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Times the tasks run on the JS and native module queues, and reports the
+ * ones taking longer than a budget, e.g. a 16 ms frame, as long task events
+ * with where they came from. Tasks are timed with TaskScope by whoever posts
+ * them, e.g. Bridge::runOnExecutorQueue().
+ *
+ * The JS stack of a long task is captured by the first native hook it calls
+ * once it is over budget (see installGlobalFunction()), since JSC can only
+ * walk it on the JS thread. Tasks that call no hooks by then have none.
+ *
+ * Events are reported on the thread that ran the task, once it has ended.
+ * Timing takes no locks, and costs nothing while the watchdog is stopped.
+ */
+class LongTaskWatchdog {
+public:
+  enum class Queue : uint8_t {
+    JS,
+    JSWorker,
+    NativeModules,
+  };
+
+  static const size_t kQueueCount = 3;
+
+  struct TaskOrigin {
+    enum class Kind : uint8_t {
+      Other,
+      CallFunction,
+      InvokeCallback,
+      // A batch of native module calls from JS
+      NativeModuleCalls,
+    };
+
+    Kind kind = Kind::Other;
+    // The TraceRecorder name ID of the tracing name of the call, or 0
+    uint32_t nameId = 0;
+    double callbackId = 0;
+    // Of the first call of the batch
+    int moduleId = -1;
+    int methodId = -1;
+    size_t callCount = 0;
+
+    static TaskOrigin callFunction(uint32_t nameId);
+    static TaskOrigin invokeCallback(double callbackId);
+    static TaskOrigin nativeModuleCalls(int moduleId, int methodId, size_t callCount);
+  };
+
+  struct LongTaskEvent {
+    Queue queue;
+    TaskOrigin origin;
+    pid_t tid;
+    // CLOCK_MONOTONIC, like System.nanoTime()
+    int64_t startNanos;
+    int64_t durationNanos;
+    int64_t budgetNanos;
+    // Empty if it wasn't captured
+    std::string jsStack;
+  };
+
+  struct Stats {
+    Queue queue;
+    uint64_t taskCount;
+    uint64_t longTaskCount;
+    // The time long tasks took beyond their budget
+    uint64_t overBudgetNanos;
+    uint64_t maxNanos;
+  };
+
+  using LongTaskCallback = std::function<void(const LongTaskEvent& event)>;
+
+  /**
+   * Times a task on the calling thread for the lifetime of this object, if
+   * the watchdog is running when it begins. Scopes can be nested, e.g. for
+   * tasks run synchronously by other tasks.
+   */
+  class TaskScope : public noncopyable {
+  public:
+    explicit TaskScope(Queue queue);
+    TaskScope(Queue queue, const TaskOrigin& origin);
+    ~TaskScope();
+
+    /**
+     * For tasks whose origin is only known once they have begun.
+     */
+    void setOrigin(const TaskOrigin& origin) {
+      m_origin = origin;
+    }
+
+  private:
+    friend class LongTaskWatchdog;
+
+    const Queue m_queue;
+    TaskOrigin m_origin;
+    // 0 if the watchdog wasn't running when the task began
+    const int64_t m_budgetNanos;
+    int64_t m_startNanos = 0;
+    std::string m_jsStack;
+    TaskScope* m_previous = nullptr;
+  };
+
+  /**
+   * Starts reporting tasks longer than budgetMs to onLongTask, replacing the
+   * budget and callback if the watchdog is already running. Stats are kept
+   * across restarts.
+   */
+  static void start(int budgetMs, LongTaskCallback onLongTask);
+  static void stop();
+  static bool isRunning();
+
+  /**
+   * Whether the task running on the calling thread is over budget and has
+   * no JS stack yet, see setCurrentTaskJSStack().
+   */
+  static bool needsCurrentTaskJSStack();
+  static void setCurrentTaskJSStack(std::string jsStack);
+
+  /**
+   * Returns the stats of each queue since the last reset. If reset is true,
+   * this starts a new window.
+   */
+  static std::vector<Stats> getStats(bool reset);
+
+  static const char* getQueueName(Queue queue);
+  static const char* getOriginKindName(TaskOrigin::Kind kind);
+};
+
+} }
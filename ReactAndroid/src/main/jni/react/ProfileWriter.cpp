@@ -0,0 +1,240 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "ProfileWriter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+const char kMagic[8] = { 'R', 'N', 'P', 'R', 'O', 'F', '\0', '\1' };
+// Chunks can't be longer than this, so that reading a damaged file can't
+// allocate much
+const uint32_t kMaxChunkLength = 64 * 1024 * 1024;
+
+bool writeFully(int fd, const void* data, size_t length) {
+  const char* bytes = static_cast<const char*>(data);
+  while (length > 0) {
+    ssize_t written = ::write(fd, bytes, length);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += written;
+    length -= written;
+  }
+  return true;
+}
+
+bool readFully(FILE* file, void* data, size_t length) {
+  return fread(data, 1, length, file) == length;
+}
+
+}
+
+const uint32_t ProfileWriter::kFlagCompressed;
+const uint32_t ProfileWriter::kFlagContinued;
+const size_t ProfileWriter::kChunkSize;
+
+std::unique_ptr<ProfileWriter> ProfileWriter::create(const std::string& path, bool compress) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return nullptr;
+  }
+  uint32_t pid = static_cast<uint32_t>(getpid());
+  if (!writeFully(fd, kMagic, sizeof(kMagic)) || !writeFully(fd, &pid, sizeof(pid))) {
+    int error = errno;
+    ::close(fd);
+    errno = error;
+    return nullptr;
+  }
+  return std::unique_ptr<ProfileWriter>(new ProfileWriter(fd, path, compress));
+}
+
+ProfileWriter::ProfileWriter(int fd, std::string path, bool compress) :
+    m_path(std::move(path)),
+    m_compress(compress),
+    m_fd(fd) {
+  m_buffer.reserve(kChunkSize);
+  if (m_compress) {
+    m_compressed.resize(sizeof(uint32_t) + compressBound(kChunkSize));
+  }
+}
+
+ProfileWriter::~ProfileWriter() {
+  close();
+}
+
+void ProfileWriter::writeTraceEvent(const std::string& event) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_fd < 0) {
+    return;
+  }
+  if (!m_buffer.empty() && m_buffer.size() + event.size() + 1 > kChunkSize) {
+    flushLocked(ChunkType::TraceEvents, 0);
+  }
+  // Events longer than a chunk get a chunk of their own
+  m_buffer += event;
+  m_buffer += '\n';
+  if (m_buffer.size() >= kChunkSize) {
+    flushLocked(ChunkType::TraceEvents, 0);
+  }
+}
+
+bool ProfileWriter::writeFile(ChunkType type, const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_fd < 0) {
+    fclose(file);
+    return true;
+  }
+  // The chunks of the document must be consecutive
+  flushLocked(ChunkType::TraceEvents, 0);
+  m_buffer.resize(kChunkSize);
+  size_t length = fread(&m_buffer[0], 1, kChunkSize, file);
+  // Reads ahead a chunk, to know which one is the last
+  std::string next(kChunkSize, '\0');
+  while (true) {
+    size_t nextLength = length == kChunkSize ? fread(&next[0], 1, kChunkSize, file) : 0;
+    m_buffer.resize(length);
+    flushLocked(type, nextLength > 0 ? kFlagContinued : 0);
+    if (nextLength == 0) {
+      break;
+    }
+    m_buffer.swap(next);
+    next.resize(kChunkSize);
+    length = nextLength;
+  }
+  bool succeeded = !ferror(file);
+  fclose(file);
+  return succeeded;
+}
+
+bool ProfileWriter::close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_fd >= 0) {
+    flushLocked(ChunkType::TraceEvents, 0);
+    if (::close(m_fd) != 0) {
+      m_failed = true;
+    }
+    m_fd = -1;
+  }
+  return !m_failed;
+}
+
+void ProfileWriter::flushLocked(ChunkType type, uint32_t flags) {
+  if (m_buffer.empty() || m_fd < 0) {
+    return;
+  }
+
+  const void* data = m_buffer.data();
+  size_t length = m_buffer.size();
+  if (m_compress) {
+    uint32_t uncompressedLength = static_cast<uint32_t>(length);
+    memcpy(m_compressed.data(), &uncompressedLength, sizeof(uncompressedLength));
+    uLongf compressedLength = m_compressed.size() - sizeof(uint32_t);
+    // Events longer than a chunk need a bigger buffer
+    if (compressedLength < compressBound(length)) {
+      m_compressed.resize(sizeof(uint32_t) + compressBound(length));
+      compressedLength = m_compressed.size() - sizeof(uint32_t);
+    }
+    if (compress2(
+          m_compressed.data() + sizeof(uint32_t),
+          &compressedLength,
+          reinterpret_cast<const Bytef*>(m_buffer.data()),
+          length,
+          Z_BEST_SPEED) == Z_OK) {
+      data = m_compressed.data();
+      length = sizeof(uint32_t) + compressedLength;
+      flags |= kFlagCompressed;
+    }
+  }
+
+  uint32_t header[3] = {
+    static_cast<uint32_t>(type),
+    flags,
+    static_cast<uint32_t>(length),
+  };
+  if (!writeFully(m_fd, header, sizeof(header)) || !writeFully(m_fd, data, length)) {
+    m_failed = true;
+  }
+  m_buffer.clear();
+}
+
+bool ProfileReader::read(const std::string& path, uint32_t& pid, const ChunkCallback& onChunk) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char magic[sizeof(kMagic)];
+  bool succeeded = readFully(file, magic, sizeof(magic)) &&
+    memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+    readFully(file, &pid, sizeof(pid));
+  std::string stored;
+  std::string data;
+  while (succeeded) {
+    uint32_t header[3];
+    size_t headerLength = fread(header, 1, sizeof(header), file);
+    if (headerLength == 0 && feof(file)) {
+      break;
+    }
+    uint32_t flags = header[1];
+    uint32_t length = header[2];
+    if (headerLength != sizeof(header) || length > kMaxChunkLength) {
+      succeeded = false;
+      break;
+    }
+    stored.resize(length);
+    if (length > 0 && !readFully(file, &stored[0], length)) {
+      succeeded = false;
+      break;
+    }
+
+    if (flags & ProfileWriter::kFlagCompressed) {
+      uint32_t uncompressedLength;
+      if (length < sizeof(uncompressedLength)) {
+        succeeded = false;
+        break;
+      }
+      memcpy(&uncompressedLength, stored.data(), sizeof(uncompressedLength));
+      if (uncompressedLength > kMaxChunkLength) {
+        succeeded = false;
+        break;
+      }
+      data.resize(uncompressedLength);
+      uLongf dataLength = uncompressedLength;
+      if (uncompress(
+            reinterpret_cast<Bytef*>(&data[0]),
+            &dataLength,
+            reinterpret_cast<const Bytef*>(stored.data() + sizeof(uncompressedLength)),
+            length - sizeof(uncompressedLength)) != Z_OK ||
+          dataLength != uncompressedLength) {
+        succeeded = false;
+        break;
+      }
+      onChunk(static_cast<ProfileWriter::ChunkType>(header[0]), flags, data);
+    } else {
+      onChunk(static_cast<ProfileWriter::ChunkType>(header[0]), flags, stored);
+    }
+  }
+  fclose(file);
+  return succeeded;
+}
+
+} }
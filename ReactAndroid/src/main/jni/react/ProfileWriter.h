@@ -0,0 +1,109 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Streams profiling and tracing output to a file as it is produced, so that
+ * long captures don't have to fit in memory. At most kChunkSize bytes are
+ * buffered before they are written out as a chunk, optionally deflated.
+ *
+ * The file is a header followed by chunks, with little-endian integers:
+ *
+ *   header: "RNPROF\0\1", uint32 pid
+ *   chunk:  uint32 type, uint32 flags, uint32 length, length bytes of data
+ *
+ * Compressed chunks start with the uint32 length of their uncompressed data.
+ * Use profile2trace (tools/) to convert files to Chrome Trace Event JSON.
+ *
+ * All methods are thread safe.
+ */
+class ProfileWriter : public noncopyable {
+public:
+  enum class ChunkType : uint32_t {
+    // Chrome trace event objects, one per line. Events are never split
+    // across chunks.
+    TraceEvents = 1,
+    // The JSON output of the JSC legacy profiler
+    JSCProfile = 2,
+  };
+
+  static const uint32_t kFlagCompressed = 1;
+  // The next chunk continues the same document
+  static const uint32_t kFlagContinued = 2;
+  static const size_t kChunkSize = 64 * 1024;
+
+  /**
+   * Returns nullptr, with errno set, if path can't be created.
+   */
+  static std::unique_ptr<ProfileWriter> create(const std::string& path, bool compress);
+
+  ~ProfileWriter();
+
+  const std::string& getPath() const {
+    return m_path;
+  }
+
+  /**
+   * event must be a single trace event object, without a trailing newline.
+   */
+  void writeTraceEvent(const std::string& event);
+
+  /**
+   * Copies the file at path as a document of the given type, a chunk at a
+   * time. Returns false if it can't be read.
+   */
+  bool writeFile(ChunkType type, const std::string& path);
+
+  /**
+   * Writes out the buffered data and closes the file. Later writes are
+   * dropped. Returns false if any write failed.
+   */
+  bool close();
+
+private:
+  ProfileWriter(int fd, std::string path, bool compress);
+
+  // With m_mutex held
+  void flushLocked(ChunkType type, uint32_t flags);
+
+  const std::string m_path;
+  const bool m_compress;
+  std::mutex m_mutex;
+  int m_fd;
+  bool m_failed = false;
+  // Trace events not written out yet
+  std::string m_buffer;
+  std::vector<uint8_t> m_compressed;
+};
+
+/**
+ * Reads the files written by ProfileWriter.
+ */
+class ProfileReader {
+public:
+  using ChunkCallback = std::function<void(
+    ProfileWriter::ChunkType type,
+    uint32_t flags,
+    const std::string& data)>;
+
+  /**
+   * Calls onChunk with the uncompressed data of each chunk, in order. Returns
+   * false if the file can't be read or is malformed, which includes files
+   * truncated by a crash: the chunks before the damage have been read then.
+   */
+  static bool read(const std::string& path, uint32_t& pid, const ChunkCallback& onChunk);
+};
+
+} }
@@ -0,0 +1,609 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "SamplingProfiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+// Bionic only has <sys/ucontext.h> from API 21, this is the same layout
+#include <asm/ucontext.h>
+typedef struct ucontext SignalContext;
+#else
+#include <ucontext.h>
+typedef ucontext_t SignalContext;
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ProfileWriter.h"
+#include "TraceRecorder.h"
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+const size_t kMaxThreads = 16;
+const size_t kMaxFrames = 64;
+const size_t kSamplesPerChunk = 100;
+// How long the sampler thread waits for a thread to take its sample
+const auto kSampleTimeout = std::chrono::milliseconds(10);
+
+// Activities are packed in 32 bits, so that they are read and written
+// atomically everywhere
+const int kActivityShift = 30;
+const uint32_t kValueMask = (1u << kActivityShift) - 1;
+
+uint32_t packActivity(SamplingProfiler::Activity activity, uint32_t value) {
+  return (static_cast<uint32_t>(activity) << kActivityShift) | (value & kValueMask);
+}
+
+struct ThreadSlot {
+  // 0 when the slot is free
+  std::atomic<pid_t> tid;
+  std::atomic<uint32_t> activity;
+  // Only used by the registered thread, with g_slotsMutex held
+  int registrations;
+  // Set by the registered thread, read by its signal handler
+  uintptr_t stackEnd;
+
+  // The sampler thread sets requested and signals the thread, whose signal
+  // handler fills in the sample and sets completed to the same value
+  std::atomic<uint32_t> requested;
+  std::atomic<uint32_t> completed;
+  uint32_t sampledActivity;
+  size_t depth;
+  uintptr_t frames[kMaxFrames];
+};
+
+// Never freed or moved, since signal handlers read it
+ThreadSlot g_slots[kMaxThreads];
+std::mutex g_slotsMutex;
+
+// Read by the signal handler, which stays installed once the profiler has
+// started: a SIGPROF still pending when the profiler stops would kill the
+// process if the default action was restored
+std::atomic<bool> g_running{false};
+
+ThreadSlot*& currentSlot() {
+  static thread_local ThreadSlot* t_slot = nullptr;
+  return t_slot;
+}
+
+// Reads the pc and the frame pointer of the interrupted code. fp is 0 where
+// frames can't be walked.
+void getInterruptedRegisters(const void* context, uintptr_t& pc, uintptr_t& fp) {
+  const SignalContext* uc = static_cast<const SignalContext*>(context);
+#if defined(__ANDROID__) && defined(__i386__)
+  pc = uc->uc_mcontext.eip;
+  fp = uc->uc_mcontext.ebp;
+#elif defined(__arm__)
+  // The Thumb-2 code GCC generates doesn't keep a chain of frame records, r7
+  // doesn't point at the saved r7 and lr, so only the pc is sampled
+  pc = uc->uc_mcontext.arm_pc;
+  fp = 0;
+#elif !defined(__ANDROID__) && defined(__i386__)
+  pc = uc->uc_mcontext.gregs[REG_EIP];
+  fp = uc->uc_mcontext.gregs[REG_EBP];
+#elif !defined(__ANDROID__) && defined(__x86_64__)
+  pc = uc->uc_mcontext.gregs[REG_RIP];
+  fp = uc->uc_mcontext.gregs[REG_RBP];
+#elif !defined(__ANDROID__) && defined(__aarch64__)
+  pc = uc->uc_mcontext.pc;
+  fp = uc->uc_mcontext.regs[29];
+#else
+  pc = 0;
+  fp = 0;
+#endif
+}
+
+// Follows the chain of frame records, each of which holds the caller's frame
+// pointer and the return address. Unlike _Unwind_Backtrace, this doesn't
+// lock or allocate, and it starts from the interrupted registers rather than
+// unwinding through the signal frame. A frame pointer outside of the part of
+// the stack above stackStart ends the walk, so code built without frame
+// pointers only truncates stacks.
+size_t walkFrames(uintptr_t pc, uintptr_t fp, uintptr_t stackStart, uintptr_t stackEnd, uintptr_t* frames) {
+  if (pc == 0) {
+    return 0;
+  }
+  size_t depth = 0;
+  frames[depth++] = pc;
+  while (depth < kMaxFrames &&
+         fp >= stackStart &&
+         fp + 2 * sizeof(uintptr_t) <= stackEnd &&
+         fp % sizeof(uintptr_t) == 0) {
+    const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+    uintptr_t callerFp = record[0];
+    uintptr_t returnAddress = record[1];
+    if (returnAddress == 0) {
+      break;
+    }
+    frames[depth++] = returnAddress;
+    // Stacks grow down, so callers' frames are at higher addresses
+    if (callerFp <= fp) {
+      break;
+    }
+    fp = callerFp;
+  }
+  return depth;
+}
+
+// Must only do async-signal-safe work
+void onSignal(int, siginfo_t*, void* context) {
+  if (!g_running.load(std::memory_order_relaxed)) {
+    return;
+  }
+  int savedErrno = errno;
+  pid_t tid = static_cast<pid_t>(syscall(__NR_gettid));
+  for (auto& slot : g_slots) {
+    if (slot.tid.load(std::memory_order_relaxed) == tid) {
+      uint32_t request = slot.requested.load(std::memory_order_acquire);
+      slot.sampledActivity = slot.activity.load(std::memory_order_relaxed);
+      uintptr_t pc;
+      uintptr_t fp;
+      getInterruptedRegisters(context, pc, fp);
+      // Without SA_ONSTACK the handler runs on the interrupted stack, below
+      // the frames to walk, and everything from here up to stackEnd is mapped
+      uintptr_t stackStart = reinterpret_cast<uintptr_t>(&pc);
+      slot.depth = walkFrames(pc, fp, stackStart, slot.stackEnd, slot.frames);
+      slot.completed.store(request, std::memory_order_release);
+      break;
+    }
+  }
+  errno = savedErrno;
+}
+
+// The highest address of the calling thread's stack, or 0 if unknown
+uintptr_t getCurrentStackEnd() {
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+    return 0;
+  }
+  void* stackAddress = nullptr;
+  size_t stackSize = 0;
+  int result = pthread_attr_getstack(&attributes, &stackAddress, &stackSize);
+  pthread_attr_destroy(&attributes);
+  if (result != 0) {
+    return 0;
+  }
+  return reinterpret_cast<uintptr_t>(stackAddress) + stackSize;
+}
+
+enum class NodeType : uint8_t {
+  Root,
+  Thread,
+  Activity,
+  Frame,
+};
+
+// A node of the call tree. Threads are children of the root, activities
+// children of threads, and the outermost frames children of activities.
+struct Node {
+  NodeType type;
+  // The tid, packed activity or pc
+  uint64_t key;
+  // -1 for the root
+  int parent;
+  uint32_t hitCount;
+  std::vector<int> children;
+  std::unordered_map<uint64_t, int> childrenByKey;
+};
+
+struct State {
+  // Guards starting and stopping
+  std::mutex mutex;
+  std::thread sampler;
+  bool handlerInstalled = false;
+  // Not reset between runs, so that a sample requested by an earlier run
+  // can't pass for one of this run
+  uint32_t lastRequest = 0;
+
+  // Only used by the sampler thread while it runs
+  std::vector<Node> nodes;
+  std::vector<int> samples;
+  std::vector<int64_t> sampleTimes;
+  int64_t startMicros;
+  int64_t endMicros;
+  pid_t samplerTid;
+
+  // When streaming, samples are written out and cleared every
+  // kSamplesPerChunk
+  std::shared_ptr<ProfileWriter> writer;
+  uint32_t profileId = 0;
+  size_t writtenNodes;
+  int64_t lastSampleMicros;
+};
+
+State& state() {
+  // Leaked, since threads may unregister while static destructors run
+  static State* s = new State();
+  return *s;
+}
+
+int64_t nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int childNode(State& s, int parent, NodeType type, uint64_t key) {
+  auto it = s.nodes[parent].childrenByKey.find(key);
+  if (it != s.nodes[parent].childrenByKey.end()) {
+    return it->second;
+  }
+  int id = static_cast<int>(s.nodes.size());
+  s.nodes.push_back(Node { type, key, parent, 0, {}, {} });
+  s.nodes[parent].children.push_back(id);
+  s.nodes[parent].childrenByKey.emplace(key, id);
+  return id;
+}
+
+void addSample(State& s, pid_t tid, const ThreadSlot& slot) {
+  int node = childNode(s, 0, NodeType::Thread, static_cast<uint64_t>(tid));
+  node = childNode(s, node, NodeType::Activity, slot.sampledActivity);
+  // Frames are innermost first
+  for (size_t i = slot.depth; i > 0; i--) {
+    node = childNode(s, node, NodeType::Frame, slot.frames[i - 1]);
+  }
+  s.nodes[node].hitCount++;
+  s.samples.push_back(node);
+  s.sampleTimes.push_back(nowMicros());
+}
+
+void appendEscaped(std::string& out, const char* value) {
+  for (; *value; value++) {
+    char c = *value;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+}
+
+std::string getActivityName(uint32_t packed) {
+  uint32_t value = packed & kValueMask;
+  switch (static_cast<SamplingProfiler::Activity>(packed >> kActivityShift)) {
+    case SamplingProfiler::Activity::None:
+      return "(outside bridge calls)";
+    case SamplingProfiler::Activity::CallFunction: {
+      const char* name = TraceRecorder::getName(value);
+      return std::string("(callFunction) ") + (name != nullptr ? name : "");
+    }
+    case SamplingProfiler::Activity::InvokeCallback:
+      return "(invokeCallback)";
+    case SamplingProfiler::Activity::NativeRequire:
+      return "(nativeRequire) " + std::to_string(value);
+  }
+  return "";
+}
+
+// Names the function the return address pc is in, and the library it is in
+void symbolize(uintptr_t pc, std::string& functionName, std::string& url) {
+  char buf[32];
+  Dl_info info;
+  // pc - 1 is in the call instruction, pc may already be in the next function
+  if (dladdr(reinterpret_cast<void*>(pc - 1), &info) == 0) {
+    snprintf(buf, sizeof(buf), "0x%" PRIxPTR, pc);
+    functionName = buf;
+    url.clear();
+    return;
+  }
+  url = info.dli_fname != nullptr ? info.dli_fname : "";
+  if (info.dli_sname != nullptr) {
+    int status;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    functionName = status == 0 ? demangled : info.dli_sname;
+    free(demangled);
+  } else {
+    // The offset in the library, for symbolizing offline
+    snprintf(buf, sizeof(buf), "0x%" PRIxPTR,
+      pc - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    functionName = buf;
+  }
+}
+
+void appendCallFrame(std::string& out, const Node& node) {
+  std::string functionName;
+  std::string url;
+  switch (node.type) {
+    case NodeType::Root:
+      functionName = "(root)";
+      break;
+    case NodeType::Thread:
+      functionName = "(thread " + std::to_string(node.key) + ")";
+      break;
+    case NodeType::Activity:
+      functionName = getActivityName(static_cast<uint32_t>(node.key));
+      break;
+    case NodeType::Frame:
+      symbolize(static_cast<uintptr_t>(node.key), functionName, url);
+      break;
+  }
+  out += "\"callFrame\":{\"functionName\":\"";
+  appendEscaped(out, functionName.c_str());
+  out += "\",\"scriptId\":\"0\",\"url\":\"";
+  appendEscaped(out, url.c_str());
+  out += "\",\"lineNumber\":-1,\"columnNumber\":-1}";
+}
+
+void appendSamples(std::string& out, const State& s, int64_t previousMicros) {
+  char buf[32];
+  out += "\"samples\":[";
+  for (size_t i = 0; i < s.samples.size(); i++) {
+    // Node IDs start at 1
+    snprintf(buf, sizeof(buf), "%s%d", i ? "," : "", s.samples[i] + 1);
+    out += buf;
+  }
+  out += "],\"timeDeltas\":[";
+  for (size_t i = 0; i < s.sampleTimes.size(); i++) {
+    snprintf(buf, sizeof(buf), "%s%" PRId64, i ? "," : "", s.sampleTimes[i] - previousMicros);
+    out += buf;
+    previousMicros = s.sampleTimes[i];
+  }
+  out += "]";
+}
+
+std::string toCpuProfile(const State& s) {
+  std::string out = "{\"nodes\":[";
+  char buf[64];
+  for (size_t id = 0; id < s.nodes.size(); id++) {
+    const Node& node = s.nodes[id];
+    snprintf(buf, sizeof(buf), "%s{\"id\":%zu,", id ? "," : "", id + 1);
+    out += buf;
+    appendCallFrame(out, node);
+    snprintf(buf, sizeof(buf), ",\"hitCount\":%u", node.hitCount);
+    out += buf;
+    if (!node.children.empty()) {
+      out += ",\"children\":[";
+      for (size_t i = 0; i < node.children.size(); i++) {
+        snprintf(buf, sizeof(buf), "%s%d", i ? "," : "", node.children[i] + 1);
+        out += buf;
+      }
+      out += "]";
+    }
+    out += "}";
+  }
+
+  snprintf(buf, sizeof(buf), "],\"startTime\":%" PRId64 ",\"endTime\":%" PRId64 ",",
+    s.startMicros, s.endMicros);
+  out += buf;
+  appendSamples(out, s, s.startMicros);
+  out += "}\n";
+  return out;
+}
+
+// Streams the profile as the Profile and ProfileChunk trace events Chrome
+// writes for its own CPU profiles, so that memory use doesn't grow with the
+// length of the capture
+void appendProfileEventHeader(std::string& out, const State& s, const char* name, int64_t micros) {
+  char buf[256];
+  snprintf(
+    buf,
+    sizeof(buf),
+    "{\"name\":\"%s\",\"cat\":\"disabled-by-default-v8.cpu_profiler\",\"ph\":\"P\","
+    "\"id\":\"0x%x\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRId64 ",\"args\":{\"data\":{",
+    name,
+    s.profileId,
+    static_cast<int>(getpid()),
+    static_cast<int>(s.samplerTid),
+    micros);
+  out += buf;
+}
+
+void writeProfileEvent(State& s) {
+  std::string event;
+  appendProfileEventHeader(event, s, "Profile", s.startMicros);
+  char buf[64];
+  snprintf(buf, sizeof(buf), "\"startTime\":%" PRId64 "}}}", s.startMicros);
+  event += buf;
+  s.writer->writeTraceEvent(event);
+}
+
+// Writes the nodes and samples added since the last chunk
+void writeProfileChunk(State& s) {
+  if (s.samples.empty() && s.writtenNodes == s.nodes.size()) {
+    return;
+  }
+  int64_t micros = s.sampleTimes.empty() ? nowMicros() : s.sampleTimes.back();
+  std::string event;
+  appendProfileEventHeader(event, s, "ProfileChunk", micros);
+  event += "\"cpuProfile\":{\"nodes\":[";
+  char buf[64];
+  for (size_t id = s.writtenNodes; id < s.nodes.size(); id++) {
+    const Node& node = s.nodes[id];
+    snprintf(buf, sizeof(buf), "%s{\"id\":%zu,", id > s.writtenNodes ? "," : "", id + 1);
+    event += buf;
+    appendCallFrame(event, node);
+    if (node.parent >= 0) {
+      snprintf(buf, sizeof(buf), ",\"parent\":%d", node.parent + 1);
+      event += buf;
+    }
+    event += "}";
+  }
+  event += "],";
+  // timeDeltas are a sibling of cpuProfile in ProfileChunk events
+  std::string samples;
+  appendSamples(samples, s, s.lastSampleMicros);
+  size_t split = samples.find(",\"timeDeltas\"");
+  event.append(samples, 0, split);
+  event += "}";
+  event.append(samples, split, std::string::npos);
+  event += "}}}";
+  s.writer->writeTraceEvent(event);
+
+  s.writtenNodes = s.nodes.size();
+  if (!s.sampleTimes.empty()) {
+    s.lastSampleMicros = s.sampleTimes.back();
+  }
+  s.samples.clear();
+  s.sampleTimes.clear();
+}
+
+void sampleThreads(State& s, std::chrono::microseconds interval) {
+  pid_t pid = getpid();
+  uint32_t& request = s.lastRequest;
+  s.samplerTid = static_cast<pid_t>(syscall(__NR_gettid));
+  if (s.writer) {
+    writeProfileEvent(s);
+  }
+  while (g_running.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(interval);
+    for (auto& slot : g_slots) {
+      pid_t tid = slot.tid.load(std::memory_order_relaxed);
+      if (tid == 0) {
+        continue;
+      }
+      request++;
+      slot.requested.store(request, std::memory_order_release);
+      if (syscall(__NR_tgkill, pid, tid, SIGPROF) != 0) {
+        continue;
+      }
+      auto deadline = std::chrono::steady_clock::now() + kSampleTimeout;
+      bool completed;
+      while (!(completed = slot.completed.load(std::memory_order_acquire) == request) &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      if (completed) {
+        addSample(s, tid, slot);
+      }
+    }
+    if (s.writer && s.samples.size() >= kSamplesPerChunk) {
+      writeProfileChunk(s);
+    }
+  }
+  if (s.writer) {
+    writeProfileChunk(s);
+  }
+}
+
+}
+
+SamplingProfiler::ActivityScope::ActivityScope(Activity activity, uint32_t value) {
+  ThreadSlot* slot = currentSlot();
+  if (slot == nullptr) {
+    m_previous = 0;
+    return;
+  }
+  m_previous = slot->activity.load(std::memory_order_relaxed);
+  slot->activity.store(packActivity(activity, value), std::memory_order_relaxed);
+  // Only the signal handler on this thread reads it
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+SamplingProfiler::ActivityScope::~ActivityScope() {
+  ThreadSlot* slot = currentSlot();
+  if (slot != nullptr) {
+    slot->activity.store(m_previous, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+}
+
+void SamplingProfiler::registerCurrentThread() {
+  std::lock_guard<std::mutex> lock(g_slotsMutex);
+  ThreadSlot*& current = currentSlot();
+  if (current != nullptr) {
+    current->registrations++;
+    return;
+  }
+  for (auto& slot : g_slots) {
+    if (slot.tid.load(std::memory_order_relaxed) == 0) {
+      slot.activity.store(0, std::memory_order_relaxed);
+      slot.registrations = 1;
+      slot.stackEnd = getCurrentStackEnd();
+      slot.tid.store(static_cast<pid_t>(syscall(__NR_gettid)), std::memory_order_release);
+      current = &slot;
+      return;
+    }
+  }
+  // All slots are taken, this thread won't be sampled
+}
+
+void SamplingProfiler::unregisterCurrentThread() {
+  std::lock_guard<std::mutex> lock(g_slotsMutex);
+  ThreadSlot*& current = currentSlot();
+  if (current == nullptr || --current->registrations > 0) {
+    return;
+  }
+  current->tid.store(0, std::memory_order_release);
+  current = nullptr;
+}
+
+bool SamplingProfiler::start(int intervalMicros, std::shared_ptr<ProfileWriter> writer) {
+  State& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  if (g_running.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  if (!s.handlerInstalled) {
+    struct sigaction action = {};
+    action.sa_sigaction = &onSignal;
+    // Interrupted system calls, like waiting for the next task, are restarted
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      return false;
+    }
+    s.handlerInstalled = true;
+  }
+
+  s.nodes.clear();
+  s.nodes.push_back(Node { NodeType::Root, 0, -1, 0, {}, {} });
+  s.samples.clear();
+  s.sampleTimes.clear();
+  s.startMicros = nowMicros();
+  s.writer = std::move(writer);
+  s.profileId++;
+  s.writtenNodes = 0;
+  s.lastSampleMicros = s.startMicros;
+  g_running.store(true, std::memory_order_relaxed);
+  s.sampler = std::thread(&sampleThreads, std::ref(s), std::chrono::microseconds(intervalMicros));
+  return true;
+}
+
+std::string SamplingProfiler::stop() {
+  State& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  if (!g_running.load(std::memory_order_relaxed)) {
+    return "";
+  }
+  g_running.store(false, std::memory_order_relaxed);
+  s.sampler.join();
+  s.endMicros = nowMicros();
+
+  std::string profile;
+  if (s.writer) {
+    // The sampler thread has written the last chunk
+    s.writer = nullptr;
+  } else {
+    profile = toCpuProfile(s);
+  }
+  s.nodes.clear();
+  s.samples.clear();
+  s.sampleTimes.clear();
+  return profile;
+}
+
+} }
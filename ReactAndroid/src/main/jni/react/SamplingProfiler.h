@@ -0,0 +1,75 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+class ProfileWriter;
+
+/**
+ * Samples the native stacks of registered threads (the JS threads) by
+ * interrupting them with SIGPROF from a sampler thread, and attributes each
+ * sample to the bridge activity the thread was in: a callFunction, an
+ * invokeCallback or a nativeRequire. Unlike the JSC profiler used by
+ * Bridge::startProfiler(), this doesn't instrument JS, so it costs nothing
+ * between samples.
+ *
+ * Stacks are walked through frame pointers from the interrupted registers,
+ * so they stop at the first frame built without one. On 32-bit ARM only the
+ * interrupted pc is sampled. The SIGPROF handler stays installed once the
+ * profiler has started, and ignores signals while it's stopped.
+ */
+class SamplingProfiler {
+public:
+  enum class Activity : uint32_t {
+    None,
+    // Value is the name ID of the tracing name of the call
+    CallFunction,
+    InvokeCallback,
+    // Value is the module ID
+    NativeRequire,
+  };
+
+  /**
+   * Sets the activity of the calling thread for the lifetime of this object.
+   * Scopes can be nested.
+   */
+  class ActivityScope {
+  public:
+    ActivityScope(Activity activity, uint32_t value);
+    ~ActivityScope();
+
+  private:
+    uint32_t m_previous;
+  };
+
+  /**
+   * Registration is counted, a thread stays registered until it has
+   * unregistered as many times as it has registered.
+   */
+  static void registerCurrentThread();
+  static void unregisterCurrentThread();
+
+  /**
+   * With a writer, samples are streamed to it as Chrome's Profile and
+   * ProfileChunk trace events while profiling, instead of being kept in
+   * memory until stop(). Returns false if the profiler is already running or
+   * can't install its signal handler.
+   */
+  static bool start(int intervalMicros, std::shared_ptr<ProfileWriter> writer = nullptr);
+
+  /**
+   * Stops the profiler and returns the samples as a Chrome .cpuprofile,
+   * which Chrome DevTools can load. Samples are grouped by thread, then by
+   * activity, then by native stack. Returns an empty string if the profiler
+   * isn't running, or if it was streaming to a writer.
+   */
+  static std::string stop();
+};
+
+} }
@@ -0,0 +1,164 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "StartupTimeline.h"
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+enum PhaseStatus : int {
+  NotBegun,
+  Beginning,
+  Begun,
+  Ending,
+  Ended,
+};
+
+// Written by begin() and end() when they move the status forward, read once
+// the status is Ended
+struct PhaseState {
+  std::atomic<int> status;
+  std::atomic<int64_t> beginNanos;
+  std::atomic<int64_t> endNanos;
+  std::atomic<pid_t> beginTid;
+  std::atomic<pid_t> endTid;
+};
+
+// Shorter gaps, e.g. between phases that run back to back, are left out of
+// the critical path
+const int64_t kMinGapNanos = 100000;
+
+PhaseState g_phases[StartupTimeline::kPhaseCount];
+std::atomic<int64_t> g_startNanos{0};
+
+int64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+pid_t currentTid() {
+  return static_cast<pid_t>(syscall(__NR_gettid));
+}
+
+// Moves the status of state from expected to the next one, with the fields
+// written by update() in between
+template <typename F>
+void advance(PhaseState& state, PhaseStatus expected, F&& update) {
+  int status = expected;
+  if (!state.status.compare_exchange_strong(status, expected + 1, std::memory_order_acquire)) {
+    return;
+  }
+  update(state);
+  state.status.store(expected + 2, std::memory_order_release);
+}
+
+}
+
+const size_t StartupTimeline::kPhaseCount;
+
+void StartupTimeline::reset() {
+  for (auto& state : g_phases) {
+    state.status.store(NotBegun, std::memory_order_relaxed);
+  }
+  g_startNanos.store(nowNanos(), std::memory_order_release);
+}
+
+void StartupTimeline::begin(Phase phase) {
+  advance(g_phases[static_cast<size_t>(phase)], NotBegun, [] (PhaseState& state) {
+    state.beginNanos.store(nowNanos(), std::memory_order_relaxed);
+    state.beginTid.store(currentTid(), std::memory_order_relaxed);
+  });
+}
+
+void StartupTimeline::end(Phase phase) {
+  advance(g_phases[static_cast<size_t>(phase)], Begun, [] (PhaseState& state) {
+    state.endNanos.store(nowNanos(), std::memory_order_relaxed);
+    state.endTid.store(currentTid(), std::memory_order_relaxed);
+  });
+}
+
+int64_t StartupTimeline::getStartNanos() {
+  return g_startNanos.load(std::memory_order_acquire);
+}
+
+std::vector<StartupTimeline::Span> StartupTimeline::getSpans() {
+  std::vector<Span> spans;
+  for (size_t i = 0; i < kPhaseCount; i++) {
+    PhaseState& state = g_phases[i];
+    if (state.status.load(std::memory_order_acquire) != Ended) {
+      continue;
+    }
+    spans.push_back(Span {
+      static_cast<Phase>(i),
+      state.beginNanos.load(std::memory_order_relaxed),
+      state.endNanos.load(std::memory_order_relaxed),
+      state.beginTid.load(std::memory_order_relaxed),
+      state.endTid.load(std::memory_order_relaxed),
+    });
+  }
+  std::sort(spans.begin(), spans.end(), [] (const Span& a, const Span& b) {
+    return a.beginNanos < b.beginNanos;
+  });
+  return spans;
+}
+
+std::vector<StartupTimeline::CriticalPathEntry> StartupTimeline::getCriticalPath() {
+  std::vector<Span> spans = getSpans();
+  std::vector<CriticalPathEntry> path;
+  if (spans.empty()) {
+    return path;
+  }
+
+  // Walks back from the phase ending last, built in reverse
+  const Span* current = &*std::max_element(spans.begin(), spans.end(), [] (const Span& a, const Span& b) {
+    return a.endNanos < b.endNanos;
+  });
+  while (current != nullptr) {
+    path.push_back(CriticalPathEntry { current->phase, false, current->endNanos - current->beginNanos });
+    const Span* previous = nullptr;
+    for (auto& span : spans) {
+      if (span.endNanos <= current->beginNanos &&
+          (previous == nullptr || span.endNanos > previous->endNanos)) {
+        previous = &span;
+      }
+    }
+    int64_t gapStart = previous != nullptr ? previous->endNanos : getStartNanos();
+    if (current->beginNanos - gapStart >= kMinGapNanos) {
+      path.push_back(CriticalPathEntry { current->phase, true, current->beginNanos - gapStart });
+    }
+    current = previous;
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+const char* StartupTimeline::getPhaseName(Phase phase) {
+  switch (phase) {
+    case Phase::ReadScript:
+      return "readScript";
+    case Phase::ConvertScript:
+      return "convertScript";
+    case Phase::ModuleConfig:
+      return "moduleConfig";
+    case Phase::CreateContext:
+      return "createContext";
+    case Phase::EvaluateScript:
+      return "evaluateScript";
+    case Phase::FirstFlush:
+      return "firstFlush";
+    case Phase::FirstNativeBatch:
+      return "firstNativeBatch";
+  }
+  return "";
+}
+
+} }
@@ -0,0 +1,104 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Records when the phases of starting a bridge began and ended, and on which
+ * threads, so that time to interactive can be attributed to them. Unlike
+ * ReactMarker::logMarker, phases are typed and are kept after startup, to
+ * be queried as a critical path.
+ *
+ * Only the first begin and end of each phase since reset() are recorded,
+ * later ones (e.g. from web workers) are ignored. Recording is lock-free.
+ */
+class StartupTimeline {
+public:
+  enum class Phase : uint8_t {
+    // Reading the bundle from assets or a file
+    ReadScript,
+    // Checking the bundle is ASCII and converting it to a JS string
+    ConvertScript,
+    // Injecting the native module config into JS
+    ModuleConfig,
+    // Creating the JS context and installing the native hooks
+    CreateContext,
+    EvaluateScript,
+    // Flushing the JS queue once the bundle has run
+    FirstFlush,
+    // Running the first batch of native module calls from JS
+    FirstNativeBatch,
+  };
+
+  static const size_t kPhaseCount = 7;
+
+  struct Span {
+    Phase phase;
+    // CLOCK_MONOTONIC, like System.nanoTime()
+    int64_t beginNanos;
+    int64_t endNanos;
+    pid_t beginTid;
+    pid_t endTid;
+  };
+
+  /**
+   * The critical path is the chain of phases, each ending before the next
+   * begins, that leads to the phase ending last. Gaps are the time between
+   * them (or between reset() and the first of them) that no phase on the
+   * path accounts for, e.g. waiting for a queue, or Java work. Gaps shorter
+   * than 0.1 ms are left out.
+   */
+  struct CriticalPathEntry {
+    // The phase, or the phase the gap is before
+    Phase phase;
+    bool isGap;
+    int64_t durationNanos;
+  };
+
+  class Scope : public noncopyable {
+  public:
+    explicit Scope(Phase phase) : m_phase(phase) {
+      begin(phase);
+    }
+
+    ~Scope() {
+      end(m_phase);
+    }
+
+  private:
+    const Phase m_phase;
+  };
+
+  /**
+   * Starts a new timeline, when a bridge is created.
+   */
+  static void reset();
+
+  static void begin(Phase phase);
+  static void end(Phase phase);
+
+  /**
+   * When reset() was last called.
+   */
+  static int64_t getStartNanos();
+
+  /**
+   * Returns the phases that have ended, in the order they began.
+   */
+  static std::vector<Span> getSpans();
+
+  static std::vector<CriticalPathEntry> getCriticalPath();
+
+  static const char* getPhaseName(Phase phase);
+};
+
+} }
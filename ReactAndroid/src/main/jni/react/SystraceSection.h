@@ -0,0 +1,71 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#ifdef WITH_FBSYSTRACE
+#include <fbsystrace.h>
+#endif
+
+#include "TraceRecorder.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Traces the lifetime of this object as a section named name. The section
+ * goes to systrace in builds with WITH_FBSYSTRACE, and to TraceRecorder when
+ * it is enabled, which works in every build. args are key/value pairs of
+ * systrace section arguments, TraceRecorder doesn't record them.
+ */
+class SystraceSection {
+public:
+  template <typename... ConvertsToStringPiece>
+  explicit SystraceSection(const char* name, ConvertsToStringPiece&&... args)
+  #ifdef WITH_FBSYSTRACE
+    : m_section(TRACE_TAG_REACT_CXX_BRIDGE, name, args...)
+  #endif
+  {
+    // Remembered, so that the end of the section is recorded even if
+    // recording stops in the middle of it
+    m_recorded = TraceRecorder::isEnabled();
+    if (m_recorded) {
+      TraceRecorder::record(
+        TraceRecorder::EventType::Begin, TraceRecorder::internName(name));
+    }
+  }
+
+  ~SystraceSection() {
+    if (m_recorded) {
+      TraceRecorder::record(TraceRecorder::EventType::End, static_cast<uint32_t>(0));
+    }
+  }
+
+private:
+  #ifdef WITH_FBSYSTRACE
+  fbsystrace::FbSystraceSection m_section;
+  #endif
+  bool m_recorded;
+};
+
+/**
+ * Async flows link an event on one thread, like a call being queued, with the
+ * work it causes on another. begin() and end() calls are matched by name and
+ * cookie.
+ */
+struct SystraceAsyncFlow {
+  static void begin(const char* name, int cookie) {
+    #ifdef WITH_FBSYSTRACE
+    fbsystrace::FbSystraceAsyncFlow::begin(TRACE_TAG_REACT_CXX_BRIDGE, name, cookie);
+    #endif
+    TraceRecorder::record(TraceRecorder::EventType::AsyncBegin, name, cookie);
+  }
+
+  static void end(const char* name, int cookie) {
+    #ifdef WITH_FBSYSTRACE
+    fbsystrace::FbSystraceAsyncFlow::end(TRACE_TAG_REACT_CXX_BRIDGE, name, cookie);
+    #endif
+    TraceRecorder::record(TraceRecorder::EventType::AsyncEnd, name, cookie);
+  }
+};
+
+} }
@@ -0,0 +1,410 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "TraceRecorder.h"
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fb/ThreadLocal.h>
+
+#include "ProfileWriter.h"
+
+namespace facebook {
+namespace react {
+
+std::atomic<bool> TraceRecorder::s_enabled(false);
+
+namespace {
+
+// Per thread, must be a power of two
+const size_t kBufferCapacity = 8192;
+// Per thread, the cache is cleared when it grows past this
+const size_t kMaxCachedNames = 1024;
+
+struct Event {
+  uint64_t timestampNanos;
+  int64_t value;
+  uint32_t name;
+  TraceRecorder::EventType type;
+};
+
+// Written by its thread only, read by dumpChromeTrace()
+struct ThreadBuffer {
+  explicit ThreadBuffer(pid_t tid_) : tid(tid_) {}
+
+  const pid_t tid;
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  // Set once the thread has exited, guarded by State::mutex
+  bool exited = false;
+  Event events[kBufferCapacity];
+};
+
+// Hashes and compares names by contents, so that a name can be looked up
+// through any pointer to its characters without building a std::string
+struct NameHash {
+  size_t operator()(const char* name) const {
+    // FNV-1a
+    size_t hash = 2166136261u;
+    for (; *name; name++) {
+      hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619u;
+    }
+    return hash;
+  }
+};
+
+struct NameEquals {
+  bool operator()(const char* a, const char* b) const {
+    return strcmp(a, b) == 0;
+  }
+};
+
+// Keys point into State::names
+using NameMap = std::unordered_map<const char*, uint32_t, NameHash, NameEquals>;
+
+struct ThreadState {
+  ThreadBuffer* buffer = nullptr;
+  NameMap names;
+  // Indexed by name ID, point into State::names
+  std::vector<const char*> namesById;
+};
+
+// Guards the fields of Streaming, but not the writer's I/O
+struct Streaming {
+  std::mutex mutex;
+  std::condition_variable stopRequested;
+  std::shared_ptr<ProfileWriter> writer;
+  bool stopping = false;
+  std::thread thread;
+};
+
+struct State {
+  std::mutex mutex;
+  // Never shrinks, so that the keys of the name maps stay valid
+  std::deque<std::string> names;
+  NameMap nameIds;
+  std::vector<ThreadBuffer*> buffers;
+  std::atomic<uint64_t> dropped{0};
+  // Recording is on while either is set, guarded by mutex
+  bool recordingForCaller = false;
+  bool recordingForStreaming = false;
+  Streaming streaming;
+};
+
+State& state() {
+  // Leaked, since threads may record while static destructors run
+  static State* s = new State();
+  return *s;
+}
+
+ThreadState*& threadState() {
+  // A thread_local for speed; exitHandler() only cleans up
+  static thread_local ThreadState* t_state = nullptr;
+  return t_state;
+}
+
+void onThreadExit(void* obj) {
+  ThreadState* threadStateToDelete = static_cast<ThreadState*>(obj);
+  if (threadStateToDelete == nullptr) {
+    return;
+  }
+  // Later thread exit handlers may still record, with a new ThreadState
+  threadState() = nullptr;
+  if (threadStateToDelete->buffer != nullptr) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    // Deleted by the next dump, which still has to read its events
+    threadStateToDelete->buffer->exited = true;
+  }
+  delete threadStateToDelete;
+}
+
+ThreadLocal<ThreadState>& exitHandler() {
+  static ThreadLocal<ThreadState>* handler = new ThreadLocal<ThreadState>(&onThreadExit);
+  return *handler;
+}
+
+ThreadState& localState() {
+  ThreadState*& local = threadState();
+  if (local == nullptr) {
+    local = new ThreadState();
+    exitHandler().reset(local);
+  }
+  return *local;
+}
+
+ThreadBuffer& localBuffer(ThreadState& local) {
+  if (local.buffer == nullptr) {
+    local.buffer = new ThreadBuffer(static_cast<pid_t>(syscall(__NR_gettid)));
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.buffers.push_back(local.buffer);
+  }
+  return *local.buffer;
+}
+
+uint64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void appendEscaped(std::string& out, const std::string& value) {
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+          out += escaped;
+        } else {
+          out += c;
+        }
+    }
+  }
+}
+
+void appendEvent(
+    std::string& out,
+    const Event& event,
+    const std::string& name,
+    pid_t pid,
+    pid_t tid) {
+  static const char* const kPhases[] = { "B", "E", "b", "e", "C" };
+  char buf[128];
+  snprintf(
+    buf,
+    sizeof(buf),
+    "{\"ph\":\"%s\",\"ts\":%" PRIu64 ".%03u,\"pid\":%d,\"tid\":%d",
+    kPhases[static_cast<int>(event.type)],
+    event.timestampNanos / 1000,
+    static_cast<unsigned>(event.timestampNanos % 1000),
+    pid,
+    tid);
+  out += buf;
+
+  if (event.type != TraceRecorder::EventType::End) {
+    out += ",\"cat\":\"react\",\"name\":\"";
+    appendEscaped(out, name);
+    out += "\"";
+  }
+  switch (event.type) {
+    case TraceRecorder::EventType::AsyncBegin:
+    case TraceRecorder::EventType::AsyncEnd:
+      snprintf(buf, sizeof(buf), ",\"id\":\"0x%" PRIx64 "\"", static_cast<uint64_t>(event.value));
+      out += buf;
+      break;
+    case TraceRecorder::EventType::Counter:
+      snprintf(buf, sizeof(buf), ",\"args\":{\"value\":%" PRId64 "}", event.value);
+      out += buf;
+      break;
+    default:
+      break;
+  }
+  out += "}";
+}
+
+// Removes the recorded events of all threads and passes them to onEvent,
+// with the state mutex held
+template <typename F>
+void drainEvents(F&& onEvent) {
+  State& s = state();
+  pid_t pid = getpid();
+  static const std::string kNoName;
+
+  std::lock_guard<std::mutex> lock(s.mutex);
+  for (auto it = s.buffers.begin(); it != s.buffers.end();) {
+    ThreadBuffer* buffer = *it;
+    size_t tail = buffer->tail.load(std::memory_order_relaxed);
+    size_t head = buffer->head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+      const Event& event = buffer->events[tail & (kBufferCapacity - 1)];
+      const std::string& name = event.name < s.names.size() ? s.names[event.name] : kNoName;
+      onEvent(event, name, pid, buffer->tid);
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+
+    if (buffer->exited) {
+      delete buffer;
+      it = s.buffers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void writeEvents(ProfileWriter& writer) {
+  // Formatted with the state mutex held, written without it. Bounded by the
+  // capacity of the thread buffers.
+  std::vector<std::string> events;
+  drainEvents([&] (const Event& event, const std::string& name, pid_t pid, pid_t tid) {
+    events.emplace_back();
+    appendEvent(events.back(), event, name, pid, tid);
+  });
+  for (auto& event : events) {
+    writer.writeTraceEvent(event);
+  }
+}
+
+}
+
+void TraceRecorder::setEnabled(bool enabled) {
+  setRecording(false, enabled);
+}
+
+void TraceRecorder::setRecording(bool forStreaming, bool enabled) {
+  State& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  (forStreaming ? s.recordingForStreaming : s.recordingForCaller) = enabled;
+  s_enabled.store(s.recordingForCaller || s.recordingForStreaming, std::memory_order_relaxed);
+}
+
+uint32_t TraceRecorder::internName(const char* name) {
+  ThreadState& local = localState();
+  auto cached = local.names.find(name);
+  if (cached != local.names.end()) {
+    return cached->second;
+  }
+
+  State& s = state();
+  uint32_t id;
+  const char* key;
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto interned = s.nameIds.find(name);
+    if (interned == s.nameIds.end()) {
+      id = static_cast<uint32_t>(s.names.size());
+      s.names.emplace_back(name);
+      key = s.names.back().c_str();
+      s.nameIds.emplace(key, id);
+    } else {
+      key = interned->first;
+      id = interned->second;
+    }
+  }
+  if (local.names.size() >= kMaxCachedNames) {
+    // Names built at runtime could otherwise grow the cache forever
+    local.names.clear();
+  }
+  local.names.emplace(key, id);
+  return id;
+}
+
+const char* TraceRecorder::getName(uint32_t id) {
+  ThreadState& local = localState();
+  if (id < local.namesById.size()) {
+    return local.namesById[id];
+  }
+
+  State& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  for (size_t i = local.namesById.size(); i < s.names.size(); i++) {
+    local.namesById.push_back(s.names[i].c_str());
+  }
+  return id < local.namesById.size() ? local.namesById[id] : nullptr;
+}
+
+void TraceRecorder::record(EventType type, uint32_t name, int64_t value) {
+  ThreadBuffer& buffer = localBuffer(localState());
+  size_t head = buffer.head.load(std::memory_order_relaxed);
+  if (head - buffer.tail.load(std::memory_order_acquire) == kBufferCapacity) {
+    state().dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Event& event = buffer.events[head & (kBufferCapacity - 1)];
+  event.timestampNanos = nowNanos();
+  event.value = value;
+  event.name = name;
+  event.type = type;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+std::string TraceRecorder::dumpChromeTrace() {
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  drainEvents([&] (const Event& event, const std::string& name, pid_t pid, pid_t tid) {
+    if (!first) {
+      out += ",\n";
+    }
+    first = false;
+    appendEvent(out, event, name, pid, tid);
+  });
+  out += "],\"displayTimeUnit\":\"ms\"}\n";
+  return out;
+}
+
+bool TraceRecorder::startStreaming(std::shared_ptr<ProfileWriter> writer, int flushIntervalMs) {
+  Streaming& streaming = state().streaming;
+  std::lock_guard<std::mutex> lock(streaming.mutex);
+  if (streaming.writer) {
+    return false;
+  }
+  streaming.writer = std::move(writer);
+  streaming.stopping = false;
+  streaming.thread = std::thread([&streaming, flushIntervalMs] {
+    std::unique_lock<std::mutex> lock(streaming.mutex);
+    while (!streaming.stopping) {
+      streaming.stopRequested.wait_for(
+        lock, std::chrono::milliseconds(flushIntervalMs), [&] { return streaming.stopping; });
+      std::shared_ptr<ProfileWriter> writer = streaming.writer;
+      // So that startStreaming() and getStreamingWriter() don't wait for I/O
+      lock.unlock();
+      writeEvents(*writer);
+      lock.lock();
+    }
+  });
+  setRecording(true, true);
+  return true;
+}
+
+std::shared_ptr<ProfileWriter> TraceRecorder::stopStreaming() {
+  Streaming& streaming = state().streaming;
+  std::unique_lock<std::mutex> lock(streaming.mutex);
+  if (!streaming.writer || streaming.stopping) {
+    return nullptr;
+  }
+  setRecording(true, false);
+  streaming.stopping = true;
+  streaming.stopRequested.notify_all();
+  std::thread thread = std::move(streaming.thread);
+  lock.unlock();
+  // The thread writes the remaining events before exiting
+  thread.join();
+  lock.lock();
+  std::shared_ptr<ProfileWriter> writer = std::move(streaming.writer);
+  streaming.writer = nullptr;
+  return writer;
+}
+
+std::shared_ptr<ProfileWriter> TraceRecorder::getStreamingWriter() {
+  Streaming& streaming = state().streaming;
+  std::lock_guard<std::mutex> lock(streaming.mutex);
+  return streaming.stopping ? nullptr : streaming.writer;
+}
+
+uint64_t TraceRecorder::getDroppedEventCount() {
+  return state().dropped.load(std::memory_order_relaxed);
+}
+
+} }
@@ -0,0 +1,106 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+class ProfileWriter;
+
+/**
+ * Records trace events in process, for builds and platforms without
+ * fbsystrace. Events are written to a lock-free ring buffer owned by the
+ * recording thread, with a monotonic timestamp and the ID of their interned
+ * name, and are read back with dumpChromeTrace().
+ *
+ * Recording is off by default, and costs a relaxed atomic load per event when
+ * off. When a thread's buffer is full, its new events are dropped until the
+ * next dump.
+ *
+ * Use SystraceSection and SystraceAsyncFlow (SystraceSection.h) rather than
+ * calling this directly, so that events also go to systrace when available.
+ */
+class TraceRecorder {
+public:
+  enum class EventType : uint8_t {
+    Begin,
+    End,
+    AsyncBegin,
+    AsyncEnd,
+    Counter,
+  };
+
+  static bool isEnabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Recording is on while enabled here or while streaming, so this doesn't
+   * stop a stream from recording and stopStreaming() doesn't undo it.
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * Returns a stable ID for name, for use with record(). Lock-free once the
+   * calling thread has seen the name.
+   */
+  static uint32_t internName(const char* name);
+
+  /**
+   * Returns the name interned as id, or nullptr if there is none. The result
+   * stays valid forever. Lock-free once the calling thread has seen the ID.
+   */
+  static const char* getName(uint32_t id);
+
+  /**
+   * Records an event on the calling thread's buffer. value is the cookie of
+   * async events, and the value of counters.
+   */
+  static void record(EventType type, uint32_t name, int64_t value = 0);
+
+  static void record(EventType type, const char* name, int64_t value = 0) {
+    if (isEnabled()) {
+      record(type, internName(name), value);
+    }
+  }
+
+  /**
+   * Removes the recorded events of all threads and returns them as Chrome
+   * Trace Event JSON, which chrome://tracing and Perfetto can open.
+   */
+  static std::string dumpChromeTrace();
+
+  static uint64_t getDroppedEventCount();
+
+  /**
+   * Enables recording, and writes the recorded events to writer every
+   * flushIntervalMs from a background thread, so that captures aren't
+   * limited by the size of the thread buffers. dumpChromeTrace() shouldn't be
+   * used meanwhile. Returns false if already streaming.
+   */
+  static bool startStreaming(std::shared_ptr<ProfileWriter> writer, int flushIntervalMs);
+
+  /**
+   * Writes the remaining events, stops recording unless setEnabled(true) was
+   * called, and returns the writer, or nullptr if not streaming.
+   */
+  static std::shared_ptr<ProfileWriter> stopStreaming();
+
+  /**
+   * Returns the writer events are streamed to, or nullptr. Other profilers
+   * write their output to it too, so that a capture ends up in one file.
+   */
+  static std::shared_ptr<ProfileWriter> getStreamingWriter();
+
+private:
+  static void setRecording(bool forStreaming, bool enabled);
+
+  static std::atomic<bool> s_enabled;
+};
+
+} }
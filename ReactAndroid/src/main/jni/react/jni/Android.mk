@@ -10,14 +10,21 @@ LOCAL_SRC_FILES := \
   JSCPerfLogging.cpp \
   JSLoader.cpp \
   JSLogging.cpp \
+  JavaCallBatch.cpp \
   JniJSModulesUnbundle.cpp \
+  JniStringCache.cpp \
   NativeArray.cpp \
+  NativeCollections.cpp \
+  NativeMarkers.cpp \
+  NativeRunnableDeprecated.cpp \
   OnLoad.cpp \
   ProxyExecutor.cpp \
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)
 
 LOCAL_CFLAGS += -Wall -Werror -fvisibility=hidden -fexceptions -frtti
+# SamplingProfiler walks stacks through frame pointers
+LOCAL_CFLAGS += -fno-omit-frame-pointer
 CXX11_FLAGS := -std=c++11
 LOCAL_CFLAGS += $(CXX11_FLAGS)
 LOCAL_EXPORT_CPPFLAGS := $(CXX11_FLAGS)
@@ -9,10 +9,7 @@
 #include <streambuf>
 #include <string>
 #include <fb/log.h>
-#ifdef WITH_FBSYSTRACE
-#include <fbsystrace.h>
-using fbsystrace::FbSystraceSection;
-#endif
+#include <react/SystraceSection.h>
 
 namespace facebook {
 namespace react {
@@ -33,10 +30,7 @@ std::string loadScriptFromAssets(const std::string& assetName) {
 std::string loadScriptFromAssets(
     AAssetManager *manager,
     const std::string& assetName) {
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromAssets",
-    "assetName", assetName);
-  #endif
+  SystraceSection s("reactbridge_jni_loadScriptFromAssets", "assetName", assetName);
   if (manager) {
     auto asset = AAssetManager_open(
       manager,
@@ -60,10 +54,7 @@ std::string loadScriptFromAssets(
 }
 
 std::string loadScriptFromFile(const std::string& fileName) {
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_loadScriptFromFile",
-    "fileName", fileName);
-  #endif
+  SystraceSection s("reactbridge_jni_loadScriptFromFile", "fileName", fileName);
   std::ifstream jsfile(fileName);
   if (jsfile) {
     std::string output;
@@ -0,0 +1,110 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JavaCallBatch.h"
+
+#include <jni/LocalString.h>
+#include <jni/fbjni.h>
+#include <jni/fbjni/ByteBuffer.h>
+#include <react/BridgeLatency.h>
+#include <react/TraceRecorder.h>
+#include "NativeMarkers.h"
+#include "ReadableNativeArray.h"
+
+#ifdef WITH_FBSYSTRACE
+#include <fbsystrace.h>
+#endif
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+static jmethodID gCallBatchMethod;
+
+// Written by Java into the third int of a call once it has run
+static const int32_t kNotRun = -1;
+
+static uint32_t getLatencyNameId(const MethodNameIds& nameIds, int32_t moduleId, int32_t methodId) {
+  if (moduleId >= 0 && static_cast<size_t>(moduleId) < nameIds.size() &&
+      methodId >= 0 && static_cast<size_t>(methodId) < nameIds[moduleId].size()) {
+    return nameIds[moduleId][methodId];
+  }
+  static const uint32_t kUnknownNameId = TraceRecorder::internName("<unknown>");
+  return kUnknownNameId;
+}
+
+MethodNameIds internMethodNames(JNIEnv* env, jobjectArray names) {
+  MethodNameIds nameIds;
+  if (names == nullptr) {
+    return nameIds;
+  }
+  jsize moduleCount = env->GetArrayLength(names);
+  nameIds.resize(moduleCount);
+  for (jsize moduleId = 0; moduleId < moduleCount; moduleId++) {
+    auto methods = static_cast<jobjectArray>(env->GetObjectArrayElement(names, moduleId));
+    jsize methodCount = env->GetArrayLength(methods);
+    for (jsize methodId = 0; methodId < methodCount; methodId++) {
+      auto name = static_cast<jstring>(env->GetObjectArrayElement(methods, methodId));
+      nameIds[moduleId].push_back(TraceRecorder::internName(fromJString(env, name).c_str()));
+      env->DeleteLocalRef(name);
+    }
+    env->DeleteLocalRef(methods);
+  }
+  return nameIds;
+}
+
+void makeJavaCalls(JNIEnv* env, jobject executorToken, jobject callback,
+                   std::vector<MethodCall>&& calls, const MethodNameIds& nameIds) {
+  std::vector<int32_t> ids;
+  ids.reserve(calls.size() * 3);
+  std::vector<MethodCall*> called;
+  called.reserve(calls.size());
+  for (auto& call : calls) {
+    if (call.arguments.isNull()) {
+      continue;
+    }
+
+    #ifdef WITH_FBSYSTRACE
+    if (call.callId != -1) {
+      fbsystrace_end_async_flow(TRACE_TAG_REACT_APPS, "native", call.callId);
+    }
+    #endif
+
+    ids.push_back(call.moduleId);
+    ids.push_back(call.methodId);
+    ids.push_back(kNotRun);
+    called.push_back(&call);
+  }
+  if (ids.empty()) {
+    return;
+  }
+
+  countJniTransition();
+  auto jcalls = JByteBuffer::wrapBytes(
+    reinterpret_cast<uint8_t*>(ids.data()), ids.size() * sizeof(int32_t));
+  // NativeModule.invoke() takes a ReadableNativeArray per call, so one still
+  // has to be allocated for each, but without a downcall from Java per call.
+  auto jarguments = JArrayClass<ReadableNativeArray::javaobject>::newArray(called.size());
+  for (size_t i = 0; i < called.size(); i++) {
+    auto jcallArguments = ReadableNativeArray::newObjectCxxArgs(std::move(called[i]->arguments));
+    jarguments->setElement(i, jcallArguments.get());
+  }
+  env->CallVoidMethod(callback, gCallBatchMethod, executorToken, jcalls.get(), jarguments.get());
+
+  for (size_t i = 0; i < ids.size(); i += 3) {
+    if (ids[i + 2] != kNotRun) {
+      BridgeLatency::record(
+        BridgeLatency::Kind::NativeCall,
+        getLatencyNameId(nameIds, ids[i], ids[i + 1]),
+        static_cast<uint64_t>(ids[i + 2]) * 1000);
+    }
+  }
+}
+
+void initializeJavaCallBatch(JNIEnv* env) {
+  jclass callbackClass = env->FindClass("com/facebook/react/bridge/ReactCallback");
+  gCallBatchMethod = env->GetMethodID(callbackClass, "callBatch", "(Lcom/facebook/react/bridge/ExecutorToken;Ljava/nio/ByteBuffer;[Lcom/facebook/react/bridge/ReadableNativeArray;)V");
+  env->DeleteLocalRef(callbackClass);
+}
+
+} }
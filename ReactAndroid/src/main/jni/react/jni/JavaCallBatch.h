@@ -0,0 +1,46 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <jni.h>
+#include <react/MethodCall.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * The TraceRecorder name IDs of the "Module.method" names of a bridge's
+ * native module methods, by module ID and method ID.
+ */
+using MethodNameIds = std::vector<std::vector<uint32_t>>;
+
+/**
+ * Interns the names of ReactBridge's nativeMethodNames, a String[][] by
+ * module ID and method ID. Done once per bridge, so that calls don't build
+ * names.
+ */
+MethodNameIds internMethodNames(JNIEnv* env, jobjectArray names);
+
+/**
+ * Delivers a batch of calls to ReactCallback.callBatch() with a single upcall.
+ * Each call is encoded as three native-endian int32s in a direct ByteBuffer:
+ * the module and method IDs, and a slot where Java writes how long the call
+ * took in microseconds, which is recorded in BridgeLatency under the
+ * method's name in nameIds once the upcall returns. The arguments of the i-th
+ * call are the i-th element of a ReadableNativeArray[] built here, so Java
+ * makes no downcall to fetch them.
+ * The buffer wraps native memory and is only valid for the duration of the
+ * upcall. Calls without arguments are skipped.
+ */
+void makeJavaCalls(JNIEnv* env, jobject executorToken, jobject callback,
+                   std::vector<MethodCall>&& calls, const MethodNameIds& nameIds);
+
+/**
+ * Looks up ReactCallback.callBatch(), must be called before makeJavaCalls().
+ */
+void initializeJavaCallBatch(JNIEnv* env);
+
+} }
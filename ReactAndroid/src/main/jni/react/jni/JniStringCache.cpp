@@ -0,0 +1,112 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "JniStringCache.h"
+
+#include <cstring>
+#include <memory>
+
+#include <jni/fbjni.h>
+#include <jni/LocalString.h>
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+constexpr size_t JniStringCache::kMaxLength;
+constexpr size_t JniStringCache::kSlotCount;
+constexpr size_t JniStringCache::kProbeCount;
+
+JniStringCache& JniStringCache::get() {
+  static JniStringCache* cache = new JniStringCache();
+  return *cache;
+}
+
+static bool matches(const std::u16string& cached, const char16_t* utf16, size_t length) {
+  return cached.size() == length &&
+    std::memcmp(cached.data(), utf16, length * sizeof(char16_t)) == 0;
+}
+
+const std::string& JniStringCache::fromJString(
+    JNIEnv* env, jstring str, std::string& storage) {
+  size_t length = env->GetStringLength(str);
+  if (length > kMaxLength) {
+    storage = jni::fromJString(env, str);
+    return storage;
+  }
+
+  jchar chars[kMaxLength];
+  env->GetStringRegion(str, 0, length, chars);
+
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ chars[i]) * 16777619u;
+  }
+
+  auto utf16 = reinterpret_cast<const char16_t*>(chars);
+  std::unique_ptr<Entry> created;
+  for (size_t probe = 0; probe <= kProbeCount; probe++) {
+    std::atomic<const Entry*>& slot = slots_[(hash + probe) % kSlotCount];
+    const Entry* entry = slot.load(std::memory_order_acquire);
+    if (entry == nullptr) {
+      if (!created) {
+        created.reset(new Entry {
+          std::u16string(utf16, length),
+          detail::utf16toUTF8(chars, length),
+        });
+      }
+      if (slot.compare_exchange_strong(entry, created.get(), std::memory_order_acq_rel)) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return created.release()->utf8;
+      }
+      // Another thread took the slot first, `entry` is now its string
+    }
+    if (matches(entry->utf16, utf16, length)) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return entry->utf8;
+    }
+  }
+
+  overflows_.fetch_add(1, std::memory_order_relaxed);
+  if (created) {
+    storage = std::move(created->utf8);
+  } else {
+    storage = detail::utf16toUTF8(chars, length);
+  }
+  return storage;
+}
+
+JniStringCache::Stats JniStringCache::getStats() const {
+  return Stats {
+    hits_.load(std::memory_order_relaxed),
+    misses_.load(std::memory_order_relaxed),
+    overflows_.load(std::memory_order_relaxed),
+  };
+}
+
+namespace {
+
+jlong getHitCount(alias_ref<jclass>) {
+  return JniStringCache::get().getStats().hits;
+}
+
+jlong getMissCount(alias_ref<jclass>) {
+  return JniStringCache::get().getStats().misses;
+}
+
+jlong getOverflowCount(alias_ref<jclass>) {
+  return JniStringCache::get().getStats().overflows;
+}
+
+}
+
+void JniStringCache::registerNatives() {
+  jni::registerNatives("com/facebook/react/bridge/JniStringCache", {
+    makeNativeMethod("getHitCount", getHitCount),
+    makeNativeMethod("getMissCount", getMissCount),
+    makeNativeMethod("getOverflowCount", getOverflowCount),
+  });
+}
+
+} }
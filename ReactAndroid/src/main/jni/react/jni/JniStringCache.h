@@ -0,0 +1,67 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include <jni.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Caches the UTF-8 conversion of short Java strings. Map keys and module and
+ * method names cross JNI as the same few strings over and over, so instead of
+ * decoding them on every call they are looked up by their UTF-16 contents.
+ *
+ * Strings are interned in a fixed size open addressed table, and never
+ * evicted: once the slots a string hashes to are taken, it is converted
+ * directly. Entries are immutable once published, so lookups don't lock and
+ * the strings returned by reference stay valid for the life of the process.
+ * It can be used from any thread.
+ */
+class JniStringCache {
+ public:
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    // Strings that could not be cached because their slots were taken
+    uint64_t overflows;
+  };
+
+  static JniStringCache& get();
+
+  // Same as jni::fromJString(). Returns the interned string when `str` is
+  // cached, or converts it into `storage` and returns that.
+  const std::string& fromJString(JNIEnv* env, jstring str, std::string& storage);
+
+  Stats getStats() const;
+
+  static void registerNatives();
+
+ private:
+  // Longer strings are converted directly, they are unlikely to be keys
+  static constexpr size_t kMaxLength = 32;
+  static constexpr size_t kSlotCount = 512;
+  // Slots tried after the one a string hashes to
+  static constexpr size_t kProbeCount = 4;
+
+  struct Entry {
+    std::u16string utf16;
+    std::string utf8;
+  };
+
+  std::atomic<const Entry*> slots_[kSlotCount] = {};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> overflows_{0};
+};
+
+inline std::string fromJStringCached(JNIEnv* env, jstring str) {
+  std::string storage;
+  const std::string& string = JniStringCache::get().fromJString(env, str, storage);
+  return &string == &storage ? std::move(storage) : string;
+}
+
+} }
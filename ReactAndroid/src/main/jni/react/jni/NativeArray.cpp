@@ -9,10 +9,13 @@ namespace facebook {
 namespace react {
 
 NativeArray::NativeArray(folly::dynamic a)
+    : NativeArray(SharedDynamic(std::move(a))) {}
+
+NativeArray::NativeArray(SharedDynamic a)
     : array(std::move(a)) {
-  if (!array.isArray()) {
+  if (!array.get().isArray()) {
     jni::throwNewJavaException("com/facebook/react/bridge/UnexpectedNativeTypeException",
-                               "expected Array, got a %s", array.typeName());
+                               "expected Array, got a %s", array.get().typeName());
   }
 }
 
@@ -21,7 +24,7 @@ jstring NativeArray::toString() {
     jni::throwNewJavaException("com/facebook/react/bridge/ObjectAlreadyConsumedException",
                                "Array already consumed");
   }
-  return jni::make_jstring(folly::toJson(array).c_str()).release();
+  return jni::make_jstring(folly::toJson(array.get()).c_str()).release();
 }
 
 void NativeArray::registerNatives() {
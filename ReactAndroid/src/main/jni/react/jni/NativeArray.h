@@ -5,6 +5,8 @@
 #include <jni/fbjni.h>
 #include <folly/dynamic.h>
 
+#include "SharedDynamic.h"
+
 namespace facebook {
 namespace react {
 
@@ -15,7 +17,8 @@ class NativeArray : public jni::HybridClass<NativeArray> {
   // Whether this array has been added to another array or map and no longer
   // has a valid array value.
   bool isConsumed = false;
-  folly::dynamic array;
+  // May be shared with the nested arrays and maps read from this array
+  SharedDynamic array;
 
   jstring toString();
 
@@ -24,6 +27,7 @@ class NativeArray : public jni::HybridClass<NativeArray> {
  protected:
   friend HybridBase;
   explicit NativeArray(folly::dynamic array);
+  explicit NativeArray(SharedDynamic array);
 };
 
 }}
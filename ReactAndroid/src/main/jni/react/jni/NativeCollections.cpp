@@ -0,0 +1,1007 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "NativeCollections.h"
+
+#include <folly/json.h>
+#include <jni/Environment.h>
+#include <jni/LocalReference.h>
+#include <jni/LocalString.h>
+#include <jni/fbjni/Exceptions.h>
+#include "JniStringCache.h"
+#include "ReadableNativeArray.h"
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+static jclass gReadableNativeMapClass;
+static jmethodID gReadableNativeMapCtor;
+
+namespace exceptions {
+
+static const char *gUnexpectedNativeTypeExceptionClass =
+  "com/facebook/react/bridge/UnexpectedNativeTypeException";
+
+}
+
+struct ReadableNativeMapKeySetIterator
+    : public Countable, public PooledAllocation<ReadableNativeMapKeySetIterator> {
+  folly::dynamic::const_item_iterator iterator;
+  // Keeps the iterated map alive even if the NativeMap gets written to
+  SharedDynamic map;
+
+  ReadableNativeMapKeySetIterator(folly::dynamic::const_item_iterator&& it,
+                                  SharedDynamic&& map_)
+    : iterator(std::move(it))
+    , map(std::move(map_)) {}
+};
+
+static jobject createReadableNativeMapWithContents(JNIEnv* env, SharedDynamic map) {
+  if (map.get().isNull()) {
+    return nullptr;
+  }
+
+  if (!map.get().isObject()) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass,
+                          "expected Map, got a %s", map.get().typeName());
+  }
+
+  jobject jnewMap = env->NewObject(gReadableNativeMapClass, gReadableNativeMapCtor);
+  if (env->ExceptionCheck()) {
+    return nullptr;
+  }
+  auto nativeMap = extractRefPtr<NativeMap>(env, jnewMap);
+  nativeMap->map = std::move(map);
+  return jnewMap;
+}
+
+namespace type {
+
+static jclass gReadableReactType;
+static jobject gTypeNullValue;
+static jobject gTypeBooleanValue;
+static jobject gTypeNumberValue;
+static jobject gTypeStringValue;
+static jobject gTypeMapValue;
+static jobject gTypeArrayValue;
+
+static jobject getTypeValue(JNIEnv* env, const char* fieldName) {
+  jfieldID fieldID = env->GetStaticFieldID(
+    gReadableReactType, fieldName, "Lcom/facebook/react/bridge/ReadableType;");
+  jobject typeValue = env->GetStaticObjectField(gReadableReactType, fieldID);
+  return env->NewGlobalRef(typeValue);
+}
+
+static void initialize(JNIEnv* env) {
+  gTypeNullValue = getTypeValue(env, "Null");
+  gTypeBooleanValue = getTypeValue(env, "Boolean");
+  gTypeNumberValue = getTypeValue(env, "Number");
+  gTypeStringValue = getTypeValue(env, "String");
+  gTypeMapValue = getTypeValue(env, "Map");
+  gTypeArrayValue = getTypeValue(env, "Array");
+}
+
+static jobject getType(folly::dynamic::Type type) {
+  switch (type) {
+    case folly::dynamic::Type::NULLT:
+      return type::gTypeNullValue;
+    case folly::dynamic::Type::BOOL:
+      return type::gTypeBooleanValue;
+    case folly::dynamic::Type::DOUBLE:
+    case folly::dynamic::Type::INT64:
+      return type::gTypeNumberValue;
+    case folly::dynamic::Type::STRING:
+      return type::gTypeStringValue;
+    case folly::dynamic::Type::OBJECT:
+      return type::gTypeMapValue;
+    case folly::dynamic::Type::ARRAY:
+      return type::gTypeArrayValue;
+    default:
+      throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, "Unknown type");
+  }
+}
+
+}
+
+// Converts whole folly::dynamic trees into java.util collections in a single
+// JNI call, instead of one call per key, type check and value.
+namespace collections {
+
+static jclass gHashMapClass;
+static jmethodID gHashMapCtor;
+static jmethodID gHashMapPut;
+static jclass gArrayListClass;
+static jmethodID gArrayListCtor;
+static jmethodID gArrayListAdd;
+static jclass gDoubleClass;
+static jmethodID gDoubleValueOf;
+static jobject gBooleanTrue;
+static jobject gBooleanFalse;
+
+static void initialize(JNIEnv* env) {
+  gHashMapClass = (jclass)env->NewGlobalRef(env->FindClass("java/util/HashMap"));
+  gHashMapCtor = env->GetMethodID(gHashMapClass, "<init>", "(I)V");
+  gHashMapPut = env->GetMethodID(
+    gHashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+  gArrayListClass = (jclass)env->NewGlobalRef(env->FindClass("java/util/ArrayList"));
+  gArrayListCtor = env->GetMethodID(gArrayListClass, "<init>", "(I)V");
+  gArrayListAdd = env->GetMethodID(gArrayListClass, "add", "(Ljava/lang/Object;)Z");
+  gDoubleClass = (jclass)env->NewGlobalRef(env->FindClass("java/lang/Double"));
+  gDoubleValueOf = env->GetStaticMethodID(gDoubleClass, "valueOf", "(D)Ljava/lang/Double;");
+
+  jclass booleanClass = env->FindClass("java/lang/Boolean");
+  const char* booleanSignature = "Ljava/lang/Boolean;";
+  gBooleanTrue = env->NewGlobalRef(env->GetStaticObjectField(
+    booleanClass, env->GetStaticFieldID(booleanClass, "TRUE", booleanSignature)));
+  gBooleanFalse = env->NewGlobalRef(env->GetStaticObjectField(
+    booleanClass, env->GetStaticFieldID(booleanClass, "FALSE", booleanSignature)));
+  env->DeleteLocalRef(booleanClass);
+}
+
+static jobject toHashMap(JNIEnv* env, const folly::dynamic& map);
+static jobject toArrayList(JNIEnv* env, const folly::dynamic& array);
+
+// Returns a new local reference, which is null for null values and when a
+// Java exception is pending. Numbers are boxed as Double, like
+// ReadableMap.getType() reports them.
+static jobject toJava(JNIEnv* env, const folly::dynamic& value) {
+  switch (value.type()) {
+    case folly::dynamic::Type::NULLT:
+      return nullptr;
+    case folly::dynamic::Type::BOOL:
+      return env->NewLocalRef(value.getBool() ? gBooleanTrue : gBooleanFalse);
+    case folly::dynamic::Type::DOUBLE:
+      return env->CallStaticObjectMethod(gDoubleClass, gDoubleValueOf, value.getDouble());
+    case folly::dynamic::Type::INT64:
+      return env->CallStaticObjectMethod(
+        gDoubleClass, gDoubleValueOf, static_cast<jdouble>(value.getInt()));
+    case folly::dynamic::Type::STRING: {
+      LocalString string(value.getString().c_str());
+      return env->NewLocalRef(string.string());
+    }
+    case folly::dynamic::Type::OBJECT:
+      return toHashMap(env, value);
+    case folly::dynamic::Type::ARRAY:
+      return toArrayList(env, value);
+    default:
+      throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, "Unknown type");
+  }
+}
+
+static jobject toHashMap(JNIEnv* env, const folly::dynamic& map) {
+  // Sized so that the map never rehashes with the default load factor of 0.75
+  jint capacity = static_cast<jint>(map.size() * 4 / 3 + 1);
+  jobject hashMap = env->NewObject(gHashMapClass, gHashMapCtor, capacity);
+  if (env->ExceptionCheck()) {
+    return nullptr;
+  }
+  for (const auto& item : map.items()) {
+    LocalString key(item.first.c_str());
+    jobject value = toJava(env, item.second);
+    if (env->ExceptionCheck()) {
+      env->DeleteLocalRef(hashMap);
+      return nullptr;
+    }
+    jobject previous = env->CallObjectMethod(hashMap, gHashMapPut, key.string(), value);
+    // Local references are released as we go, deep trees would otherwise
+    // overflow the local reference table
+    env->DeleteLocalRef(previous);
+    env->DeleteLocalRef(value);
+    if (env->ExceptionCheck()) {
+      env->DeleteLocalRef(hashMap);
+      return nullptr;
+    }
+  }
+  return hashMap;
+}
+
+static jobject toArrayList(JNIEnv* env, const folly::dynamic& array) {
+  jobject arrayList = env->NewObject(
+    gArrayListClass, gArrayListCtor, static_cast<jint>(array.size()));
+  if (env->ExceptionCheck()) {
+    return nullptr;
+  }
+  for (const auto& elem : array) {
+    jobject value = toJava(env, elem);
+    if (env->ExceptionCheck()) {
+      env->DeleteLocalRef(arrayList);
+      return nullptr;
+    }
+    env->CallBooleanMethod(arrayList, gArrayListAdd, value);
+    env->DeleteLocalRef(value);
+    if (env->ExceptionCheck()) {
+      env->DeleteLocalRef(arrayList);
+      return nullptr;
+    }
+  }
+  return arrayList;
+}
+
+} // namespace collections
+
+// This attribute exports the ctor symbol, so ReadableNativeArray to be
+// constructed from other DSOs.
+__attribute__((visibility("default")))
+ReadableNativeArray::ReadableNativeArray(folly::dynamic array)
+    : HybridBase(std::move(array)) {}
+
+__attribute__((visibility("default")))
+ReadableNativeArray::ReadableNativeArray(SharedDynamic array)
+    : HybridBase(std::move(array)) {}
+
+void ReadableNativeArray::mapException(const std::exception& ex) {
+  if (dynamic_cast<const folly::TypeError*>(&ex) != nullptr) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
+  }
+}
+
+jint ReadableNativeArray::getSize() {
+  return array.get().size();
+}
+
+jboolean ReadableNativeArray::isNull(jint index) {
+  return array.get().at(index).isNull() ? JNI_TRUE : JNI_FALSE;
+}
+
+jboolean ReadableNativeArray::getBoolean(jint index) {
+  return array.get().at(index).getBool() ? JNI_TRUE : JNI_FALSE;
+}
+
+jdouble ReadableNativeArray::getDouble(jint index) {
+  const folly::dynamic& val = array.get().at(index);
+  if (val.isInt()) {
+    return val.getInt();
+  }
+  return val.getDouble();
+}
+
+jint ReadableNativeArray::getInt(jint index) {
+  auto integer = array.get().at(index).getInt();
+  static_assert(std::is_same<decltype(integer), int64_t>::value,
+                "folly::dynamic int is not int64_t");
+  jint javaint = static_cast<jint>(integer);
+  if (integer != javaint) {
+    throwNewJavaException(
+      exceptions::gUnexpectedNativeTypeExceptionClass,
+      "Value '%lld' doesn't fit into a 32 bit signed int", integer);
+  }
+  return javaint;
+}
+
+const char* ReadableNativeArray::getString(jint index) {
+  const folly::dynamic& dyn = array.get().at(index);
+  if (dyn.isNull()) {
+    return nullptr;
+  }
+  return dyn.getString().c_str();
+}
+
+jni::local_ref<ReadableNativeArray::jhybridobject> ReadableNativeArray::getArray(jint index) {
+  auto& elem = array.get().at(index);
+  if (elem.isNull()) {
+    return jni::local_ref<ReadableNativeArray::jhybridobject>(nullptr);
+  } else {
+    return ReadableNativeArray::newObjectCxxArgs(array.view(elem));
+  }
+}
+
+// Export getMap() so we can workaround constructing ReadableNativeMap
+__attribute__((visibility("default")))
+jobject ReadableNativeArray::getMap(jint index) {
+  auto& elem = array.get().at(index);
+  return createReadableNativeMapWithContents(Environment::current(), array.view(elem));
+}
+
+jobject ReadableNativeArray::getType(jint index) {
+  return type::getType(array.get().at(index).type());
+}
+
+jobject ReadableNativeArray::toArrayList() {
+  return collections::toArrayList(Environment::current(), array.get());
+}
+
+void ReadableNativeArray::registerNatives() {
+  jni::registerNatives("com/facebook/react/bridge/ReadableNativeArray", {
+    makeNativeMethod("size", ReadableNativeArray::getSize),
+    makeNativeMethod("isNull", ReadableNativeArray::isNull),
+    makeNativeMethod("getBoolean", ReadableNativeArray::getBoolean),
+    makeNativeMethod("getDouble", ReadableNativeArray::getDouble),
+    makeNativeMethod("getInt", ReadableNativeArray::getInt),
+    makeNativeMethod("getString", ReadableNativeArray::getString),
+    makeNativeMethod("getArray", ReadableNativeArray::getArray),
+    makeNativeMethod("getMap", "(I)Lcom/facebook/react/bridge/ReadableNativeMap;",
+                     ReadableNativeArray::getMap),
+    makeNativeMethod("getType", "(I)Lcom/facebook/react/bridge/ReadableType;",
+                     ReadableNativeArray::getType),
+    makeNativeMethod("toArrayList", "()Ljava/util/ArrayList;",
+                     ReadableNativeArray::toArrayList),
+  });
+}
+
+namespace {
+
+struct WritableNativeArray
+    : public jni::HybridClass<WritableNativeArray, ReadableNativeArray> {
+  static constexpr const char* kJavaDescriptor = "Lcom/facebook/react/bridge/WritableNativeArray;";
+
+  WritableNativeArray()
+      : HybridBase(folly::dynamic::array()) {}
+
+  static local_ref<jhybriddata> initHybrid(alias_ref<jclass>) {
+    return makeCxxInstance();
+  }
+
+  void pushNull() {
+    exceptions::throwIfObjectAlreadyConsumed(this, "Array already consumed");
+    array.mutate().push_back(nullptr);
+  }
+
+  void pushBoolean(jboolean value) {
+    exceptions::throwIfObjectAlreadyConsumed(this, "Array already consumed");
+    array.mutate().push_back(value == JNI_TRUE);
+  }
+
+  void pushDouble(jdouble value) {
+    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
+    array.mutate().push_back(value);
+  }
+
+  void pushInt(jint value) {
+    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
+    array.mutate().push_back(value);
+  }
+
+  void pushString(jstring value) {
+    if (value == NULL) {
+      pushNull();
+      return;
+    }
+    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
+    array.mutate().push_back(wrap_alias(value)->toStdString());
+  }
+
+  void pushNativeArray(WritableNativeArray* otherArray) {
+    if (otherArray == NULL) {
+      pushNull();
+      return;
+    }
+    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
+    exceptions::throwIfObjectAlreadyConsumed(otherArray, "Array to push already consumed");
+    array.mutate().push_back(otherArray->array.take());
+    otherArray->isConsumed = true;
+  }
+
+  void pushNativeMap(jobject jmap) {
+    if (jmap == NULL) {
+      pushNull();
+      return;
+    }
+    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
+    auto map = extractRefPtr<NativeMap>(Environment::current(), jmap);
+    exceptions::throwIfObjectAlreadyConsumed(map, "Map to push already consumed");
+    array.mutate().push_back(map->map.take());
+    map->isConsumed = true;
+  }
+
+  static void registerNatives() {
+    jni::registerNatives("com/facebook/react/bridge/WritableNativeArray", {
+        makeNativeMethod("initHybrid", WritableNativeArray::initHybrid),
+        makeNativeMethod("pushNull", WritableNativeArray::pushNull),
+        makeNativeMethod("pushBoolean", WritableNativeArray::pushBoolean),
+        makeNativeMethod("pushDouble", WritableNativeArray::pushDouble),
+        makeNativeMethod("pushInt", WritableNativeArray::pushInt),
+        makeNativeMethod("pushString", WritableNativeArray::pushString),
+        makeNativeMethod("pushNativeArray", WritableNativeArray::pushNativeArray),
+        makeNativeMethod("pushNativeMap", "(Lcom/facebook/react/bridge/WritableNativeMap;)V",
+                         WritableNativeArray::pushNativeMap),
+    });
+  }
+};
+
+}
+
+namespace map {
+
+static void initialize(JNIEnv* env, jobject obj) {
+  auto map = createNew<NativeMap>();
+  setCountableForJava(env, obj, std::move(map));
+}
+
+static jstring toString(JNIEnv* env, jobject obj) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(nativeMap, "Map already consumed");
+  LocalString string(
+    ("{ NativeMap: " + folly::toJson(nativeMap->map.get()) + " }").c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
+namespace writable {
+
+static void putNull(JNIEnv* env, jobject obj, jstring key) {
+  auto map = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
+  map->map.mutate().insert(fromJStringCached(env, key), nullptr);
+}
+
+static void putBoolean(JNIEnv* env, jobject obj, jstring key, jboolean value) {
+  auto map = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
+  map->map.mutate().insert(fromJStringCached(env, key), value == JNI_TRUE);
+}
+
+static void putDouble(JNIEnv* env, jobject obj, jstring key, jdouble value) {
+  auto map = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
+  map->map.mutate().insert(fromJStringCached(env, key), value);
+}
+
+static void putInt(JNIEnv* env, jobject obj, jstring key, jint value) {
+  auto map = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
+  map->map.mutate().insert(fromJStringCached(env, key), value);
+}
+
+static void putString(JNIEnv* env, jobject obj, jstring key, jstring value) {
+  if (value == NULL) {
+    putNull(env, obj, key);
+    return;
+  }
+  auto map = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
+  map->map.mutate().insert(fromJStringCached(env, key), fromJString(env, value));
+}
+
+static void putArray(JNIEnv* env, jobject obj, jstring key,
+                     WritableNativeArray::jhybridobject value) {
+  if (value == NULL) {
+    putNull(env, obj, key);
+    return;
+  }
+  auto parentMap = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(parentMap, "Receiving map already consumed");
+  auto arrayValue = cthis(wrap_alias(value));
+  exceptions::throwIfObjectAlreadyConsumed(arrayValue, "Array to put already consumed");
+  parentMap->map.mutate().insert(fromJStringCached(env, key), arrayValue->array.take());
+  arrayValue->isConsumed = true;
+}
+
+static void putMap(JNIEnv* env, jobject obj, jstring key, jobject value) {
+  if (value == NULL) {
+    putNull(env, obj, key);
+    return;
+  }
+  auto parentMap = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(parentMap, "Receiving map already consumed");
+  auto mapValue = extractRefPtr<NativeMap>(env, value);
+  exceptions::throwIfObjectAlreadyConsumed(mapValue, "Map to put already consumed");
+  parentMap->map.mutate().insert(fromJStringCached(env, key), mapValue->map.take());
+  mapValue->isConsumed = true;
+}
+
+static void mergeInto(folly::dynamic& dest, const folly::dynamic& source) {
+  // std::map#insert doesn't overwrite the value, therefore we need to clean values for keys
+  // that already exists before merging dest map into source map
+  for (auto sourceIt : source.items()) {
+    dest.erase(sourceIt.first);
+    dest.insert(std::move(sourceIt.first), std::move(sourceIt.second));
+  }
+}
+
+static void mergeMap(JNIEnv* env, jobject obj, jobject source) {
+  auto sourceMap = extractRefPtr<NativeMap>(env, source);
+  exceptions::throwIfObjectAlreadyConsumed(sourceMap, "Source map already consumed");
+  auto destMap = extractRefPtr<NativeMap>(env, obj);
+  exceptions::throwIfObjectAlreadyConsumed(destMap, "Destination map already consumed");
+
+  mergeInto(destMap->map.mutate(), sourceMap->map.get());
+}
+
+} // namespace writable
+
+namespace readable {
+
+static const char *gNoSuchKeyExceptionClass = "com/facebook/react/bridge/NoSuchKeyException";
+
+static jboolean hasKey(JNIEnv* env, jobject obj, jstring keyName) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  auto& map = nativeMap->map.get();
+  bool found = map.find(fromJStringCached(env, keyName)) != map.items().end();
+  return found ? JNI_TRUE : JNI_FALSE;
+}
+
+static const folly::dynamic& getMapValue(JNIEnv* env, const SharedDynamic& map, jstring keyName) {
+  std::string key = fromJStringCached(env, keyName);
+  try {
+    return map.get().at(key);
+  } catch (const std::out_of_range& ex) {
+    throwNewJavaException(gNoSuchKeyExceptionClass, ex.what());
+  }
+}
+
+static const folly::dynamic& getMapValue(JNIEnv* env, jobject obj, jstring keyName) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  return getMapValue(env, nativeMap->map, keyName);
+}
+
+static jboolean isNull(JNIEnv* env, jobject obj, jstring keyName) {
+  return getMapValue(env, obj, keyName).isNull() ? JNI_TRUE : JNI_FALSE;
+}
+
+static jboolean getBooleanKey(JNIEnv* env, jobject obj, jstring keyName) {
+  try {
+    return getMapValue(env, obj, keyName).getBool() ? JNI_TRUE : JNI_FALSE;
+  } catch (const folly::TypeError& ex) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
+  }
+}
+
+static jdouble getDoubleKey(JNIEnv* env, jobject obj, jstring keyName) {
+  const folly::dynamic& val = getMapValue(env, obj, keyName);
+  if (val.isInt()) {
+    return val.getInt();
+  }
+  try {
+    return val.getDouble();
+  } catch (const folly::TypeError& ex) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
+  }
+}
+
+static jint getIntKey(JNIEnv* env, jobject obj, jstring keyName) {
+  try {
+    auto integer = getMapValue(env, obj, keyName).getInt();
+    jint javaint = static_cast<jint>(integer);
+    if (integer != javaint) {
+      throwNewJavaException(
+        exceptions::gUnexpectedNativeTypeExceptionClass,
+        "Value '%lld' doesn't fit into a 32 bit signed int", integer);
+    }
+    return javaint;
+  } catch (const folly::TypeError& ex) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
+  }
+}
+
+static jstring getStringKey(JNIEnv* env, jobject obj, jstring keyName) {
+  const folly::dynamic& val = getMapValue(env, obj, keyName);
+  if (val.isNull()) {
+    return nullptr;
+  }
+  try {
+    LocalString value(val.getString().c_str());
+    return static_cast<jstring>(env->NewLocalRef(value.string()));
+  } catch (const folly::TypeError& ex) {
+    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
+  }
+}
+
+static jni::local_ref<ReadableNativeArray::jhybridobject> getArrayKey(
+    jni::alias_ref<jobject> obj, jstring keyName) {
+  JNIEnv* env = Environment::current();
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj.get());
+  auto& value = getMapValue(env, nativeMap->map, keyName);
+  if (value.isNull()) {
+    return jni::local_ref<ReadableNativeArray::jhybridobject>(nullptr);
+  } else {
+    return ReadableNativeArray::newObjectCxxArgs(nativeMap->map.view(value));
+  }
+}
+
+static jobject getMapKey(JNIEnv* env, jobject obj, jstring keyName) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  auto& value = getMapValue(env, nativeMap->map, keyName);
+  return createReadableNativeMapWithContents(env, nativeMap->map.view(value));
+}
+
+static jobject getValueType(JNIEnv* env, jobject obj, jstring keyName) {
+  return type::getType(getMapValue(env, obj, keyName).type());
+}
+
+static jobject toHashMap(JNIEnv* env, jobject obj) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
+  return collections::toHashMap(env, nativeMap->map.get());
+}
+
+} // namespace readable
+
+namespace iterator {
+
+static void initialize(JNIEnv* env, jobject obj, jobject nativeMapObj) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, nativeMapObj);
+  SharedDynamic map = nativeMap->map;
+  auto mapIterator = createNew<ReadableNativeMapKeySetIterator>(
+    map.get().items().begin(), std::move(map));
+  setCountableForJava(env, obj, std::move(mapIterator));
+}
+
+static jboolean hasNextKey(JNIEnv* env, jobject obj) {
+  auto nativeIterator = extractRefPtr<ReadableNativeMapKeySetIterator>(env, obj);
+  return ((nativeIterator->iterator != nativeIterator->map.get().items().end())
+          ? JNI_TRUE : JNI_FALSE);
+}
+
+static jstring getNextKey(JNIEnv* env, jobject obj) {
+  auto nativeIterator = extractRefPtr<ReadableNativeMapKeySetIterator>(env, obj);
+  if (JNI_FALSE == hasNextKey(env, obj)) {
+    throwNewJavaException("com/facebook/react/bridge/InvalidIteratorException",
+                          "No such element exists");
+  }
+  LocalString value(nativeIterator->iterator->first.c_str());
+  ++nativeIterator->iterator;
+  return static_cast<jstring>(env->NewLocalRef(value.string()));
+}
+
+} // namespace iterator
+} // namespace map
+
+// Applies the writes recorded by a NativeValueBuilder in Java. See
+// NativeValueBuilder.java for the format.
+namespace builder {
+
+enum : jint {
+  TYPE_NULL = 0,
+  TYPE_BOOLEAN = 1,
+  TYPE_INT = 2,
+  TYPE_DOUBLE = 3,
+  TYPE_STRING = 4,
+  TYPE_MAP = 5,
+  TYPE_ARRAY = 6,
+  TYPE_NATIVE_MAP = 7,
+  TYPE_NATIVE_ARRAY = 8,
+  TYPE_MERGE = 9,
+  TYPE_END = 10,
+};
+
+// Deeper nesting is rejected rather than risking the stack, like folly::parseJson
+static const int kMaxDepth = 100;
+
+static jclass gStringClass;
+static jclass gWritableNativeMapClass;
+static jclass gWritableNativeArrayClass;
+
+static void initialize(JNIEnv* env) {
+  gStringClass = (jclass)env->NewGlobalRef(findClassLocal("java/lang/String").get());
+  gWritableNativeMapClass = (jclass)env->NewGlobalRef(
+    findClassLocal("com/facebook/react/bridge/WritableNativeMap").get());
+  gWritableNativeArrayClass = (jclass)env->NewGlobalRef(
+    findClassLocal("com/facebook/react/bridge/WritableNativeArray").get());
+}
+
+static void throwMalformed(const char* what) {
+  throwNewJavaException("java/lang/IllegalStateException", "Malformed builder ops: %s", what);
+}
+
+// Every count and index comes from Java and is checked against the arrays
+// before anything is read.
+class Reader {
+ public:
+  Reader(JNIEnv* env, jintArray ops, jint opCount, jdoubleArray doubles, jint doubleCount,
+         jobjectArray objects, jint objectCount)
+    : env_(env)
+    , jops_(ops)
+    , jdoubles_(doubles)
+    , objects_(objects) {
+    if (!ops || !doubles || !objects) {
+      throwNewJavaException("java/lang/NullPointerException", "Missing builder arrays");
+    }
+    if (opCount < 0 || opCount > env->GetArrayLength(ops) ||
+        doubleCount < 0 || doubleCount > env->GetArrayLength(doubles) ||
+        objectCount < 0 || objectCount > env->GetArrayLength(objects)) {
+      throwMalformed("counts out of bounds");
+    }
+    opCount_ = opCount;
+    doubleCount_ = doubleCount;
+    objectCount_ = objectCount;
+    ops_ = env->GetIntArrayElements(ops, nullptr);
+    if (!ops_) {
+      throwPendingJniExceptionAsCppException();
+    }
+    doubles_ = env->GetDoubleArrayElements(doubles, nullptr);
+    if (!doubles_) {
+      env->ReleaseIntArrayElements(jops_, ops_, JNI_ABORT);
+      throwPendingJniExceptionAsCppException();
+    }
+  }
+
+  ~Reader() {
+    env_->ReleaseIntArrayElements(jops_, ops_, JNI_ABORT);
+    env_->ReleaseDoubleArrayElements(jdoubles_, doubles_, JNI_ABORT);
+  }
+
+  bool hasNext() const {
+    return op_ < opCount_;
+  }
+
+  jint nextOp() {
+    if (op_ >= opCount_) {
+      throwMalformed("truncated ops");
+    }
+    return ops_[op_++];
+  }
+
+  jdouble nextDouble() {
+    if (double_ >= doubleCount_) {
+      throwMalformed("truncated doubles");
+    }
+    return doubles_[double_++];
+  }
+
+  // Returns the next object, which must be a non null instance of `clazz`
+  LocalReference<jobject> nextObject(jclass clazz) {
+    if (object_ >= objectCount_) {
+      throwMalformed("truncated objects");
+    }
+    LocalReference<jobject> object(env_->GetObjectArrayElement(objects_, object_++));
+    if (!object || !env_->IsInstanceOf(object.get(), clazz)) {
+      throwMalformed("unexpected object");
+    }
+    return object;
+  }
+
+  std::string nextString() {
+    auto string = nextObject(gStringClass);
+    return fromJString(env_, static_cast<jstring>(string.get()));
+  }
+
+  std::string nextKey() {
+    auto key = nextObject(gStringClass);
+    return fromJStringCached(env_, static_cast<jstring>(key.get()));
+  }
+
+  // Called around nested maps and arrays
+  void enter() {
+    if (++depth_ > kMaxDepth) {
+      throwMalformed("nested too deeply");
+    }
+  }
+
+  void leave() {
+    depth_--;
+  }
+
+  JNIEnv* env() const {
+    return env_;
+  }
+
+ private:
+  JNIEnv* env_;
+  jintArray jops_;
+  jdoubleArray jdoubles_;
+  jobjectArray objects_;
+  jint* ops_ = nullptr;
+  jint opCount_ = 0;
+  jdouble* doubles_ = nullptr;
+  jint doubleCount_ = 0;
+  jint objectCount_ = 0;
+  jint op_ = 0;
+  jint double_ = 0;
+  jint object_ = 0;
+  int depth_ = 0;
+};
+
+static void readMap(Reader& reader, folly::dynamic& map);
+static void readArray(Reader& reader, folly::dynamic& array);
+
+static folly::dynamic readValue(Reader& reader, jint type) {
+  switch (type) {
+    case TYPE_NULL:
+      return nullptr;
+    case TYPE_BOOLEAN:
+      return reader.nextOp() != 0;
+    case TYPE_INT:
+      return reader.nextOp();
+    case TYPE_DOUBLE:
+      return reader.nextDouble();
+    case TYPE_STRING:
+      return reader.nextString();
+    case TYPE_MAP: {
+      folly::dynamic map = folly::dynamic::object;
+      reader.enter();
+      readMap(reader, map);
+      reader.leave();
+      return map;
+    }
+    case TYPE_ARRAY: {
+      folly::dynamic array = folly::dynamic::array();
+      reader.enter();
+      readArray(reader, array);
+      reader.leave();
+      return array;
+    }
+    // Native values were consumed when they were put into the builder. One
+    // that was already taken by an earlier commit is left holding null.
+    case TYPE_NATIVE_MAP: {
+      auto jmap = reader.nextObject(gWritableNativeMapClass);
+      auto map = extractRefPtr<NativeMap>(reader.env(), jmap.get());
+      if (!map->isConsumed || !map->map.get().isObject()) {
+        throwMalformed("map not owned by the builder");
+      }
+      return map->map.take();
+    }
+    case TYPE_NATIVE_ARRAY: {
+      auto jarray = reader.nextObject(gWritableNativeArrayClass);
+      auto array = cthis(wrap_alias(
+        static_cast<WritableNativeArray::jhybridobject>(jarray.get())));
+      if (!array->isConsumed || !array->array.get().isArray()) {
+        throwMalformed("array not owned by the builder");
+      }
+      return array->array.take();
+    }
+    default:
+      throwNewJavaException("java/lang/IllegalStateException", "Unknown builder op %d", type);
+  }
+}
+
+// Reads entries up to TYPE_END or the end of the ops
+static void readMap(Reader& reader, folly::dynamic& map) {
+  while (reader.hasNext()) {
+    jint type = reader.nextOp();
+    if (type == TYPE_END) {
+      return;
+    }
+    if (type == TYPE_MERGE) {
+      auto jsource = reader.nextObject(gReadableNativeMapClass);
+      auto source = extractRefPtr<NativeMap>(reader.env(), jsource.get());
+      exceptions::throwIfObjectAlreadyConsumed(source, "Source map already consumed");
+      map::writable::mergeInto(map, source->map.get());
+      continue;
+    }
+    std::string key = reader.nextKey();
+    map.insert(std::move(key), readValue(reader, type));
+  }
+}
+
+static void readArray(Reader& reader, folly::dynamic& array) {
+  while (reader.hasNext()) {
+    jint type = reader.nextOp();
+    if (type == TYPE_END) {
+      return;
+    }
+    array.push_back(readValue(reader, type));
+  }
+}
+
+// The ops are read into a scratch value which is only moved into the
+// receiving map or array once all of them have been read, so malformed ops
+// leave it untouched.
+static void commitToMap(JNIEnv* env, jclass, jobject jmap, jintArray ops, jint opCount,
+                        jdoubleArray doubles, jint doubleCount, jobjectArray objects,
+                        jint objectCount) {
+  auto nativeMap = extractRefPtr<NativeMap>(env, jmap);
+  exceptions::throwIfObjectAlreadyConsumed(nativeMap, "Receiving map already consumed");
+  Reader reader(env, ops, opCount, doubles, doubleCount, objects, objectCount);
+  folly::dynamic scratch = folly::dynamic::object;
+  readMap(reader, scratch);
+
+  folly::dynamic& map = nativeMap->map.mutate();
+  if (map.empty()) {
+    map = std::move(scratch);
+    return;
+  }
+  for (const auto& entry : scratch.items()) {
+    map[entry.first] = std::move(scratch[entry.first]);
+  }
+}
+
+static void commitToArray(JNIEnv* env, jclass, WritableNativeArray::jhybridobject jarray,
+                          jintArray ops, jint opCount, jdoubleArray doubles,
+                          jint doubleCount, jobjectArray objects, jint objectCount) {
+  auto array = cthis(wrap_alias(jarray));
+  exceptions::throwIfObjectAlreadyConsumed(array, "Receiving array already consumed");
+  Reader reader(env, ops, opCount, doubles, doubleCount, objects, objectCount);
+  folly::dynamic scratch = folly::dynamic::array();
+  readArray(reader, scratch);
+
+  folly::dynamic& values = array->array.mutate();
+  if (values.empty()) {
+    values = std::move(scratch);
+    return;
+  }
+  for (auto& value : scratch) {
+    values.push_back(std::move(value));
+  }
+}
+
+// Called when a native value is put into a builder, which takes it over like
+// WritableNativeMap.putMap() would
+static void consumeMap(JNIEnv* env, jclass, jobject jmap) {
+  auto map = extractRefPtr<NativeMap>(env, jmap);
+  exceptions::throwIfObjectAlreadyConsumed(map, "Map to put already consumed");
+  map->isConsumed = true;
+}
+
+static void consumeArray(JNIEnv* env, jclass, WritableNativeArray::jhybridobject jarray) {
+  auto array = cthis(wrap_alias(jarray));
+  exceptions::throwIfObjectAlreadyConsumed(array, "Array to put already consumed");
+  array->isConsumed = true;
+}
+
+} // namespace builder
+
+void registerNativeCollectionNatives() {
+  JNIEnv* env = Environment::current();
+
+  auto readableTypeClass = findClassLocal("com/facebook/react/bridge/ReadableType");
+  type::gReadableReactType = (jclass)env->NewGlobalRef(readableTypeClass.get());
+  type::initialize(env);
+  collections::initialize(env);
+  builder::initialize(env);
+
+  NativeArray::registerNatives();
+  ReadableNativeArray::registerNatives();
+  WritableNativeArray::registerNatives();
+
+  registerNatives("com/facebook/react/bridge/NativeMap", {
+      makeNativeMethod("initialize", map::initialize),
+      makeNativeMethod("toString", map::toString),
+  });
+
+  jclass readableMapClass = env->FindClass("com/facebook/react/bridge/ReadableNativeMap");
+  gReadableNativeMapClass = (jclass)env->NewGlobalRef(readableMapClass);
+  gReadableNativeMapCtor = env->GetMethodID(readableMapClass, "<init>", "()V");
+  wrap_alias(readableMapClass)->registerNatives({
+      makeNativeMethod("hasKey", map::readable::hasKey),
+      makeNativeMethod("isNull", map::readable::isNull),
+      makeNativeMethod("getBoolean", map::readable::getBooleanKey),
+      makeNativeMethod("getDouble", map::readable::getDoubleKey),
+      makeNativeMethod("getInt", map::readable::getIntKey),
+      makeNativeMethod("getString", map::readable::getStringKey),
+      makeNativeMethod("getArray", map::readable::getArrayKey),
+      makeNativeMethod(
+        "getMap", "(Ljava/lang/String;)Lcom/facebook/react/bridge/ReadableNativeMap;",
+        map::readable::getMapKey),
+      makeNativeMethod(
+        "getType", "(Ljava/lang/String;)Lcom/facebook/react/bridge/ReadableType;",
+        map::readable::getValueType),
+      makeNativeMethod("toHashMap", "()Ljava/util/HashMap;", map::readable::toHashMap),
+  });
+
+  registerNatives("com/facebook/react/bridge/WritableNativeMap", {
+      makeNativeMethod("putNull", map::writable::putNull),
+      makeNativeMethod("putBoolean", map::writable::putBoolean),
+      makeNativeMethod("putDouble", map::writable::putDouble),
+      makeNativeMethod("putInt", map::writable::putInt),
+      makeNativeMethod("putString", map::writable::putString),
+      makeNativeMethod("putNativeArray", map::writable::putArray),
+      makeNativeMethod(
+        "putNativeMap", "(Ljava/lang/String;Lcom/facebook/react/bridge/WritableNativeMap;)V",
+        map::writable::putMap),
+      makeNativeMethod(
+        "mergeNativeMap", "(Lcom/facebook/react/bridge/ReadableNativeMap;)V",
+        map::writable::mergeMap)
+  });
+
+  registerNatives("com/facebook/react/bridge/NativeValueBuilder", {
+      makeNativeMethod(
+        "commitToMap",
+        "(Lcom/facebook/react/bridge/WritableNativeMap;[II[DI[Ljava/lang/Object;I)V",
+        builder::commitToMap),
+      makeNativeMethod(
+        "commitToArray",
+        "(Lcom/facebook/react/bridge/WritableNativeArray;[II[DI[Ljava/lang/Object;I)V",
+        builder::commitToArray),
+      makeNativeMethod(
+        "consumeMap", "(Lcom/facebook/react/bridge/WritableNativeMap;)V", builder::consumeMap),
+      makeNativeMethod(
+        "consumeArray", "(Lcom/facebook/react/bridge/WritableNativeArray;)V",
+        builder::consumeArray),
+  });
+
+  registerNatives("com/facebook/react/bridge/ReadableNativeMap$ReadableNativeMapKeySetIterator", {
+    makeNativeMethod("initialize", "(Lcom/facebook/react/bridge/ReadableNativeMap;)V",
+                     map::iterator::initialize),
+    makeNativeMethod("hasNextKey", map::iterator::hasNextKey),
+    makeNativeMethod("nextKey", map::iterator::getNextKey),
+  });
+}
+
+ObjectPoolStats getNativeMapPoolStats() {
+  return ObjectPool<NativeMap>::getStats();
+}
+
+ObjectPoolStats getNativeMapKeySetIteratorPoolStats() {
+  return ObjectPool<ReadableNativeMapKeySetIterator>::getStats();
+}
+
+} }
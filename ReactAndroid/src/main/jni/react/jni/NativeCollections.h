@@ -0,0 +1,43 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <fb/ObjectPool.h>
+#include <jni/Countable.h>
+#include <jni/fbjni.h>
+
+#include "SharedDynamic.h"
+
+namespace facebook {
+namespace react {
+
+namespace exceptions {
+
+template <typename T>
+void throwIfObjectAlreadyConsumed(const T& t, const char* msg) {
+  if (t->isConsumed) {
+    jni::throwNewJavaException("com/facebook/react/bridge/ObjectAlreadyConsumedException", msg);
+  }
+}
+
+}
+
+struct NativeMap : public Countable, public PooledAllocation<NativeMap> {
+  // Whether this map has been added to another array or map and no longer has a valid map value
+  bool isConsumed = false;
+  // May be shared with the nested arrays and maps read from this map
+  SharedDynamic map{folly::dynamic::object};
+};
+
+/**
+ * Registers the natives of the Java bridge collections: NativeArray, NativeMap,
+ * their readable and writable subclasses, ReadableNativeMapKeySetIterator and
+ * NativeValueBuilder. Doesn't depend on JSC or on the Android runtime, so the
+ * collections can also be loaded into a desktop JVM.
+ */
+void registerNativeCollectionNatives();
+
+ObjectPoolStats getNativeMapPoolStats();
+ObjectPoolStats getNativeMapKeySetIteratorPoolStats();
+
+} }
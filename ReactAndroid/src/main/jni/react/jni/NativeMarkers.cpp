@@ -0,0 +1,150 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "NativeMarkers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <time.h>
+#include <vector>
+
+#include <fb/log.h>
+#include <jni/Environment.h>
+#include <jni/fbjni.h>
+#include <jni/LocalString.h>
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+struct Marker {
+  std::string name;
+  // CLOCK_MONOTONIC, like System.nanoTime()
+  jlong timestampNanos;
+};
+
+constexpr size_t kMarkerCapacity = 256;
+// Java is asked to flush once this many markers are buffered, so that markers
+// logged after the JS bundle has loaded are delivered too
+constexpr size_t kFlushThreshold = kMarkerCapacity * 3 / 4;
+
+std::mutex gMarkersMutex;
+Marker gMarkers[kMarkerCapacity];
+size_t gMarkersStart = 0;
+size_t gMarkersCount = 0;
+size_t gDroppedMarkers = 0;
+// Set from when a flush is requested until Java drains the buffer
+bool gFlushRequested = false;
+
+jclass gReactMarkerClass;
+jmethodID gFlushNativeMarkersMethod;
+
+std::atomic<uint64_t> gJniTransitions{0};
+
+jlong now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<jlong>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Moves up to as many markers as fit in the arrays into them, oldest first,
+// and returns how many were moved.
+jint drainNativeMarkers(JNIEnv* env, jclass, jobjectArray names, jlongArray timestamps) {
+  size_t capacity = std::min(env->GetArrayLength(names), env->GetArrayLength(timestamps));
+  std::vector<Marker> markers;
+  size_t dropped;
+  {
+    std::lock_guard<std::mutex> lock(gMarkersMutex);
+    size_t count = std::min(capacity, gMarkersCount);
+    markers.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      markers.push_back(std::move(gMarkers[(gMarkersStart + i) % kMarkerCapacity]));
+    }
+    gMarkersStart = (gMarkersStart + count) % kMarkerCapacity;
+    gMarkersCount -= count;
+    dropped = gDroppedMarkers;
+    gDroppedMarkers = 0;
+    gFlushRequested = false;
+  }
+
+  if (dropped > 0) {
+    FBLOGW("Dropped %zu native markers that were not flushed in time", dropped);
+  }
+
+  std::vector<jlong> markerTimestamps;
+  markerTimestamps.reserve(markers.size());
+  for (size_t i = 0; i < markers.size(); i++) {
+    LocalString name(markers[i].name);
+    env->SetObjectArrayElement(names, i, name.string());
+    markerTimestamps.push_back(markers[i].timestampNanos);
+  }
+  env->SetLongArrayRegion(timestamps, 0, markers.size(), markerTimestamps.data());
+  return markers.size();
+}
+
+// Calls ReactMarker.flushNativeMarkers(), unless this thread can't call into
+// Java right now. Returns whether Java was called without throwing.
+bool requestFlush() {
+  JNIEnv* env = Environment::current();
+  if (env == nullptr || env->ExceptionCheck()) {
+    return false;
+  }
+  env->CallStaticVoidMethod(gReactMarkerClass, gFlushNativeMarkersMethod);
+  if (env->ExceptionCheck()) {
+    // Whoever logged the marker isn't expecting a Java exception
+    FBLOGW("Flushing native markers threw, some markers may be lost");
+    env->ExceptionClear();
+    return false;
+  }
+  return true;
+}
+
+}
+
+void logNativeMarker(const std::string& marker) {
+  jlong timestamp = now();
+  bool flush;
+  {
+    std::lock_guard<std::mutex> lock(gMarkersMutex);
+    if (gMarkersCount == kMarkerCapacity) {
+      // Overwrite the oldest marker
+      gMarkersStart = (gMarkersStart + 1) % kMarkerCapacity;
+      gMarkersCount--;
+      gDroppedMarkers++;
+    }
+    gMarkers[(gMarkersStart + gMarkersCount) % kMarkerCapacity] = Marker {marker, timestamp};
+    gMarkersCount++;
+    flush = gMarkersCount >= kFlushThreshold && !gFlushRequested;
+    if (flush) {
+      gFlushRequested = true;
+    }
+  }
+  if (flush && !requestFlush()) {
+    // Let the next marker ask again, from a thread that may be able to
+    std::lock_guard<std::mutex> lock(gMarkersMutex);
+    gFlushRequested = false;
+  }
+}
+
+void countJniTransition() {
+  gJniTransitions.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t getJniTransitionCount() {
+  return gJniTransitions.load(std::memory_order_relaxed);
+}
+
+void registerNativeMarkerNatives() {
+  JNIEnv* env = Environment::current();
+  auto markerClass = findClassLocal("com/facebook/react/bridge/ReactMarker");
+  gReactMarkerClass = (jclass)env->NewGlobalRef(markerClass.get());
+  gFlushNativeMarkersMethod = env->GetStaticMethodID(gReactMarkerClass, "flushNativeMarkers", "()V");
+  markerClass->registerNatives({
+    makeNativeMethod("drainNativeMarkers", "([Ljava/lang/String;[J)I", drainNativeMarkers),
+  });
+}
+
+} }
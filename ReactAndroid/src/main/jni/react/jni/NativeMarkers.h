@@ -0,0 +1,30 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Records a marker logged from native code (ReactMarker::logMarker) with its
+ * timestamp, without calling into Java. Java delivers the buffered markers to
+ * its listener with ReactMarker.flushNativeMarkers(), which is also called
+ * from here once the buffer is 3/4 full. The buffer holds the most recent 256
+ * markers.
+ */
+void logNativeMarker(const std::string& marker);
+
+/**
+ * Counts calls between Java and native code made by the bridge, in either
+ * direction, so that regressions in their number (e.g. during startup) can be
+ * tracked.
+ */
+void countJniTransition();
+uint64_t getJniTransitionCount();
+
+void registerNativeMarkerNatives();
+
+} }
@@ -0,0 +1,69 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "NativeRunnableDeprecated.h"
+
+#include <jni/Countable.h>
+#include <jni/Environment.h>
+#include <jni/fbjni.h>
+#include "NativeMarkers.h"
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+struct NativeRunnable : public Countable, public PooledAllocation<NativeRunnable> {
+  std::function<void()> callable;
+};
+
+static jclass gNativeRunnableClass;
+static jmethodID gNativeRunnableCtor;
+static jmethodID gRunOnQueueThreadMethod;
+
+static void run(JNIEnv* env, jobject jNativeRunnable) {
+  countJniTransition();
+  auto nativeRunnable = extractRefPtr<NativeRunnable>(env, jNativeRunnable);
+  nativeRunnable->callable();
+}
+
+}
+
+LocalReference<jobject> createNativeRunnable(JNIEnv* env, std::function<void()>&& callable) {
+  LocalReference<jobject> jRunnable{env->NewObject(gNativeRunnableClass, gNativeRunnableCtor)};
+  if (env->ExceptionCheck()) {
+    return nullptr;
+  }
+  auto nativeRunnable = createNew<NativeRunnable>();
+  nativeRunnable->callable = std::move(callable);
+  setCountableForJava(env, jRunnable.get(), std::move(nativeRunnable));
+  return jRunnable;
+}
+
+void enqueueNativeRunnableOnQueue(JNIEnv* env, jobject queue, jobject runnable) {
+  countJniTransition();
+  env->CallVoidMethod(queue, gRunOnQueueThreadMethod, runnable);
+}
+
+void registerNativeRunnableNatives() {
+  JNIEnv* env = Environment::current();
+
+  jclass nativeRunnableClass = env->FindClass("com/facebook/react/bridge/queue/NativeRunnableDeprecated");
+  gNativeRunnableClass = (jclass)env->NewGlobalRef(nativeRunnableClass);
+  gNativeRunnableCtor = env->GetMethodID(nativeRunnableClass, "<init>", "()V");
+  wrap_alias(nativeRunnableClass)->registerNatives({
+      makeNativeMethod("run", run),
+  });
+
+  jclass messageQueueThreadClass =
+    env->FindClass("com/facebook/react/bridge/queue/MessageQueueThread");
+  gRunOnQueueThreadMethod =
+    env->GetMethodID(messageQueueThreadClass, "runOnQueue", "(Ljava/lang/Runnable;)V");
+}
+
+ObjectPoolStats getNativeRunnablePoolStats() {
+  return ObjectPool<NativeRunnable>::getStats();
+}
+
+} }
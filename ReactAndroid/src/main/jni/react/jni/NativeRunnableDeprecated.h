@@ -0,0 +1,28 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <functional>
+
+#include <fb/ObjectPool.h>
+#include <jni/LocalReference.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Wraps callable in a new NativeRunnableDeprecated. Returns null if a Java
+ * exception is pending.
+ */
+jni::LocalReference<jobject> createNativeRunnable(JNIEnv* env, std::function<void()>&& callable);
+
+/**
+ * Calls MessageQueueThread.runOnQueue(runnable) on queue.
+ */
+void enqueueNativeRunnableOnQueue(JNIEnv* env, jobject queue, jobject runnable);
+
+void registerNativeRunnableNatives();
+
+ObjectPoolStats getNativeRunnablePoolStats();
+
+} }
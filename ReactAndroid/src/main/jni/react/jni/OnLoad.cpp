@@ -4,6 +4,7 @@
 #include <android/input.h>
 #include <fb/log.h>
 #include <fb/glog_init.h>
+#include <fb/ObjectPool.h>
 #include <folly/json.h>
 #include <jni/Countable.h>
 #include <jni/Environment.h>
@@ -13,13 +14,23 @@
 #include <jni/WeakReference.h>
 #include <jni/fbjni/Exceptions.h>
 #include <react/Bridge.h>
+#include <react/BridgeLatency.h>
+#include <react/BridgeRecorder.h>
 #include <react/Executor.h>
 #include <react/JSCExecutor.h>
 #include <react/JSModulesUnbundle.h>
+#include <react/LongTaskWatchdog.h>
 #include <react/MethodCall.h>
+#include <react/NativeHookStats.h>
 #include <react/Platform.h>
+#include <react/ProfileWriter.h>
+#include <react/SamplingProfiler.h>
+#include <react/StartupTimeline.h>
+#include <react/SystraceSection.h>
+#include <react/TraceRecorder.h>
 #include "JExecutorToken.h"
 #include "JExecutorTokenFactory.h"
+#include "JavaCallBatch.h"
 #include "JNativeRunnable.h"
 #include "JSLoader.h"
 #include "ReadableNativeArray.h"
@@ -27,588 +38,56 @@
 #include "OnLoad.h"
 #include "JMessageQueueThread.h"
 #include "JniJSModulesUnbundle.h"
+#include "JniStringCache.h"
+#include "NativeCollections.h"
 #include "JSLogging.h"
+#include "NativeMarkers.h"
+#include "NativeRunnableDeprecated.h"
 #include "JSCPerfLogging.h"
 #include "WebWorkers.h"
 #include <algorithm>
-
-#ifdef WITH_FBSYSTRACE
-#include <fbsystrace.h>
-using fbsystrace::FbSystraceSection;
-#endif
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
 
 using namespace facebook::jni;
 
 namespace facebook {
 namespace react {
 
-static jclass gReadableNativeMapClass;
-static jmethodID gReadableNativeMapCtor;
-
-namespace exceptions {
-
-static const char *gUnexpectedNativeTypeExceptionClass =
-  "com/facebook/react/bridge/UnexpectedNativeTypeException";
-
-template <typename T>
-void throwIfObjectAlreadyConsumed(const T& t, const char* msg) {
-  if (t->isConsumed) {
-    throwNewJavaException("com/facebook/react/bridge/ObjectAlreadyConsumedException", msg);
-  }
-}
-
-}
-
-struct NativeMap : public Countable {
-  // Whether this map has been added to another array or map and no longer has a valid map value
-  bool isConsumed = false;
-  folly::dynamic map = folly::dynamic::object;
-};
-
-struct ReadableNativeMapKeySetIterator : public Countable {
-  folly::dynamic::const_item_iterator iterator;
-  RefPtr<NativeMap> mapRef;
-
-  ReadableNativeMapKeySetIterator(folly::dynamic::const_item_iterator&& it,
-                                  const RefPtr<NativeMap>& mapRef_)
-    : iterator(std::move(it))
-    , mapRef(mapRef_) {}
-};
-
-static jobject createReadableNativeMapWithContents(JNIEnv* env, folly::dynamic map) {
-  if (map.isNull()) {
-    return nullptr;
-  }
-
-  if (!map.isObject()) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass,
-                          "expected Map, got a %s", map.typeName());
-  }
-
-  jobject jnewMap = env->NewObject(gReadableNativeMapClass, gReadableNativeMapCtor);
-  if (env->ExceptionCheck()) {
-    return nullptr;
-  }
-  auto nativeMap = extractRefPtr<NativeMap>(env, jnewMap);
-  nativeMap->map = std::move(map);
-  return jnewMap;
-}
-
-namespace type {
-
-static jclass gReadableReactType;
-static jobject gTypeNullValue;
-static jobject gTypeBooleanValue;
-static jobject gTypeNumberValue;
-static jobject gTypeStringValue;
-static jobject gTypeMapValue;
-static jobject gTypeArrayValue;
-
-static jobject getTypeValue(JNIEnv* env, const char* fieldName) {
-  jfieldID fieldID = env->GetStaticFieldID(
-    gReadableReactType, fieldName, "Lcom/facebook/react/bridge/ReadableType;");
-  jobject typeValue = env->GetStaticObjectField(gReadableReactType, fieldID);
-  return env->NewGlobalRef(typeValue);
-}
-
-static void initialize(JNIEnv* env) {
-  gTypeNullValue = getTypeValue(env, "Null");
-  gTypeBooleanValue = getTypeValue(env, "Boolean");
-  gTypeNumberValue = getTypeValue(env, "Number");
-  gTypeStringValue = getTypeValue(env, "String");
-  gTypeMapValue = getTypeValue(env, "Map");
-  gTypeArrayValue = getTypeValue(env, "Array");
-}
-
-static jobject getType(folly::dynamic::Type type) {
-  switch (type) {
-    case folly::dynamic::Type::NULLT:
-      return type::gTypeNullValue;
-    case folly::dynamic::Type::BOOL:
-      return type::gTypeBooleanValue;
-    case folly::dynamic::Type::DOUBLE:
-    case folly::dynamic::Type::INT64:
-      return type::gTypeNumberValue;
-    case folly::dynamic::Type::STRING:
-      return type::gTypeStringValue;
-    case folly::dynamic::Type::OBJECT:
-      return type::gTypeMapValue;
-    case folly::dynamic::Type::ARRAY:
-      return type::gTypeArrayValue;
-    default:
-      throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, "Unknown type");
-  }
-}
-
-}
-
-// This attribute exports the ctor symbol, so ReadableNativeArray to be
-// constructed from other DSOs.
-__attribute__((visibility("default")))
-ReadableNativeArray::ReadableNativeArray(folly::dynamic array)
-    : HybridBase(std::move(array)) {}
-
-void ReadableNativeArray::mapException(const std::exception& ex) {
-  if (dynamic_cast<const folly::TypeError*>(&ex) != nullptr) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
-  }
-}
-
-jint ReadableNativeArray::getSize() {
-  return array.size();
-}
-
-jboolean ReadableNativeArray::isNull(jint index) {
-  return array.at(index).isNull() ? JNI_TRUE : JNI_FALSE;
-}
-
-jboolean ReadableNativeArray::getBoolean(jint index) {
-  return array.at(index).getBool() ? JNI_TRUE : JNI_FALSE;
-}
-
-jdouble ReadableNativeArray::getDouble(jint index) {
-  const folly::dynamic& val = array.at(index);
-  if (val.isInt()) {
-    return val.getInt();
-  }
-  return val.getDouble();
-}
-
-jint ReadableNativeArray::getInt(jint index) {
-  auto integer = array.at(index).getInt();
-  static_assert(std::is_same<decltype(integer), int64_t>::value,
-                "folly::dynamic int is not int64_t");
-  jint javaint = static_cast<jint>(integer);
-  if (integer != javaint) {
-    throwNewJavaException(
-      exceptions::gUnexpectedNativeTypeExceptionClass,
-      "Value '%lld' doesn't fit into a 32 bit signed int", integer);
-  }
-  return javaint;
-}
-
-const char* ReadableNativeArray::getString(jint index) {
-  const folly::dynamic& dyn = array.at(index);
-  if (dyn.isNull()) {
-    return nullptr;
-  }
-  return dyn.getString().c_str();
-}
-
-jni::local_ref<ReadableNativeArray::jhybridobject> ReadableNativeArray::getArray(jint index) {
-  auto& elem = array.at(index);
-  if (elem.isNull()) {
-    return jni::local_ref<ReadableNativeArray::jhybridobject>(nullptr);
-  } else {
-    return ReadableNativeArray::newObjectCxxArgs(elem);
-  }
-}
-
-// Export getMap() so we can workaround constructing ReadableNativeMap
-__attribute__((visibility("default")))
-jobject ReadableNativeArray::getMap(jint index) {
-  return createReadableNativeMapWithContents(Environment::current(), array.at(index));
-}
-
-jobject ReadableNativeArray::getType(jint index) {
-  return type::getType(array.at(index).type());
-}
-
-void ReadableNativeArray::registerNatives() {
-  jni::registerNatives("com/facebook/react/bridge/ReadableNativeArray", {
-    makeNativeMethod("size", ReadableNativeArray::getSize),
-    makeNativeMethod("isNull", ReadableNativeArray::isNull),
-    makeNativeMethod("getBoolean", ReadableNativeArray::getBoolean),
-    makeNativeMethod("getDouble", ReadableNativeArray::getDouble),
-    makeNativeMethod("getInt", ReadableNativeArray::getInt),
-    makeNativeMethod("getString", ReadableNativeArray::getString),
-    makeNativeMethod("getArray", ReadableNativeArray::getArray),
-    makeNativeMethod("getMap", "(I)Lcom/facebook/react/bridge/ReadableNativeMap;",
-                     ReadableNativeArray::getMap),
-    makeNativeMethod("getType", "(I)Lcom/facebook/react/bridge/ReadableType;",
-                     ReadableNativeArray::getType),
-  });
-}
-
 namespace {
 
-struct WritableNativeArray
-    : public jni::HybridClass<WritableNativeArray, ReadableNativeArray> {
-  static constexpr const char* kJavaDescriptor = "Lcom/facebook/react/bridge/WritableNativeArray;";
-
-  WritableNativeArray()
-      : HybridBase(folly::dynamic::array()) {}
-
-  static local_ref<jhybriddata> initHybrid(alias_ref<jclass>) {
-    return makeCxxInstance();
-  }
-
-  void pushNull() {
-    exceptions::throwIfObjectAlreadyConsumed(this, "Array already consumed");
-    array.push_back(nullptr);
-  }
-
-  void pushBoolean(jboolean value) {
-    exceptions::throwIfObjectAlreadyConsumed(this, "Array already consumed");
-    array.push_back(value == JNI_TRUE);
-  }
-
-  void pushDouble(jdouble value) {
-    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
-    array.push_back(value);
-  }
-
-  void pushInt(jint value) {
-    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
-    array.push_back(value);
-  }
-
-  void pushString(jstring value) {
-    if (value == NULL) {
-      pushNull();
-      return;
-    }
-    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
-    array.push_back(wrap_alias(value)->toStdString());
-  }
-
-  void pushNativeArray(WritableNativeArray* otherArray) {
-    if (otherArray == NULL) {
-      pushNull();
-      return;
-    }
-    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
-    exceptions::throwIfObjectAlreadyConsumed(otherArray, "Array to push already consumed");
-    array.push_back(std::move(otherArray->array));
-    otherArray->isConsumed = true;
-  }
-
-  void pushNativeMap(jobject jmap) {
-    if (jmap == NULL) {
-      pushNull();
-      return;
-    }
-    exceptions::throwIfObjectAlreadyConsumed(this, "Receiving array already consumed");
-    auto map = extractRefPtr<NativeMap>(Environment::current(), jmap);
-    exceptions::throwIfObjectAlreadyConsumed(map, "Map to push already consumed");
-    array.push_back(std::move(map->map));
-    map->isConsumed = true;
-  }
-
-  static void registerNatives() {
-    jni::registerNatives("com/facebook/react/bridge/WritableNativeArray", {
-        makeNativeMethod("initHybrid", WritableNativeArray::initHybrid),
-        makeNativeMethod("pushNull", WritableNativeArray::pushNull),
-        makeNativeMethod("pushBoolean", WritableNativeArray::pushBoolean),
-        makeNativeMethod("pushDouble", WritableNativeArray::pushDouble),
-        makeNativeMethod("pushInt", WritableNativeArray::pushInt),
-        makeNativeMethod("pushString", WritableNativeArray::pushString),
-        makeNativeMethod("pushNativeArray", WritableNativeArray::pushNativeArray),
-        makeNativeMethod("pushNativeMap", "(Lcom/facebook/react/bridge/WritableNativeMap;)V",
-                         WritableNativeArray::pushNativeMap),
-    });
-  }
-};
-
-}
-
-namespace map {
-
-static void initialize(JNIEnv* env, jobject obj) {
-  auto map = createNew<NativeMap>();
-  setCountableForJava(env, obj, std::move(map));
-}
-
-static jstring toString(JNIEnv* env, jobject obj) {
-  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(nativeMap, "Map already consumed");
-  LocalString string(
-    ("{ NativeMap: " + folly::toJson(nativeMap->map) + " }").c_str());
-  return static_cast<jstring>(env->NewLocalRef(string.string()));
-}
-
-namespace writable {
-
-static void putNull(JNIEnv* env, jobject obj, jstring key) {
-  auto map = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
-  map->map.insert(fromJString(env, key), nullptr);
-}
-
-static void putBoolean(JNIEnv* env, jobject obj, jstring key, jboolean value) {
-  auto map = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
-  map->map.insert(fromJString(env, key), value == JNI_TRUE);
-}
-
-static void putDouble(JNIEnv* env, jobject obj, jstring key, jdouble value) {
-  auto map = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
-  map->map.insert(fromJString(env, key), value);
-}
-
-static void putInt(JNIEnv* env, jobject obj, jstring key, jint value) {
-  auto map = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
-  map->map.insert(fromJString(env, key), value);
-}
-
-static void putString(JNIEnv* env, jobject obj, jstring key, jstring value) {
-  if (value == NULL) {
-    putNull(env, obj, key);
-    return;
-  }
-  auto map = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(map, "Receiving map already consumed");
-  map->map.insert(fromJString(env, key), fromJString(env, value));
-}
-
-static void putArray(JNIEnv* env, jobject obj, jstring key,
-                     WritableNativeArray::jhybridobject value) {
-  if (value == NULL) {
-    putNull(env, obj, key);
-    return;
-  }
-  auto parentMap = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(parentMap, "Receiving map already consumed");
-  auto arrayValue = cthis(wrap_alias(value));
-  exceptions::throwIfObjectAlreadyConsumed(arrayValue, "Array to put already consumed");
-  parentMap->map.insert(fromJString(env, key), std::move(arrayValue->array));
-  arrayValue->isConsumed = true;
-}
-
-static void putMap(JNIEnv* env, jobject obj, jstring key, jobject value) {
-  if (value == NULL) {
-    putNull(env, obj, key);
-    return;
-  }
-  auto parentMap = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(parentMap, "Receiving map already consumed");
-  auto mapValue = extractRefPtr<NativeMap>(env, value);
-  exceptions::throwIfObjectAlreadyConsumed(mapValue, "Map to put already consumed");
-  parentMap->map.insert(fromJString(env, key), std::move(mapValue->map));
-  mapValue->isConsumed = true;
-}
-
-static void mergeMap(JNIEnv* env, jobject obj, jobject source) {
-  auto sourceMap = extractRefPtr<NativeMap>(env, source);
-  exceptions::throwIfObjectAlreadyConsumed(sourceMap, "Source map already consumed");
-  auto destMap = extractRefPtr<NativeMap>(env, obj);
-  exceptions::throwIfObjectAlreadyConsumed(destMap, "Destination map already consumed");
-
-  // std::map#insert doesn't overwrite the value, therefore we need to clean values for keys
-  // that already exists before merging dest map into source map
-  for (auto sourceIt : sourceMap->map.items()) {
-    destMap->map.erase(sourceIt.first);
-    destMap->map.insert(std::move(sourceIt.first), std::move(sourceIt.second));
-  }
-}
-
-} // namespace writable
-
-namespace readable {
-
-static const char *gNoSuchKeyExceptionClass = "com/facebook/react/bridge/NoSuchKeyException";
-
-static jboolean hasKey(JNIEnv* env, jobject obj, jstring keyName) {
-  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
-  auto& map = nativeMap->map;
-  bool found = map.find(fromJString(env, keyName)) != map.items().end();
-  return found ? JNI_TRUE : JNI_FALSE;
-}
-
-static const folly::dynamic& getMapValue(JNIEnv* env, jobject obj, jstring keyName) {
-  auto nativeMap = extractRefPtr<NativeMap>(env, obj);
-  std::string key = fromJString(env, keyName);
-  try {
-    return nativeMap->map.at(key);
-  } catch (const std::out_of_range& ex) {
-    throwNewJavaException(gNoSuchKeyExceptionClass, ex.what());
-  }
-}
-
-static jboolean isNull(JNIEnv* env, jobject obj, jstring keyName) {
-  return getMapValue(env, obj, keyName).isNull() ? JNI_TRUE : JNI_FALSE;
-}
-
-static jboolean getBooleanKey(JNIEnv* env, jobject obj, jstring keyName) {
-  try {
-    return getMapValue(env, obj, keyName).getBool() ? JNI_TRUE : JNI_FALSE;
-  } catch (const folly::TypeError& ex) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
-  }
-}
-
-static jdouble getDoubleKey(JNIEnv* env, jobject obj, jstring keyName) {
-  const folly::dynamic& val = getMapValue(env, obj, keyName);
-  if (val.isInt()) {
-    return val.getInt();
-  }
-  try {
-    return val.getDouble();
-  } catch (const folly::TypeError& ex) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
-  }
-}
-
-static jint getIntKey(JNIEnv* env, jobject obj, jstring keyName) {
-  try {
-    auto integer = getMapValue(env, obj, keyName).getInt();
-    jint javaint = static_cast<jint>(integer);
-    if (integer != javaint) {
-      throwNewJavaException(
-        exceptions::gUnexpectedNativeTypeExceptionClass,
-        "Value '%lld' doesn't fit into a 32 bit signed int", integer);
-    }
-    return javaint;
-  } catch (const folly::TypeError& ex) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
-  }
-}
-
-static jstring getStringKey(JNIEnv* env, jobject obj, jstring keyName) {
-  const folly::dynamic& val = getMapValue(env, obj, keyName);
-  if (val.isNull()) {
-    return nullptr;
-  }
-  try {
-    LocalString value(val.getString().c_str());
-    return static_cast<jstring>(env->NewLocalRef(value.string()));
-  } catch (const folly::TypeError& ex) {
-    throwNewJavaException(exceptions::gUnexpectedNativeTypeExceptionClass, ex.what());
-  }
-}
-
-static jni::local_ref<ReadableNativeArray::jhybridobject> getArrayKey(
-    jni::alias_ref<jobject> obj, jstring keyName) {
-  auto& value = getMapValue(Environment::current(), obj.get(), keyName);
-  if (value.isNull()) {
-    return jni::local_ref<ReadableNativeArray::jhybridobject>(nullptr);
-  } else {
-    return ReadableNativeArray::newObjectCxxArgs(value);
-  }
-}
-
-static jobject getMapKey(JNIEnv* env, jobject obj, jstring keyName) {
-  return createReadableNativeMapWithContents(env, getMapValue(env, obj, keyName));
-}
-
-static jobject getValueType(JNIEnv* env, jobject obj, jstring keyName) {
-  return type::getType(getMapValue(env, obj, keyName).type());
-}
-
-} // namespace readable
-
-namespace iterator {
-
-static void initialize(JNIEnv* env, jobject obj, jobject nativeMapObj) {
-  auto nativeMap = extractRefPtr<NativeMap>(env, nativeMapObj);
-  auto mapIterator = createNew<ReadableNativeMapKeySetIterator>(
-    nativeMap->map.items().begin(), nativeMap);
-  setCountableForJava(env, obj, std::move(mapIterator));
-}
-
-static jboolean hasNextKey(JNIEnv* env, jobject obj) {
-  auto nativeIterator = extractRefPtr<ReadableNativeMapKeySetIterator>(env, obj);
-  return ((nativeIterator->iterator != nativeIterator->mapRef.get()->map.items().end())
-          ? JNI_TRUE : JNI_FALSE);
-}
-
-static jstring getNextKey(JNIEnv* env, jobject obj) {
-  auto nativeIterator = extractRefPtr<ReadableNativeMapKeySetIterator>(env, obj);
-  if (JNI_FALSE == hasNextKey(env, obj)) {
-    throwNewJavaException("com/facebook/react/bridge/InvalidIteratorException",
-                          "No such element exists");
-  }
-  LocalString value(nativeIterator->iterator->first.c_str());
-  ++nativeIterator->iterator;
-  return static_cast<jstring>(env->NewLocalRef(value.string()));
-}
-
-} // namespace iterator
-} // namespace map
-
-namespace {
-
-namespace runnable {
-
-struct NativeRunnable : public Countable {
-  std::function<void()> callable;
-};
-
-static jclass gNativeRunnableClass;
-static jmethodID gNativeRunnableCtor;
-
-static LocalReference<jobject> createNativeRunnable(JNIEnv* env, decltype(NativeRunnable::callable)&& callable) {
-  LocalReference<jobject> jRunnable{env->NewObject(gNativeRunnableClass, gNativeRunnableCtor)};
-  if (env->ExceptionCheck()) {
-    return nullptr;
-  }
-  auto nativeRunnable = createNew<NativeRunnable>();
-  nativeRunnable->callable = std::move(callable);
-  setCountableForJava(env, jRunnable.get(), std::move(nativeRunnable));
-  return jRunnable;
-}
-
-static void run(JNIEnv* env, jobject jNativeRunnable) {
-  auto nativeRunnable = extractRefPtr<NativeRunnable>(env, jNativeRunnable);
-  nativeRunnable->callable();
-}
-
-} // namespace runnable
-
-namespace queue {
-
-static jmethodID gRunOnQueueThreadMethod;
-
-static void enqueueNativeRunnableOnQueue(JNIEnv* env, jobject callbackQueueThread, jobject nativeRunnable) {
-  env->CallVoidMethod(callbackQueueThread, gRunOnQueueThreadMethod, nativeRunnable);
-}
-
-} // namespace queue
-
 namespace bridge {
 
-static jmethodID gCallbackMethod;
 static jmethodID gOnBatchCompleteMethod;
 static jmethodID gOnExecutorUnregisteredMethod;
-static jmethodID gLogMarkerMethod;
+
+// How often recorded trace events are written to the profile capture
+static const int kProfileCaptureFlushIntervalMs = 250;
+
+// Where the traffic of the next bridges created is recorded, if anywhere
+static std::mutex gBridgeTrafficPathMutex;
+static std::string gBridgeTrafficPath;
+
+// The last long tasks reported by the watchdog, oldest first
+static const size_t kMaxRecentLongTasks = 32;
+static std::mutex gRecentLongTasksMutex;
+static std::deque<folly::dynamic> gRecentLongTasks;
 
 struct CountableBridge : Bridge, Countable {
   using Bridge::Bridge;
 };
 
-static void logMarker(const std::string& marker) {
-  JNIEnv* env = Environment::current();
-  jclass markerClass = env->FindClass("com/facebook/react/bridge/ReactMarker");
-  jstring jmarker = env->NewStringUTF(marker.c_str());
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, jmarker);
-  env->DeleteLocalRef(markerClass);
-  env->DeleteLocalRef(jmarker);
-}
-
-static void makeJavaCall(JNIEnv* env, ExecutorToken executorToken, jobject callback, const MethodCall& call) {
-  if (call.arguments.isNull()) {
-    return;
-  }
-
-  #ifdef WITH_FBSYSTRACE
-  if (call.callId != -1) {
-    fbsystrace_end_async_flow(TRACE_TAG_REACT_APPS, "native", call.callId);
-  }
-  #endif
-
-  auto newArray = ReadableNativeArray::newObjectCxxArgs(std::move(call.arguments));
-  env->CallVoidMethod(
-      callback,
-      gCallbackMethod,
-      static_cast<JExecutorTokenHolder*>(executorToken.getPlatformExecutorToken().get())->getJobj(),
-      call.moduleId,
-      call.methodId,
-      newArray.get());
+static void makeJavaCalls(JNIEnv* env, ExecutorToken executorToken, jobject callback,
+                          std::vector<MethodCall>&& calls, const MethodNameIds& nameIds) {
+  auto jexecutorToken =
+    static_cast<JExecutorTokenHolder*>(executorToken.getPlatformExecutorToken().get())->getJobj();
+  react::makeJavaCalls(env, jexecutorToken, callback, std::move(calls), nameIds);
 }
 
 static void signalBatchComplete(JNIEnv* env, jobject callback) {
+  countJniTransition();
   env->CallVoidMethod(callback, gOnBatchCompleteMethod);
 }
 
@@ -616,9 +95,11 @@ class PlatformBridgeCallback : public BridgeCallback {
 public:
   PlatformBridgeCallback(
       RefPtr<WeakReference> weakCallback_,
-      RefPtr<WeakReference> weakCallbackQueueThread_) :
+      RefPtr<WeakReference> weakCallbackQueueThread_,
+      MethodNameIds methodNameIds_) :
     weakCallback_(std::move(weakCallback_)),
-    weakCallbackQueueThread_(std::move(weakCallbackQueueThread_)) {}
+    weakCallbackQueueThread_(std::move(weakCallbackQueueThread_)),
+    methodNameIds_(std::make_shared<const MethodNameIds>(std::move(methodNameIds_))) {}
 
   void executeCallbackOnCallbackQueueThread(std::function<void(ResolvedWeakReference&)>&& runnable) {
     auto env = Environment::current();
@@ -645,24 +126,30 @@ public:
       }
     }, std::move(runnable));
 
-    auto jNativeRunnable = runnable::createNativeRunnable(env, std::move(runnableWrapper));
-    queue::enqueueNativeRunnableOnQueue(env, callbackQueueThread, jNativeRunnable.get());
+    auto jNativeRunnable = createNativeRunnable(env, std::move(runnableWrapper));
+    enqueueNativeRunnableOnQueue(env, callbackQueueThread, jNativeRunnable.get());
   }
 
   virtual void onCallNativeModules(
       ExecutorToken executorToken,
       const std::string& callJSON,
       bool isEndOfBatch) override {
-    executeCallbackOnCallbackQueueThread([executorToken, callJSON, isEndOfBatch] (ResolvedWeakReference& callback) {
+    executeCallbackOnCallbackQueueThread([executorToken, callJSON, isEndOfBatch, nameIds=methodNameIds_] (ResolvedWeakReference& callback) {
       JNIEnv* env = Environment::current();
-      for (auto& call : react::parseMethodCalls(callJSON)) {
-        makeJavaCall(env, executorToken, callback, call);
-        if (env->ExceptionCheck()) {
-          return;
-        }
+      StartupTimeline::begin(StartupTimeline::Phase::FirstNativeBatch);
+      LongTaskWatchdog::TaskScope longTask(LongTaskWatchdog::Queue::NativeModules);
+      auto calls = react::parseMethodCalls(callJSON);
+      if (!calls.empty()) {
+        longTask.setOrigin(LongTaskWatchdog::TaskOrigin::nativeModuleCalls(
+          calls[0].moduleId, calls[0].methodId, calls.size()));
+      }
+      makeJavaCalls(env, executorToken, callback, std::move(calls), *nameIds);
+      if (env->ExceptionCheck()) {
+        return;
       }
       if (isEndOfBatch) {
         signalBatchComplete(env, callback);
+        StartupTimeline::end(StartupTimeline::Phase::FirstNativeBatch);
       }
     });
   }
@@ -670,6 +157,7 @@ public:
   virtual void onExecutorUnregistered(ExecutorToken executorToken) override {
     executeCallbackOnCallbackQueueThread([executorToken] (ResolvedWeakReference& callback) {
       JNIEnv *env = Environment::current();
+      countJniTransition();
       env->CallVoidMethod(
           callback,
           gOnExecutorUnregisteredMethod,
@@ -679,16 +167,43 @@ public:
 private:
   RefPtr<WeakReference> weakCallback_;
   RefPtr<WeakReference> weakCallbackQueueThread_;
+  // Shared with queued batches, which may outlive the callback
+  std::shared_ptr<const MethodNameIds> methodNameIds_;
 };
 
+static std::shared_ptr<BridgeTrafficWriter> createBridgeTrafficWriter() {
+  std::lock_guard<std::mutex> lock(gBridgeTrafficPathMutex);
+  if (gBridgeTrafficPath.empty()) {
+    return nullptr;
+  }
+  std::shared_ptr<BridgeTrafficWriter> writer = BridgeTrafficWriter::create(gBridgeTrafficPath);
+  if (!writer) {
+    FBLOGE("Can't record bridge traffic to %s: %s", gBridgeTrafficPath.c_str(), strerror(errno));
+  }
+  return writer;
+}
+
 static void create(JNIEnv* env, jobject obj, jobject executor, jobject callback,
-                   jobject callbackQueueThread) {
+                   jobject callbackQueueThread, jobjectArray nativeMethodNames) {
+  StartupTimeline::reset();
   auto weakCallback = createNew<WeakReference>(callback);
   auto weakCallbackQueueThread = createNew<WeakReference>(callbackQueueThread);
-  auto bridgeCallback = folly::make_unique<PlatformBridgeCallback>(weakCallback, weakCallbackQueueThread);
+  std::unique_ptr<BridgeCallback> bridgeCallback =
+    folly::make_unique<PlatformBridgeCallback>(
+      weakCallback, weakCallbackQueueThread, internMethodNames(env, nativeMethodNames));
   auto nativeExecutorFactory = extractRefPtr<CountableJSExecutorFactory>(env, executor);
+  JSExecutorFactory* executorFactory = nativeExecutorFactory.get();
+  std::unique_ptr<RecordingJSExecutorFactory> recordingExecutorFactory;
+  std::shared_ptr<BridgeTrafficWriter> trafficWriter = createBridgeTrafficWriter();
+  if (trafficWriter) {
+    recordingExecutorFactory =
+      folly::make_unique<RecordingJSExecutorFactory>(executorFactory, trafficWriter);
+    executorFactory = recordingExecutorFactory.get();
+    bridgeCallback =
+      folly::make_unique<RecordingBridgeCallback>(std::move(bridgeCallback), trafficWriter);
+  }
   auto executorTokenFactory = folly::make_unique<JExecutorTokenFactory>();
-  auto bridge = createNew<CountableBridge>(nativeExecutorFactory.get(), std::move(executorTokenFactory), std::move(bridgeCallback));
+  auto bridge = createNew<CountableBridge>(executorFactory, std::move(executorTokenFactory), std::move(bridgeCallback));
   setCountableForJava(env, obj, std::move(bridge));
 }
 
@@ -730,20 +245,18 @@ static void loadApplicationUnbundle(
 
 static void loadScriptFromAssets(JNIEnv* env, jobject obj, jobject assetManager,
                                  jstring assetName) {
-  jclass markerClass = env->FindClass("com/facebook/react/bridge/ReactMarker");
+  countJniTransition();
   auto manager = AAssetManager_fromJava(env, assetManager);
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   auto assetNameStr = fromJString(env, assetName);
 
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_start"));
+  logNativeMarker("loadScriptFromAssets_start");
+  StartupTimeline::begin(StartupTimeline::Phase::ReadScript);
   auto script = react::loadScriptFromAssets(manager, assetNameStr);
-  #ifdef WITH_FBSYSTRACE
-  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_"
-    "loadApplicationScript",
-    "assetName", assetNameStr);
-  #endif
+  StartupTimeline::end(StartupTimeline::Phase::ReadScript);
+  SystraceSection s("reactbridge_jni_loadApplicationScript", "assetName", assetNameStr);
 
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_read"));
+  logNativeMarker("loadScriptFromAssets_read");
   if (JniJSModulesUnbundle::isUnbundle(manager, assetNameStr)) {
     loadApplicationUnbundle(bridge, manager, script, assetNameStr);
   } else {
@@ -752,40 +265,41 @@ static void loadScriptFromAssets(JNIEnv* env, jobject obj, jobject assetManager,
   if (env->ExceptionCheck()) {
     return;
   }
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromAssets_done"));
+  logNativeMarker("loadScriptFromAssets_done");
 }
 
 static void loadScriptFromFile(JNIEnv* env, jobject obj, jstring fileName, jstring sourceURL) {
-  jclass markerClass = env->FindClass("com/facebook/react/bridge/ReactMarker");
-
+  countJniTransition();
   auto bridge = jni::extractRefPtr<CountableBridge>(env, obj);
   auto fileNameStr = fileName == NULL ? "" : fromJString(env, fileName);
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_start"));
+  logNativeMarker("loadScriptFromFile_start");
+  StartupTimeline::begin(StartupTimeline::Phase::ReadScript);
   auto script = fileName == NULL ? "" : react::loadScriptFromFile(fileNameStr);
-  #ifdef WITH_FBSYSTRACE
+  StartupTimeline::end(StartupTimeline::Phase::ReadScript);
   auto sourceURLStr = sourceURL == NULL ? fileNameStr : fromJString(env, sourceURL);
-  FbSystraceSection s(TRACE_TAG_REACT_CXX_BRIDGE, "reactbridge_jni_"
-    "loadApplicationScript",
-    "sourceURL", sourceURLStr);
-  #endif
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_read"));
+  SystraceSection s("reactbridge_jni_loadApplicationScript", "sourceURL", sourceURLStr);
+  logNativeMarker("loadScriptFromFile_read");
   loadApplicationScript(bridge, script, jni::fromJString(env, sourceURL));
   if (env->ExceptionCheck()) {
     return;
   }
-  env->CallStaticVoidMethod(markerClass, gLogMarkerMethod, env->NewStringUTF("loadScriptFromFile_exec"));
+  logNativeMarker("loadScriptFromFile_exec");
 }
 
 static void callFunction(JNIEnv* env, jobject obj, JExecutorToken::jhybridobject jExecutorToken, jstring module, jstring method,
                          NativeArray::jhybridobject args, jstring tracingName) {
+  countJniTransition();
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   auto arguments = cthis(wrap_alias(args));
   try {
+    std::string moduleStorage;
+    std::string methodStorage;
+    auto& stringCache = JniStringCache::get();
     bridge->callFunction(
       cthis(wrap_alias(jExecutorToken))->getExecutorToken(wrap_alias(jExecutorToken)),
-      fromJString(env, module),
-      fromJString(env, method),
-      std::move(arguments->array),
+      stringCache.fromJString(env, module, moduleStorage),
+      stringCache.fromJString(env, method, methodStorage),
+      arguments->array.take(),
       fromJString(env, tracingName)
     );
   } catch (...) {
@@ -795,24 +309,231 @@ static void callFunction(JNIEnv* env, jobject obj, JExecutorToken::jhybridobject
 
 static void invokeCallback(JNIEnv* env, jobject obj, JExecutorToken::jhybridobject jExecutorToken, jint callbackId,
                            NativeArray::jhybridobject args) {
+  countJniTransition();
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   auto arguments = cthis(wrap_alias(args));
   try {
     bridge->invokeCallback(
       cthis(wrap_alias(jExecutorToken))->getExecutorToken(wrap_alias(jExecutorToken)),
       (double) callbackId,
-      std::move(arguments->array)
+      arguments->array.take()
     );
   } catch (...) {
     translatePendingCppExceptionToJavaException();
   }
 }
 
+static jlong getJniTransitionCount(JNIEnv* env, jclass) {
+  return react::getJniTransitionCount();
+}
+
+static void setAsyncNativeLogging(JNIEnv* env, jclass, jboolean enabled) {
+  // Never drops messages: a thread that fills its buffer writes it out itself
+  setAsyncLogging(enabled ? 1 : 0, LOG_OVERFLOW_BLOCK);
+}
+
+static jlong getNativeValueCopyCount(JNIEnv* env, jclass) {
+  return SharedDynamic::getCopyCount();
+}
+
+static void appendPoolStats(std::string& out, const char* name, const ObjectPoolStats& stats) {
+  out += folly::to<std::string>(
+    name, ": ", stats.live, " live, ", stats.pooled, " pooled, ",
+    stats.allocated, " allocated\n");
+}
+
+static jstring getNativeObjectPoolStats(JNIEnv* env, jclass) {
+  std::string stats;
+  appendPoolStats(stats, "NativeMap", getNativeMapPoolStats());
+  appendPoolStats(
+    stats, "ReadableNativeMapKeySetIterator", getNativeMapKeySetIteratorPoolStats());
+  appendPoolStats(stats, "NativeRunnable", getNativeRunnablePoolStats());
+  appendPoolStats(stats, "Countable holder", getCountableHolderPoolStats());
+  LocalString string(stats.c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
+static void setNativeTraceRecordingEnabled(JNIEnv* env, jclass, jboolean enabled) {
+  TraceRecorder::setEnabled(enabled == JNI_TRUE);
+}
+
+static jstring dumpNativeTrace(JNIEnv* env, jclass) {
+  LocalString trace(TraceRecorder::dumpChromeTrace().c_str());
+  return static_cast<jstring>(env->NewLocalRef(trace.string()));
+}
+
+static jstring getBridgeLatencyStats(JNIEnv* env, jclass, jboolean reset) {
+  folly::dynamic stats = folly::dynamic::object;
+  for (auto& entry : BridgeLatency::getStats(reset == JNI_TRUE)) {
+    const char* kind = BridgeLatency::getKindName(entry.kind);
+    if (stats.find(kind) == stats.items().end()) {
+      stats[kind] = folly::dynamic::array();
+    }
+    stats[kind].push_back(folly::dynamic::object
+      ("name", entry.name)
+      ("count", static_cast<int64_t>(entry.count))
+      ("p50Nanos", static_cast<int64_t>(entry.p50Nanos))
+      ("p90Nanos", static_cast<int64_t>(entry.p90Nanos))
+      ("p99Nanos", static_cast<int64_t>(entry.p99Nanos))
+      ("maxNanos", static_cast<int64_t>(entry.maxNanos)));
+  }
+  LocalString string(folly::toJson(stats).c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
+static void setNativeHookStatsEnabled(JNIEnv* env, jclass, jboolean enabled) {
+  NativeHookStats::setEnabled(enabled == JNI_TRUE);
+}
+
+static jstring getNativeHookStats(JNIEnv* env, jclass, jboolean reset) {
+  folly::dynamic stats = folly::dynamic::array();
+  for (auto& entry : NativeHookStats::getStats(reset == JNI_TRUE)) {
+    stats.push_back(folly::dynamic::object
+      ("name", entry.name)
+      ("count", static_cast<int64_t>(entry.count))
+      ("totalNanos", static_cast<int64_t>(entry.totalNanos))
+      ("maxNanos", static_cast<int64_t>(entry.maxNanos)));
+  }
+  LocalString string(folly::toJson(stats).c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
+static jboolean startSamplingProfiler(JNIEnv* env, jclass, jint intervalMicros) {
+  // Streams into the profile capture, if there is one
+  return SamplingProfiler::start(intervalMicros, TraceRecorder::getStreamingWriter())
+    ? JNI_TRUE : JNI_FALSE;
+}
+
+static jstring stopSamplingProfiler(JNIEnv* env, jclass) {
+  LocalString profile(SamplingProfiler::stop().c_str());
+  return static_cast<jstring>(env->NewLocalRef(profile.string()));
+}
+
+static jboolean startProfileCapture(JNIEnv* env, jclass, jstring path, jboolean compress) {
+  std::shared_ptr<ProfileWriter> writer =
+    ProfileWriter::create(fromJString(env, path), compress == JNI_TRUE);
+  if (!writer) {
+    FBLOGE("Can't create profile capture: %s", strerror(errno));
+    return JNI_FALSE;
+  }
+  return TraceRecorder::startStreaming(writer, kProfileCaptureFlushIntervalMs) ? JNI_TRUE : JNI_FALSE;
+}
+
+static jboolean stopProfileCapture(JNIEnv* env, jclass) {
+  std::shared_ptr<ProfileWriter> writer = TraceRecorder::stopStreaming();
+  return writer && writer->close() ? JNI_TRUE : JNI_FALSE;
+}
+
+static void setBridgeTrafficRecordingPath(JNIEnv* env, jclass, jstring path) {
+  std::lock_guard<std::mutex> lock(gBridgeTrafficPathMutex);
+  gBridgeTrafficPath = path != nullptr ? fromJString(env, path) : "";
+}
+
+static folly::dynamic longTaskEventToDynamic(const LongTaskWatchdog::LongTaskEvent& event) {
+  const char* name = event.origin.nameId != 0 ? TraceRecorder::getName(event.origin.nameId) : "";
+  return folly::dynamic::object
+    ("queue", LongTaskWatchdog::getQueueName(event.queue))
+    ("origin", LongTaskWatchdog::getOriginKindName(event.origin.kind))
+    ("name", name != nullptr ? name : "")
+    ("callbackId", event.origin.callbackId)
+    ("moduleId", event.origin.moduleId)
+    ("methodId", event.origin.methodId)
+    ("callCount", static_cast<int64_t>(event.origin.callCount))
+    ("tid", static_cast<int64_t>(event.tid))
+    ("startNanos", event.startNanos)
+    ("durationNanos", event.durationNanos)
+    ("budgetNanos", event.budgetNanos)
+    ("jsStack", event.jsStack);
+}
+
+static void startLongTaskWatchdog(JNIEnv* env, jclass, jint budgetMs) {
+  LongTaskWatchdog::start(budgetMs, [] (const LongTaskWatchdog::LongTaskEvent& event) {
+    FBLOGW(
+      "Long task on the %s queue: %s took %lld ms",
+      LongTaskWatchdog::getQueueName(event.queue),
+      LongTaskWatchdog::getOriginKindName(event.origin.kind),
+      static_cast<long long>(event.durationNanos / 1000000));
+    folly::dynamic longTask = longTaskEventToDynamic(event);
+    std::lock_guard<std::mutex> lock(gRecentLongTasksMutex);
+    gRecentLongTasks.push_back(std::move(longTask));
+    if (gRecentLongTasks.size() > kMaxRecentLongTasks) {
+      gRecentLongTasks.pop_front();
+    }
+  });
+}
+
+static void stopLongTaskWatchdog(JNIEnv* env, jclass) {
+  LongTaskWatchdog::stop();
+}
+
+static jstring getLongTaskStats(JNIEnv* env, jclass, jboolean reset) {
+  folly::dynamic queues = folly::dynamic::object;
+  for (auto& entry : LongTaskWatchdog::getStats(reset == JNI_TRUE)) {
+    queues[LongTaskWatchdog::getQueueName(entry.queue)] = folly::dynamic::object
+      ("taskCount", static_cast<int64_t>(entry.taskCount))
+      ("longTaskCount", static_cast<int64_t>(entry.longTaskCount))
+      ("overBudgetNanos", static_cast<int64_t>(entry.overBudgetNanos))
+      ("maxNanos", static_cast<int64_t>(entry.maxNanos));
+  }
+  folly::dynamic recent = folly::dynamic::array();
+  {
+    std::lock_guard<std::mutex> lock(gRecentLongTasksMutex);
+    for (auto& longTask : gRecentLongTasks) {
+      recent.push_back(longTask);
+    }
+    if (reset == JNI_TRUE) {
+      gRecentLongTasks.clear();
+    }
+  }
+  folly::dynamic stats = folly::dynamic::object
+    ("queues", std::move(queues))
+    ("recentLongTasks", std::move(recent));
+  LocalString string(folly::toJson(stats).c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
+static jstring getStartupTimeline(JNIEnv* env, jclass) {
+  int64_t startNanos = StartupTimeline::getStartNanos();
+  folly::dynamic phases = folly::dynamic::array();
+  int64_t endNanos = startNanos;
+  for (auto& span : StartupTimeline::getSpans()) {
+    phases.push_back(folly::dynamic::object
+      ("phase", StartupTimeline::getPhaseName(span.phase))
+      ("beginNanos", span.beginNanos)
+      ("endNanos", span.endNanos)
+      ("durationNanos", span.endNanos - span.beginNanos)
+      ("beginThread", span.beginTid)
+      ("endThread", span.endTid));
+    endNanos = std::max(endNanos, span.endNanos);
+  }
+  folly::dynamic criticalPath = folly::dynamic::array();
+  for (auto& entry : StartupTimeline::getCriticalPath()) {
+    criticalPath.push_back(folly::dynamic::object
+      ("phase", StartupTimeline::getPhaseName(entry.phase))
+      ("isGap", entry.isGap)
+      ("durationNanos", entry.durationNanos));
+  }
+  folly::dynamic timeline = folly::dynamic::object
+    ("startNanos", startNanos)
+    ("totalNanos", endNanos - startNanos)
+    ("phases", std::move(phases))
+    ("criticalPath", std::move(criticalPath));
+  LocalString string(folly::toJson(timeline).c_str());
+  return static_cast<jstring>(env->NewLocalRef(string.string()));
+}
+
 static void setGlobalVariable(JNIEnv* env, jobject obj, jstring propName, jstring jsonValue) {
+  countJniTransition();
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   bridge->setGlobalVariable(fromJString(env, propName), fromJString(env, jsonValue));
 }
 
+static jstring getJSHeapSamples(JNIEnv* env, jobject obj) {
+  auto bridge = extractRefPtr<CountableBridge>(env, obj);
+  LocalString samples(bridge->getHeapSamplesJSON().c_str());
+  return static_cast<jstring>(env->NewLocalRef(samples.string()));
+}
+
 static jlong getJavaScriptContext(JNIEnv *env, jobject obj) {
   auto bridge = extractRefPtr<CountableBridge>(env, obj);
   return (uintptr_t) bridge->getJavaScriptContext();
@@ -853,35 +574,43 @@ static void handleMemoryPressureCritical(JNIEnv* env, jobject obj) {
 
 namespace executors {
 
-static std::string getApplicationDir(const char* methodName) {
-  // Get the Application Context object
-  auto getApplicationClass = findClassLocal(
-                              "com/facebook/react/common/ApplicationHolder");
-  auto getApplicationMethod = getApplicationClass->getStaticMethod<jobject()>(
-                              "getApplication",
-                              "()Landroid/app/Application;"
-                              );
-  auto application = getApplicationMethod(getApplicationClass);
-
-  // Get getCacheDir() from the context
-  auto getDirMethod = findClassLocal("android/app/Application")
-                       ->getMethod<jobject()>(methodName,
-                                              "()Ljava/io/File;"
-                                                  );
-  auto dirObj = getDirMethod(application);
-
-  // Call getAbsolutePath() on the returned File object
-  auto getAbsolutePathMethod = findClassLocal("java/io/File")
-                                ->getMethod<jstring()>("getAbsolutePath");
-  return getAbsolutePathMethod(dirObj)->toStdString();
+static jclass gApplicationHolderClass;
+static jmethodID gGetApplicationMethod;
+static jmethodID gGetCacheDirMethod;
+static jmethodID gGetFilesDirMethod;
+static jmethodID gGetAbsolutePathMethod;
+
+static void initialize(JNIEnv* env) {
+  jclass applicationHolderClass = env->FindClass("com/facebook/react/common/ApplicationHolder");
+  gApplicationHolderClass = (jclass)env->NewGlobalRef(applicationHolderClass);
+  gGetApplicationMethod = env->GetStaticMethodID(
+    applicationHolderClass, "getApplication", "()Landroid/app/Application;");
+  jclass applicationClass = env->FindClass("android/app/Application");
+  gGetCacheDirMethod = env->GetMethodID(applicationClass, "getCacheDir", "()Ljava/io/File;");
+  gGetFilesDirMethod = env->GetMethodID(applicationClass, "getFilesDir", "()Ljava/io/File;");
+  jclass fileClass = env->FindClass("java/io/File");
+  gGetAbsolutePathMethod = env->GetMethodID(fileClass, "getAbsolutePath", "()Ljava/lang/String;");
+}
+
+static std::string getApplicationDir(jmethodID getDirMethod) {
+  JNIEnv* env = Environment::current();
+  LocalReference<jobject> application(
+    env->CallStaticObjectMethod(gApplicationHolderClass, gGetApplicationMethod));
+  FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
+  LocalReference<jobject> dir(env->CallObjectMethod(application.get(), getDirMethod));
+  FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
+  LocalReference<jstring> path(
+    static_cast<jstring>(env->CallObjectMethod(dir.get(), gGetAbsolutePathMethod)));
+  FACEBOOK_JNI_THROW_PENDING_EXCEPTION();
+  return fromJString(env, path.get());
 }
 
 static std::string getApplicationCacheDir() {
-  return getApplicationDir("getCacheDir");
+  return getApplicationDir(gGetCacheDirMethod);
 }
 
 static std::string getApplicationPersistentDir() {
-  return getApplicationDir("getFilesDir");
+  return getApplicationDir(gGetFilesDirMethod);
 }
 
 struct CountableJSCExecutorFactory : CountableJSExecutorFactory  {
@@ -899,7 +628,7 @@ private:
 static void createJSCExecutor(JNIEnv *env, jobject obj, jobject jscConfig) {
   auto nativeMap = extractRefPtr<NativeMap>(env, jscConfig);
   exceptions::throwIfObjectAlreadyConsumed(nativeMap, "Map to push already consumed");
-  auto executor = createNew<CountableJSCExecutorFactory>(std::move(nativeMap->map));
+  auto executor = createNew<CountableJSCExecutorFactory>(nativeMap->map.take());
   nativeMap->isConsumed = true;
   setCountableForJava(env, obj, std::move(executor));
 }
@@ -914,15 +643,11 @@ static void createProxyExecutor(JNIEnv *env, jobject obj, jobject executorInstan
 
 }
 
-jmethodID getLogMarkerMethod() {
-  return bridge::gLogMarkerMethod;
-}
-
 extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   return initialize(vm, [] {
     facebook::gloginit::initialize();
     // Inject some behavior into react/
-    ReactMarker::logMarker = bridge::logMarker;
+    ReactMarker::logMarker = logNativeMarker;
     WebWorkerUtil::createWebWorkerThread = WebWorkers::createWebWorkerThread;
     WebWorkerUtil::loadScriptFromAssets =
       [] (const std::string& assetName) {
@@ -940,62 +665,12 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     // get the current env
     JNIEnv* env = Environment::current();
 
-    auto readableTypeClass = findClassLocal("com/facebook/react/bridge/ReadableType");
-    type::gReadableReactType = (jclass)env->NewGlobalRef(readableTypeClass.get());
-    type::initialize(env);
-
-    NativeArray::registerNatives();
-    ReadableNativeArray::registerNatives();
-    WritableNativeArray::registerNatives();
+    registerNativeCollectionNatives();
     JNativeRunnable::registerNatives();
+    JniStringCache::registerNatives();
+    registerNativeMarkerNatives();
     registerJSLoaderNatives();
 
-    registerNatives("com/facebook/react/bridge/NativeMap", {
-        makeNativeMethod("initialize", map::initialize),
-        makeNativeMethod("toString", map::toString),
-    });
-
-    jclass readableMapClass = env->FindClass("com/facebook/react/bridge/ReadableNativeMap");
-    gReadableNativeMapClass = (jclass)env->NewGlobalRef(readableMapClass);
-    gReadableNativeMapCtor = env->GetMethodID(readableMapClass, "<init>", "()V");
-    wrap_alias(readableMapClass)->registerNatives({
-        makeNativeMethod("hasKey", map::readable::hasKey),
-        makeNativeMethod("isNull", map::readable::isNull),
-        makeNativeMethod("getBoolean", map::readable::getBooleanKey),
-        makeNativeMethod("getDouble", map::readable::getDoubleKey),
-        makeNativeMethod("getInt", map::readable::getIntKey),
-        makeNativeMethod("getString", map::readable::getStringKey),
-        makeNativeMethod("getArray", map::readable::getArrayKey),
-        makeNativeMethod(
-          "getMap", "(Ljava/lang/String;)Lcom/facebook/react/bridge/ReadableNativeMap;",
-          map::readable::getMapKey),
-        makeNativeMethod(
-          "getType", "(Ljava/lang/String;)Lcom/facebook/react/bridge/ReadableType;",
-          map::readable::getValueType),
-    });
-
-    registerNatives("com/facebook/react/bridge/WritableNativeMap", {
-        makeNativeMethod("putNull", map::writable::putNull),
-        makeNativeMethod("putBoolean", map::writable::putBoolean),
-        makeNativeMethod("putDouble", map::writable::putDouble),
-        makeNativeMethod("putInt", map::writable::putInt),
-        makeNativeMethod("putString", map::writable::putString),
-        makeNativeMethod("putNativeArray", map::writable::putArray),
-        makeNativeMethod(
-          "putNativeMap", "(Ljava/lang/String;Lcom/facebook/react/bridge/WritableNativeMap;)V",
-          map::writable::putMap),
-        makeNativeMethod(
-          "mergeNativeMap", "(Lcom/facebook/react/bridge/ReadableNativeMap;)V",
-          map::writable::mergeMap)
-    });
-
-    registerNatives("com/facebook/react/bridge/ReadableNativeMap$ReadableNativeMapKeySetIterator", {
-      makeNativeMethod("initialize", "(Lcom/facebook/react/bridge/ReadableNativeMap;)V",
-                       map::iterator::initialize),
-      makeNativeMethod("hasNextKey", map::iterator::hasNextKey),
-      makeNativeMethod("nextKey", map::iterator::getNextKey),
-    });
-
     registerNatives("com/facebook/react/bridge/JSCJavaScriptExecutor", {
       makeNativeMethod("initialize", "(Lcom/facebook/react/bridge/WritableNativeMap;)V",
         executors::createJSCExecutor),
@@ -1007,16 +682,14 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
           executors::createProxyExecutor),
     });
 
+    initializeJavaCallBatch(env);
+    executors::initialize(env);
     jclass callbackClass = env->FindClass("com/facebook/react/bridge/ReactCallback");
-    bridge::gCallbackMethod = env->GetMethodID(callbackClass, "call", "(Lcom/facebook/react/bridge/ExecutorToken;IILcom/facebook/react/bridge/ReadableNativeArray;)V");
     bridge::gOnBatchCompleteMethod = env->GetMethodID(callbackClass, "onBatchComplete", "()V");
     bridge::gOnExecutorUnregisteredMethod = env->GetMethodID(callbackClass, "onExecutorUnregistered", "(Lcom/facebook/react/bridge/ExecutorToken;)V");
 
-    jclass markerClass = env->FindClass("com/facebook/react/bridge/ReactMarker");
-    bridge::gLogMarkerMethod = env->GetStaticMethodID(markerClass, "logMarker", "(Ljava/lang/String;)V");
-
     registerNatives("com/facebook/react/bridge/ReactBridge", {
-        makeNativeMethod("initialize", "(Lcom/facebook/react/bridge/JavaScriptExecutor;Lcom/facebook/react/bridge/ReactCallback;Lcom/facebook/react/bridge/queue/MessageQueueThread;)V", bridge::create),
+        makeNativeMethod("initialize", "(Lcom/facebook/react/bridge/JavaScriptExecutor;Lcom/facebook/react/bridge/ReactCallback;Lcom/facebook/react/bridge/queue/MessageQueueThread;[[Ljava/lang/String;)V", bridge::create),
         makeNativeMethod("destroy", bridge::destroy),
         makeNativeMethod(
           "loadScriptFromAssets", "(Landroid/content/res/AssetManager;Ljava/lang/String;)V",
@@ -1032,19 +705,38 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
         makeNativeMethod("handleMemoryPressureModerate", bridge::handleMemoryPressureModerate),
         makeNativeMethod("handleMemoryPressureCritical", bridge::handleMemoryPressureCritical),
         makeNativeMethod("getJavaScriptContextNativePtrExperimental", bridge::getJavaScriptContext),
+        makeNativeMethod("getJSHeapSamples", "()Ljava/lang/String;", bridge::getJSHeapSamples),
+        makeNativeMethod("getJniTransitionCount", "()J", bridge::getJniTransitionCount),
+        makeNativeMethod("getNativeValueCopyCount", "()J", bridge::getNativeValueCopyCount),
+        makeNativeMethod("setAsyncNativeLogging", "(Z)V", bridge::setAsyncNativeLogging),
+        makeNativeMethod(
+          "getNativeObjectPoolStats", "()Ljava/lang/String;", bridge::getNativeObjectPoolStats),
+        makeNativeMethod(
+          "setNativeTraceRecordingEnabled", "(Z)V", bridge::setNativeTraceRecordingEnabled),
+        makeNativeMethod("dumpNativeTrace", "()Ljava/lang/String;", bridge::dumpNativeTrace),
+        makeNativeMethod(
+          "getBridgeLatencyStats", "(Z)Ljava/lang/String;", bridge::getBridgeLatencyStats),
+        makeNativeMethod("setNativeHookStatsEnabled", "(Z)V", bridge::setNativeHookStatsEnabled),
+        makeNativeMethod(
+          "getNativeHookStats", "(Z)Ljava/lang/String;", bridge::getNativeHookStats),
+        makeNativeMethod("startSamplingProfiler", "(I)Z", bridge::startSamplingProfiler),
+        makeNativeMethod(
+          "stopSamplingProfiler", "()Ljava/lang/String;", bridge::stopSamplingProfiler),
+        makeNativeMethod(
+          "startProfileCapture", "(Ljava/lang/String;Z)Z", bridge::startProfileCapture),
+        makeNativeMethod("stopProfileCapture", "()Z", bridge::stopProfileCapture),
+        makeNativeMethod("getStartupTimeline", "()Ljava/lang/String;", bridge::getStartupTimeline),
+        makeNativeMethod(
+          "setBridgeTrafficRecordingPath",
+          "(Ljava/lang/String;)V",
+          bridge::setBridgeTrafficRecordingPath),
+        makeNativeMethod("startLongTaskWatchdog", "(I)V", bridge::startLongTaskWatchdog),
+        makeNativeMethod("stopLongTaskWatchdog", "()V", bridge::stopLongTaskWatchdog),
+        makeNativeMethod(
+          "getLongTaskStats", "(Z)Ljava/lang/String;", bridge::getLongTaskStats),
     });
 
-    jclass nativeRunnableClass = env->FindClass("com/facebook/react/bridge/queue/NativeRunnableDeprecated");
-    runnable::gNativeRunnableClass = (jclass)env->NewGlobalRef(nativeRunnableClass);
-    runnable::gNativeRunnableCtor = env->GetMethodID(nativeRunnableClass, "<init>", "()V");
-    wrap_alias(nativeRunnableClass)->registerNatives({
-        makeNativeMethod("run", runnable::run),
-    });
-
-    jclass messageQueueThreadClass =
-      env->FindClass("com/facebook/react/bridge/queue/MessageQueueThread");
-    queue::gRunOnQueueThreadMethod =
-      env->GetMethodID(messageQueueThreadClass, "runOnQueue", "(Ljava/lang/Runnable;)V");
+    registerNativeRunnableNatives();
   });
 }
 
@@ -9,8 +9,6 @@
 namespace facebook {
 namespace react {
 
-jmethodID getLogMarkerMethod();
-
 struct CountableJSExecutorFactory : JSExecutorFactory, Countable {
   using JSExecutorFactory::JSExecutorFactory;
 };
@@ -11,6 +11,7 @@ class ReadableNativeArray : public jni::HybridClass<ReadableNativeArray, NativeA
  protected:
   friend HybridBase;
   explicit ReadableNativeArray(folly::dynamic array);
+  explicit ReadableNativeArray(SharedDynamic array);
 
  public:
   static constexpr const char* kJavaDescriptor = "Lcom/facebook/react/bridge/ReadableNativeArray;";
@@ -28,6 +29,7 @@ class ReadableNativeArray : public jni::HybridClass<ReadableNativeArray, NativeA
   jni::local_ref<jhybridobject> getArray(jint index);
   jobject getMap(jint index);
   jobject getType(jint index);
+  jobject toArrayList();
 
   static void registerNatives();
 };
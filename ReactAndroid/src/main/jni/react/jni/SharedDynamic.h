@@ -0,0 +1,78 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <folly/dynamic.h>
+
+namespace facebook {
+namespace react {
+
+/**
+ * Storage for the value of a NativeArray or NativeMap that lets nested
+ * arrays and maps be handed to Java without copying them.
+ *
+ * The value always lives in reference counted storage. Copying a
+ * SharedDynamic or taking a view() of one of its elements only adds a
+ * reference, so reads never modify the object and can run concurrently.
+ * Writes go through mutate(), which copies the value first if anything else
+ * still references its storage, so views never observe later changes. That
+ * copy only happens while a copy or view is alive; getCopyCount() counts them.
+ */
+class SharedDynamic {
+ public:
+  explicit SharedDynamic(folly::dynamic value)
+    : root_(std::make_shared<folly::dynamic>(std::move(value)))
+    , view_(root_.get()) {}
+
+  const folly::dynamic& get() const {
+    return *view_;
+  }
+
+  folly::dynamic& mutate() {
+    if (!root_.unique() || view_ != root_.get()) {
+      copyCounter().fetch_add(1, std::memory_order_relaxed);
+      root_ = std::make_shared<folly::dynamic>(*view_);
+      view_ = root_.get();
+    }
+    return *root_;
+  }
+
+  folly::dynamic take() {
+    return std::move(mutate());
+  }
+
+  /**
+   * Returns a view of `nested`, which must be a reference into get() of this
+   * object.
+   */
+  SharedDynamic view(const folly::dynamic& nested) const {
+    return SharedDynamic(root_, nested);
+  }
+
+  /**
+   * Number of values mutate() or take() had to copy because they were still
+   * shared, across all objects.
+   */
+  static uint64_t getCopyCount() {
+    return copyCounter().load(std::memory_order_relaxed);
+  }
+
+ private:
+  SharedDynamic(std::shared_ptr<folly::dynamic> root, const folly::dynamic& nested)
+    : root_(std::move(root))
+    , view_(&nested) {}
+
+  static std::atomic<uint64_t>& copyCounter() {
+    static std::atomic<uint64_t> count{0};
+    return count;
+  }
+
+  std::shared_ptr<folly::dynamic> root_;
+  const folly::dynamic* view_;
+};
+
+}}
@@ -0,0 +1,133 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+// Entry point of the desktop build of libreactnativejni (see Makefile). It
+// only registers the parts of the bridge that don't need JSC or the Android
+// runtime, plus the natives of the benchmarks and tests in src/test.
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <jni/Environment.h>
+#include <jni/fbjni.h>
+#include <jni/LocalReference.h>
+#include <jni/LocalString.h>
+#include <react/MethodCall.h>
+#include "../JavaCallBatch.h"
+#include "../JniStringCache.h"
+#include "../NativeCollections.h"
+#include "../NativeMarkers.h"
+#include "../NativeRunnableDeprecated.h"
+
+using namespace facebook::jni;
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+namespace benchmark {
+
+static void dispatchCallBatches(
+    JNIEnv* env, jclass, jobject callback, jstring callsJson, jint iterations) {
+  std::string json = fromJString(env, callsJson);
+  // Without names, the calls are recorded under "<unknown>"
+  MethodNameIds nameIds;
+  for (jint i = 0; i < iterations && !env->ExceptionCheck(); i++) {
+    makeJavaCalls(env, nullptr, callback, parseMethodCalls(json), nameIds);
+  }
+}
+
+static jint postRunnables(JNIEnv* env, jclass, jobject queue, jint count) {
+  // The queue may run the runnables on another thread, and after this returns
+  auto ran = std::make_shared<std::atomic<jint>>(0);
+  for (jint i = 0; i < count && !env->ExceptionCheck(); i++) {
+    auto runnable = createNativeRunnable(env, [ran] { ran->fetch_add(1); });
+    enqueueNativeRunnableOnQueue(env, queue, runnable.get());
+  }
+  return ran->load();
+}
+
+// Returns the total length of the converted strings, so that the conversions
+// aren't optimized away
+static jlong convertStrings(
+    JNIEnv* env, jclass, jobjectArray strings, jint iterations, jboolean cached) {
+  std::vector<LocalReference<jstring>> refs;
+  for (jsize i = 0; i < env->GetArrayLength(strings); i++) {
+    refs.emplace_back(static_cast<jstring>(env->GetObjectArrayElement(strings, i)));
+  }
+  auto& cache = JniStringCache::get();
+  jlong total = 0;
+  for (jint i = 0; i < iterations; i++) {
+    for (auto& ref : refs) {
+      if (cached) {
+        std::string storage;
+        total += cache.fromJString(env, ref.get(), storage).size();
+      } else {
+        total += fromJString(env, ref.get()).size();
+      }
+    }
+  }
+  return total;
+}
+
+static void registerNatives(JNIEnv* env) {
+  // Only there when the tests are on the classpath
+  jclass benchmarkClass = env->FindClass("com/facebook/react/bridge/NativeBridgeBenchmarkTest");
+  if (benchmarkClass == nullptr) {
+    env->ExceptionClear();
+    return;
+  }
+  wrap_alias(benchmarkClass)->registerNatives({
+      makeNativeMethod(
+        "dispatchCallBatches", "(Lcom/facebook/react/bridge/ReactCallback;Ljava/lang/String;I)V",
+        dispatchCallBatches),
+      makeNativeMethod(
+        "postRunnables", "(Lcom/facebook/react/bridge/queue/MessageQueueThread;I)I",
+        postRunnables),
+      makeNativeMethod("convertStrings", "([Ljava/lang/String;IZ)J", convertStrings),
+  });
+}
+
+} // namespace benchmark
+
+namespace test {
+
+static void logNativeMarkers(JNIEnv* env, jclass, jstring prefix, jint count) {
+  std::string name = fromJString(env, prefix);
+  for (jint i = 0; i < count; i++) {
+    logNativeMarker(name + std::to_string(i));
+  }
+}
+
+static void registerNatives(JNIEnv* env) {
+  jclass markerTestClass = env->FindClass("com/facebook/react/bridge/ReactMarkerTest");
+  if (markerTestClass == nullptr) {
+    env->ExceptionClear();
+    return;
+  }
+  wrap_alias(markerTestClass)->registerNatives({
+      makeNativeMethod("logNativeMarkers", "(Ljava/lang/String;I)V", logNativeMarkers),
+  });
+}
+
+} // namespace test
+
+}
+
+extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
+  return initialize(vm, [] {
+    JNIEnv* env = Environment::current();
+
+    registerNativeCollectionNatives();
+    registerNativeRunnableNatives();
+    JniStringCache::registerNatives();
+    registerNativeMarkerNatives();
+    initializeJavaCallBatch(env);
+
+    benchmark::registerNatives(env);
+    test::registerNatives(env);
+  });
+}
+
+} }
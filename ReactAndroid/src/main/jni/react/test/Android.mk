@@ -3,13 +3,26 @@ LOCAL_PATH:= $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_SRC_FILES:= \
+	asynclogging.cpp \
+	bridgelatency.cpp \
+	bridgetraffic.cpp \
+	environment.cpp \
 	jscexecutor.cpp \
+	jscheapsampler.cpp \
 	jsclogging.cpp \
+	longtaskwatchdog.cpp \
+	objectpool.cpp \
+	profilewriter.cpp \
+	samplingprofiler.cpp \
+	startuptimeline.cpp \
+	tracerecorder.cpp \
 	value.cpp \
 	methodcall.cpp \
+	nativehookstats.cpp \
 
 LOCAL_SHARED_LIBRARIES := \
 	libfb \
+	libfbjni \
 	libreactnative \
   libjsc
 
@@ -20,6 +33,10 @@ LOCAL_MODULE := reactnative_test
 
 LOCAL_CFLAGS += $(BUCK_DEP_CFLAGS)
 LOCAL_LDFLAGS += $(BUCK_DEP_LDFLAGS)
+# samplingprofiler.cpp finds its own functions by name in sampled stacks,
+# walked through frame pointers and symbolized with dladdr()
+LOCAL_CFLAGS += -fno-omit-frame-pointer
+LOCAL_LDFLAGS += -rdynamic
 
 include $(BUILD_EXECUTABLE)
 
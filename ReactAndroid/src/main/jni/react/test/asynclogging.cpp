@@ -0,0 +1,187 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <fb/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int kThreadCount = 4;
+static const char* kTag = "AsyncLogTest";
+
+static std::atomic<int> gDelivered(0);
+static std::mutex gLastIndexMutex;
+static std::vector<int> gLastIndex;
+static bool gOutOfOrder = false;
+
+// The drain thread reports drops with its own tag, possibly during a later
+// test, so only messages logged by the tests are counted
+static bool isTestMessage(const char *tag) {
+  return tag != nullptr && strcmp(tag, kTag) == 0;
+}
+
+static void countingSink(int pri, const char *tag, const char *msg) {
+  if (!isTestMessage(tag)) {
+    return;
+  }
+  gDelivered++;
+  int thread;
+  int index;
+  if (sscanf(msg, "%d %d", &thread, &index) == 2) {
+    std::lock_guard<std::mutex> lock(gLastIndexMutex);
+    gOutOfOrder |= index <= gLastIndex[thread];
+    gLastIndex[thread] = index;
+  }
+}
+
+static void logFromThreads(int messagesPerThread) {
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreadCount; thread++) {
+    threads.emplace_back([thread, messagesPerThread] {
+      for (int i = 0; i < messagesPerThread; i++) {
+        fb_printLog(ANDROID_LOG_INFO, kTag, "%d %d some padding to make it realistic", thread, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+class AsyncLoggingTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      gDelivered = 0;
+      gLastIndex.assign(kThreadCount, -1);
+      gOutOfOrder = false;
+      setLogSink(&countingSink);
+    }
+
+    virtual void TearDown() override {
+      setAsyncLogging(0, LOG_OVERFLOW_DROP);
+      setLogSink(NULL);
+    }
+};
+
+TEST_F(AsyncLoggingTest, DeliversEveryMessageInOrder) {
+  // Small enough that the rings never fill up
+  const int messagesPerThread = 200;
+  setAsyncLogging(1, LOG_OVERFLOW_DROP);
+  unsigned long long droppedBefore = getDroppedLogCount();
+
+  logFromThreads(messagesPerThread);
+  flushLogs();
+
+  ASSERT_EQ(droppedBefore, getDroppedLogCount());
+  ASSERT_EQ(kThreadCount * messagesPerThread, gDelivered.load());
+  ASSERT_FALSE(gOutOfOrder);
+}
+
+TEST_F(AsyncLoggingTest, CountsDroppedMessages) {
+  const int messagesPerThread = 20000;
+  setAsyncLogging(1, LOG_OVERFLOW_DROP);
+  unsigned long long droppedBefore = getDroppedLogCount();
+
+  logFromThreads(messagesPerThread);
+  flushLogs();
+
+  unsigned long long dropped = getDroppedLogCount() - droppedBefore;
+  ASSERT_EQ(kThreadCount * messagesPerThread, gDelivered.load() + (int) dropped);
+  ASSERT_FALSE(gOutOfOrder);
+}
+
+TEST_F(AsyncLoggingTest, BlockingDeliversEveryMessageInOrder) {
+  // Enough to fill the rings many times over
+  const int messagesPerThread = 20000;
+  setAsyncLogging(1, LOG_OVERFLOW_BLOCK);
+  unsigned long long droppedBefore = getDroppedLogCount();
+
+  logFromThreads(messagesPerThread);
+  flushLogs();
+
+  ASSERT_EQ(droppedBefore, getDroppedLogCount());
+  ASSERT_EQ(kThreadCount * messagesPerThread, gDelivered.load());
+  ASSERT_FALSE(gOutOfOrder);
+}
+
+TEST_F(AsyncLoggingTest, FatalMessagesFlushFirst) {
+  setAsyncLogging(1, LOG_OVERFLOW_DROP);
+  fb_printLog(ANDROID_LOG_INFO, kTag, "0 0");
+  fb_printLog(ANDROID_LOG_FATAL, kTag, "0 1");
+  ASSERT_EQ(2, gDelivered.load());
+  ASSERT_FALSE(gOutOfOrder);
+}
+
+static void slowSink(int pri, const char *tag, const char *msg) {
+  // Stands in for logd: writes are serialized and take about a microsecond
+  static std::mutex writeMutex;
+  std::lock_guard<std::mutex> lock(writeMutex);
+  auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+  while (std::chrono::steady_clock::now() < until) {}
+  if (isTestMessage(tag)) {
+    gDelivered++;
+  }
+}
+
+// Compares the time spent on the logging threads, for bursts that fit in the
+// rings and for logging that outpaces the sink. Once the rings are full,
+// async logging only beats the serialized sink by dropping messages, so it is
+// measured with LOG_OVERFLOW_BLOCK, which delivers all of them, and the drop
+// count of LOG_OVERFLOW_DROP is reported next to its timing.
+static void measureThroughput(int messagesPerThread) {
+  const struct {
+    const char *name;
+    int async;
+    LogOverflowPolicy policy;
+  } configs[] = {
+    {"sync", 0, LOG_OVERFLOW_DROP},
+    {"async, blocking when full", 1, LOG_OVERFLOW_BLOCK},
+    {"async, dropping when full", 1, LOG_OVERFLOW_DROP},
+  };
+  setLogSink(&slowSink);
+  for (const auto& config : configs) {
+    setAsyncLogging(config.async, config.policy);
+    gDelivered = 0;
+    unsigned long long droppedBefore = getDroppedLogCount();
+
+    auto start = std::chrono::steady_clock::now();
+    logFromThreads(messagesPerThread);
+    auto logged = std::chrono::steady_clock::now();
+    flushLogs();
+    auto flushed = std::chrono::steady_clock::now();
+
+    int dropped = (int) (getDroppedLogCount() - droppedBefore);
+    if (config.policy == LOG_OVERFLOW_BLOCK) {
+      EXPECT_EQ(0, dropped);
+      EXPECT_EQ(kThreadCount * messagesPerThread, gDelivered.load());
+    } else {
+      EXPECT_EQ(kThreadCount * messagesPerThread, gDelivered.load() + dropped);
+    }
+    auto loggingNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(logged - start).count();
+    auto flushMicros =
+      std::chrono::duration_cast<std::chrono::microseconds>(flushed - logged).count();
+    printf(
+      "%s, %d threads x %d: %lld ns per message on the logging threads, %lld us to flush, "
+      "%d of %d dropped\n",
+      config.name,
+      kThreadCount,
+      messagesPerThread,
+      (long long) loggingNanos / (kThreadCount * messagesPerThread),
+      (long long) flushMicros,
+      dropped,
+      kThreadCount * messagesPerThread);
+  }
+}
+
+TEST_F(AsyncLoggingTest, Throughput) {
+  // About 64 bytes per message, so 500 fit in a ring
+  measureThroughput(500);
+  measureThroughput(20000);
+}
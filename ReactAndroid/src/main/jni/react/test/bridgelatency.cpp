@@ -0,0 +1,124 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/BridgeLatency.h>
+#include <react/TraceRecorder.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+static const BridgeLatency::Stats* findStats(
+    const std::vector<BridgeLatency::Stats>& stats,
+    BridgeLatency::Kind kind,
+    const char* name) {
+  for (auto& entry : stats) {
+    if (entry.kind == kind && entry.name == name) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// Histogram buckets are 1/16 of a power of two wide
+static void expectNear(uint64_t expected, uint64_t actual) {
+  EXPECT_LE(expected, actual);
+  EXPECT_LE(actual, expected + expected / 16);
+}
+
+class BridgeLatencyTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      BridgeLatency::getStats(true);
+    }
+};
+
+TEST_F(BridgeLatencyTest, ComputesPercentiles) {
+  uint32_t name = TraceRecorder::internName("RCTEventEmitter.receiveEvent");
+  for (uint64_t i = 1; i <= 1000; i++) {
+    BridgeLatency::record(BridgeLatency::Kind::JSCall, name, i * 1000);
+  }
+
+  auto stats = BridgeLatency::getStats(false);
+  auto entry = findStats(stats, BridgeLatency::Kind::JSCall, "RCTEventEmitter.receiveEvent");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(1000u, entry->count);
+  expectNear(500000, entry->p50Nanos);
+  expectNear(900000, entry->p90Nanos);
+  expectNear(990000, entry->p99Nanos);
+  expectNear(1000000, entry->maxNanos);
+
+  // Small values are exact
+  BridgeLatency::record(BridgeLatency::Kind::QueueWait, name, 7);
+  stats = BridgeLatency::getStats(false);
+  entry = findStats(stats, BridgeLatency::Kind::QueueWait, "RCTEventEmitter.receiveEvent");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(7u, entry->maxNanos);
+}
+
+TEST_F(BridgeLatencyTest, SeparatesKinds) {
+  uint32_t name = TraceRecorder::internName("main");
+  BridgeLatency::record(BridgeLatency::Kind::QueueWait, name, 100);
+  BridgeLatency::record(BridgeLatency::Kind::NativeCall, name, 200);
+
+  auto stats = BridgeLatency::getStats(false);
+  ASSERT_EQ(2u, stats.size());
+  ASSERT_EQ(BridgeLatency::Kind::QueueWait, stats[0].kind);
+  ASSERT_EQ(BridgeLatency::Kind::NativeCall, stats[1].kind);
+  ASSERT_STREQ("queueWait", BridgeLatency::getKindName(stats[0].kind));
+}
+
+TEST_F(BridgeLatencyTest, MergesThreads) {
+  uint32_t name = TraceRecorder::internName("merged");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([name] {
+      for (int i = 0; i < 100; i++) {
+        BridgeLatency::record(BridgeLatency::Kind::NativeCall, name, 1000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Merged with the histograms of threads that have exited
+  BridgeLatency::record(BridgeLatency::Kind::NativeCall, name, 1000);
+
+  auto stats = BridgeLatency::getStats(false);
+  auto entry = findStats(stats, BridgeLatency::Kind::NativeCall, "merged");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(401u, entry->count);
+}
+
+TEST_F(BridgeLatencyTest, ResetsWindows) {
+  uint32_t name = TraceRecorder::internName("windowed");
+  BridgeLatency::record(BridgeLatency::Kind::JSCall, name, 1000000);
+  auto stats = BridgeLatency::getStats(true);
+  auto entry = findStats(stats, BridgeLatency::Kind::JSCall, "windowed");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(1u, entry->count);
+
+  // Keys without values in the window are left out
+  ASSERT_EQ(nullptr, findStats(BridgeLatency::getStats(false), BridgeLatency::Kind::JSCall, "windowed"));
+
+  BridgeLatency::record(BridgeLatency::Kind::JSCall, name, 10);
+  stats = BridgeLatency::getStats(false);
+  entry = findStats(stats, BridgeLatency::Kind::JSCall, "windowed");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(1u, entry->count);
+  ASSERT_EQ(10u, entry->maxNanos);
+}
+
+TEST_F(BridgeLatencyTest, Benchmark) {
+  const int iterations = 1000000;
+  uint32_t name = TraceRecorder::internName("benchmark");
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    BridgeLatency::record(BridgeLatency::Kind::JSCall, name, i);
+  }
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  printf("BridgeLatency::record: %.2f ns\n", (double) elapsed.count() / iterations);
+}
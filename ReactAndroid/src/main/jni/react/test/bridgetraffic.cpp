@@ -0,0 +1,160 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/BridgeTraffic.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+using Type = BridgeTrafficRecord::Type;
+
+static std::string tempPath(const char* name) {
+  const char* dir = getenv("TMPDIR");
+  return std::string(dir != nullptr ? dir : "/tmp") + "/" + name + "." + std::to_string(getpid());
+}
+
+static std::vector<BridgeTrafficRecord> readRecords(const std::string& path, bool expectComplete = true) {
+  std::vector<BridgeTrafficRecord> records;
+  bool complete = BridgeTrafficReader::read(path, [&] (const BridgeTrafficRecord& record) {
+    records.push_back(record);
+  });
+  EXPECT_EQ(expectComplete, complete);
+  return records;
+}
+
+static BridgeTrafficRecord makeRecord(Type type) {
+  BridgeTrafficRecord record;
+  record.type = type;
+  return record;
+}
+
+class BridgeTrafficTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      m_path = tempPath("bridgetraffic");
+    }
+
+    virtual void TearDown() override {
+      unlink(m_path.c_str());
+    }
+
+    std::string m_path;
+};
+
+TEST_F(BridgeTrafficTest, WritesAndReadsEachType) {
+  auto writer = BridgeTrafficWriter::create(m_path);
+  ASSERT_NE(nullptr, writer);
+
+  auto load = makeRecord(Type::LoadScript);
+  load.timestampNanos = 1;
+  load.durationNanos = 1000000000000;
+  load.target = "assets://index.android.bundle";
+  writer->write(load);
+
+  auto global = makeRecord(Type::SetGlobalVariable);
+  global.target = "__fbBatchedBridgeConfig";
+  global.json = std::string(100000, 'c');
+  writer->write(global);
+
+  auto call = makeRecord(Type::CallFunction);
+  call.timestampNanos = writer->elapsedNanos();
+  call.target = "RCTDeviceEventEmitter";
+  call.method = "emit";
+  call.json = "[\"didUpdateDimensions\",{}]";
+  writer->write(call);
+
+  auto callback = makeRecord(Type::InvokeCallback);
+  callback.callbackId = 42.5;
+  callback.json = "[]";
+  writer->write(callback);
+
+  auto batch = makeRecord(Type::CallNativeModules);
+  batch.json = "[[1],[2],[[]],7]";
+  batch.isEndOfBatch = true;
+  writer->write(batch);
+
+  ASSERT_TRUE(writer->close());
+  // Writes after closing are dropped
+  writer->write(load);
+
+  auto records = readRecords(m_path);
+  ASSERT_EQ(5u, records.size());
+  ASSERT_EQ(Type::LoadScript, records[0].type);
+  ASSERT_EQ(1u, records[0].timestampNanos);
+  ASSERT_EQ(1000000000000u, records[0].durationNanos);
+  ASSERT_EQ(load.target, records[0].target);
+  ASSERT_EQ(Type::SetGlobalVariable, records[1].type);
+  ASSERT_EQ(global.target, records[1].target);
+  ASSERT_EQ(global.json, records[1].json);
+  ASSERT_EQ(Type::CallFunction, records[2].type);
+  ASSERT_EQ(call.timestampNanos, records[2].timestampNanos);
+  ASSERT_EQ("RCTDeviceEventEmitter", records[2].target);
+  ASSERT_EQ("emit", records[2].method);
+  ASSERT_EQ(call.json, records[2].json);
+  ASSERT_EQ(Type::InvokeCallback, records[3].type);
+  ASSERT_EQ(42.5, records[3].callbackId);
+  ASSERT_EQ("[]", records[3].json);
+  ASSERT_EQ(Type::CallNativeModules, records[4].type);
+  ASSERT_TRUE(records[4].isEndOfBatch);
+  ASSERT_EQ(batch.json, records[4].json);
+}
+
+TEST_F(BridgeTrafficTest, WritesFromManyThreads) {
+  auto writer = BridgeTrafficWriter::create(m_path);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&writer, i] {
+      for (int j = 0; j < 1000; j++) {
+        auto record = makeRecord(Type::CallNativeModules);
+        record.json = std::to_string(i);
+        writer->write(record);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(writer->close());
+
+  std::vector<int> counts(4);
+  for (auto& record : readRecords(m_path)) {
+    counts[std::stoi(record.json)]++;
+  }
+  ASSERT_EQ(std::vector<int>(4, 1000), counts);
+}
+
+TEST_F(BridgeTrafficTest, ReadsTruncatedFiles) {
+  {
+    auto writer = BridgeTrafficWriter::create(m_path);
+    auto record = makeRecord(Type::CallFunction);
+    record.target = "first";
+    writer->write(record);
+    record.target = "second";
+    writer->write(record);
+  }
+  FILE* file = fopen(m_path.c_str(), "r");
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  ASSERT_EQ(0, truncate(m_path.c_str(), size - 1));
+
+  auto records = readRecords(m_path, false);
+  ASSERT_EQ(1u, records.size());
+  ASSERT_EQ("first", records[0].target);
+}
+
+TEST_F(BridgeTrafficTest, RejectsOtherFiles) {
+  FILE* file = fopen(m_path.c_str(), "w");
+  fputs("RNPROF\n", file);
+  fclose(file);
+  ASSERT_TRUE(readRecords(m_path, false).empty());
+  ASSERT_TRUE(readRecords(m_path + ".missing", false).empty());
+  ASSERT_EQ(nullptr, BridgeTrafficWriter::create("/nonexistent/bridgetraffic"));
+}
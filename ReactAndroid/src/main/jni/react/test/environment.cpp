@@ -0,0 +1,170 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <jni/Environment.h>
+
+#include <pthread.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using namespace facebook::jni;
+
+// A JavaVM that only tracks which threads are attached, so that Environment
+// can be tested and measured without a real VM.
+namespace {
+
+JNIEnv gFakeEnv;
+thread_local bool t_attached = false;
+std::atomic<int> gGetEnvCount(0);
+std::atomic<int> gAttachCount(0);
+std::atomic<int> gDetachCount(0);
+
+jint fakeGetEnv(JavaVM*, void** env, jint) {
+  gGetEnvCount++;
+  *env = t_attached ? &gFakeEnv : nullptr;
+  return t_attached ? JNI_OK : JNI_EDETACHED;
+}
+
+jint fakeAttachCurrentThread(JavaVM*, JNIEnv** env, void*) {
+  gAttachCount++;
+  t_attached = true;
+  *env = &gFakeEnv;
+  return JNI_OK;
+}
+
+jint fakeDetachCurrentThread(JavaVM*) {
+  gDetachCount++;
+  t_attached = false;
+  return JNI_OK;
+}
+
+const JNIInvokeInterface gFakeInvokeInterface = {
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  fakeAttachCurrentThread,
+  fakeDetachCurrentThread,
+  fakeGetEnv,
+  fakeAttachCurrentThread,
+};
+
+JavaVM gFakeVM = { &gFakeInvokeInterface };
+
+template <typename F>
+void runOnNewThread(F&& f) {
+  std::thread(std::forward<F>(f)).join();
+}
+
+long long nanosSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+class EnvironmentTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      Environment::initialize(&gFakeVM);
+      gGetEnvCount = 0;
+      gAttachCount = 0;
+      gDetachCount = 0;
+    }
+};
+
+TEST_F(EnvironmentTest, CurrentIsCachedPerThread) {
+  runOnNewThread([] {
+    ASSERT_TRUE(Environment::current() == nullptr);
+    ThreadScope scope;
+    ASSERT_EQ(&gFakeEnv, Environment::current());
+    int getEnvCount = gGetEnvCount;
+    ASSERT_EQ(&gFakeEnv, Environment::current());
+    ASSERT_EQ(getEnvCount, gGetEnvCount);
+  });
+  runOnNewThread([] {
+    ASSERT_TRUE(Environment::current() == nullptr);
+  });
+}
+
+TEST_F(EnvironmentTest, ThreadScopeDetachesOnlyWhatItAttached) {
+  runOnNewThread([] {
+    {
+      ThreadScope outer;
+      ThreadScope inner;
+    }
+    ASSERT_EQ(1, gAttachCount);
+    ASSERT_EQ(1, gDetachCount);
+    ASSERT_TRUE(Environment::current() == nullptr);
+  });
+}
+
+TEST_F(EnvironmentTest, AttachUntilThreadExit) {
+  runOnNewThread([] {
+    ThreadScope::attachUntilThreadExit();
+    for (int i = 0; i < 10; i++) {
+      ThreadScope scope;
+      ThreadScope::attachUntilThreadExit();
+    }
+    ASSERT_EQ(1, gAttachCount);
+    ASSERT_EQ(0, gDetachCount);
+    ASSERT_EQ(&gFakeEnv, Environment::current());
+  });
+  ASSERT_EQ(1, gDetachCount);
+}
+
+TEST_F(EnvironmentTest, Benchmark) {
+  const int iterations = 1000000;
+  runOnNewThread([iterations] {
+    ThreadScope scope;
+
+    // What Environment::current() used to do on a hit
+    pthread_key_t key;
+    pthread_key_create(&key, nullptr);
+    pthread_setspecific(key, &gFakeEnv);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      JNIEnv* env = static_cast<JNIEnv*>(pthread_getspecific(key));
+      asm volatile("" : : "r"(env));
+    }
+    long long pthreadNanos = nanosSince(start);
+    pthread_key_delete(key);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      JNIEnv* env = Environment::current();
+      asm volatile("" : : "r"(env));
+    }
+    long long currentNanos = nanosSince(start);
+
+    printf("Environment::current(): %.2f ns per call, pthread key: %.2f ns per call\n",
+      (double) currentNanos / iterations,
+      (double) pthreadNanos / iterations);
+  });
+
+  const int units = 1000;
+  int attachCount = gAttachCount;
+  runOnNewThread([units] {
+    for (int i = 0; i < units; i++) {
+      ThreadScope scope;
+    }
+  });
+  int scopedAttaches = gAttachCount - attachCount;
+
+  attachCount = gAttachCount;
+  runOnNewThread([units] {
+    ThreadScope::attachUntilThreadExit();
+    for (int i = 0; i < units; i++) {
+      ThreadScope scope;
+    }
+  });
+  int lifetimeAttaches = gAttachCount - attachCount;
+
+  ASSERT_EQ(units, scopedAttaches);
+  ASSERT_EQ(1, lifetimeAttaches);
+  printf("%d units of work: %d attaches with ThreadScope, %d with attachUntilThreadExit\n",
+    units, scopedAttaches, lifetimeAttaches);
+}
@@ -0,0 +1,63 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/JSCHeapSampler.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace facebook::react;
+
+class JSCHeapSamplerTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      m_context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    }
+
+    virtual void TearDown() override {
+      JSGlobalContextRelease(m_context);
+    }
+
+    JSGlobalContextRef m_context;
+};
+
+TEST_F(JSCHeapSamplerTest, SamplesAtMostEveryInterval) {
+  JSCHeapSampler sampler(50);
+  ASSERT_TRUE(sampler.isSampleDue());
+  sampler.sample(m_context, JSCHeapSample::Event::Sample);
+  ASSERT_FALSE(sampler.isSampleDue());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_TRUE(sampler.isSampleDue());
+  sampler.sample(m_context, JSCHeapSample::Event::Sample);
+  auto samples = sampler.getSamples();
+  ASSERT_EQ(2u, samples.size());
+  ASSERT_LT(samples[0].timestampNanos, samples[1].timestampNanos);
+  ASSERT_EQ(JSCHeapSample::Event::Sample, samples[1].event);
+}
+
+TEST_F(JSCHeapSamplerTest, RecordsMemoryPressureWhenDisabled) {
+  JSCHeapSampler sampler(0);
+  ASSERT_FALSE(sampler.isSampleDue());
+  sampler.sample(m_context, JSCHeapSample::Event::MemoryPressureCritical);
+
+  auto samples = sampler.getSamples();
+  ASSERT_EQ(1u, samples.size());
+  ASSERT_EQ(JSCHeapSample::Event::MemoryPressureCritical, samples[0].event);
+  ASSERT_STREQ("memoryPressureCritical", JSCHeapSampler::getEventName(samples[0].event));
+}
+
+TEST_F(JSCHeapSamplerTest, KeepsTheLatestSamples) {
+  JSCHeapSampler sampler(0);
+  for (size_t i = 0; i < JSCHeapSampler::kCapacity; i++) {
+    sampler.sample(m_context, JSCHeapSample::Event::Sample);
+  }
+  sampler.sample(m_context, JSCHeapSample::Event::MemoryPressureModerate);
+
+  auto samples = sampler.getSamples();
+  ASSERT_EQ(JSCHeapSampler::kCapacity, samples.size());
+  ASSERT_EQ(JSCHeapSample::Event::MemoryPressureModerate, samples.back().event);
+  for (size_t i = 1; i < samples.size(); i++) {
+    ASSERT_LE(samples[i - 1].timestampNanos, samples[i].timestampNanos);
+  }
+}
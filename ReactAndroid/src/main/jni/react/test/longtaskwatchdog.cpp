@@ -0,0 +1,156 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/LongTaskWatchdog.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+using Queue = LongTaskWatchdog::Queue;
+using TaskOrigin = LongTaskWatchdog::TaskOrigin;
+using TaskScope = LongTaskWatchdog::TaskScope;
+
+static void sleepMs(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static LongTaskWatchdog::Stats getStats(Queue queue, bool reset = false) {
+  return LongTaskWatchdog::getStats(reset)[static_cast<size_t>(queue)];
+}
+
+class LongTaskWatchdogTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      LongTaskWatchdog::getStats(true);
+      LongTaskWatchdog::start(5, [this] (const LongTaskWatchdog::LongTaskEvent& event) {
+        m_events.push_back(event);
+      });
+    }
+
+    virtual void TearDown() override {
+      LongTaskWatchdog::stop();
+    }
+
+    std::vector<LongTaskWatchdog::LongTaskEvent> m_events;
+};
+
+TEST_F(LongTaskWatchdogTest, ReportsTasksOverBudget) {
+  {
+    TaskScope task(Queue::JS, TaskOrigin::callFunction(7));
+  }
+  {
+    TaskScope task(Queue::JS, TaskOrigin::invokeCallback(42));
+    sleepMs(10);
+  }
+
+  ASSERT_EQ(1u, m_events.size());
+  auto& event = m_events[0];
+  ASSERT_EQ(Queue::JS, event.queue);
+  ASSERT_EQ(TaskOrigin::Kind::InvokeCallback, event.origin.kind);
+  ASSERT_EQ(42, event.origin.callbackId);
+  ASSERT_GE(event.durationNanos, 10000000);
+  ASSERT_EQ(5000000, event.budgetNanos);
+  ASSERT_TRUE(event.jsStack.empty());
+
+  auto stats = getStats(Queue::JS);
+  ASSERT_EQ(2u, stats.taskCount);
+  ASSERT_EQ(1u, stats.longTaskCount);
+  ASSERT_EQ(static_cast<uint64_t>(event.durationNanos - event.budgetNanos), stats.overBudgetNanos);
+  ASSERT_EQ(static_cast<uint64_t>(event.durationNanos), stats.maxNanos);
+  ASSERT_EQ(0u, getStats(Queue::NativeModules).taskCount);
+}
+
+TEST_F(LongTaskWatchdogTest, SetsOriginAfterBeginning) {
+  {
+    TaskScope task(Queue::NativeModules);
+    task.setOrigin(TaskOrigin::nativeModuleCalls(3, 4, 10));
+    sleepMs(10);
+  }
+
+  ASSERT_EQ(1u, m_events.size());
+  ASSERT_EQ(TaskOrigin::Kind::NativeModuleCalls, m_events[0].origin.kind);
+  ASSERT_EQ(3, m_events[0].origin.moduleId);
+  ASSERT_EQ(4, m_events[0].origin.methodId);
+  ASSERT_EQ(10u, m_events[0].origin.callCount);
+  ASSERT_STREQ("nativeModules", LongTaskWatchdog::getQueueName(m_events[0].queue));
+  ASSERT_STREQ("nativeModuleCalls", LongTaskWatchdog::getOriginKindName(m_events[0].origin.kind));
+}
+
+TEST_F(LongTaskWatchdogTest, CapturesJSStackOnceOverBudget) {
+  ASSERT_FALSE(LongTaskWatchdog::needsCurrentTaskJSStack());
+  {
+    TaskScope task(Queue::JS);
+    ASSERT_FALSE(LongTaskWatchdog::needsCurrentTaskJSStack());
+    sleepMs(10);
+    ASSERT_TRUE(LongTaskWatchdog::needsCurrentTaskJSStack());
+    LongTaskWatchdog::setCurrentTaskJSStack("render@index.bundle:1:2");
+    ASSERT_FALSE(LongTaskWatchdog::needsCurrentTaskJSStack());
+  }
+  ASSERT_FALSE(LongTaskWatchdog::needsCurrentTaskJSStack());
+
+  ASSERT_EQ(1u, m_events.size());
+  ASSERT_EQ("render@index.bundle:1:2", m_events[0].jsStack);
+}
+
+TEST_F(LongTaskWatchdogTest, TimesNestedTasks) {
+  {
+    TaskScope outer(Queue::JS, TaskOrigin::callFunction(1));
+    {
+      TaskScope inner(Queue::JS, TaskOrigin::callFunction(2));
+      sleepMs(10);
+      LongTaskWatchdog::setCurrentTaskJSStack("inner");
+    }
+    // The stack was the inner task's
+    ASSERT_TRUE(LongTaskWatchdog::needsCurrentTaskJSStack());
+  }
+
+  ASSERT_EQ(2u, m_events.size());
+  ASSERT_EQ(2u, m_events[0].origin.nameId);
+  ASSERT_EQ("inner", m_events[0].jsStack);
+  ASSERT_EQ(1u, m_events[1].origin.nameId);
+  ASSERT_TRUE(m_events[1].jsStack.empty());
+  ASSERT_GE(m_events[1].durationNanos, m_events[0].durationNanos);
+}
+
+TEST_F(LongTaskWatchdogTest, IgnoresTasksWhileStopped) {
+  LongTaskWatchdog::stop();
+  ASSERT_FALSE(LongTaskWatchdog::isRunning());
+  {
+    TaskScope task(Queue::JS);
+    sleepMs(10);
+    ASSERT_FALSE(LongTaskWatchdog::needsCurrentTaskJSStack());
+  }
+  ASSERT_TRUE(m_events.empty());
+  ASSERT_EQ(0u, getStats(Queue::JS).taskCount);
+
+  // Tasks that began before it stopped are counted, but not reported
+  LongTaskWatchdog::start(5, [this] (const LongTaskWatchdog::LongTaskEvent& event) {
+    m_events.push_back(event);
+  });
+  {
+    TaskScope task(Queue::JSWorker);
+    sleepMs(10);
+    LongTaskWatchdog::stop();
+  }
+  ASSERT_TRUE(m_events.empty());
+  ASSERT_EQ(1u, getStats(Queue::JSWorker, true).longTaskCount);
+  ASSERT_EQ(0u, getStats(Queue::JSWorker).longTaskCount);
+}
+
+TEST_F(LongTaskWatchdogTest, CountsTasksFromManyThreads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 1000; j++) {
+        TaskScope task(Queue::NativeModules);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(4000u, getStats(Queue::NativeModules).taskCount);
+}
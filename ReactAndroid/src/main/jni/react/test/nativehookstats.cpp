@@ -0,0 +1,133 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/NativeHookStats.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+static const NativeHookStats::Stats* findStats(
+    const std::vector<NativeHookStats::Stats>& stats,
+    const std::string& name) {
+  for (auto& entry : stats) {
+    if (entry.name == name) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+TEST(NativeHookStatsTest, RegistersEachNameOnce) {
+  int flush = NativeHookStats::registerHook("registerFlush");
+  int require = NativeHookStats::registerHook("registerRequire");
+  ASSERT_GE(flush, 0);
+  ASSERT_GE(require, 0);
+  ASSERT_NE(flush, require);
+  ASSERT_EQ(flush, NativeHookStats::registerHook(std::string("registerFlush").c_str()));
+}
+
+TEST(NativeHookStatsTest, RegistersConcurrently) {
+  std::atomic<bool> go{false};
+  std::vector<int> hooks(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < hooks.size(); i++) {
+    threads.emplace_back([&, i] {
+      while (!go) {
+      }
+      hooks[i] = NativeHookStats::registerHook(i % 2 ? "concurrentA" : "concurrentB");
+    });
+  }
+  go = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 2; i < hooks.size(); i++) {
+    ASSERT_EQ(hooks[i % 2], hooks[i]);
+  }
+  ASSERT_NE(hooks[0], hooks[1]);
+}
+
+TEST(NativeHookStatsTest, RecordsCountTotalAndMax) {
+  NativeHookStats::getStats(true);
+  int hook = NativeHookStats::registerHook("record");
+  NativeHookStats::record(hook, 10);
+  NativeHookStats::record(hook, 30);
+  NativeHookStats::record(hook, 20);
+  // Ignored
+  NativeHookStats::record(-1, 1000);
+
+  auto stats = NativeHookStats::getStats(false);
+  auto entry = findStats(stats, "record");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(3u, entry->count);
+  ASSERT_EQ(60u, entry->totalNanos);
+  ASSERT_EQ(30u, entry->maxNanos);
+
+  // Reading without reset kept the stats
+  stats = NativeHookStats::getStats(true);
+  ASSERT_EQ(3u, findStats(stats, "record")->count);
+  ASSERT_EQ(nullptr, findStats(NativeHookStats::getStats(false), "record"));
+}
+
+TEST(NativeHookStatsTest, SortsByTotalTime) {
+  NativeHookStats::getStats(true);
+  NativeHookStats::record(NativeHookStats::registerHook("cheap"), 5);
+  NativeHookStats::record(NativeHookStats::registerHook("expensive"), 500);
+
+  auto stats = NativeHookStats::getStats(true);
+  ASSERT_EQ(2u, stats.size());
+  ASSERT_EQ("expensive", stats[0].name);
+  ASSERT_EQ("cheap", stats[1].name);
+}
+
+TEST(NativeHookStatsTest, MetersScopesOnlyWhileEnabled) {
+  NativeHookStats::getStats(true);
+  int hook = NativeHookStats::registerHook("scope");
+  ASSERT_FALSE(NativeHookStats::isEnabled());
+  {
+    NativeHookStats::Scope scope(hook);
+  }
+  ASSERT_EQ(nullptr, findStats(NativeHookStats::getStats(false), "scope"));
+
+  NativeHookStats::setEnabled(true);
+  {
+    NativeHookStats::Scope scope(hook);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  NativeHookStats::setEnabled(false);
+
+  auto stats = NativeHookStats::getStats(true);
+  auto entry = findStats(stats, "scope");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(1u, entry->count);
+  ASSERT_GE(entry->totalNanos, 2000000u);
+  ASSERT_EQ(entry->totalNanos, entry->maxNanos);
+}
+
+TEST(NativeHookStatsTest, RecordsConcurrently) {
+  NativeHookStats::getStats(true);
+  int hook = NativeHookStats::registerHook("concurrentRecord");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([hook, i] {
+      for (int j = 0; j < 10000; j++) {
+        NativeHookStats::record(hook, j == 0 ? 100 + i : 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = NativeHookStats::getStats(true);
+  auto entry = findStats(stats, "concurrentRecord");
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(40000u, entry->count);
+  ASSERT_EQ(4u * 9999 + 100 + 101 + 102 + 103, entry->totalNanos);
+  ASSERT_EQ(103u, entry->maxNanos);
+}
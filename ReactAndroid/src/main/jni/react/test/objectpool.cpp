@@ -0,0 +1,162 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <fb/Countable.h>
+#include <fb/ObjectPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook;
+
+namespace {
+
+struct PooledObject : public Countable, public PooledAllocation<PooledObject> {
+  std::string value;
+};
+
+struct DerivedPooledObject : public PooledObject {
+  char padding[64];
+};
+
+struct UnpooledObject : public Countable {
+  std::string value;
+};
+
+}
+
+TEST(ObjectPool, ReusesFreedObjects) {
+  auto before = ObjectPool<PooledObject>::getStats();
+  void* address;
+  {
+    auto object = createNew<PooledObject>();
+    address = object.get();
+    ASSERT_EQ(before.live + 1, ObjectPool<PooledObject>::getStats().live);
+  }
+  auto object = createNew<PooledObject>();
+  ASSERT_EQ(address, object.get());
+  auto after = ObjectPool<PooledObject>::getStats();
+  ASSERT_EQ(before.live + 1, after.live);
+  ASSERT_LE(after.allocated, before.allocated + 1);
+}
+
+TEST(ObjectPool, DerivedClassesUseTheHeap) {
+  auto before = ObjectPool<PooledObject>::getStats();
+  {
+    auto object = createNew<DerivedPooledObject>();
+    ASSERT_EQ(before.live, ObjectPool<PooledObject>::getStats().live);
+  }
+  ASSERT_EQ(before.pooled, ObjectPool<PooledObject>::getStats().pooled);
+}
+
+TEST(ObjectPool, ObjectsFreedOnAnotherThreadAreReused) {
+  const int count = 1000;
+  std::vector<RefPtr<PooledObject>> objects;
+  for (int i = 0; i < count; i++) {
+    objects.push_back(createNew<PooledObject>());
+  }
+  auto allocatedBefore = ObjectPool<PooledObject>::getStats().allocated;
+
+  // Like a finalizer thread releasing objects created on the JS thread
+  std::thread([&objects] { objects.clear(); }).join();
+  for (int i = 0; i < count; i++) {
+    objects.push_back(createNew<PooledObject>());
+  }
+
+  auto stats = ObjectPool<PooledObject>::getStats();
+  // Only what the depot could hold is reused
+  ASSERT_LT(stats.allocated, allocatedBefore + count);
+  objects.clear();
+}
+
+template <typename T>
+static long long churn(int iterations, int liveObjects) {
+  std::vector<RefPtr<T>> objects(liveObjects);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    objects[i % liveObjects] = createNew<T>();
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+TEST(ObjectPool, Benchmark) {
+  const int iterations = 1000000;
+  const int liveObjects = 16;
+  churn<PooledObject>(iterations, liveObjects);
+  churn<UnpooledObject>(iterations, liveObjects);
+
+  long long pooledNanos = churn<PooledObject>(iterations, liveObjects);
+  long long unpooledNanos = churn<UnpooledObject>(iterations, liveObjects);
+  auto stats = ObjectPool<PooledObject>::getStats();
+  printf("createNew + release: pooled %lld ns, heap %lld ns (%zu live, %zu pooled, %zu allocated)\n",
+    pooledNanos, unpooledNanos, stats.live, stats.pooled, stats.allocated);
+}
+
+// One thread creates objects and hands them over in batches to another that
+// releases them, like the JS thread and the finalizer thread. Returns the time
+// per object, and sets how many objects per created one came from the heap
+// when the pool is used.
+template <typename T>
+static long long handOff(int count, int backlog, double* poolMisses) {
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<RefPtr<T>> handedOff;
+  bool done = false;
+  std::thread finalizer([&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!done || !handedOff.empty()) {
+      if (handedOff.empty()) {
+        condition.wait(lock);
+        continue;
+      }
+      std::vector<RefPtr<T>> batch;
+      batch.swap(handedOff);
+      lock.unlock();
+      batch.clear();
+      lock.lock();
+    }
+  });
+
+  auto allocatedBefore = ObjectPool<PooledObject>::getStats().allocated;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<RefPtr<T>> batch;
+  for (int i = 0; i < count; i++) {
+    batch.push_back(createNew<T>());
+    if (batch.size() == static_cast<size_t>(backlog)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::move(batch.begin(), batch.end(), std::back_inserter(handedOff));
+      batch.clear();
+      condition.notify_one();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    condition.notify_one();
+  }
+  finalizer.join();
+  auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count() / count;
+  *poolMisses = double(ObjectPool<PooledObject>::getStats().allocated - allocatedBefore) / count;
+  return nanos;
+}
+
+TEST(ObjectPool, FinalizerHandOffBenchmark) {
+  const int count = 200000;
+  for (int backlog : {16, 64, 256, 1024}) {
+    double poolMisses;
+    double unused;
+    long long pooledNanos = handOff<PooledObject>(count, backlog, &poolMisses);
+    long long unpooledNanos = handOff<UnpooledObject>(count, backlog, &unused);
+    printf("hand off, backlog %d: pooled %lld ns (%.2f from the heap), heap %lld ns\n",
+      backlog, pooledNanos, poolMisses, unpooledNanos);
+  }
+}
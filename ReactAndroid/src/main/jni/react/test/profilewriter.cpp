@@ -0,0 +1,191 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/ProfileWriter.h>
+#include <react/SamplingProfiler.h>
+#include <react/SystraceSection.h>
+#include <react/TraceRecorder.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+struct Chunk {
+  ProfileWriter::ChunkType type;
+  uint32_t flags;
+  std::string data;
+};
+
+static std::string tempPath(const char* name) {
+  const char* dir = getenv("TMPDIR");
+  return std::string(dir != nullptr ? dir : "/tmp") + "/" + name + "." + std::to_string(getpid());
+}
+
+static std::vector<Chunk> readChunks(const std::string& path, bool expectComplete = true) {
+  std::vector<Chunk> chunks;
+  uint32_t pid = 0;
+  bool complete = ProfileReader::read(path, pid, [&] (
+      ProfileWriter::ChunkType type,
+      uint32_t flags,
+      const std::string& data) {
+    chunks.push_back(Chunk { type, flags, data });
+  });
+  EXPECT_EQ(expectComplete, complete);
+  EXPECT_EQ(static_cast<uint32_t>(getpid()), pid);
+  return chunks;
+}
+
+class ProfileWriterTest : public testing::TestWithParam<bool> {
+  protected:
+    virtual void SetUp() override {
+      m_path = tempPath("profilewriter");
+    }
+
+    virtual void TearDown() override {
+      unlink(m_path.c_str());
+    }
+
+    std::string m_path;
+};
+
+TEST_P(ProfileWriterTest, WritesEventsInBoundedChunks) {
+  auto writer = ProfileWriter::create(m_path, GetParam());
+  ASSERT_NE(nullptr, writer);
+  std::string event(1000, 'x');
+  const int count = 1000;
+  for (int i = 0; i < count; i++) {
+    writer->writeTraceEvent(event);
+  }
+  ASSERT_TRUE(writer->close());
+  // Writes after closing are dropped
+  writer->writeTraceEvent(event);
+
+  auto chunks = readChunks(m_path);
+  ASSERT_LT(1u, chunks.size());
+  size_t events = 0;
+  for (auto& chunk : chunks) {
+    ASSERT_EQ(ProfileWriter::ChunkType::TraceEvents, chunk.type);
+    ASSERT_EQ(GetParam(), (chunk.flags & ProfileWriter::kFlagCompressed) != 0);
+    ASSERT_LE(chunk.data.size(), ProfileWriter::kChunkSize);
+    // Events aren't split across chunks
+    ASSERT_EQ(0u, chunk.data.size() % (event.size() + 1));
+    events += chunk.data.size() / (event.size() + 1);
+  }
+  ASSERT_EQ(static_cast<size_t>(count), events);
+}
+
+TEST_P(ProfileWriterTest, WritesFilesAsDocuments) {
+  std::string documentPath = tempPath("profilewriter-document");
+  std::string document;
+  for (size_t i = 0; document.size() < 2 * ProfileWriter::kChunkSize + 100; i++) {
+    document += std::to_string(i) + ",";
+  }
+  FILE* file = fopen(documentPath.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  fwrite(document.data(), 1, document.size(), file);
+  fclose(file);
+
+  auto writer = ProfileWriter::create(m_path, GetParam());
+  writer->writeTraceEvent("{\"before\":1}");
+  ASSERT_TRUE(writer->writeFile(ProfileWriter::ChunkType::JSCProfile, documentPath));
+  writer->writeTraceEvent("{\"after\":1}");
+  ASSERT_FALSE(writer->writeFile(ProfileWriter::ChunkType::JSCProfile, documentPath + ".missing"));
+  ASSERT_TRUE(writer->close());
+  unlink(documentPath.c_str());
+
+  auto chunks = readChunks(m_path);
+  ASSERT_EQ(5u, chunks.size());
+  ASSERT_EQ("{\"before\":1}\n", chunks[0].data);
+  std::string read;
+  for (size_t i = 1; i <= 3; i++) {
+    ASSERT_EQ(ProfileWriter::ChunkType::JSCProfile, chunks[i].type);
+    ASSERT_EQ(i < 3, (chunks[i].flags & ProfileWriter::kFlagContinued) != 0);
+    read += chunks[i].data;
+  }
+  ASSERT_EQ(document, read);
+  ASSERT_EQ("{\"after\":1}\n", chunks[4].data);
+}
+
+TEST_P(ProfileWriterTest, ReadsTruncatedFiles) {
+  {
+    auto writer = ProfileWriter::create(m_path, GetParam());
+    writer->writeTraceEvent(std::string(ProfileWriter::kChunkSize - 1, 'a'));
+    writer->writeTraceEvent("{}");
+  }
+  FILE* file = fopen(m_path.c_str(), "r+");
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fclose(file);
+  ASSERT_EQ(0, truncate(m_path.c_str(), size - 1));
+
+  auto chunks = readChunks(m_path, false);
+  ASSERT_EQ(1u, chunks.size());
+  ASSERT_EQ(ProfileWriter::kChunkSize, chunks[0].data.size());
+}
+
+INSTANTIATE_TEST_CASE_P(Compression, ProfileWriterTest, testing::Bool());
+
+TEST(ProfileWriterStreamingTest, StreamsTraceEventsAndSamples) {
+  std::string path = tempPath("profilewriter-streaming");
+  std::shared_ptr<ProfileWriter> writer = ProfileWriter::create(path, true);
+  ASSERT_TRUE(TraceRecorder::startStreaming(writer, 10));
+  ASSERT_FALSE(TraceRecorder::startStreaming(writer, 10));
+  ASSERT_EQ(writer, TraceRecorder::getStreamingWriter());
+
+  SamplingProfiler::registerCurrentThread();
+  ASSERT_TRUE(SamplingProfiler::start(1000, writer));
+  // More sections than a thread buffer holds, which are only all kept if
+  // they are streamed while recording
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 1000; j++) {
+      SystraceSection s("streamed");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  ASSERT_EQ("", SamplingProfiler::stop());
+  SamplingProfiler::unregisterCurrentThread();
+  ASSERT_EQ(writer, TraceRecorder::stopStreaming());
+  ASSERT_EQ(nullptr, TraceRecorder::getStreamingWriter());
+  ASSERT_TRUE(writer->close());
+
+  std::string events;
+  for (auto& chunk : readChunks(path)) {
+    events += chunk.data;
+  }
+  unlink(path.c_str());
+
+  int sections = 0;
+  for (size_t pos = events.find("\"name\":\"streamed\""); pos != std::string::npos;
+       pos = events.find("\"name\":\"streamed\"", pos + 1)) {
+    sections++;
+  }
+  ASSERT_EQ(20000, sections);
+  ASSERT_NE(std::string::npos, events.find("\"name\":\"Profile\""));
+  ASSERT_NE(std::string::npos, events.find("\"name\":\"ProfileChunk\""));
+}
+
+TEST(ProfileWriterStreamingTest, KeepsRecordingEnabledByTheCaller) {
+  std::string path = tempPath("profilewriter-recording");
+  std::shared_ptr<ProfileWriter> writer = ProfileWriter::create(path, true);
+
+  TraceRecorder::setEnabled(true);
+  ASSERT_TRUE(TraceRecorder::startStreaming(writer, 10));
+  ASSERT_EQ(writer, TraceRecorder::stopStreaming());
+  ASSERT_TRUE(TraceRecorder::isEnabled());
+
+  ASSERT_TRUE(TraceRecorder::startStreaming(writer, 10));
+  TraceRecorder::setEnabled(false);
+  ASSERT_TRUE(TraceRecorder::isEnabled());
+  ASSERT_EQ(writer, TraceRecorder::stopStreaming());
+  ASSERT_FALSE(TraceRecorder::isEnabled());
+
+  ASSERT_TRUE(writer->close());
+  unlink(path.c_str());
+}
@@ -0,0 +1,80 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/SamplingProfiler.h>
+#include <react/TraceRecorder.h>
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace facebook::react;
+
+// Not static and not inlined, so that it shows up by name in stacks
+__attribute__((noinline))
+void samplingProfilerTestSpin(std::chrono::milliseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  volatile uint64_t counter = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    // Mostly in this function rather than in the clock, which may not keep a
+    // frame pointer
+    for (int i = 0; i < 10000; i++) {
+      counter++;
+    }
+  }
+}
+
+TEST(SamplingProfilerTest, AttributesSamplesToActivities) {
+  uint32_t name = TraceRecorder::internName("AppRegistry.runApplication");
+  std::atomic<bool> started{false};
+  std::thread js([&] {
+    SamplingProfiler::registerCurrentThread();
+    started = true;
+    {
+      SamplingProfiler::ActivityScope scope(SamplingProfiler::Activity::CallFunction, name);
+      samplingProfilerTestSpin(std::chrono::milliseconds(100));
+    }
+    SamplingProfiler::unregisterCurrentThread();
+  });
+  while (!started) {
+    std::this_thread::yield();
+  }
+
+  ASSERT_TRUE(SamplingProfiler::start(1000));
+  ASSERT_FALSE(SamplingProfiler::start(1000));
+  js.join();
+  std::string profile = SamplingProfiler::stop();
+
+  ASSERT_EQ(0u, profile.find("{\"nodes\":[{\"id\":1,\"callFrame\":{\"functionName\":\"(root)\""));
+  ASSERT_NE(std::string::npos, profile.find("(callFunction) AppRegistry.runApplication"));
+#ifndef __SANITIZE_THREAD__
+  // ThreadSanitizer delivers signals from its interceptors, here the one of
+  // clock_gettime, whose callers in libstdc++ have no frame pointers
+  ASSERT_NE(std::string::npos, profile.find("samplingProfilerTestSpin"));
+#endif
+  ASSERT_EQ(std::string::npos, profile.find("\"samples\":[]"));
+  ASSERT_NE(std::string::npos, profile.find("\"timeDeltas\":["));
+}
+
+TEST(SamplingProfilerTest, IgnoresUnregisteredThreads) {
+  ASSERT_TRUE(SamplingProfiler::start(1000));
+  samplingProfilerTestSpin(std::chrono::milliseconds(20));
+  std::string profile = SamplingProfiler::stop();
+  ASSERT_NE(std::string::npos, profile.find("\"samples\":[]"));
+  ASSERT_EQ("", SamplingProfiler::stop());
+}
+
+TEST(SamplingProfilerTest, IgnoresSignalsOnceStopped) {
+  SamplingProfiler::registerCurrentThread();
+  ASSERT_TRUE(SamplingProfiler::start(1000));
+  SamplingProfiler::stop();
+
+  // Like a SIGPROF that was still pending when the profiler stopped, which
+  // would kill the process with the default action
+  syscall(__NR_tgkill, getpid(), syscall(__NR_gettid), SIGPROF);
+  SamplingProfiler::unregisterCurrentThread();
+}
@@ -0,0 +1,96 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/StartupTimeline.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace facebook::react;
+
+using Phase = StartupTimeline::Phase;
+
+static void sleepMs(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST(StartupTimelineTest, RecordsFirstSpanOfEachPhase) {
+  StartupTimeline::reset();
+  StartupTimeline::begin(Phase::EvaluateScript);
+  // Ignored, the phase has begun already
+  StartupTimeline::begin(Phase::EvaluateScript);
+  StartupTimeline::end(Phase::EvaluateScript);
+  int64_t end = StartupTimeline::getSpans()[0].endNanos;
+  // Ignored, the phase has ended already
+  StartupTimeline::begin(Phase::EvaluateScript);
+  StartupTimeline::end(Phase::EvaluateScript);
+  // Ignored, the phase hasn't begun
+  StartupTimeline::end(Phase::FirstFlush);
+  // Left out, the phase hasn't ended
+  StartupTimeline::begin(Phase::ReadScript);
+
+  auto spans = StartupTimeline::getSpans();
+  ASSERT_EQ(1u, spans.size());
+  ASSERT_EQ(Phase::EvaluateScript, spans[0].phase);
+  ASSERT_EQ(end, spans[0].endNanos);
+  ASSERT_LE(StartupTimeline::getStartNanos(), spans[0].beginNanos);
+  ASSERT_LE(spans[0].beginNanos, spans[0].endNanos);
+
+  StartupTimeline::reset();
+  ASSERT_TRUE(StartupTimeline::getSpans().empty());
+  ASSERT_TRUE(StartupTimeline::getCriticalPath().empty());
+}
+
+TEST(StartupTimelineTest, RecordsThreads) {
+  StartupTimeline::reset();
+  StartupTimeline::begin(Phase::FirstNativeBatch);
+  std::thread([] {
+    StartupTimeline::end(Phase::FirstNativeBatch);
+  }).join();
+
+  auto spans = StartupTimeline::getSpans();
+  ASSERT_EQ(1u, spans.size());
+  ASSERT_NE(spans[0].beginTid, spans[0].endTid);
+}
+
+TEST(StartupTimelineTest, FindsCriticalPath) {
+  StartupTimeline::reset();
+  sleepMs(5);
+  {
+    StartupTimeline::Scope phase(Phase::CreateContext);
+    // Overlaps CreateContext, so it's off the critical path
+    StartupTimeline::Scope offPath(Phase::ModuleConfig);
+    sleepMs(5);
+  }
+  {
+    StartupTimeline::Scope phase(Phase::ReadScript);
+    sleepMs(5);
+  }
+  sleepMs(5);
+  {
+    StartupTimeline::Scope phase(Phase::EvaluateScript);
+    sleepMs(5);
+  }
+
+  auto spans = StartupTimeline::getSpans();
+  ASSERT_EQ(4u, spans.size());
+  ASSERT_EQ(Phase::CreateContext, spans[0].phase);
+  ASSERT_EQ(Phase::ModuleConfig, spans[1].phase);
+
+  auto path = StartupTimeline::getCriticalPath();
+  ASSERT_EQ(5u, path.size());
+  ASSERT_TRUE(path[0].isGap);
+  ASSERT_EQ(Phase::CreateContext, path[0].phase);
+  ASSERT_GE(path[0].durationNanos, 5000000);
+  ASSERT_FALSE(path[1].isGap);
+  ASSERT_EQ(Phase::CreateContext, path[1].phase);
+  ASSERT_FALSE(path[2].isGap);
+  ASSERT_EQ(Phase::ReadScript, path[2].phase);
+  ASSERT_TRUE(path[3].isGap);
+  ASSERT_EQ(Phase::EvaluateScript, path[3].phase);
+  ASSERT_GE(path[3].durationNanos, 5000000);
+  ASSERT_FALSE(path[4].isGap);
+  ASSERT_EQ(Phase::EvaluateScript, path[4].phase);
+  ASSERT_GE(path[4].durationNanos, 5000000);
+  ASSERT_STREQ("evaluateScript", StartupTimeline::getPhaseName(path[4].phase));
+}
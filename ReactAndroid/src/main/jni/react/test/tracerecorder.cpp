@@ -0,0 +1,132 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <react/SystraceSection.h>
+#include <react/TraceRecorder.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::react;
+
+static int countOccurrences(const std::string& haystack, const std::string& needle) {
+  int count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    count++;
+  }
+  return count;
+}
+
+class TraceRecorderTest : public testing::Test {
+  protected:
+    virtual void SetUp() override {
+      TraceRecorder::setEnabled(true);
+      TraceRecorder::dumpChromeTrace();
+    }
+
+    virtual void TearDown() override {
+      TraceRecorder::setEnabled(false);
+      TraceRecorder::dumpChromeTrace();
+    }
+};
+
+TEST_F(TraceRecorderTest, RecordsSections) {
+  {
+    SystraceSection outer("outer");
+    SystraceSection inner("inner \"quoted\"", "key", "value");
+  }
+  std::string trace = TraceRecorder::dumpChromeTrace();
+  ASSERT_EQ(0u, trace.find("{\"traceEvents\":["));
+  ASSERT_EQ(2, countOccurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(2, countOccurrences(trace, "\"ph\":\"E\""));
+  ASSERT_LT(trace.find("\"name\":\"outer\""), trace.find("\"name\":\"inner \\\"quoted\\\"\""));
+
+  // Dumping removes the events
+  ASSERT_EQ(0, countOccurrences(TraceRecorder::dumpChromeTrace(), "\"ph\""));
+}
+
+TEST_F(TraceRecorderTest, RecordsAsyncFlowsAcrossThreads) {
+  SystraceAsyncFlow::begin("call", 42);
+  std::thread([] {
+    SystraceAsyncFlow::end("call", 42);
+    TraceRecorder::record(TraceRecorder::EventType::Counter, "queued", 7);
+  }).join();
+
+  std::string trace = TraceRecorder::dumpChromeTrace();
+  ASSERT_EQ(1, countOccurrences(trace, "\"ph\":\"b\""));
+  ASSERT_EQ(1, countOccurrences(trace, "\"ph\":\"e\""));
+  ASSERT_EQ(2, countOccurrences(trace, "\"id\":\"0x2a\""));
+  ASSERT_EQ(1, countOccurrences(trace, "\"args\":{\"value\":7}"));
+}
+
+TEST_F(TraceRecorderTest, SectionsEndEvenIfRecordingStops) {
+  {
+    SystraceSection section("section");
+    TraceRecorder::setEnabled(false);
+    SystraceSection ignored("ignored");
+  }
+  std::string trace = TraceRecorder::dumpChromeTrace();
+  ASSERT_EQ(1, countOccurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(1, countOccurrences(trace, "\"ph\":\"E\""));
+  ASSERT_EQ(0, countOccurrences(trace, "ignored"));
+}
+
+TEST_F(TraceRecorderTest, InternsNamesByContents) {
+  std::string first = "dynamic name";
+  std::string second = "dynamic name";
+  ASSERT_EQ(TraceRecorder::internName(first.c_str()), TraceRecorder::internName(second.c_str()));
+  ASSERT_NE(TraceRecorder::internName("one name"), TraceRecorder::internName("another name"));
+}
+
+TEST_F(TraceRecorderTest, LooksUpNamesById) {
+  uint32_t id = TraceRecorder::internName("looked up");
+  ASSERT_STREQ("looked up", TraceRecorder::getName(id));
+  std::thread([id] {
+    ASSERT_STREQ("looked up", TraceRecorder::getName(id));
+  }).join();
+  ASSERT_EQ(nullptr, TraceRecorder::getName(UINT32_MAX));
+
+  // Names interned after a thread's first lookup are found as well
+  uint32_t later = TraceRecorder::internName("interned later");
+  ASSERT_STREQ("interned later", TraceRecorder::getName(later));
+}
+
+TEST_F(TraceRecorderTest, DropsEventsWhenFull) {
+  const int events = 20000;
+  uint64_t droppedBefore = TraceRecorder::getDroppedEventCount();
+  for (int i = 0; i < events; i++) {
+    TraceRecorder::record(TraceRecorder::EventType::Counter, "counter", i);
+  }
+  std::string trace = TraceRecorder::dumpChromeTrace();
+  int recorded = countOccurrences(trace, "\"ph\":\"C\"");
+  ASSERT_LT(recorded, events);
+  ASSERT_EQ((uint64_t) (events - recorded), TraceRecorder::getDroppedEventCount() - droppedBefore);
+}
+
+TEST_F(TraceRecorderTest, Benchmark) {
+  const int iterations = 1000000;
+  auto measure = [iterations] {
+    std::chrono::nanoseconds elapsed(0);
+    for (int done = 0; done < iterations; done += 1024) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < 1024; i++) {
+        SystraceSection s("JSCExecutor.flush");
+      }
+      elapsed += std::chrono::steady_clock::now() - start;
+      // Not measured, so that the buffer never fills up
+      TraceRecorder::dumpChromeTrace();
+    }
+    return (double) elapsed.count() / iterations;
+  };
+
+  TraceRecorder::setEnabled(false);
+  double disabledNanos = measure();
+  TraceRecorder::setEnabled(true);
+  double enabledNanos = measure();
+  printf("SystraceSection: %.2f ns when not recording, %.2f ns when recording\n",
+    disabledNanos, enabledNanos);
+}
@@ -0,0 +1,371 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+// Replays the bridge traffic recorded with
+// ReactBridge.setBridgeTrafficRecordingPath() against a bundle, on the host,
+// and reports throughput and latency:
+//
+//   bridgereplay [--realtime] <recording> <bundle.js>
+//
+// The calls into JS are replayed in the order they were recorded, as fast as
+// possible or, with --realtime, no earlier than when they were recorded.
+// Native module calls go to mock native modules that only count them: the
+// callbacks native modules invoked are replayed from the recording instead.
+// Web workers aren't replayed.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <folly/Memory.h>
+#include <react/Bridge.h>
+#include <react/BridgeLatency.h>
+#include <react/BridgeTraffic.h>
+#include <react/JSCExecutor.h>
+#include <react/MethodCall.h>
+#include <react/Platform.h>
+
+using namespace facebook::react;
+
+namespace {
+
+using Type = BridgeTrafficRecord::Type;
+
+// The name BridgeLatency records callbacks under
+const char* const kCallbackName = "<callback>";
+// Names with the most calls that are reported
+const size_t kMaxReportedNames = 25;
+
+class ReplayQueue;
+
+// The queue of the current thread, for getCurrentMessageQueueThread
+thread_local ReplayQueue* s_currentQueue = nullptr;
+
+class ReplayQueue : public MessageQueueThread {
+public:
+  ReplayQueue() : m_thread([this] { run(); }) {}
+
+  ~ReplayQueue() {
+    quitSynchronous();
+  }
+
+  virtual void runOnQueue(std::function<void()>&& task) override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_quit) {
+      m_tasks.push_back(std::move(task));
+      m_cv.notify_one();
+    }
+  }
+
+  virtual bool isOnThread() override {
+    return std::this_thread::get_id() == m_thread.get_id();
+  }
+
+  virtual void quitSynchronous() override {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_quit = true;
+      m_cv.notify_one();
+    }
+    if (m_thread.joinable() && !isOnThread()) {
+      m_thread.join();
+    }
+  }
+
+  // Tasks that threw, e.g. because of a JS exception
+  size_t getFailedTaskCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failedTasks;
+  }
+
+private:
+  void run() {
+    s_currentQueue = this;
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_quit || !m_tasks.empty(); });
+        if (m_quit) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      try {
+        task();
+      } catch (const std::exception& e) {
+        fprintf(stderr, "replayed call failed: %s\n", e.what());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failedTasks++;
+      }
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::function<void()>> m_tasks;
+  bool m_quit = false;
+  size_t m_failedTasks = 0;
+  // Last, so that the rest is initialized before it runs
+  std::thread m_thread;
+};
+
+// Doesn't own the queue it forwards to
+class QueueRef : public MessageQueueThread {
+public:
+  explicit QueueRef(MessageQueueThread* queue) : m_queue(queue) {}
+
+  virtual void runOnQueue(std::function<void()>&& task) override {
+    m_queue->runOnQueue(std::move(task));
+  }
+
+  virtual bool isOnThread() override {
+    return m_queue->isOnThread();
+  }
+
+  virtual void quitSynchronous() override {
+    m_queue->quitSynchronous();
+  }
+
+private:
+  MessageQueueThread* m_queue;
+};
+
+class ReplayExecutorTokenFactory : public ExecutorTokenFactory {
+public:
+  virtual ExecutorToken createExecutorToken() const override {
+    return ExecutorToken(std::make_shared<PlatformExecutorToken>());
+  }
+};
+
+// Runs on the JS thread, so its counts are read after a sync with it
+class MockNativeModules : public BridgeCallback {
+public:
+  virtual void onCallNativeModules(
+      ExecutorToken executorToken,
+      const std::string& callJSON,
+      bool isEndOfBatch) override {
+    calls += parseMethodCalls(callJSON).size();
+    batches++;
+  }
+
+  virtual void onExecutorUnregistered(ExecutorToken executorToken) override {}
+
+  uint64_t calls = 0;
+  uint64_t batches = 0;
+};
+
+JSValueRef nativeLoggingHook(
+    JSContextRef ctx,
+    JSObjectRef function,
+    JSObjectRef thisObject,
+    size_t argumentCount,
+    const JSValueRef arguments[],
+    JSValueRef *exception) {
+  return JSValueMakeUndefined(ctx);
+}
+
+void installPlatform() {
+  MessageQueues::getCurrentMessageQueueThread = [] {
+    return std::unique_ptr<MessageQueueThread>(new QueueRef(s_currentQueue));
+  };
+  ReactMarker::logMarker = [] (const std::string&) {};
+  PerfLogging::installNativeHooks = [] (JSGlobalContextRef) {};
+  JSLogging::nativeHook = nativeLoggingHook;
+}
+
+bool readFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  contents = buffer.str();
+  return file.good() || file.eof();
+}
+
+double toMs(uint64_t nanos) {
+  return nanos / 1e6;
+}
+
+uint64_t percentile(std::vector<uint64_t>& values, double fraction) {
+  if (values.empty()) {
+    return 0;
+  }
+  size_t index = std::min(values.size() - 1, static_cast<size_t>(values.size() * fraction));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// A call into JS to replay, with its arguments parsed ahead of time
+struct ReplayedCall {
+  const BridgeTrafficRecord* record;
+  folly::dynamic arguments;
+};
+
+}
+
+int main(int argc, char** argv) {
+  bool realtime = argc > 1 && strcmp(argv[1], "--realtime") == 0;
+  if (argc != (realtime ? 4 : 3)) {
+    fprintf(stderr, "usage: %s [--realtime] <recording> <bundle.js>\n", argv[0]);
+    return 2;
+  }
+  const char* recordingPath = argv[realtime ? 2 : 1];
+  const char* bundlePath = argv[realtime ? 3 : 2];
+
+  std::vector<BridgeTrafficRecord> records;
+  bool complete = BridgeTrafficReader::read(recordingPath, [&] (const BridgeTrafficRecord& record) {
+    records.push_back(record);
+  });
+  if (records.empty() && !complete) {
+    fprintf(stderr, "%s: not a bridge traffic recording\n", recordingPath);
+    return 1;
+  }
+  if (!complete) {
+    // Most likely the app died while recording, what was read is still useful
+    fprintf(stderr, "%s: truncated or damaged, replaying the records before the damage\n", recordingPath);
+  }
+  std::string bundle;
+  if (!readFile(bundlePath, bundle)) {
+    perror(bundlePath);
+    return 1;
+  }
+
+  // Parsed before replaying, so that parsing doesn't hold the replay back
+  std::vector<ReplayedCall> calls;
+  std::map<std::string, std::vector<uint64_t>> recordedNanos;
+  uint64_t recordedNativeCalls = 0;
+  for (auto& record : records) {
+    switch (record.type) {
+      case Type::CallFunction:
+        recordedNanos[record.target + "." + record.method].push_back(record.durationNanos);
+        calls.push_back(ReplayedCall { &record, folly::parseJson(record.json) });
+        break;
+      case Type::InvokeCallback:
+        recordedNanos[kCallbackName].push_back(record.durationNanos);
+        calls.push_back(ReplayedCall { &record, folly::parseJson(record.json) });
+        break;
+      case Type::CallNativeModules:
+        recordedNativeCalls += parseMethodCalls(record.json).size();
+        break;
+      default:
+        calls.push_back(ReplayedCall { &record, nullptr });
+    }
+  }
+
+  installPlatform();
+  ReplayQueue jsQueue;
+  JSCExecutorFactory executorFactory("", folly::dynamic::object);
+  std::unique_ptr<Bridge> bridge;
+  MockNativeModules* nativeModules = nullptr;
+  jsQueue.runOnQueueSync([&] {
+    auto callback = folly::make_unique<MockNativeModules>();
+    nativeModules = callback.get();
+    bridge.reset(new Bridge(
+      &executorFactory,
+      folly::make_unique<ReplayExecutorTokenFactory>(),
+      std::move(callback)));
+  });
+  ExecutorToken token = bridge->getMainExecutorToken();
+
+  BridgeLatency::getStats(true);
+  auto start = std::chrono::steady_clock::now();
+  size_t jsCalls = 0;
+  for (auto& call : calls) {
+    const BridgeTrafficRecord& record = *call.record;
+    if (realtime) {
+      std::this_thread::sleep_until(start + std::chrono::nanoseconds(record.timestampNanos));
+    }
+    switch (record.type) {
+      case Type::LoadScript:
+        // Unbundles are replayed with the bundle too
+        jsQueue.runOnQueue([&bridge, &bundle, &record] {
+          bridge->loadApplicationScript(bundle, record.target);
+        });
+        break;
+      case Type::SetGlobalVariable:
+        bridge->setGlobalVariable(record.target, record.json);
+        break;
+      case Type::CallFunction:
+        bridge->callFunction(
+          token, record.target, record.method, call.arguments, record.target + "." + record.method);
+        jsCalls++;
+        break;
+      case Type::InvokeCallback:
+        bridge->invokeCallback(token, record.callbackId, call.arguments);
+        jsCalls++;
+        break;
+      case Type::CallNativeModules:
+        break;
+    }
+  }
+  jsQueue.runOnQueueSync([] {});
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf(
+    "replayed %zu calls into JS in %.3f s, %.1f calls/s, %zu failed\n",
+    jsCalls,
+    seconds,
+    jsCalls / seconds,
+    jsQueue.getFailedTaskCount());
+  printf(
+    "native module calls: %llu replayed in %llu batches, %llu recorded\n",
+    static_cast<unsigned long long>(nativeModules->calls),
+    static_cast<unsigned long long>(nativeModules->batches),
+    static_cast<unsigned long long>(recordedNativeCalls));
+
+  std::vector<BridgeLatency::Stats> stats;
+  for (auto& entry : BridgeLatency::getStats(true)) {
+    if (entry.kind == BridgeLatency::Kind::QueueWait) {
+      printf(
+        "queue wait: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        toMs(entry.p50Nanos),
+        toMs(entry.p90Nanos),
+        toMs(entry.p99Nanos),
+        toMs(entry.maxNanos));
+    } else if (entry.kind == BridgeLatency::Kind::JSCall) {
+      stats.push_back(entry);
+    }
+  }
+  std::sort(stats.begin(), stats.end(), [] (const BridgeLatency::Stats& a, const BridgeLatency::Stats& b) {
+    return a.count > b.count;
+  });
+  if (stats.size() > kMaxReportedNames) {
+    stats.resize(kMaxReportedNames);
+  }
+  printf(
+    "\n%-48s %8s %10s %10s %10s %10s %10s\n",
+    "JS call (ms)", "count", "rec p50", "rec p90", "p50", "p90", "p99");
+  for (auto& entry : stats) {
+    std::vector<uint64_t>& recorded = recordedNanos[entry.name];
+    printf(
+      "%-48s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+      entry.name.c_str(),
+      static_cast<unsigned long long>(entry.count),
+      toMs(percentile(recorded, 0.5)),
+      toMs(percentile(recorded, 0.9)),
+      toMs(entry.p50Nanos),
+      toMs(entry.p90Nanos),
+      toMs(entry.p99Nanos));
+  }
+
+  jsQueue.runOnQueueSync([&] {
+    bridge->destroy();
+    bridge.reset();
+  });
+  jsQueue.quitSynchronous();
+  return complete && jsQueue.getFailedTaskCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+// Converts the profile captures written by ProfileWriter to Chrome Trace
+// Event JSON, which chrome://tracing, Perfetto and Chrome DevTools open.
+//
+//   profile2trace <capture> [<output.json>]
+//
+// Trace events are copied as they are. JSC legacy profiles become complete
+// ("X") events on a thread of their own.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <react/ProfileWriter.h>
+
+using namespace facebook::react;
+
+namespace {
+
+// The JSC profile thread, which has no tid of its own
+const int kJSCProfileTid = 0;
+
+struct JsonValue {
+  enum class Type {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+  };
+
+  Type type = Type::Null;
+  double number = 0;
+  std::string string;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue* get(const char* key) const {
+    for (auto& member : object) {
+      if (member.first == key) {
+        return &member.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// Just enough JSON for JSC profiles, which come from JSC
+class JsonParser {
+public:
+  explicit JsonParser(const std::string& text) : m_text(text) {}
+
+  bool parse(JsonValue& value) {
+    return parseValue(value, 0) && (skipSpace(), m_pos == m_text.size());
+  }
+
+private:
+  static const int kMaxDepth = 512;
+
+  void skipSpace() {
+    while (m_pos < m_text.size() && strchr(" \t\r\n", m_text[m_pos]) != nullptr) {
+      m_pos++;
+    }
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (m_pos < m_text.size() && m_text[m_pos] == c) {
+      m_pos++;
+      return true;
+    }
+    return false;
+  }
+
+  bool consumeWord(const char* word) {
+    size_t length = strlen(word);
+    if (m_text.compare(m_pos, length, word) == 0) {
+      m_pos += length;
+      return true;
+    }
+    return false;
+  }
+
+  bool parseString(std::string& out) {
+    if (!consume('"')) {
+      return false;
+    }
+    while (m_pos < m_text.size()) {
+      char c = m_text[m_pos++];
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (m_pos >= m_text.size()) {
+        return false;
+      }
+      c = m_text[m_pos++];
+      switch (c) {
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+          if (m_pos + 4 > m_text.size()) {
+            return false;
+          }
+          unsigned code = strtoul(m_text.substr(m_pos, 4).c_str(), nullptr, 16);
+          m_pos += 4;
+          // Surrogates are kept as they are, names are only displayed
+          if (code < 0x80) {
+            out += static_cast<char>(code);
+          } else if (code < 0x800) {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+          } else {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+          }
+          break;
+        }
+        default:
+          out += c;
+      }
+    }
+    return false;
+  }
+
+  bool parseValue(JsonValue& value, int depth) {
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    skipSpace();
+    if (m_pos >= m_text.size()) {
+      return false;
+    }
+    char c = m_text[m_pos];
+    if (c == '{') {
+      m_pos++;
+      value.type = JsonValue::Type::Object;
+      if (consume('}')) {
+        return true;
+      }
+      do {
+        std::string key;
+        if (!parseString(key) || !consume(':')) {
+          return false;
+        }
+        value.object.emplace_back(std::move(key), JsonValue());
+        if (!parseValue(value.object.back().second, depth + 1)) {
+          return false;
+        }
+      } while (consume(','));
+      return consume('}');
+    }
+    if (c == '[') {
+      m_pos++;
+      value.type = JsonValue::Type::Array;
+      if (consume(']')) {
+        return true;
+      }
+      do {
+        value.array.emplace_back();
+        if (!parseValue(value.array.back(), depth + 1)) {
+          return false;
+        }
+      } while (consume(','));
+      return consume(']');
+    }
+    if (c == '"') {
+      value.type = JsonValue::Type::String;
+      return parseString(value.string);
+    }
+    if (consumeWord("true")) {
+      value.type = JsonValue::Type::Bool;
+      value.number = 1;
+      return true;
+    }
+    if (consumeWord("false")) {
+      value.type = JsonValue::Type::Bool;
+      return true;
+    }
+    if (consumeWord("null")) {
+      return true;
+    }
+    const char* start = m_text.c_str() + m_pos;
+    char* end;
+    value.type = JsonValue::Type::Number;
+    value.number = strtod(start, &end);
+    m_pos += end - start;
+    return end != start;
+  }
+
+  const std::string& m_text;
+  size_t m_pos = 0;
+};
+
+void writeEscaped(FILE* out, const std::string& value) {
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      fputc('\\', out);
+      fputc(c, out);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+    } else {
+      fputc(c, out);
+    }
+  }
+}
+
+class TraceOutput {
+public:
+  TraceOutput(FILE* out, uint32_t pid) : m_out(out), m_pid(pid) {
+    fputs("{\"traceEvents\":[", m_out);
+  }
+
+  void finish() {
+    fputs("],\"displayTimeUnit\":\"ms\"}\n", m_out);
+  }
+
+  // events is one trace event object per line
+  void writeTraceEvents(const std::string& events) {
+    size_t start = 0;
+    while (start < events.size()) {
+      size_t end = events.find('\n', start);
+      if (end == std::string::npos) {
+        end = events.size();
+      }
+      if (end > start) {
+        separate();
+        fwrite(events.data() + start, 1, end - start, m_out);
+      }
+      start = end + 1;
+    }
+  }
+
+  bool writeJSCProfile(const std::string& document) {
+    JsonValue profile;
+    if (!JsonParser(document).parse(profile)) {
+      return false;
+    }
+    const JsonValue* rootNodes = profile.get("rootNodes");
+    if (rootNodes == nullptr) {
+      return false;
+    }
+    if (!m_namedJSCThread) {
+      separate();
+      fprintf(
+        m_out,
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%d,"
+        "\"args\":{\"name\":\"JSC profile\"}}",
+        m_pid,
+        kJSCProfileTid);
+      m_namedJSCThread = true;
+    }
+    for (auto& node : rootNodes->array) {
+      writeJSCProfileNode(node);
+    }
+    return true;
+  }
+
+private:
+  void separate() {
+    fputs(m_first ? "\n" : ",\n", m_out);
+    m_first = false;
+  }
+
+  void writeJSCProfileNode(const JsonValue& node) {
+    const JsonValue* name = node.get("functionName");
+    const JsonValue* url = node.get("url");
+    const JsonValue* line = node.get("lineNumber");
+    const JsonValue* column = node.get("columnNumber");
+    const JsonValue* calls = node.get("calls");
+    if (calls != nullptr) {
+      for (auto& call : calls->array) {
+        const JsonValue* startTime = call.get("startTime");
+        const JsonValue* totalTime = call.get("totalTime");
+        if (startTime == nullptr || totalTime == nullptr) {
+          continue;
+        }
+        separate();
+        fputs("{\"name\":\"", m_out);
+        writeEscaped(m_out, name != nullptr && !name->string.empty() ? name->string : "(anonymous)");
+        // JSC times are in seconds
+        fprintf(
+          m_out,
+          "\",\"cat\":\"jsc\",\"ph\":\"X\",\"pid\":%u,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+          "\"args\":{\"url\":\"",
+          m_pid,
+          kJSCProfileTid,
+          startTime->number * 1e6,
+          totalTime->number * 1e6);
+        writeEscaped(m_out, url != nullptr ? url->string : "");
+        fprintf(
+          m_out,
+          "\",\"line\":%d,\"column\":%d}}",
+          line != nullptr ? static_cast<int>(line->number) : -1,
+          column != nullptr ? static_cast<int>(column->number) : -1);
+      }
+    }
+    const JsonValue* children = node.get("children");
+    if (children != nullptr) {
+      for (auto& child : children->array) {
+        writeJSCProfileNode(child);
+      }
+    }
+  }
+
+  FILE* m_out;
+  uint32_t m_pid;
+  bool m_first = true;
+  bool m_namedJSCThread = false;
+};
+
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s <capture> [<output.json>]\n", argv[0]);
+    return 2;
+  }
+  FILE* out = argc == 3 ? fopen(argv[2], "w") : stdout;
+  if (out == nullptr) {
+    perror(argv[2]);
+    return 1;
+  }
+
+  std::unique_ptr<TraceOutput> output;
+  // Documents split across chunks, only kept until their last chunk
+  std::string document;
+  int invalidDocuments = 0;
+  uint32_t pid = 0;
+  bool complete = ProfileReader::read(argv[1], pid, [&] (
+      ProfileWriter::ChunkType type,
+      uint32_t flags,
+      const std::string& data) {
+    if (!output) {
+      output.reset(new TraceOutput(out, pid));
+    }
+    switch (type) {
+      case ProfileWriter::ChunkType::TraceEvents:
+        output->writeTraceEvents(data);
+        break;
+      case ProfileWriter::ChunkType::JSCProfile:
+        document += data;
+        if (!(flags & ProfileWriter::kFlagContinued)) {
+          if (!output->writeJSCProfile(document)) {
+            invalidDocuments++;
+          }
+          document.clear();
+          document.shrink_to_fit();
+        }
+        break;
+      default:
+        // From a newer writer
+        break;
+    }
+  });
+
+  if (!output) {
+    if (!complete) {
+      fprintf(stderr, "%s: not a profile capture\n", argv[1]);
+      return 1;
+    }
+    output.reset(new TraceOutput(out, pid));
+  }
+  output->finish();
+  if (out != stdout && fclose(out) != 0) {
+    perror(argv[2]);
+    return 1;
+  }
+  if (!complete) {
+    // Most likely the app died while capturing, what was read is still useful
+    fprintf(stderr, "%s: truncated or damaged, converted the chunks before the damage\n", argv[1]);
+  }
+  if (invalidDocuments > 0) {
+    fprintf(stderr, "%s: skipped %d invalid JSC profiles\n", argv[1], invalidDocuments);
+  }
+  return complete && invalidDocuments == 0 ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.IntBuffer;
+import java.util.concurrent.Callable;
+import java.util.concurrent.Future;
+
+import com.facebook.react.bridge.queue.MessageQueueThread;
+import com.facebook.soloader.SoLoader;
+
+import org.junit.Assume;
+import org.junit.BeforeClass;
+import org.junit.Test;
+
+import static org.fest.assertions.api.Assertions.assertThat;
+
+/**
+ * Measures the JNI marshalling of the bridge on a desktop JVM, against the host build of
+ * libreactnativejni (src/main/jni/react/jni/host), so that it can be tracked in CI without a device
+ * or an emulator:
+ *
+ *   ./gradlew :ReactAndroid:testDebugUnitTest -PhostJni --tests '*NativeBridgeBenchmarkTest'
+ *
+ * Skipped when the host libraries aren't on java.library.path.
+ */
+public class NativeBridgeBenchmarkTest {
+
+  private static final int WARMUP_ITERATIONS = 2000;
+  private static final int ITERATIONS = 20000;
+  private static final int CALLS_PER_BATCH = 50;
+
+  private interface Benchmark {
+    void run();
+  }
+
+  @BeforeClass
+  public static void loadHostLibraries() {
+    try {
+      SoLoader.loadLibrary(ReactBridge.REACT_NATIVE_LIB);
+    } catch (UnsatisfiedLinkError e) {
+      Assume.assumeNoException("Host build of libreactnativejni not found", e);
+    }
+  }
+
+  @Test
+  public void writeMap() {
+    measure("WritableNativeMap.put*", new Benchmark() {
+      @Override
+      public void run() {
+        WritableNativeMap map = new WritableNativeMap();
+        map.putInt("reactTag", 42);
+        map.putString("type", "topChange");
+        map.putDouble("x", 12.5);
+        map.putDouble("y", 3.25);
+        map.putBoolean("bubbles", true);
+        map.putNull("target");
+        map.dispose();
+      }
+    });
+  }
+
+  @Test
+  public void writeMapWithBuilder() {
+    final WritableNativeMapBuilder builder = new WritableNativeMapBuilder();
+    measure("WritableNativeMapBuilder", new Benchmark() {
+      @Override
+      public void run() {
+        WritableNativeMap map = builder
+            .putInt("reactTag", 42)
+            .putString("type", "topChange")
+            .putDouble("x", 12.5)
+            .putDouble("y", 3.25)
+            .putBoolean("bubbles", true)
+            .putNull("target")
+            .build();
+        map.dispose();
+      }
+    });
+  }
+
+  @Test
+  public void readMap() {
+    final WritableNativeMap map = createEvent();
+    measure("ReadableNativeMap.get*", new Benchmark() {
+      @Override
+      public void run() {
+        map.getInt("reactTag");
+        map.getString("type");
+        map.getDouble("x");
+        map.getDouble("y");
+        map.getBoolean("bubbles");
+        map.isNull("target");
+      }
+    });
+    measure("ReadableNativeMap.toHashMap", new Benchmark() {
+      @Override
+      public void run() {
+        map.toHashMap();
+      }
+    });
+  }
+
+  @Test
+  public void readArray() {
+    final WritableNativeArray array = new WritableNativeArray();
+    for (int i = 0; i < 10; i++) {
+      array.pushInt(i);
+      array.pushString("item" + i);
+    }
+    measure("ReadableNativeArray.get*", new Benchmark() {
+      @Override
+      public void run() {
+        for (int i = 0; i < array.size(); i += 2) {
+          array.getInt(i);
+          array.getString(i + 1);
+        }
+      }
+    });
+    measure("ReadableNativeArray.toArrayList", new Benchmark() {
+      @Override
+      public void run() {
+        array.toArrayList();
+      }
+    });
+  }
+
+  @Test
+  public void dispatchCallBatch() {
+    final String callsJson = createCallBatchJson(CALLS_PER_BATCH);
+    final CountingCallback callback = new CountingCallback();
+    measure("call batch of " + CALLS_PER_BATCH, new Benchmark() {
+      @Override
+      public void run() {
+        dispatchCallBatches(callback, callsJson, 1);
+      }
+    });
+    assertThat(callback.mCalls).isEqualTo(
+        (long) (WARMUP_ITERATIONS + ITERATIONS) * CALLS_PER_BATCH);
+  }
+
+  @Test
+  public void postRunnable() {
+    final InlineMessageQueueThread queue = new InlineMessageQueueThread();
+    final int runnablesPerIteration = 10;
+    measure("posting " + runnablesPerIteration + " runnables", new Benchmark() {
+      @Override
+      public void run() {
+        assertThat(postRunnables(queue, runnablesPerIteration)).isEqualTo(runnablesPerIteration);
+      }
+    });
+  }
+
+  @Test
+  public void convertKeys() {
+    final String[] keys = {"reactTag", "type", "width", "height", "backgroundColor", "transform"};
+    final long length = convertStrings(keys, 1, false);
+    measure("jni::fromJString of " + keys.length + " keys", new Benchmark() {
+      @Override
+      public void run() {
+        assertThat(convertStrings(keys, 1, false)).isEqualTo(length);
+      }
+    });
+    measure("JniStringCache of " + keys.length + " keys", new Benchmark() {
+      @Override
+      public void run() {
+        assertThat(convertStrings(keys, 1, true)).isEqualTo(length);
+      }
+    });
+  }
+
+  private static void measure(String name, Benchmark benchmark) {
+    for (int i = 0; i < WARMUP_ITERATIONS; i++) {
+      benchmark.run();
+    }
+    long start = System.nanoTime();
+    for (int i = 0; i < ITERATIONS; i++) {
+      benchmark.run();
+    }
+    long nanos = (System.nanoTime() - start) / ITERATIONS;
+    System.out.println(name + ": " + nanos + " ns per iteration");
+  }
+
+  private static WritableNativeMap createEvent() {
+    WritableNativeMap map = new WritableNativeMap();
+    map.putInt("reactTag", 42);
+    map.putString("type", "topChange");
+    map.putDouble("x", 12.5);
+    map.putDouble("y", 3.25);
+    map.putBoolean("bubbles", true);
+    map.putNull("target");
+    return map;
+  }
+
+  // In the format of MessageQueue.flushedQueue(): module IDs, method IDs, arguments
+  private static String createCallBatchJson(int calls) {
+    StringBuilder moduleIds = new StringBuilder();
+    StringBuilder methodIds = new StringBuilder();
+    StringBuilder arguments = new StringBuilder();
+    for (int i = 0; i < calls; i++) {
+      String separator = i == 0 ? "" : ",";
+      moduleIds.append(separator).append(i % 7);
+      methodIds.append(separator).append(i % 3);
+      arguments.append(separator)
+          .append("[").append(i).append(",\"view").append(i).append("\",{\"width\":100.5}]");
+    }
+    return "[[" + moduleIds + "],[" + methodIds + "],[" + arguments + "]]";
+  }
+
+  private static class CountingCallback implements ReactCallback {
+    private long mCalls;
+
+    @Override
+    public void callBatch(
+        ExecutorToken executorToken,
+        ByteBuffer calls,
+        ReadableNativeArray[] parameters) {
+      // Same decoding as CatalystInstanceImpl
+      IntBuffer ids = calls.order(ByteOrder.nativeOrder()).asIntBuffer();
+      assertThat(parameters).hasSize(ids.remaining() / 3);
+      while (ids.hasRemaining()) {
+        ids.get();
+        ids.get();
+        ids.put(0);
+        mCalls++;
+      }
+    }
+
+    @Override
+    public void onBatchComplete() {
+    }
+
+    @Override
+    public void onExecutorUnregistered(ExecutorToken executorToken) {
+    }
+  }
+
+  // Runs runnables as soon as they're posted, so only the cost of posting is measured
+  private static class InlineMessageQueueThread implements MessageQueueThread {
+    @Override
+    public void runOnQueue(Runnable runnable) {
+      runnable.run();
+    }
+
+    @Override
+    public <T> Future<T> callOnQueue(Callable<T> callable) {
+      throw new UnsupportedOperationException();
+    }
+
+    @Override
+    public boolean isOnThread() {
+      return true;
+    }
+
+    @Override
+    public void assertIsOnThread() {
+    }
+
+    @Override
+    public void quitSynchronous() {
+    }
+  }
+
+  // Registered by host/HostOnLoad.cpp
+  private static native void dispatchCallBatches(
+      ReactCallback callback,
+      String callsJson,
+      int iterations);
+
+  private static native int postRunnables(MessageQueueThread queue, int count);
+
+  private static native long convertStrings(String[] strings, int iterations, boolean cached);
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2015-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+package com.facebook.react.bridge;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import com.facebook.soloader.SoLoader;
+
+import org.junit.After;
+import org.junit.Assume;
+import org.junit.Before;
+import org.junit.BeforeClass;
+import org.junit.Test;
+
+import static org.fest.assertions.api.Assertions.assertThat;
+
+/**
+ * Tests the delivery of markers logged from native code, against the host build of
+ * libreactnativejni (see {@link NativeBridgeBenchmarkTest}). Skipped when the host libraries
+ * aren't on java.library.path.
+ */
+public class ReactMarkerTest {
+
+  private static class RecordingListener implements ReactMarker.TimedMarkerListener {
+    private final List<String> mNames = new ArrayList<>();
+    private final List<Long> mTimestamps = new ArrayList<>();
+
+    @Override
+    public void logMarker(String name) {
+      throw new AssertionError("Native markers should be delivered with their timestamp");
+    }
+
+    @Override
+    public void logMarker(String name, long timestampNanos) {
+      mNames.add(name);
+      mTimestamps.add(timestampNanos);
+    }
+  }
+
+  private RecordingListener mListener;
+
+  @BeforeClass
+  public static void loadHostLibraries() {
+    try {
+      SoLoader.loadLibrary(ReactBridge.REACT_NATIVE_LIB);
+    } catch (UnsatisfiedLinkError e) {
+      Assume.assumeNoException("Host build of libreactnativejni not found", e);
+    }
+  }
+
+  @Before
+  public void setUp() {
+    // Drop whatever earlier tests left in the native buffer
+    ReactMarker.setMarkerListener(null);
+    ReactMarker.flushNativeMarkers();
+    mListener = new RecordingListener();
+    ReactMarker.setMarkerListener(mListener);
+  }
+
+  @After
+  public void tearDown() {
+    ReactMarker.setMarkerListener(null);
+  }
+
+  @Test
+  public void testMarkersAreBufferedUntilFlushed() {
+    logNativeMarkers("marker", 100);
+    assertThat(mListener.mNames).isEmpty();
+
+    ReactMarker.flushNativeMarkers();
+    assertMarkers("marker", 100);
+    long before = System.nanoTime();
+    assertThat(mListener.mTimestamps.get(99)).isLessThanOrEqualTo(before);
+  }
+
+  @Test
+  public void testFullBufferIsFlushedWithoutLosingMarkers() {
+    // Several times the buffer size, without flushing from Java
+    logNativeMarkers("marker", 1000);
+    assertThat(mListener.mNames.size()).isGreaterThan(0);
+
+    ReactMarker.flushNativeMarkers();
+    assertMarkers("marker", 1000);
+  }
+
+  private void assertMarkers(String prefix, int count) {
+    assertThat(mListener.mNames).hasSize(count);
+    for (int i = 0; i < count; i++) {
+      assertThat(mListener.mNames.get(i)).isEqualTo(prefix + i);
+      if (i > 0) {
+        assertThat(mListener.mTimestamps.get(i))
+            .isGreaterThanOrEqualTo(mListener.mTimestamps.get(i - 1));
+      }
+    }
+  }
+
+  // Registered by host/HostOnLoad.cpp, logs prefix0 to prefix(count - 1)
+  private static native void logNativeMarkers(String prefix, int count);
+}
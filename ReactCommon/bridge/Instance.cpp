@@ -170,6 +170,7 @@ ExecutorToken Instance::getMainExecutorToken() {
 void Instance::callNativeModules(ExecutorToken token, const std::string& calls, bool isEndOfBatch) {
   // TODO mhorowitz: avoid copying calls here.
   nativeQueue_->runOnQueue([this, token, calls, isEndOfBatch] {
+      SystraceSection s("Instance::callNativeModules");
       try {
         // An exception anywhere in here stops processing of the batch.  This
         // was the behavior of the Android bridge, and since exception handling
@@ -3,6 +3,7 @@
 #include "JSCExecutor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <sstream>
@@ -16,6 +17,7 @@
 
 #include "Bridge.h"
 #include "JSCHelpers.h"
+#include "NativeHookStats.h"
 #include "Platform.h"
 #include "SystraceSection.h"
 #include "Value.h"
@@ -51,9 +53,16 @@ namespace react {
 
 namespace {
 
+// Metered in NativeHookStats under name
 template<JSValueRef (JSCExecutor::*method)(size_t, const JSValueRef[])>
-inline JSObjectCallAsFunctionCallback exceptionWrapMethod() {
+inline JSObjectCallAsFunctionCallback exceptionWrapMethod(const char* name) {
   struct funcWrapper {
+    // The NativeHookStats index of the method, -1 if it isn't metered
+    static std::atomic<int>& hook() {
+      static std::atomic<int> index{-1};
+      return index;
+    }
+
     static JSValueRef call(
         JSContextRef ctx,
         JSObjectRef function,
@@ -61,6 +70,7 @@ inline JSObjectCallAsFunctionCallback exceptionWrapMethod() {
         size_t argumentCount,
         const JSValueRef arguments[],
         JSValueRef *exception) {
+      NativeHookStats::Scope scope(hook().load(std::memory_order_relaxed));
       try {
         auto globalObj = JSContextGetGlobalObject(ctx);
         auto executor = static_cast<JSCExecutor*>(JSObjectGetPrivate(globalObj));
@@ -77,6 +87,11 @@ inline JSObjectCallAsFunctionCallback exceptionWrapMethod() {
     }
   };
 
+  int hook = NativeHookStats::registerHook(name);
+  if (hook < 0) {
+    LOG(WARNING) << "Too many native hooks, not metering " << name;
+  }
+  funcWrapper::hook().store(hook, std::memory_order_relaxed);
   return &funcWrapper::call;
 }
 
@@ -478,7 +493,7 @@ Object JSCExecutor::createMessageObject(const std::string& msgJson) {
 // Native JS hooks
 template<JSValueRef (JSCExecutor::*method)(size_t, const JSValueRef[])>
 void JSCExecutor::installNativeHook(const char* name) {
-  installGlobalFunction(m_context, name, exceptionWrapMethod<method>());
+  installGlobalFunction(m_context, name, exceptionWrapMethod<method>(name));
 }
 
 JSValueRef JSCExecutor::nativePostMessage(
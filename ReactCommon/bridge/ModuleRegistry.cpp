@@ -2,14 +2,17 @@
 
 #include "ModuleRegistry.h"
 
+#include "BridgeLatency.h"
 #include "NativeModule.h"
 #include "SystraceSection.h"
+#include "TraceRecorder.h"
 
 namespace facebook {
 namespace react {
 
 ModuleRegistry::ModuleRegistry(std::vector<std::unique_ptr<NativeModule>> modules)
-    : modules_(std::move(modules)) {}
+    : modules_(std::move(modules))
+    , latencyNameIds_(modules_.size()) {}
 
 folly::dynamic ModuleRegistry::moduleDescriptions() {
   folly::dynamic modDescs = folly::dynamic::object;
@@ -66,7 +69,12 @@ void ModuleRegistry::callNativeMethod(ExecutorToken token, unsigned int moduleId
   // TODO mhorowitz: systrace
   std::string what;
   try {
+    uint64_t start = BridgeLatency::nowNanos();
     modules_[moduleId]->invoke(token, methodId, std::move(params));
+    BridgeLatency::record(
+      BridgeLatency::Kind::NativeCall,
+      getLatencyNameId(moduleId, methodId),
+      BridgeLatency::nowNanos() - start);
     return;
   } catch (const std::exception& e) {
     what = e.what();
@@ -96,6 +104,21 @@ void ModuleRegistry::callNativeMethod(ExecutorToken token, unsigned int moduleId
   }
 }
 
+uint32_t ModuleRegistry::getLatencyNameId(unsigned int moduleId, unsigned int methodId) {
+  auto& nameIds = latencyNameIds_[moduleId];
+  if (nameIds.empty()) {
+    std::string moduleName = modules_[moduleId]->getName();
+    for (const auto& method : modules_[moduleId]->getMethods()) {
+      nameIds.push_back(TraceRecorder::internName((moduleName + "." + method.name).c_str()));
+    }
+  }
+  if (methodId >= nameIds.size()) {
+    static const uint32_t kUnknownNameId = TraceRecorder::internName("<unknown>");
+    return kUnknownNameId;
+  }
+  return nameIds[methodId];
+}
+
 MethodCallResult ModuleRegistry::callSerializableNativeHook(ExecutorToken token, unsigned int moduleId, unsigned int methodId, folly::dynamic&& params) {
   if (moduleId >= modules_.size()) {
     throw std::runtime_error(
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -31,7 +32,12 @@ class ModuleRegistry {
   MethodCallResult callSerializableNativeHook(ExecutorToken token, unsigned int moduleId, unsigned int methodId, folly::dynamic&& args);
 
  private:
+  uint32_t getLatencyNameId(unsigned int moduleId, unsigned int methodId);
+
   std::vector<std::unique_ptr<NativeModule>> modules_;
+  // BridgeLatency name IDs of "Module.method", by module ID and method ID.
+  // Filled in on first call, only used on the native modules queue.
+  std::vector<std::vector<uint32_t>> latencyNameIds_;
 };
 
 }
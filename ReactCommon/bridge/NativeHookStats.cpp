@@ -0,0 +1,126 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "NativeHookStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace facebook {
+namespace react {
+
+namespace {
+
+enum SlotStatus : int {
+  Free,
+  Claiming,
+  Claimed,
+};
+
+// name is written once, by the thread claiming the slot, before the status
+// becomes Claimed
+struct HookSlot {
+  std::atomic<int> status;
+  std::string name;
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> totalNanos;
+  std::atomic<uint64_t> maxNanos;
+};
+
+HookSlot g_hooks[NativeHookStats::kMaxHooks];
+std::atomic<bool> g_enabled{false};
+
+// steady_clock rather than clock_gettime(), which not every iOS version
+// this builds for has
+uint64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+const size_t NativeHookStats::kMaxHooks;
+
+NativeHookStats::Scope::Scope(int hook)
+  : m_hook(g_enabled.load(std::memory_order_relaxed) ? hook : -1),
+    m_startNanos(m_hook >= 0 ? nowNanos() : 0) {}
+
+NativeHookStats::Scope::~Scope() {
+  if (m_hook >= 0) {
+    record(m_hook, nowNanos() - m_startNanos);
+  }
+}
+
+void NativeHookStats::setEnabled(bool enabled) {
+  g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool NativeHookStats::isEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+int NativeHookStats::registerHook(const char* name) {
+  // Slots are claimed in order, and a slot being claimed is waited for, so
+  // two threads registering the same name end up with the same slot
+  for (size_t i = 0; i < kMaxHooks; i++) {
+    HookSlot& slot = g_hooks[i];
+    int status = slot.status.load(std::memory_order_acquire);
+    while (status != Claimed) {
+      if (status == Claiming) {
+        std::this_thread::yield();
+        status = slot.status.load(std::memory_order_acquire);
+      } else if (slot.status.compare_exchange_weak(status, Claiming, std::memory_order_acquire)) {
+        slot.name = name;
+        slot.status.store(Claimed, std::memory_order_release);
+        return static_cast<int>(i);
+      }
+    }
+    if (slot.name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void NativeHookStats::record(int hook, uint64_t nanos) {
+  if (hook < 0 || static_cast<size_t>(hook) >= kMaxHooks) {
+    return;
+  }
+  HookSlot& slot = g_hooks[hook];
+  slot.count.fetch_add(1, std::memory_order_relaxed);
+  slot.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+  uint64_t max = slot.maxNanos.load(std::memory_order_relaxed);
+  while (nanos > max &&
+         !slot.maxNanos.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<NativeHookStats::Stats> NativeHookStats::getStats(bool reset) {
+  std::vector<Stats> stats;
+  for (auto& slot : g_hooks) {
+    if (slot.status.load(std::memory_order_acquire) != Claimed) {
+      break;
+    }
+    // The counters are read one at a time, so a call recorded meanwhile may
+    // be in some of them only
+    uint64_t count = reset
+      ? slot.count.exchange(0, std::memory_order_relaxed)
+      : slot.count.load(std::memory_order_relaxed);
+    uint64_t totalNanos = reset
+      ? slot.totalNanos.exchange(0, std::memory_order_relaxed)
+      : slot.totalNanos.load(std::memory_order_relaxed);
+    uint64_t maxNanos = reset
+      ? slot.maxNanos.exchange(0, std::memory_order_relaxed)
+      : slot.maxNanos.load(std::memory_order_relaxed);
+    if (count > 0) {
+      stats.push_back(Stats { slot.name, count, totalNanos, maxNanos });
+    }
+  }
+  std::sort(stats.begin(), stats.end(), [] (const Stats& a, const Stats& b) {
+    return a.totalNanos > b.totalNanos;
+  });
+  return stats;
+}
+
+} }
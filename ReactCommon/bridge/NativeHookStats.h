@@ -0,0 +1,70 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace facebook {
+namespace react {
+
+/**
+ * Call counts and times of the native hooks JS calls, e.g.
+ * nativeCallSyncHook or nativeRequire, by hook name. Hooks JSCExecutor
+ * installs with installNativeHook() are registered here and metered while
+ * metering is enabled, so that overuse of synchronous hooks shows up.
+ *
+ * Hooks of the same name share their stats across JS contexts. The table
+ * holds kMaxHooks names, hooks past that aren't metered. Recording is
+ * lock-free.
+ */
+class NativeHookStats {
+public:
+  static const size_t kMaxHooks = 64;
+
+  struct Stats {
+    std::string name;
+    uint64_t count;
+    uint64_t totalNanos;
+    uint64_t maxNanos;
+  };
+
+  /**
+   * Times a hook call, if metering is enabled when it begins.
+   */
+  class Scope : public noncopyable {
+  public:
+    explicit Scope(int hook);
+    ~Scope();
+
+  private:
+    const int m_hook;
+    const uint64_t m_startNanos;
+  };
+
+  /**
+   * Metering is disabled by default, when it is, hooks only pay for an
+   * atomic load per call.
+   */
+  static void setEnabled(bool enabled);
+  static bool isEnabled();
+
+  /**
+   * Returns the index of the hook named name, registering it the first time,
+   * or -1 if the table is full.
+   */
+  static int registerHook(const char* name);
+
+  static void record(int hook, uint64_t nanos);
+
+  /**
+   * Returns the stats of every hook called since the last reset, the hook
+   * taking the most time first. If reset is true, this starts a new window.
+   */
+  static std::vector<Stats> getStats(bool reset);
+};
+
+} }
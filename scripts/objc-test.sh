@@ -33,4 +33,17 @@ xcodebuild \
   -project Examples/UIExplorer/UIExplorer.xcodeproj \
   -scheme UIExplorer -sdk iphonesimulator -destination 'platform=iOS Simulator,name=iPhone 5,OS=9.3' \
   test \
+| xcpretty
+XCODEBUILD_EXIT_CODE=${PIPESTATUS[0]}
+[ $XCODEBUILD_EXIT_CODE -eq 0 ] || exit $XCODEBUILD_EXIT_CODE
+
+# The layout pass instrumentation is compiled out of the run above. Build the
+# unit tests again with it, into their own derived data so the default build
+# is left untouched, so that RCTLayoutInstrumentationTests run.
+xcodebuild \
+  -project Examples/UIExplorer/UIExplorer.xcodeproj \
+  -scheme UIExplorerUnitTests -sdk iphonesimulator -destination 'platform=iOS Simulator,name=iPhone 5,OS=9.3' \
+  -derivedDataPath "${TMPDIR:-/tmp}/UIExplorerInstrumented" \
+  OTHER_CFLAGS='$(inherited) -DCSS_LAYOUT_INSTRUMENTATION' \
+  test \
 | xcpretty && exit ${PIPESTATUS[0]}